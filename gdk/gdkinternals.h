@@ -300,6 +300,15 @@ struct _GdkWindow
     gboolean surface_needs_composite;
     gboolean use_gl;
   } current_paint;
+
+  /* The double buffer surface of the last paint. We keep it around
+   * so that we don't have to allocate a new one for every frame. */
+  struct {
+    cairo_surface_t *surface;
+    int width;
+    int height;
+    int scale;
+  } paint_buffer;
   GdkGLContext *gl_paint_context;
 
   cairo_region_t *update_area;
@@ -530,6 +539,11 @@ void       _gdk_offscreen_window_new                 (GdkWindow     *window,
 cairo_surface_t * _gdk_offscreen_window_create_surface (GdkWindow *window,
                                                         gint       width,
                                                         gint       height);
+gboolean   _gdk_offscreen_window_get_embedder_offset (GdkWindow     *window,
+                                                      gdouble       *x,
+                                                      gdouble       *y);
+void       _gdk_offscreen_window_damage_embedder     (GdkWindow            *window,
+                                                      const cairo_region_t *region);
 
 G_END_DECLS
 
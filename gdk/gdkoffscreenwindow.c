@@ -50,6 +50,13 @@ struct _GdkOffscreenWindow
 
   cairo_surface_t *surface;
   GdkWindow *embedder;
+
+  /* Set when the embedder only translates the window, so that
+   * coordinates and damage can be converted without signals.
+   */
+  guint has_embedder_offset : 1;
+  gdouble embedder_offset_x;
+  gdouble embedder_offset_y;
 };
 
 struct _GdkOffscreenWindowClass
@@ -224,6 +231,15 @@ from_embedder (GdkWindow *window,
 	       double embedder_x, double embedder_y,
 	       double *offscreen_x, double *offscreen_y)
 {
+  double dx, dy;
+
+  if (_gdk_offscreen_window_get_embedder_offset (window->impl_window, &dx, &dy))
+    {
+      *offscreen_x = embedder_x - dx;
+      *offscreen_y = embedder_y - dy;
+      return;
+    }
+
   g_signal_emit_by_name (window->impl_window,
 			 "from-embedder",
 			 embedder_x, embedder_y,
@@ -236,6 +252,15 @@ to_embedder (GdkWindow *window,
 	     double offscreen_x, double offscreen_y,
 	     double *embedder_x, double *embedder_y)
 {
+  double dx, dy;
+
+  if (_gdk_offscreen_window_get_embedder_offset (window->impl_window, &dx, &dy))
+    {
+      *embedder_x = offscreen_x + dx;
+      *embedder_y = offscreen_y + dy;
+      return;
+    }
+
   g_signal_emit_by_name (window->impl_window,
 			 "to-embedder",
 			 offscreen_x, offscreen_y,
@@ -551,7 +576,11 @@ gdk_offscreen_window_queue_antiexpose (GdkWindow *window,
  * To fully embed an offscreen window, in addition to calling this
  * function, it is also necessary to handle the #GdkWindow::pick-embedded-child
  * signal on the @embedder and the #GdkWindow::to-embedder and
- * #GdkWindow::from-embedder signals on @window.
+ * #GdkWindow::from-embedder signals on @window, or to call
+ * gdk_offscreen_window_set_embedder_offset().
+ *
+ * Calling this function unsets any offset set with
+ * gdk_offscreen_window_set_embedder_offset().
  *
  * Since: 2.18
  */
@@ -581,6 +610,116 @@ gdk_offscreen_window_set_embedder (GdkWindow     *window,
     }
 
   offscreen->embedder = embedder;
+  offscreen->has_embedder_offset = FALSE;
+}
+
+/**
+ * gdk_offscreen_window_set_embedder_offset:
+ * @window: a #GdkWindow
+ * @x: X position of @window in its embedder
+ * @y: Y position of @window in its embedder
+ *
+ * Tells GDK that @window is drawn untransformed at position
+ * (@x, @y) in its embedder.
+ *
+ * GDK will then translate coordinates between @window and its
+ * embedder itself instead of emitting the #GdkWindow::to-embedder
+ * and #GdkWindow::from-embedder signals, and will invalidate the
+ * matching area of the embedder whenever @window is damaged, so that
+ * the embedder only needs to redraw the parts that changed.
+ *
+ * The offset is kept until the next call to
+ * gdk_offscreen_window_set_embedder(). Call this function again
+ * whenever the position of @window in its embedder changes.
+ *
+ * Since: 3.20
+ */
+void
+gdk_offscreen_window_set_embedder_offset (GdkWindow *window,
+                                          gdouble    x,
+                                          gdouble    y)
+{
+  GdkOffscreenWindow *offscreen;
+
+  g_return_if_fail (GDK_IS_WINDOW (window));
+
+  if (!GDK_IS_OFFSCREEN_WINDOW (window->impl))
+    return;
+
+  offscreen = GDK_OFFSCREEN_WINDOW (window->impl);
+
+  g_return_if_fail (offscreen->embedder != NULL);
+
+  offscreen->has_embedder_offset = TRUE;
+  offscreen->embedder_offset_x = x;
+  offscreen->embedder_offset_y = y;
+}
+
+gboolean
+_gdk_offscreen_window_get_embedder_offset (GdkWindow *window,
+                                           gdouble   *x,
+                                           gdouble   *y)
+{
+  GdkOffscreenWindow *offscreen;
+
+  if (!GDK_IS_OFFSCREEN_WINDOW (window->impl))
+    return FALSE;
+
+  offscreen = GDK_OFFSCREEN_WINDOW (window->impl);
+
+  if (!offscreen->has_embedder_offset)
+    return FALSE;
+
+  *x = offscreen->embedder_offset_x;
+  *y = offscreen->embedder_offset_y;
+
+  return TRUE;
+}
+
+/* Invalidates the part of the embedder that shows @region of
+ * @window, if we know how @window is placed in it.
+ */
+void
+_gdk_offscreen_window_damage_embedder (GdkWindow            *window,
+                                       const cairo_region_t *region)
+{
+  GdkOffscreenWindow *offscreen;
+  cairo_region_t *embedder_region;
+  cairo_rectangle_int_t rect;
+  double x1, y1, x2, y2;
+  int i, n_rects;
+
+  if (!GDK_IS_OFFSCREEN_WINDOW (window->impl))
+    return;
+
+  offscreen = GDK_OFFSCREEN_WINDOW (window->impl);
+
+  if (offscreen->embedder == NULL ||
+      !offscreen->has_embedder_offset)
+    return;
+
+  embedder_region = cairo_region_create ();
+
+  n_rects = cairo_region_num_rectangles (region);
+  for (i = 0; i < n_rects; i++)
+    {
+      cairo_region_get_rectangle (region, i, &rect);
+
+      x1 = floor (rect.x + offscreen->embedder_offset_x);
+      y1 = floor (rect.y + offscreen->embedder_offset_y);
+      x2 = ceil (rect.x + rect.width + offscreen->embedder_offset_x);
+      y2 = ceil (rect.y + rect.height + offscreen->embedder_offset_y);
+
+      rect.x = x1;
+      rect.y = y1;
+      rect.width = x2 - x1;
+      rect.height = y2 - y1;
+      cairo_region_union_rectangle (embedder_region, &rect);
+    }
+
+  gdk_window_invalidate_region (offscreen->embedder, embedder_region, FALSE);
+
+  cairo_region_destroy (embedder_region);
 }
 
 /**
@@ -1927,6 +1927,15 @@ gdk_window_free_current_paint (GdkWindow *window)
   window->current_paint.surface_needs_composite = FALSE;
 }
 
+static void
+gdk_window_free_paint_buffer (GdkWindow *window)
+{
+  g_clear_pointer (&window->paint_buffer.surface, cairo_surface_destroy);
+  window->paint_buffer.width = 0;
+  window->paint_buffer.height = 0;
+  window->paint_buffer.scale = 0;
+}
+
 /**
  * _gdk_window_destroy_hierarchy:
  * @window: a #GdkWindow
@@ -2039,6 +2048,7 @@ _gdk_window_destroy_hierarchy (GdkWindow *window,
             }
 
           gdk_window_free_current_paint (window);
+          gdk_window_free_paint_buffer (window);
 
           if (window->background)
             {
@@ -2269,6 +2279,15 @@ to_embedder (GdkWindow *window,
              gdouble   *embedder_x,
              gdouble   *embedder_y)
 {
+  gdouble dx, dy;
+
+  if (_gdk_offscreen_window_get_embedder_offset (window, &dx, &dy))
+    {
+      *embedder_x = offscreen_x + dx;
+      *embedder_y = offscreen_y + dy;
+      return;
+    }
+
   g_signal_emit (window, signals[TO_EMBEDDER], 0,
                  offscreen_x, offscreen_y,
                  embedder_x, embedder_y);
@@ -2281,6 +2300,15 @@ from_embedder (GdkWindow *window,
                gdouble   *offscreen_x,
                gdouble   *offscreen_y)
 {
+  gdouble dx, dy;
+
+  if (_gdk_offscreen_window_get_embedder_offset (window, &dx, &dy))
+    {
+      *offscreen_x = embedder_x - dx;
+      *offscreen_y = embedder_y - dy;
+      return;
+    }
+
   g_signal_emit (window, signals[FROM_EMBEDDER], 0,
                  embedder_x, embedder_y,
                  offscreen_x, offscreen_y);
@@ -2857,6 +2885,51 @@ gdk_window_begin_paint_rect (GdkWindow          *window,
   cairo_region_destroy (region);
 }
 
+/* Returns a surface to use as double buffer for painting @clip_box.
+ * The front buffer keeps its contents between frames, so we only
+ * ever need to repaint the damaged region, and the back buffer can
+ * be reused from the previous frame as long as it still fits.
+ */
+static cairo_surface_t *
+gdk_window_ref_paint_buffer (GdkWindow          *window,
+                             cairo_content_t     content,
+                             const GdkRectangle *clip_box)
+{
+  int width, height, scale;
+
+  width = MAX (clip_box->width, 1);
+  height = MAX (clip_box->height, 1);
+  scale = gdk_window_get_scale_factor (window);
+
+  /* Only reuse the buffer if nobody else holds on to it, and it
+   * is still a reasonable size for the window.
+   */
+  if (window->paint_buffer.surface == NULL ||
+      cairo_surface_get_reference_count (window->paint_buffer.surface) != 1 ||
+      cairo_surface_get_content (window->paint_buffer.surface) != content ||
+      window->paint_buffer.scale != scale ||
+      window->paint_buffer.width < width ||
+      window->paint_buffer.height < height ||
+      window->paint_buffer.width > MAX (window->width, 1) ||
+      window->paint_buffer.height > MAX (window->height, 1))
+    {
+      gdk_window_free_paint_buffer (window);
+
+      width = MAX (width, window->width);
+      height = MAX (height, window->height);
+
+      window->paint_buffer.surface = gdk_window_create_similar_surface (window,
+                                                                        content,
+                                                                        width,
+                                                                        height);
+      window->paint_buffer.width = width;
+      window->paint_buffer.height = height;
+      window->paint_buffer.scale = scale;
+    }
+
+  return cairo_surface_reference (window->paint_buffer.surface);
+}
+
 /**
  * gdk_window_begin_paint_region:
  * @window: a #GdkWindow
@@ -2976,10 +3049,9 @@ gdk_window_begin_paint_region (GdkWindow       *window,
 
   if (needs_surface)
     {
-      window->current_paint.surface = gdk_window_create_similar_surface (window,
-                                                                         surface_content,
-                                                                         MAX (clip_box.width, 1),
-                                                                         MAX (clip_box.height, 1));
+      window->current_paint.surface = gdk_window_ref_paint_buffer (window,
+                                                                   surface_content,
+                                                                   &clip_box);
       sx = sy = 1;
       cairo_surface_get_device_scale (window->current_paint.surface, &sx, &sy);
       cairo_surface_set_device_offset (window->current_paint.surface, -clip_box.x*sx, -clip_box.y*sy);
@@ -3534,6 +3606,8 @@ gdk_window_add_damage (GdkWindow *toplevel,
 
   display = gdk_window_get_display (event.expose.window);
   _gdk_event_queue_append (display, gdk_event_copy (&event));
+
+  _gdk_offscreen_window_damage_embedder (toplevel, damaged_region);
 }
 
 static void
@@ -5361,6 +5435,8 @@ gdk_window_hide (GdkWindow *window)
 
   if (gdk_window_has_impl (window))
     {
+      /* No point in holding on to the double buffer while hidden */
+      gdk_window_free_paint_buffer (window);
 
       if (GDK_WINDOW_IS_MAPPED (window))
 	gdk_synthesize_window_state (window,
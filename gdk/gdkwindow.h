@@ -1086,6 +1086,10 @@ void       gdk_offscreen_window_set_embedder   (GdkWindow     *window,
 						GdkWindow     *embedder);
 GDK_AVAILABLE_IN_ALL
 GdkWindow *gdk_offscreen_window_get_embedder   (GdkWindow     *window);
+GDK_AVAILABLE_IN_3_20
+void       gdk_offscreen_window_set_embedder_offset (GdkWindow *window,
+                                                     gdouble    x,
+                                                     gdouble    y);
 GDK_AVAILABLE_IN_ALL
 void       gdk_window_geometry_changed         (GdkWindow     *window);
 
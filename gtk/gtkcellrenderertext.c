@@ -20,6 +20,7 @@
 #include "gtkcellrenderertext.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "gtkeditable.h"
 #include "gtkentry.h"
@@ -160,6 +161,13 @@ static GParamSpec *text_cell_renderer_props [LAST_PROP];
 
 #define GTK_CELL_RENDERER_TEXT_PATH "gtk-cell-renderer-text-path"
 
+/* Enough for two layouts (measuring and ellipsized) per row
+ * of a screenful of rows
+ */
+#define GTK_CELL_RENDERER_TEXT_LAYOUT_CACHE_SIZE 128
+
+#define LAYOUT_WIDTH_AUTO G_MININT
+
 struct _GtkCellRendererTextPrivate
 {
   GtkWidget *entry;
@@ -205,6 +213,9 @@ struct _GtkCellRendererTextPrivate
   gulong focus_out_id;
   gulong populate_popup_id;
   gulong entry_menu_popdown_timeout;
+
+  GQueue layouts;
+  GtkWidget *layouts_widget;
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (GtkCellRendererText, gtk_cell_renderer_text, GTK_TYPE_CELL_RENDERER)
@@ -230,6 +241,7 @@ gtk_cell_renderer_text_init (GtkCellRendererText *celltext)
   priv->wrap_mode = PANGO_WRAP_CHAR;
   priv->align = PANGO_ALIGN_LEFT;
   priv->align_set = FALSE;
+  g_queue_init (&priv->layouts);
 }
 
 static void
@@ -693,6 +705,23 @@ G_GNUC_END_IGNORE_DEPRECATIONS
   gtk_cell_renderer_class_set_accessible_type (cell_class, GTK_TYPE_TEXT_CELL_ACCESSIBLE);
 }
 
+/* Drops the cached layouts, see lookup_layout() */
+static void
+clear_layouts (GtkCellRendererText *celltext)
+{
+  GtkCellRendererTextPrivate *priv = celltext->priv;
+
+  g_list_free_full (priv->layouts.head, g_object_unref);
+  g_queue_init (&priv->layouts);
+
+  if (priv->layouts_widget)
+    {
+      g_object_remove_weak_pointer (G_OBJECT (priv->layouts_widget),
+                                    (gpointer *) &priv->layouts_widget);
+      priv->layouts_widget = NULL;
+    }
+}
+
 static void
 gtk_cell_renderer_text_finalize (GObject *object)
 {
@@ -712,6 +741,8 @@ gtk_cell_renderer_text_finalize (GObject *object)
 
   g_clear_object (&priv->entry);
 
+  clear_layouts (celltext);
+
   G_OBJECT_CLASS (gtk_cell_renderer_text_parent_class)->finalize (object);
 }
 
@@ -1547,21 +1578,154 @@ add_attr (PangoAttrList  *attr_list,
   pango_attr_list_insert (attr_list, attr);
 }
 
+static gboolean
+attr_lists_equal (PangoAttrList *list1,
+                  PangoAttrList *list2)
+{
+  PangoAttrIterator *iter1, *iter2;
+  gboolean equal = TRUE;
+  gboolean more1, more2;
+
+  if (list1 == list2)
+    return TRUE;
+  if (list1 == NULL || list2 == NULL)
+    return FALSE;
+
+  iter1 = pango_attr_list_get_iterator (list1);
+  iter2 = pango_attr_list_get_iterator (list2);
+
+  do
+    {
+      GSList *attrs1, *attrs2, *l1, *l2;
+      gint start1, end1, start2, end2;
+
+      pango_attr_iterator_range (iter1, &start1, &end1);
+      pango_attr_iterator_range (iter2, &start2, &end2);
+      if (start1 != start2 || end1 != end2)
+        {
+          equal = FALSE;
+          break;
+        }
+
+      attrs1 = pango_attr_iterator_get_attrs (iter1);
+      attrs2 = pango_attr_iterator_get_attrs (iter2);
+
+      for (l1 = attrs1, l2 = attrs2; l1 && l2; l1 = l1->next, l2 = l2->next)
+        {
+          if (!pango_attribute_equal (l1->data, l2->data))
+            break;
+        }
+      if (l1 || l2)
+        equal = FALSE;
+
+      g_slist_free_full (attrs1, (GDestroyNotify) pango_attribute_destroy);
+      g_slist_free_full (attrs2, (GDestroyNotify) pango_attribute_destroy);
+
+      more1 = pango_attr_iterator_next (iter1);
+      more2 = pango_attr_iterator_next (iter2);
+      if (more1 != more2)
+        equal = FALSE;
+    }
+  while (equal && more1);
+
+  pango_attr_iterator_destroy (iter1);
+  pango_attr_iterator_destroy (iter2);
+
+  return equal;
+}
+
+/* Layouts are kept around after use, so that measuring and drawing
+ * the same text again doesn't shape it again. Everything that goes
+ * into a layout is compared, so property changes never need to
+ * invalidate the cache. The layouts are shared and must not be changed.
+ */
+static PangoLayout *
+lookup_layout (GtkCellRendererText *celltext,
+               GtkWidget           *widget,
+               const gchar         *text,
+               PangoAttrList       *attr_list,
+               gint                 width,
+               PangoWrapMode        wrap,
+               PangoEllipsizeMode   ellipsize,
+               PangoAlignment       align)
+{
+  GtkCellRendererTextPrivate *priv = celltext->priv;
+  PangoContext *context;
+  PangoLayout *layout;
+  GList *l;
+
+  /* The layouts keep the context of their widget alive, so don't
+   * hold on to them once the renderer is used for another widget
+   */
+  if (widget != priv->layouts_widget)
+    {
+      clear_layouts (celltext);
+      priv->layouts_widget = widget;
+      g_object_add_weak_pointer (G_OBJECT (widget), (gpointer *) &priv->layouts_widget);
+    }
+
+  context = gtk_widget_get_pango_context (widget);
+  if (text == NULL)
+    text = "";
+
+  for (l = priv->layouts.head; l; l = l->next)
+    {
+      layout = l->data;
+
+      if (pango_layout_get_context (layout) == context &&
+          pango_layout_get_width (layout) == width &&
+          pango_layout_get_wrap (layout) == wrap &&
+          pango_layout_get_ellipsize (layout) == ellipsize &&
+          pango_layout_get_alignment (layout) == align &&
+          pango_layout_get_single_paragraph_mode (layout) == priv->single_paragraph &&
+          strcmp (pango_layout_get_text (layout), text) == 0 &&
+          attr_lists_equal (pango_layout_get_attributes (layout), attr_list))
+        {
+          g_queue_unlink (&priv->layouts, l);
+          g_queue_push_head_link (&priv->layouts, l);
+
+          return g_object_ref (layout);
+        }
+    }
+
+  layout = pango_layout_new (context);
+  pango_layout_set_text (layout, text, -1);
+  pango_layout_set_single_paragraph_mode (layout, priv->single_paragraph);
+  pango_layout_set_attributes (layout, attr_list);
+  pango_layout_set_ellipsize (layout, ellipsize);
+  pango_layout_set_width (layout, width);
+  pango_layout_set_wrap (layout, wrap);
+  pango_layout_set_alignment (layout, align);
+
+  g_queue_push_head (&priv->layouts, g_object_ref (layout));
+  if (priv->layouts.length > GTK_CELL_RENDERER_TEXT_LAYOUT_CACHE_SIZE)
+    g_object_unref (g_queue_pop_tail (&priv->layouts));
+
+  return layout;
+}
+
+/* @width is the width to lay out the text at, in Pango units,
+ * or LAYOUT_WIDTH_AUTO to use the wrap width, if any.
+ */
 static PangoLayout*
 get_layout (GtkCellRendererText *celltext,
             GtkWidget           *widget,
             const GdkRectangle  *cell_area,
-            GtkCellRendererState flags)
+            GtkCellRendererState flags,
+            gint                 width)
 {
   GtkCellRendererTextPrivate *priv = celltext->priv;
   PangoAttrList *attr_list;
   PangoLayout *layout;
   PangoUnderline uline;
+  PangoEllipsizeMode ellipsize;
+  PangoWrapMode wrap;
+  PangoAlignment align;
+  const gchar *text;
   gint xpad;
   gboolean placeholder_layout = show_placeholder_text (celltext);
 
-  layout = gtk_widget_create_pango_layout (widget, placeholder_layout ?
-                                           priv->placeholder_text : priv->text);
+  text = placeholder_layout ? priv->placeholder_text : priv->text;
 
   gtk_cell_renderer_get_padding (GTK_CELL_RENDERER (celltext), &xpad, NULL);
 
@@ -1570,8 +1734,6 @@ get_layout (GtkCellRendererText *celltext,
   else
     attr_list = pango_attr_list_new ();
 
-  pango_layout_set_single_paragraph_mode (layout, priv->single_paragraph);
-
   if (!placeholder_layout && cell_area)
     {
       /* Add options that affect appearance but not size */
@@ -1658,54 +1820,52 @@ get_layout (GtkCellRendererText *celltext,
   if (priv->rise_set)
     add_attr (attr_list, pango_attr_rise_new (priv->rise));
 
-  /* Now apply the attributes as they will effect the outcome
-   * of pango_layout_get_extents() */
-  pango_layout_set_attributes (layout, attr_list);
-  pango_attr_list_unref (attr_list);
-
   if (priv->ellipsize_set)
-    pango_layout_set_ellipsize (layout, priv->ellipsize);
+    ellipsize = priv->ellipsize;
+  else
+    ellipsize = PANGO_ELLIPSIZE_NONE;
+
+  if (priv->align_set)
+    align = priv->align;
+  else if (gtk_widget_get_direction (widget) == GTK_TEXT_DIR_RTL)
+    align = PANGO_ALIGN_RIGHT;
   else
-    pango_layout_set_ellipsize (layout, PANGO_ELLIPSIZE_NONE);
+    align = PANGO_ALIGN_LEFT;
 
   if (priv->wrap_width != -1)
     {
-      PangoRectangle rect;
-      gint           width, text_width;
+      wrap = priv->wrap_mode;
 
-      pango_layout_get_extents (layout, NULL, &rect);
-      text_width = rect.width;
+      if (width == LAYOUT_WIDTH_AUTO)
+        {
+          PangoRectangle rect;
 
-      if (cell_area)
-	width = (cell_area->width - xpad * 2) * PANGO_SCALE;
-      else
-	width = priv->wrap_width * PANGO_SCALE;
+          /* The attributes affect the outcome of pango_layout_get_extents() */
+          layout = lookup_layout (celltext, widget, text, attr_list,
+                                  -1, wrap, ellipsize, align);
+          pango_layout_get_extents (layout, NULL, &rect);
+          g_object_unref (layout);
 
-      width = MIN (width, text_width);
+          if (cell_area)
+            width = (cell_area->width - xpad * 2) * PANGO_SCALE;
+          else
+            width = priv->wrap_width * PANGO_SCALE;
 
-      pango_layout_set_width (layout, width);
-      pango_layout_set_wrap (layout, priv->wrap_mode);
+          width = MIN (width, rect.width);
+        }
     }
   else
     {
-      pango_layout_set_width (layout, -1);
-      pango_layout_set_wrap (layout, PANGO_WRAP_CHAR);
-    }
+      wrap = PANGO_WRAP_CHAR;
 
-  if (priv->align_set)
-    pango_layout_set_alignment (layout, priv->align);
-  else
-    {
-      PangoAlignment align;
+      if (width == LAYOUT_WIDTH_AUTO)
+        width = -1;
+    }
 
-      if (gtk_widget_get_direction (widget) == GTK_TEXT_DIR_RTL)
-	align = PANGO_ALIGN_RIGHT;
-      else
-	align = PANGO_ALIGN_LEFT;
+  layout = lookup_layout (celltext, widget, text, attr_list,
+                          width, wrap, ellipsize, align);
+  pango_attr_list_unref (attr_list);
 
-      pango_layout_set_alignment (layout, align);
-    }
-  
   return layout;
 }
 
@@ -1777,7 +1937,7 @@ get_size (GtkCellRenderer    *cell,
   if (layout)
     g_object_ref (layout);
   else
-    layout = get_layout (celltext, widget, NULL, 0);
+    layout = get_layout (celltext, widget, NULL, 0, LAYOUT_WIDTH_AUTO);
 
   pango_layout_get_pixel_extents (layout, NULL, &rect);
 
@@ -1839,7 +1999,7 @@ gtk_cell_renderer_text_render (GtkCellRenderer      *cell,
   gint xpad, ypad;
   PangoRectangle rect;
 
-  layout = get_layout (celltext, widget, cell_area, flags);
+  layout = get_layout (celltext, widget, cell_area, flags, LAYOUT_WIDTH_AUTO);
   get_size (cell, widget, cell_area, layout, &x_offset, &y_offset, NULL, NULL);
   context = gtk_widget_get_style_context (widget);
 
@@ -1853,10 +2013,11 @@ gtk_cell_renderer_text_render (GtkCellRenderer      *cell,
   gtk_cell_renderer_get_padding (cell, &xpad, &ypad);
 
   if (priv->ellipsize_set && priv->ellipsize != PANGO_ELLIPSIZE_NONE)
-    pango_layout_set_width (layout,
-			    (cell_area->width - x_offset - 2 * xpad) * PANGO_SCALE);
-  else if (priv->wrap_width == -1)
-    pango_layout_set_width (layout, -1);
+    {
+      g_object_unref (layout);
+      layout = get_layout (celltext, widget, cell_area, flags,
+                           (cell_area->width - x_offset - 2 * xpad) * PANGO_SCALE);
+    }
 
   pango_layout_get_pixel_extents (layout, NULL, &rect);
   x_offset = x_offset - rect.x;
@@ -2124,10 +2285,8 @@ gtk_cell_renderer_text_get_preferred_width (GtkCellRenderer *cell,
 
   gtk_cell_renderer_get_padding (cell, &xpad, NULL);
 
-  layout = get_layout (celltext, widget, NULL, 0);
-
   /* Fetch the length of the complete unwrapped text */
-  pango_layout_set_width (layout, -1);
+  layout = get_layout (celltext, widget, NULL, 0, -1);
   pango_layout_get_extents (layout, NULL, &rect);
   text_width = rect.width;
 
@@ -2197,9 +2356,7 @@ gtk_cell_renderer_text_get_preferred_height_for_width (GtkCellRenderer *cell,
 
   gtk_cell_renderer_get_padding (cell, &xpad, &ypad);
 
-  layout = get_layout (celltext, widget, NULL, 0);
-
-  pango_layout_set_width (layout, (width - xpad * 2) * PANGO_SCALE);
+  layout = get_layout (celltext, widget, NULL, 0, (width - xpad * 2) * PANGO_SCALE);
   pango_layout_get_pixel_size (layout, NULL, &text_height);
 
   if (minimum_height)
@@ -2243,7 +2400,7 @@ gtk_cell_renderer_text_get_aligned_area (GtkCellRenderer       *cell,
   gint x_offset = 0;
   gint y_offset = 0;
 
-  layout = get_layout (celltext, widget, cell_area, flags);
+  layout = get_layout (celltext, widget, cell_area, flags, LAYOUT_WIDTH_AUTO);
   get_size (cell, widget, cell_area, layout, &x_offset, &y_offset, 
 	    &aligned_area->width, &aligned_area->height);
 
@@ -0,0 +1,1768 @@
+/* GTK - The GIMP Toolkit
+ * Copyright (C) 2015 The GTK+ Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include <string.h>
+#include <gobject/gvaluecollector.h>
+#include "gtktreemodel.h"
+#include "gtktreemodelprivate.h"
+#include "gtkcolumnstore.h"
+#include "gtktreedatalist.h"
+
+
+/**
+ * SECTION:gtkcolumnstore
+ * @Short_description: A list model that stores its data by column
+ * @Title: GtkColumnStore
+ * @See_also: #GtkTreeModel, #GtkListStore
+ *
+ * The #GtkColumnStore object is a list model for use with a #GtkTreeView
+ * widget, meant for tables with a large number of rows. It implements the
+ * #GtkTreeModel and #GtkTreeSortable interfaces, like #GtkListStore, and is
+ * used the same way.
+ *
+ * Where a #GtkListStore allocates every row, and every cell in it, on its
+ * own, a #GtkColumnStore keeps each column in one array, typed after the
+ * column: an int column is an array of ints, a double column an array of
+ * doubles. Strings are kept in a shared pool, where equal strings are only
+ * stored once. The order of the rows is kept in a separate index, so that
+ * inserting a row in the middle of the list or sorting the list does not
+ * move the data of the rows.
+ *
+ * Rows can be added in bulk with gtk_column_store_append_rows() and whole
+ * runs of a column can be filled from a C array with
+ * gtk_column_store_set_column(). When the list is sorted on a column with
+ * the default sort function, the column is compared directly from its
+ * array.
+ *
+ * # Performance Considerations
+ *
+ * Like #GtkListStore, #GtkColumnStore sets the #GTK_TREE_MODEL_ITERS_PERSIST
+ * flag, and #GtkTreeIters stay valid for as long as their row exists, even
+ * when the list is sorted.
+ *
+ * Inserting or removing a row at some position costs time proportional to
+ * the number of rows after it, as the index has to be shifted. Appending
+ * and removing the last row are cheap. Strings that are replaced or whose
+ * row is removed stay in the pool until gtk_column_store_clear() is called,
+ * so string columns that are changed often are better kept in a
+ * #GtkListStore.
+ */
+
+
+typedef enum {
+  KIND_INT32,
+  KIND_INT8,
+  KIND_LONG,
+  KIND_INT64,
+  KIND_FLOAT,
+  KIND_DOUBLE,
+  KIND_STRING,
+  KIND_POINTER
+} ColumnKind;
+
+typedef struct
+{
+  GType type;
+  GType fundamental;
+  ColumnKind kind;
+  gsize elem_size;
+  guint8 *data;
+} Column;
+
+struct _GtkColumnStorePrivate
+{
+  GtkTreeIterCompareFunc default_sort_func;
+
+  GDestroyNotify default_sort_destroy;
+  GList *sort_list;
+  GType *column_headers;
+  Column *columns;
+
+  gint stamp;
+  gint n_columns;
+  gint sort_column_id;
+
+  GtkSortType order;
+
+  gpointer default_sort_data;
+
+  /* Rows are stored at fixed places in the column arrays. @rows
+   * lists them in list order, and @positions maps them back to
+   * their index in @rows.
+   */
+  guint *rows;
+  guint *positions;
+  guint n_rows;
+  guint n_stored;
+  guint n_allocated;
+  GArray *free_rows;
+
+  GStringChunk *strings;
+};
+
+#define INVALID_POSITION G_MAXUINT
+
+#define GTK_COLUMN_STORE_IS_SORTED(store) (((GtkColumnStore*)(store))->priv->sort_column_id != GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID)
+#define CELL(column, row) ((gpointer) ((column)->data + (gsize) (row) * (column)->elem_size))
+#define ITER_ROW(iter) GPOINTER_TO_UINT ((iter)->user_data)
+
+static void         gtk_column_store_tree_model_init (GtkTreeModelIface *iface);
+static void         gtk_column_store_sortable_init   (GtkTreeSortableIface *iface);
+static void         gtk_column_store_finalize        (GObject      *object);
+
+static void         gtk_column_store_sort            (GtkColumnStore *column_store);
+static void         gtk_column_store_sort_iter_changed (GtkColumnStore *column_store,
+                                                        GtkTreeIter    *iter);
+
+G_DEFINE_TYPE_WITH_CODE (GtkColumnStore, gtk_column_store, G_TYPE_OBJECT,
+                         G_ADD_PRIVATE (GtkColumnStore)
+                         G_IMPLEMENT_INTERFACE (GTK_TYPE_TREE_MODEL,
+                                                gtk_column_store_tree_model_init)
+                         G_IMPLEMENT_INTERFACE (GTK_TYPE_TREE_SORTABLE,
+                                                gtk_column_store_sortable_init))
+
+static void
+gtk_column_store_class_init (GtkColumnStoreClass *class)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (class);
+
+  object_class->finalize = gtk_column_store_finalize;
+}
+
+static void
+gtk_column_store_init (GtkColumnStore *column_store)
+{
+  GtkColumnStorePrivate *priv;
+
+  column_store->priv = gtk_column_store_get_instance_private (column_store);
+  priv = column_store->priv;
+
+  priv->stamp = g_random_int ();
+  priv->sort_column_id = GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID;
+  priv->free_rows = g_array_new (FALSE, FALSE, sizeof (guint));
+  priv->strings = g_string_chunk_new (4096);
+}
+
+static inline GType
+get_fundamental_type (GType type)
+{
+  GType result;
+
+  result = G_TYPE_FUNDAMENTAL (type);
+
+  if (result == G_TYPE_INTERFACE)
+    {
+      if (g_type_is_a (type, G_TYPE_OBJECT))
+        result = G_TYPE_OBJECT;
+    }
+
+  return result;
+}
+
+static gboolean
+gtk_column_store_set_columns (GtkColumnStore *column_store,
+                              gint            n_columns,
+                              GType          *types)
+{
+  GtkColumnStorePrivate *priv = column_store->priv;
+  Column *column;
+  gint i;
+
+  for (i = 0; i < n_columns; i++)
+    {
+      if (!_gtk_tree_data_list_check_type (types[i]))
+        {
+          g_warning ("%s: Invalid type %s\n", G_STRLOC, g_type_name (types[i]));
+          return FALSE;
+        }
+    }
+
+  priv->n_columns = n_columns;
+  priv->column_headers = g_memdup (types, n_columns * sizeof (GType));
+  priv->columns = g_new0 (Column, n_columns);
+  priv->sort_list = _gtk_tree_data_list_header_new (n_columns, priv->column_headers);
+
+  for (i = 0; i < n_columns; i++)
+    {
+      column = &priv->columns[i];
+      column->type = types[i];
+      column->fundamental = get_fundamental_type (types[i]);
+
+      switch (column->fundamental)
+        {
+        case G_TYPE_BOOLEAN:
+        case G_TYPE_INT:
+        case G_TYPE_UINT:
+        case G_TYPE_ENUM:
+        case G_TYPE_FLAGS:
+          column->kind = KIND_INT32;
+          column->elem_size = sizeof (gint32);
+          break;
+        case G_TYPE_CHAR:
+        case G_TYPE_UCHAR:
+          column->kind = KIND_INT8;
+          column->elem_size = sizeof (gint8);
+          break;
+        case G_TYPE_LONG:
+        case G_TYPE_ULONG:
+          column->kind = KIND_LONG;
+          column->elem_size = sizeof (glong);
+          break;
+        case G_TYPE_INT64:
+        case G_TYPE_UINT64:
+          column->kind = KIND_INT64;
+          column->elem_size = sizeof (gint64);
+          break;
+        case G_TYPE_FLOAT:
+          column->kind = KIND_FLOAT;
+          column->elem_size = sizeof (gfloat);
+          break;
+        case G_TYPE_DOUBLE:
+          column->kind = KIND_DOUBLE;
+          column->elem_size = sizeof (gdouble);
+          break;
+        case G_TYPE_STRING:
+          column->kind = KIND_STRING;
+          column->elem_size = sizeof (gchar *);
+          break;
+        default:
+          column->kind = KIND_POINTER;
+          column->elem_size = sizeof (gpointer);
+          break;
+        }
+    }
+
+  return TRUE;
+}
+
+/**
+ * gtk_column_store_new:
+ * @n_columns: number of columns in the column store
+ * @...: all #GType types for the columns, from first to last
+ *
+ * Creates a new column store with @n_columns columns each of the types
+ * passed in. The same types as for gtk_list_store_new() are supported.
+ *
+ * Returns: a new #GtkColumnStore
+ *
+ * Since: 3.20
+ */
+GtkColumnStore *
+gtk_column_store_new (gint n_columns,
+                      ...)
+{
+  GtkColumnStore *retval;
+  GType *types;
+  va_list args;
+  gint i;
+
+  g_return_val_if_fail (n_columns > 0, NULL);
+
+  types = g_new (GType, n_columns);
+
+  va_start (args, n_columns);
+  for (i = 0; i < n_columns; i++)
+    types[i] = va_arg (args, GType);
+  va_end (args);
+
+  retval = gtk_column_store_newv (n_columns, types);
+
+  g_free (types);
+
+  return retval;
+}
+
+/**
+ * gtk_column_store_newv: (rename-to gtk_column_store_new)
+ * @n_columns: number of columns in the column store
+ * @types: (array length=n_columns): an array of #GType types for the columns, from first to last
+ *
+ * Non-vararg creation function. Used primarily by language bindings.
+ *
+ * Returns: (transfer full): a new #GtkColumnStore
+ *
+ * Since: 3.20
+ */
+GtkColumnStore *
+gtk_column_store_newv (gint   n_columns,
+                       GType *types)
+{
+  GtkColumnStore *retval;
+
+  g_return_val_if_fail (n_columns > 0, NULL);
+
+  retval = g_object_new (GTK_TYPE_COLUMN_STORE, NULL);
+  if (!gtk_column_store_set_columns (retval, n_columns, types))
+    {
+      g_object_unref (retval);
+      return NULL;
+    }
+
+  return retval;
+}
+
+/* Releases what the cell at @row in @column owns, and zeroes it */
+static void
+clear_cell (Column *column,
+            guint   row)
+{
+  gpointer *cell;
+
+  if (column->kind == KIND_POINTER)
+    {
+      cell = CELL (column, row);
+      if (*cell != NULL)
+        {
+          if (column->fundamental == G_TYPE_OBJECT)
+            g_object_unref (*cell);
+          else if (column->fundamental == G_TYPE_BOXED)
+            g_boxed_free (column->type, *cell);
+          else if (column->fundamental == G_TYPE_VARIANT)
+            g_variant_unref (*cell);
+        }
+    }
+
+  memset (CELL (column, row), 0, column->elem_size);
+}
+
+static void
+gtk_column_store_clear_rows (GtkColumnStore *column_store)
+{
+  GtkColumnStorePrivate *priv = column_store->priv;
+  Column *column;
+  guint row;
+  gint i;
+
+  for (i = 0; i < priv->n_columns; i++)
+    {
+      column = &priv->columns[i];
+      if (column->kind != KIND_POINTER)
+        continue;
+
+      for (row = 0; row < priv->n_stored; row++)
+        clear_cell (column, row);
+    }
+
+  for (i = 0; i < priv->n_columns; i++)
+    {
+      column = &priv->columns[i];
+      memset (column->data, 0, priv->n_stored * column->elem_size);
+    }
+
+  priv->n_rows = 0;
+  priv->n_stored = 0;
+  g_array_set_size (priv->free_rows, 0);
+  g_string_chunk_clear (priv->strings);
+}
+
+static void
+gtk_column_store_finalize (GObject *object)
+{
+  GtkColumnStore *column_store = GTK_COLUMN_STORE (object);
+  GtkColumnStorePrivate *priv = column_store->priv;
+  gint i;
+
+  gtk_column_store_clear_rows (column_store);
+
+  for (i = 0; i < priv->n_columns; i++)
+    g_free (priv->columns[i].data);
+  g_free (priv->columns);
+  g_free (priv->column_headers);
+  g_free (priv->rows);
+  g_free (priv->positions);
+  g_array_free (priv->free_rows, TRUE);
+  g_string_chunk_free (priv->strings);
+
+  if (priv->sort_list)
+    _gtk_tree_data_list_header_free (priv->sort_list);
+
+  if (priv->default_sort_destroy)
+    {
+      GDestroyNotify d = priv->default_sort_destroy;
+
+      priv->default_sort_destroy = NULL;
+      d (priv->default_sort_data);
+      priv->default_sort_data = NULL;
+    }
+
+  G_OBJECT_CLASS (gtk_column_store_parent_class)->finalize (object);
+}
+
+/* Makes room for @n_rows more rows in every column */
+static void
+gtk_column_store_reserve (GtkColumnStore *column_store,
+                          guint           n_rows)
+{
+  GtkColumnStorePrivate *priv = column_store->priv;
+  Column *column;
+  guint n_allocated;
+  gint i;
+
+  if (priv->n_stored + n_rows <= priv->n_allocated)
+    return;
+
+  n_allocated = MAX (priv->n_allocated * 2, priv->n_stored + n_rows);
+  n_allocated = MAX (n_allocated, 16);
+
+  for (i = 0; i < priv->n_columns; i++)
+    {
+      column = &priv->columns[i];
+      column->data = g_realloc (column->data, n_allocated * column->elem_size);
+      memset (column->data + priv->n_allocated * column->elem_size, 0,
+              (n_allocated - priv->n_allocated) * column->elem_size);
+    }
+
+  priv->rows = g_renew (guint, priv->rows, n_allocated);
+  priv->positions = g_renew (guint, priv->positions, n_allocated);
+  priv->n_allocated = n_allocated;
+}
+
+/* Returns an empty row to store a new list row in */
+static guint
+gtk_column_store_alloc_row (GtkColumnStore *column_store)
+{
+  GtkColumnStorePrivate *priv = column_store->priv;
+  guint row;
+
+  if (priv->free_rows->len > 0)
+    {
+      row = g_array_index (priv->free_rows, guint, priv->free_rows->len - 1);
+      g_array_set_size (priv->free_rows, priv->free_rows->len - 1);
+      return row;
+    }
+
+  gtk_column_store_reserve (column_store, 1);
+
+  return priv->n_stored++;
+}
+
+static void
+update_positions (GtkColumnStorePrivate *priv,
+                  guint                  first,
+                  guint                  last)
+{
+  guint i;
+
+  for (i = first; i < last; i++)
+    priv->positions[priv->rows[i]] = i;
+}
+
+static gboolean
+iter_is_valid (GtkTreeIter    *iter,
+               GtkColumnStore *column_store)
+{
+  GtkColumnStorePrivate *priv = column_store->priv;
+
+  return iter != NULL &&
+         iter->stamp == priv->stamp &&
+         ITER_ROW (iter) < priv->n_stored &&
+         priv->positions[ITER_ROW (iter)] != INVALID_POSITION;
+}
+
+static inline void
+set_iter (GtkColumnStore *column_store,
+          GtkTreeIter    *iter,
+          guint           row)
+{
+  iter->stamp = column_store->priv->stamp;
+  iter->user_data = GUINT_TO_POINTER (row);
+}
+
+/* Fulfill the GtkTreeModel requirements */
+static GtkTreeModelFlags
+gtk_column_store_get_flags (GtkTreeModel *tree_model)
+{
+  return GTK_TREE_MODEL_ITERS_PERSIST | GTK_TREE_MODEL_LIST_ONLY;
+}
+
+static gint
+gtk_column_store_get_n_columns (GtkTreeModel *tree_model)
+{
+  return GTK_COLUMN_STORE (tree_model)->priv->n_columns;
+}
+
+static GType
+gtk_column_store_get_column_type (GtkTreeModel *tree_model,
+                                  gint          index)
+{
+  GtkColumnStorePrivate *priv = GTK_COLUMN_STORE (tree_model)->priv;
+
+  g_return_val_if_fail (index < priv->n_columns, G_TYPE_INVALID);
+
+  return priv->column_headers[index];
+}
+
+static gboolean
+gtk_column_store_get_iter (GtkTreeModel *tree_model,
+                           GtkTreeIter  *iter,
+                           GtkTreePath  *path)
+{
+  GtkColumnStore *column_store = GTK_COLUMN_STORE (tree_model);
+  GtkColumnStorePrivate *priv = column_store->priv;
+  gint i;
+
+  i = gtk_tree_path_get_indices (path)[0];
+
+  if (i < 0 || (guint) i >= priv->n_rows)
+    {
+      iter->stamp = 0;
+      return FALSE;
+    }
+
+  set_iter (column_store, iter, priv->rows[i]);
+
+  return TRUE;
+}
+
+static GtkTreePath *
+gtk_column_store_get_path (GtkTreeModel *tree_model,
+                           GtkTreeIter  *iter)
+{
+  GtkColumnStore *column_store = GTK_COLUMN_STORE (tree_model);
+
+  g_return_val_if_fail (iter_is_valid (iter, column_store), NULL);
+
+  return gtk_tree_path_new_from_indices (column_store->priv->positions[ITER_ROW (iter)], -1);
+}
+
+static void
+gtk_column_store_get_value (GtkTreeModel *tree_model,
+                            GtkTreeIter  *iter,
+                            gint          column,
+                            GValue       *value)
+{
+  GtkColumnStore *column_store = GTK_COLUMN_STORE (tree_model);
+  GtkColumnStorePrivate *priv = column_store->priv;
+  Column *col;
+  gpointer cell;
+
+  g_return_if_fail (column < priv->n_columns);
+  g_return_if_fail (iter_is_valid (iter, column_store));
+
+  col = &priv->columns[column];
+  cell = CELL (col, ITER_ROW (iter));
+
+  g_value_init (value, col->type);
+
+  switch (col->fundamental)
+    {
+    case G_TYPE_BOOLEAN:
+      g_value_set_boolean (value, *(gint32 *) cell);
+      break;
+    case G_TYPE_INT:
+      g_value_set_int (value, *(gint32 *) cell);
+      break;
+    case G_TYPE_UINT:
+      g_value_set_uint (value, *(guint32 *) cell);
+      break;
+    case G_TYPE_ENUM:
+      g_value_set_enum (value, *(gint32 *) cell);
+      break;
+    case G_TYPE_FLAGS:
+      g_value_set_flags (value, *(guint32 *) cell);
+      break;
+    case G_TYPE_CHAR:
+      g_value_set_schar (value, *(gint8 *) cell);
+      break;
+    case G_TYPE_UCHAR:
+      g_value_set_uchar (value, *(guint8 *) cell);
+      break;
+    case G_TYPE_LONG:
+      g_value_set_long (value, *(glong *) cell);
+      break;
+    case G_TYPE_ULONG:
+      g_value_set_ulong (value, *(gulong *) cell);
+      break;
+    case G_TYPE_INT64:
+      g_value_set_int64 (value, *(gint64 *) cell);
+      break;
+    case G_TYPE_UINT64:
+      g_value_set_uint64 (value, *(guint64 *) cell);
+      break;
+    case G_TYPE_FLOAT:
+      g_value_set_float (value, *(gfloat *) cell);
+      break;
+    case G_TYPE_DOUBLE:
+      g_value_set_double (value, *(gdouble *) cell);
+      break;
+    case G_TYPE_STRING:
+      g_value_set_string (value, *(gchar **) cell);
+      break;
+    case G_TYPE_POINTER:
+      g_value_set_pointer (value, *(gpointer *) cell);
+      break;
+    case G_TYPE_BOXED:
+      g_value_set_boxed (value, *(gpointer *) cell);
+      break;
+    case G_TYPE_VARIANT:
+      g_value_set_variant (value, *(gpointer *) cell);
+      break;
+    case G_TYPE_OBJECT:
+      g_value_set_object (value, *(gpointer *) cell);
+      break;
+    default:
+      g_warning ("%s: Unsupported type (%s) retrieved.", G_STRLOC, g_type_name (col->type));
+      break;
+    }
+}
+
+static gboolean
+gtk_column_store_iter_next (GtkTreeModel *tree_model,
+                            GtkTreeIter  *iter)
+{
+  GtkColumnStore *column_store = GTK_COLUMN_STORE (tree_model);
+  GtkColumnStorePrivate *priv = column_store->priv;
+  guint position;
+
+  g_return_val_if_fail (iter_is_valid (iter, column_store), FALSE);
+
+  position = priv->positions[ITER_ROW (iter)] + 1;
+  if (position >= priv->n_rows)
+    {
+      iter->stamp = 0;
+      return FALSE;
+    }
+
+  iter->user_data = GUINT_TO_POINTER (priv->rows[position]);
+
+  return TRUE;
+}
+
+static gboolean
+gtk_column_store_iter_previous (GtkTreeModel *tree_model,
+                                GtkTreeIter  *iter)
+{
+  GtkColumnStore *column_store = GTK_COLUMN_STORE (tree_model);
+  GtkColumnStorePrivate *priv = column_store->priv;
+  guint position;
+
+  g_return_val_if_fail (iter_is_valid (iter, column_store), FALSE);
+
+  position = priv->positions[ITER_ROW (iter)];
+  if (position == 0)
+    {
+      iter->stamp = 0;
+      return FALSE;
+    }
+
+  iter->user_data = GUINT_TO_POINTER (priv->rows[position - 1]);
+
+  return TRUE;
+}
+
+static gboolean
+gtk_column_store_iter_children (GtkTreeModel *tree_model,
+                                GtkTreeIter  *iter,
+                                GtkTreeIter  *parent)
+{
+  GtkColumnStore *column_store = GTK_COLUMN_STORE (tree_model);
+  GtkColumnStorePrivate *priv = column_store->priv;
+
+  /* this is a list, nodes have no children */
+  if (parent || priv->n_rows == 0)
+    {
+      iter->stamp = 0;
+      return FALSE;
+    }
+
+  set_iter (column_store, iter, priv->rows[0]);
+
+  return TRUE;
+}
+
+static gboolean
+gtk_column_store_iter_has_child (GtkTreeModel *tree_model,
+                                 GtkTreeIter  *iter)
+{
+  return FALSE;
+}
+
+static gint
+gtk_column_store_iter_n_children (GtkTreeModel *tree_model,
+                                  GtkTreeIter  *iter)
+{
+  GtkColumnStore *column_store = GTK_COLUMN_STORE (tree_model);
+
+  if (iter == NULL)
+    return column_store->priv->n_rows;
+
+  g_return_val_if_fail (column_store->priv->stamp == iter->stamp, -1);
+
+  return 0;
+}
+
+static gboolean
+gtk_column_store_iter_nth_child (GtkTreeModel *tree_model,
+                                 GtkTreeIter  *iter,
+                                 GtkTreeIter  *parent,
+                                 gint          n)
+{
+  GtkColumnStore *column_store = GTK_COLUMN_STORE (tree_model);
+  GtkColumnStorePrivate *priv = column_store->priv;
+
+  iter->stamp = 0;
+
+  if (parent || n < 0 || (guint) n >= priv->n_rows)
+    return FALSE;
+
+  set_iter (column_store, iter, priv->rows[n]);
+
+  return TRUE;
+}
+
+static gboolean
+gtk_column_store_iter_parent (GtkTreeModel *tree_model,
+                              GtkTreeIter  *iter,
+                              GtkTreeIter  *child)
+{
+  iter->stamp = 0;
+  return FALSE;
+}
+
+static void
+gtk_column_store_tree_model_init (GtkTreeModelIface *iface)
+{
+  iface->get_flags = gtk_column_store_get_flags;
+  iface->get_n_columns = gtk_column_store_get_n_columns;
+  iface->get_column_type = gtk_column_store_get_column_type;
+  iface->get_iter = gtk_column_store_get_iter;
+  iface->get_path = gtk_column_store_get_path;
+  iface->get_value = gtk_column_store_get_value;
+  iface->iter_next = gtk_column_store_iter_next;
+  iface->iter_previous = gtk_column_store_iter_previous;
+  iface->iter_children = gtk_column_store_iter_children;
+  iface->iter_has_child = gtk_column_store_iter_has_child;
+  iface->iter_n_children = gtk_column_store_iter_n_children;
+  iface->iter_nth_child = gtk_column_store_iter_nth_child;
+  iface->iter_parent = gtk_column_store_iter_parent;
+}
+
+/* Stores @value, which has the type of @column, at @row */
+static void
+set_cell (GtkColumnStore *column_store,
+          Column         *column,
+          guint           row,
+          const GValue   *value)
+{
+  gpointer cell;
+  const gchar *string;
+
+  clear_cell (column, row);
+  cell = CELL (column, row);
+
+  switch (column->fundamental)
+    {
+    case G_TYPE_BOOLEAN:
+      *(gint32 *) cell = g_value_get_boolean (value);
+      break;
+    case G_TYPE_INT:
+      *(gint32 *) cell = g_value_get_int (value);
+      break;
+    case G_TYPE_UINT:
+      *(guint32 *) cell = g_value_get_uint (value);
+      break;
+    case G_TYPE_ENUM:
+      *(gint32 *) cell = g_value_get_enum (value);
+      break;
+    case G_TYPE_FLAGS:
+      *(guint32 *) cell = g_value_get_flags (value);
+      break;
+    case G_TYPE_CHAR:
+      *(gint8 *) cell = g_value_get_schar (value);
+      break;
+    case G_TYPE_UCHAR:
+      *(guint8 *) cell = g_value_get_uchar (value);
+      break;
+    case G_TYPE_LONG:
+      *(glong *) cell = g_value_get_long (value);
+      break;
+    case G_TYPE_ULONG:
+      *(gulong *) cell = g_value_get_ulong (value);
+      break;
+    case G_TYPE_INT64:
+      *(gint64 *) cell = g_value_get_int64 (value);
+      break;
+    case G_TYPE_UINT64:
+      *(guint64 *) cell = g_value_get_uint64 (value);
+      break;
+    case G_TYPE_FLOAT:
+      *(gfloat *) cell = g_value_get_float (value);
+      break;
+    case G_TYPE_DOUBLE:
+      *(gdouble *) cell = g_value_get_double (value);
+      break;
+    case G_TYPE_STRING:
+      string = g_value_get_string (value);
+      if (string != NULL)
+        string = g_string_chunk_insert_const (column_store->priv->strings, string);
+      *(const gchar **) cell = string;
+      break;
+    case G_TYPE_POINTER:
+      *(gpointer *) cell = g_value_get_pointer (value);
+      break;
+    case G_TYPE_BOXED:
+      *(gpointer *) cell = g_value_dup_boxed (value);
+      break;
+    case G_TYPE_VARIANT:
+      *(gpointer *) cell = g_value_dup_variant (value);
+      break;
+    case G_TYPE_OBJECT:
+      *(gpointer *) cell = g_value_dup_object (value);
+      break;
+    default:
+      g_warning ("%s: Unsupported type (%s) stored.", G_STRLOC, g_type_name (column->type));
+      break;
+    }
+}
+
+static gboolean
+gtk_column_store_real_set_value (GtkColumnStore *column_store,
+                                 GtkTreeIter    *iter,
+                                 gint            column,
+                                 GValue         *value)
+{
+  GtkColumnStorePrivate *priv = column_store->priv;
+  GValue real_value = G_VALUE_INIT;
+
+  if (!g_type_is_a (G_VALUE_TYPE (value), priv->column_headers[column]))
+    {
+      if (!g_value_type_transformable (G_VALUE_TYPE (value), priv->column_headers[column]))
+        {
+          g_warning ("%s: Unable to convert from %s to %s\n",
+                     G_STRLOC,
+                     g_type_name (G_VALUE_TYPE (value)),
+                     g_type_name (priv->column_headers[column]));
+          return FALSE;
+        }
+
+      g_value_init (&real_value, priv->column_headers[column]);
+      if (!g_value_transform (value, &real_value))
+        {
+          g_warning ("%s: Unable to make conversion from %s to %s\n",
+                     G_STRLOC,
+                     g_type_name (G_VALUE_TYPE (value)),
+                     g_type_name (priv->column_headers[column]));
+          g_value_unset (&real_value);
+          return FALSE;
+        }
+
+      set_cell (column_store, &priv->columns[column], ITER_ROW (iter), &real_value);
+      g_value_unset (&real_value);
+    }
+  else
+    set_cell (column_store, &priv->columns[column], ITER_ROW (iter), value);
+
+  return TRUE;
+}
+
+static void
+gtk_column_store_row_changed (GtkColumnStore *column_store,
+                              GtkTreeIter    *iter)
+{
+  GtkTreePath *path;
+
+  path = gtk_column_store_get_path (GTK_TREE_MODEL (column_store), iter);
+  gtk_tree_model_row_changed (GTK_TREE_MODEL (column_store), path, iter);
+  gtk_tree_path_free (path);
+}
+
+/* Whether changing @column can change the order of the list */
+static gboolean
+gtk_column_store_column_affects_sort (GtkColumnStore *column_store,
+                                      gint            column)
+{
+  GtkColumnStorePrivate *priv = column_store->priv;
+  GtkTreeDataSortHeader *header;
+
+  if (!GTK_COLUMN_STORE_IS_SORTED (column_store))
+    return FALSE;
+
+  if (priv->sort_column_id == GTK_TREE_SORTABLE_DEFAULT_SORT_COLUMN_ID)
+    return TRUE;
+
+  header = _gtk_tree_data_list_get_header (priv->sort_list, priv->sort_column_id);
+  if (header == NULL || header->func != _gtk_tree_data_list_compare_func)
+    return TRUE;
+
+  return column == priv->sort_column_id;
+}
+
+/**
+ * gtk_column_store_set_value:
+ * @column_store: A #GtkColumnStore
+ * @iter: A valid #GtkTreeIter for the row being modified
+ * @column: column number to modify
+ * @value: new value for the cell
+ *
+ * Sets the data in the cell specified by @iter and @column.
+ * The type of @value must be convertible to the type of the
+ * column.
+ *
+ * Since: 3.20
+ */
+void
+gtk_column_store_set_value (GtkColumnStore *column_store,
+                            GtkTreeIter    *iter,
+                            gint            column,
+                            GValue         *value)
+{
+  g_return_if_fail (GTK_IS_COLUMN_STORE (column_store));
+  g_return_if_fail (iter_is_valid (iter, column_store));
+  g_return_if_fail (G_IS_VALUE (value));
+  g_return_if_fail (column >= 0 && column < column_store->priv->n_columns);
+
+  if (!gtk_column_store_real_set_value (column_store, iter, column, value))
+    return;
+
+  if (gtk_column_store_column_affects_sort (column_store, column))
+    gtk_column_store_sort_iter_changed (column_store, iter);
+
+  gtk_column_store_row_changed (column_store, iter);
+}
+
+/**
+ * gtk_column_store_set_valist:
+ * @column_store: A #GtkColumnStore
+ * @iter: A valid #GtkTreeIter for the row being modified
+ * @var_args: va_list of column/value pairs
+ *
+ * See gtk_column_store_set(); this version takes a va_list for use by
+ * language bindings.
+ *
+ * Since: 3.20
+ */
+void
+gtk_column_store_set_valist (GtkColumnStore *column_store,
+                             GtkTreeIter    *iter,
+                             va_list         var_args)
+{
+  GtkColumnStorePrivate *priv;
+  gboolean emit_signal = FALSE;
+  gboolean maybe_need_sort = FALSE;
+  gint column;
+
+  g_return_if_fail (GTK_IS_COLUMN_STORE (column_store));
+  g_return_if_fail (iter_is_valid (iter, column_store));
+
+  priv = column_store->priv;
+
+  column = va_arg (var_args, gint);
+
+  while (column != -1)
+    {
+      GValue value = G_VALUE_INIT;
+      gchar *error = NULL;
+
+      if (column < 0 || column >= priv->n_columns)
+        {
+          g_warning ("%s: Invalid column number %d added to iter (remember to end your list of columns with a -1)", G_STRLOC, column);
+          break;
+        }
+
+      G_VALUE_COLLECT_INIT (&value, priv->column_headers[column],
+                            var_args, 0, &error);
+      if (error)
+        {
+          g_warning ("%s: %s", G_STRLOC, error);
+          g_free (error);
+
+          /* we purposely leak the value here, it might not be
+           * in a sane state if an error condition occoured
+           */
+          break;
+        }
+
+      if (gtk_column_store_real_set_value (column_store, iter, column, &value))
+        {
+          emit_signal = TRUE;
+          if (gtk_column_store_column_affects_sort (column_store, column))
+            maybe_need_sort = TRUE;
+        }
+
+      g_value_unset (&value);
+
+      column = va_arg (var_args, gint);
+    }
+
+  if (maybe_need_sort)
+    gtk_column_store_sort_iter_changed (column_store, iter);
+
+  if (emit_signal)
+    gtk_column_store_row_changed (column_store, iter);
+}
+
+/**
+ * gtk_column_store_set:
+ * @column_store: a #GtkColumnStore
+ * @iter: row iterator
+ * @...: pairs of column number and value, terminated with -1
+ *
+ * Sets the value of one or more cells in the row referenced by @iter.
+ * The variable argument list should contain integer column numbers,
+ * each column number followed by the value to be set, as for
+ * gtk_list_store_set(). The list is terminated by a -1.
+ *
+ * The value will be referenced by the store if it is a %G_TYPE_OBJECT, and it
+ * will be copied if it is a %G_TYPE_STRING or %G_TYPE_BOXED.
+ *
+ * Since: 3.20
+ */
+void
+gtk_column_store_set (GtkColumnStore *column_store,
+                      GtkTreeIter    *iter,
+                      ...)
+{
+  va_list var_args;
+
+  va_start (var_args, iter);
+  gtk_column_store_set_valist (column_store, iter, var_args);
+  va_end (var_args);
+}
+
+/**
+ * gtk_column_store_set_column:
+ * @column_store: a #GtkColumnStore
+ * @column: column number to modify
+ * @position: the position of the first row to modify
+ * @n_values: the number of rows to modify
+ * @values: (skip): a C array of @n_values values
+ *
+ * Sets @column of the @n_values rows starting at @position to the
+ * values in @values, which must be an array of the C type that holds
+ * the column type in a #GValue: #gboolean, #gint or #guint for boolean,
+ * int, uint, enum and flags columns, #gchar or #guchar for char and
+ * uchar columns, #glong, #gulong, #gint64, #guint64, #gfloat or
+ * #gdouble for the respective number types, `const gchar *` for strings
+ * and #gpointer for pointers, objects, boxed types and variants.
+ *
+ * Numbers are copied straight into the column, which makes this the
+ * fastest way to fill a column store with data. Strings and boxed
+ * values are copied, and objects and variants referenced, as with
+ * gtk_column_store_set().
+ *
+ * Since: 3.20
+ */
+void
+gtk_column_store_set_column (GtkColumnStore *column_store,
+                             gint            column,
+                             gint            position,
+                             gint            n_values,
+                             gconstpointer   values)
+{
+  GtkColumnStorePrivate *priv;
+  GtkTreePath *path;
+  GtkTreeIter iter;
+  Column *col;
+  GValue value = G_VALUE_INIT;
+  gpointer cell;
+  gint i;
+
+  g_return_if_fail (GTK_IS_COLUMN_STORE (column_store));
+
+  priv = column_store->priv;
+
+  g_return_if_fail (column >= 0 && column < priv->n_columns);
+  g_return_if_fail (position >= 0 && n_values >= 0);
+  g_return_if_fail ((guint) (position + n_values) <= priv->n_rows);
+  g_return_if_fail (values != NULL || n_values == 0);
+
+  col = &priv->columns[column];
+
+  if (col->kind == KIND_STRING || col->fundamental == G_TYPE_BOXED ||
+      col->fundamental == G_TYPE_OBJECT || col->fundamental == G_TYPE_VARIANT)
+    {
+      g_value_init (&value, col->type);
+      for (i = 0; i < n_values; i++)
+        {
+          if (col->kind == KIND_STRING)
+            g_value_set_static_string (&value, ((const gchar * const *) values)[i]);
+          else if (col->fundamental == G_TYPE_OBJECT)
+            g_value_set_object (&value, ((const gpointer *) values)[i]);
+          else if (col->fundamental == G_TYPE_VARIANT)
+            g_value_set_variant (&value, ((const gpointer *) values)[i]);
+          else
+            g_value_set_static_boxed (&value, ((const gpointer *) values)[i]);
+
+          set_cell (column_store, col, priv->rows[position + i], &value);
+        }
+      g_value_unset (&value);
+    }
+  else
+    {
+      for (i = 0; i < n_values; i++)
+        {
+          cell = CELL (col, priv->rows[position + i]);
+          memcpy (cell, (const guint8 *) values + (gsize) i * col->elem_size, col->elem_size);
+        }
+    }
+
+  path = gtk_tree_path_new_from_indices (position, -1);
+  for (i = 0; i < n_values; i++)
+    {
+      set_iter (column_store, &iter, priv->rows[position + i]);
+      gtk_tree_model_row_changed (GTK_TREE_MODEL (column_store), path, &iter);
+      gtk_tree_path_next (path);
+    }
+  gtk_tree_path_free (path);
+
+  if (n_values > 0 && gtk_column_store_column_affects_sort (column_store, column))
+    gtk_column_store_sort (column_store);
+}
+
+/**
+ * gtk_column_store_insert:
+ * @column_store: A #GtkColumnStore
+ * @iter: (out): An unset #GtkTreeIter to set to the new row
+ * @position: position to insert the new row, or -1 for last
+ *
+ * Creates a new row at @position. @iter will be changed to point to this
+ * new row. If @position is -1 or is larger than the number of rows on the
+ * list, then the new row will be appended to the list. The row will be
+ * empty after this function is called. To fill in values, you need to
+ * call gtk_column_store_set() or gtk_column_store_set_value().
+ *
+ * Since: 3.20
+ */
+void
+gtk_column_store_insert (GtkColumnStore *column_store,
+                         GtkTreeIter    *iter,
+                         gint            position)
+{
+  GtkColumnStorePrivate *priv;
+  GtkTreePath *path;
+  guint row;
+
+  g_return_if_fail (GTK_IS_COLUMN_STORE (column_store));
+  g_return_if_fail (iter != NULL);
+
+  priv = column_store->priv;
+
+  if (position < 0 || (guint) position > priv->n_rows)
+    position = priv->n_rows;
+
+  row = gtk_column_store_alloc_row (column_store);
+
+  memmove (priv->rows + position + 1, priv->rows + position,
+           (priv->n_rows - position) * sizeof (guint));
+  priv->rows[position] = row;
+  priv->n_rows++;
+  update_positions (priv, position, priv->n_rows);
+
+  set_iter (column_store, iter, row);
+
+  path = gtk_tree_path_new_from_indices (position, -1);
+  gtk_tree_model_row_inserted (GTK_TREE_MODEL (column_store), path, iter);
+  gtk_tree_path_free (path);
+}
+
+/**
+ * gtk_column_store_append:
+ * @column_store: A #GtkColumnStore
+ * @iter: (out): An unset #GtkTreeIter to set to the appended row
+ *
+ * Appends a new row to @column_store. @iter will be changed to point to
+ * this new row. The row will be empty after this function is called. To
+ * fill in values, you need to call gtk_column_store_set() or
+ * gtk_column_store_set_value().
+ *
+ * Since: 3.20
+ */
+void
+gtk_column_store_append (GtkColumnStore *column_store,
+                         GtkTreeIter    *iter)
+{
+  gtk_column_store_insert (column_store, iter, -1);
+}
+
+/**
+ * gtk_column_store_append_rows:
+ * @column_store: A #GtkColumnStore
+ * @n_rows: the number of rows to append
+ *
+ * Appends @n_rows empty rows to @column_store, growing every
+ * column at once, and announces them with a single
+ * #GtkTreeModel::rows-inserted signal if all the listeners of the store
+ * support it. Use gtk_column_store_set_column() to fill them.
+ *
+ * Since: 3.20
+ */
+void
+gtk_column_store_append_rows (GtkColumnStore *column_store,
+                              gint            n_rows)
+{
+  GtkColumnStorePrivate *priv;
+  GtkTreePath *path;
+  GtkTreeIter iter;
+  guint first, i;
+
+  g_return_if_fail (GTK_IS_COLUMN_STORE (column_store));
+  g_return_if_fail (n_rows >= 0);
+
+  priv = column_store->priv;
+
+  if (n_rows == 0)
+    return;
+
+  gtk_column_store_reserve (column_store, n_rows);
+
+  /* Other listeners need to see the rows one at a time */
+  if (!_gtk_tree_model_can_batch (GTK_TREE_MODEL (column_store)))
+    {
+      for (i = 0; i < (guint) n_rows; i++)
+        gtk_column_store_insert (column_store, &iter, -1);
+      return;
+    }
+
+  first = priv->n_rows;
+  for (i = 0; i < n_rows; i++)
+    priv->rows[first + i] = gtk_column_store_alloc_row (column_store);
+  priv->n_rows += n_rows;
+  update_positions (priv, first, priv->n_rows);
+
+  path = gtk_tree_path_new_from_indices (first, -1);
+  set_iter (column_store, &iter, priv->rows[first]);
+  gtk_tree_model_rows_inserted (GTK_TREE_MODEL (column_store), path, &iter, n_rows);
+  gtk_tree_path_free (path);
+}
+
+/**
+ * gtk_column_store_remove:
+ * @column_store: A #GtkColumnStore
+ * @iter: A valid #GtkTreeIter
+ *
+ * Removes the given row from the column store. After being removed,
+ * @iter is set to be the next valid row, or invalidated if it pointed
+ * to the last row in @column_store.
+ *
+ * Returns: %TRUE if @iter is valid, %FALSE if not.
+ *
+ * Since: 3.20
+ */
+gboolean
+gtk_column_store_remove (GtkColumnStore *column_store,
+                         GtkTreeIter    *iter)
+{
+  GtkColumnStorePrivate *priv;
+  GtkTreePath *path;
+  guint row, position;
+  gint i;
+
+  g_return_val_if_fail (GTK_IS_COLUMN_STORE (column_store), FALSE);
+  g_return_val_if_fail (iter_is_valid (iter, column_store), FALSE);
+
+  priv = column_store->priv;
+
+  row = ITER_ROW (iter);
+  position = priv->positions[row];
+
+  for (i = 0; i < priv->n_columns; i++)
+    clear_cell (&priv->columns[i], row);
+  priv->positions[row] = INVALID_POSITION;
+  g_array_append_val (priv->free_rows, row);
+
+  memmove (priv->rows + position, priv->rows + position + 1,
+           (priv->n_rows - position - 1) * sizeof (guint));
+  priv->n_rows--;
+  update_positions (priv, position, priv->n_rows);
+
+  path = gtk_tree_path_new_from_indices (position, -1);
+  gtk_tree_model_row_deleted (GTK_TREE_MODEL (column_store), path);
+  gtk_tree_path_free (path);
+
+  if (position >= priv->n_rows)
+    {
+      iter->stamp = 0;
+      return FALSE;
+    }
+
+  iter->user_data = GUINT_TO_POINTER (priv->rows[position]);
+
+  return TRUE;
+}
+
+/**
+ * gtk_column_store_clear:
+ * @column_store: a #GtkColumnStore.
+ *
+ * Removes all rows from the column store, and releases the
+ * strings kept in its pool.
+ *
+ * Since: 3.20
+ */
+void
+gtk_column_store_clear (GtkColumnStore *column_store)
+{
+  GtkColumnStorePrivate *priv;
+  GtkTreePath *path;
+
+  g_return_if_fail (GTK_IS_COLUMN_STORE (column_store));
+
+  priv = column_store->priv;
+
+  /* Rows go from the end, so that nothing has to be shifted */
+  while (priv->n_rows > 0)
+    {
+      priv->n_rows--;
+      priv->positions[priv->rows[priv->n_rows]] = INVALID_POSITION;
+
+      path = gtk_tree_path_new_from_indices (priv->n_rows, -1);
+      gtk_tree_model_row_deleted (GTK_TREE_MODEL (column_store), path);
+      gtk_tree_path_free (path);
+    }
+
+  gtk_column_store_clear_rows (column_store);
+
+  do
+    priv->stamp++;
+  while (priv->stamp == 0);
+}
+
+/**
+ * gtk_column_store_iter_is_valid:
+ * @column_store: A #GtkColumnStore.
+ * @iter: A #GtkTreeIter.
+ *
+ * Checks if the given iter is a valid iter for this #GtkColumnStore.
+ *
+ * Unlike gtk_list_store_iter_is_valid(), this is cheap.
+ *
+ * Returns: %TRUE if the iter is valid, %FALSE if the iter is invalid.
+ *
+ * Since: 3.20
+ */
+gboolean
+gtk_column_store_iter_is_valid (GtkColumnStore *column_store,
+                                GtkTreeIter    *iter)
+{
+  g_return_val_if_fail (GTK_IS_COLUMN_STORE (column_store), FALSE);
+  g_return_val_if_fail (iter != NULL, FALSE);
+
+  return iter_is_valid (iter, column_store);
+}
+
+/* Sorting */
+
+typedef struct
+{
+  GtkColumnStore *column_store;
+  GtkTreeIterCompareFunc func;
+  gpointer data;
+  gconstpointer cells;
+  const gchar **keys;
+  gint sign;
+} SortData;
+
+static gint
+compare_rows_func (gconstpointer a,
+                   gconstpointer b,
+                   gpointer      user_data)
+{
+  SortData *sort = user_data;
+  GtkTreeIter iter_a, iter_b;
+
+  set_iter (sort->column_store, &iter_a, *(const guint *) a);
+  set_iter (sort->column_store, &iter_b, *(const guint *) b);
+
+  return sort->sign * sort->func (GTK_TREE_MODEL (sort->column_store),
+                                  &iter_a, &iter_b, sort->data);
+}
+
+/* The default sort function, comparing cells right in their column */
+#define DEFINE_COMPARE_CELLS(name, type) \
+static gint \
+compare_##name (gconstpointer a, \
+                gconstpointer b, \
+                gpointer      user_data) \
+{ \
+  SortData *sort = user_data; \
+  type value_a = ((const type *) sort->cells)[*(const guint *) a]; \
+  type value_b = ((const type *) sort->cells)[*(const guint *) b]; \
+\
+  return sort->sign * ((value_a > value_b) - (value_a < value_b)); \
+}
+
+DEFINE_COMPARE_CELLS (int, gint32)
+DEFINE_COMPARE_CELLS (uint, guint32)
+DEFINE_COMPARE_CELLS (schar, gint8)
+DEFINE_COMPARE_CELLS (uchar, guint8)
+DEFINE_COMPARE_CELLS (long, glong)
+DEFINE_COMPARE_CELLS (ulong, gulong)
+DEFINE_COMPARE_CELLS (int64, gint64)
+DEFINE_COMPARE_CELLS (uint64, guint64)
+DEFINE_COMPARE_CELLS (float, gfloat)
+DEFINE_COMPARE_CELLS (double, gdouble)
+
+static gint
+compare_keys (gconstpointer a,
+              gconstpointer b,
+              gpointer      user_data)
+{
+  SortData *sort = user_data;
+
+  return sort->sign * strcmp (sort->keys[*(const guint *) a],
+                              sort->keys[*(const guint *) b]);
+}
+
+static gint
+compare_strings (gconstpointer a,
+                 gconstpointer b,
+                 gpointer      user_data)
+{
+  SortData *sort = user_data;
+  const gchar *string_a = ((const gchar * const *) sort->cells)[*(const guint *) a];
+  const gchar *string_b = ((const gchar * const *) sort->cells)[*(const guint *) b];
+
+  return sort->sign * g_utf8_collate (string_a ? string_a : "",
+                                      string_b ? string_b : "");
+}
+
+/* Collation keys are computed once per distinct string, instead of
+ * collating strings on every comparison. Equal strings share their
+ * pointer in the pool.
+ */
+static const gchar **
+gtk_column_store_get_collate_keys (GtkColumnStore *column_store,
+                                   Column         *column,
+                                   GHashTable     *key_table)
+{
+  GtkColumnStorePrivate *priv = column_store->priv;
+  const gchar **keys;
+  const gchar *string;
+  gchar *key;
+  guint i, row;
+
+  keys = g_new (const gchar *, priv->n_stored);
+
+  for (i = 0; i < priv->n_rows; i++)
+    {
+      row = priv->rows[i];
+      string = *(const gchar **) CELL (column, row);
+      if (string == NULL)
+        string = "";
+
+      key = g_hash_table_lookup (key_table, string);
+      if (key == NULL)
+        {
+          key = g_utf8_collate_key (string, -1);
+          g_hash_table_insert (key_table, (gpointer) string, key);
+        }
+
+      keys[row] = key;
+    }
+
+  return keys;
+}
+
+/* Sets up @sort for the current sort column, and returns the
+ * function that compares two rows with it. Collation keys for
+ * string columns are only worth computing if @all_rows are going
+ * to be compared, otherwise the strings are collated directly.
+ */
+static GCompareDataFunc
+gtk_column_store_get_sort_func (GtkColumnStore *column_store,
+                                gboolean        all_rows,
+                                SortData       *sort,
+                                GHashTable    **key_table)
+{
+  GtkColumnStorePrivate *priv = column_store->priv;
+  GtkTreeDataSortHeader *header;
+  Column *column;
+
+  memset (sort, 0, sizeof (SortData));
+  sort->column_store = column_store;
+  sort->sign = priv->order == GTK_SORT_DESCENDING ? -1 : 1;
+  *key_table = NULL;
+
+  if (priv->sort_column_id == GTK_TREE_SORTABLE_DEFAULT_SORT_COLUMN_ID)
+    {
+      sort->func = priv->default_sort_func;
+      sort->data = priv->default_sort_data;
+      return compare_rows_func;
+    }
+
+  header = _gtk_tree_data_list_get_header (priv->sort_list, priv->sort_column_id);
+  g_return_val_if_fail (header != NULL, NULL);
+  g_return_val_if_fail (header->func != NULL, NULL);
+
+  sort->func = header->func;
+  sort->data = header->data;
+
+  if (header->func != _gtk_tree_data_list_compare_func)
+    return compare_rows_func;
+
+  column = &priv->columns[priv->sort_column_id];
+  sort->cells = column->data;
+
+  switch (column->fundamental)
+    {
+    case G_TYPE_BOOLEAN:
+    case G_TYPE_INT:
+    case G_TYPE_ENUM:
+      return compare_int;
+    case G_TYPE_UINT:
+    case G_TYPE_FLAGS:
+      return compare_uint;
+    case G_TYPE_CHAR:
+      return compare_schar;
+    case G_TYPE_UCHAR:
+      return compare_uchar;
+    case G_TYPE_LONG:
+      return compare_long;
+    case G_TYPE_ULONG:
+      return compare_ulong;
+    case G_TYPE_INT64:
+      return compare_int64;
+    case G_TYPE_UINT64:
+      return compare_uint64;
+    case G_TYPE_FLOAT:
+      return compare_float;
+    case G_TYPE_DOUBLE:
+      return compare_double;
+    case G_TYPE_STRING:
+      if (!all_rows)
+        return compare_strings;
+      *key_table = g_hash_table_new_full (NULL, NULL, NULL, g_free);
+      sort->keys = gtk_column_store_get_collate_keys (column_store, column, *key_table);
+      return compare_keys;
+    default:
+      /* Let the default function complain */
+      return compare_rows_func;
+    }
+}
+
+static void
+gtk_column_store_sort_data_clear (SortData   *sort,
+                                  GHashTable *key_table)
+{
+  g_free (sort->keys);
+  if (key_table)
+    g_hash_table_unref (key_table);
+}
+
+/* Emits ::rows-reordered after the index was rearranged, while
+ * the positions still are those from before
+ */
+static void
+gtk_column_store_rows_reordered (GtkColumnStore *column_store)
+{
+  GtkColumnStorePrivate *priv = column_store->priv;
+  GtkTreePath *path;
+  gint *new_order;
+  guint i;
+
+  new_order = g_new (gint, priv->n_rows);
+  for (i = 0; i < priv->n_rows; i++)
+    new_order[i] = priv->positions[priv->rows[i]];
+
+  update_positions (priv, 0, priv->n_rows);
+
+  path = gtk_tree_path_new ();
+  gtk_tree_model_rows_reordered (GTK_TREE_MODEL (column_store),
+                                 path, NULL, new_order);
+  gtk_tree_path_free (path);
+  g_free (new_order);
+}
+
+static void
+gtk_column_store_sort (GtkColumnStore *column_store)
+{
+  GtkColumnStorePrivate *priv = column_store->priv;
+  GCompareDataFunc compare_func;
+  GHashTable *key_table;
+  SortData sort;
+
+  if (!GTK_COLUMN_STORE_IS_SORTED (column_store) || priv->n_rows <= 1)
+    return;
+
+  compare_func = gtk_column_store_get_sort_func (column_store, TRUE, &sort, &key_table);
+  if (compare_func == NULL)
+    return;
+
+  /* Only the index moves, the columns stay as they are */
+  g_qsort_with_data (priv->rows, priv->n_rows, sizeof (guint), compare_func, &sort);
+
+  gtk_column_store_sort_data_clear (&sort, key_table);
+
+  gtk_column_store_rows_reordered (column_store);
+}
+
+/* Moves the row at @iter to its sorted position, with a binary search
+ * that only compares it to O(log n) other rows
+ */
+static void
+gtk_column_store_sort_iter_changed (GtkColumnStore *column_store,
+                                    GtkTreeIter    *iter)
+{
+  GtkColumnStorePrivate *priv = column_store->priv;
+  GCompareDataFunc compare_func;
+  GHashTable *key_table;
+  SortData sort;
+  guint row, position, new_position, lo, hi, mid;
+
+  compare_func = gtk_column_store_get_sort_func (column_store, FALSE, &sort, &key_table);
+  if (compare_func == NULL)
+    return;
+
+  row = ITER_ROW (iter);
+  position = priv->positions[row];
+
+  /* Search among the other rows, which are still sorted */
+  lo = 0;
+  hi = priv->n_rows - 1;
+  while (lo < hi)
+    {
+      mid = (lo + hi) / 2;
+      if (compare_func (&priv->rows[mid < position ? mid : mid + 1], &row, &sort) <= 0)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+  new_position = lo;
+
+  gtk_column_store_sort_data_clear (&sort, key_table);
+
+  if (new_position == position)
+    return;
+
+  if (new_position < position)
+    memmove (priv->rows + new_position + 1, priv->rows + new_position,
+             (position - new_position) * sizeof (guint));
+  else
+    memmove (priv->rows + position, priv->rows + position + 1,
+             (new_position - position) * sizeof (guint));
+  priv->rows[new_position] = row;
+
+  gtk_column_store_rows_reordered (column_store);
+}
+
+static gboolean
+gtk_column_store_get_sort_column_id (GtkTreeSortable *sortable,
+                                     gint            *sort_column_id,
+                                     GtkSortType     *order)
+{
+  GtkColumnStorePrivate *priv = GTK_COLUMN_STORE (sortable)->priv;
+
+  if (sort_column_id)
+    *sort_column_id = priv->sort_column_id;
+  if (order)
+    *order = priv->order;
+
+  if (priv->sort_column_id == GTK_TREE_SORTABLE_DEFAULT_SORT_COLUMN_ID ||
+      priv->sort_column_id == GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID)
+    return FALSE;
+
+  return TRUE;
+}
+
+static void
+gtk_column_store_set_sort_column_id (GtkTreeSortable *sortable,
+                                     gint             sort_column_id,
+                                     GtkSortType      order)
+{
+  GtkColumnStore *column_store = GTK_COLUMN_STORE (sortable);
+  GtkColumnStorePrivate *priv = column_store->priv;
+
+  if ((priv->sort_column_id == sort_column_id) &&
+      (priv->order == order))
+    return;
+
+  if (sort_column_id != GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID)
+    {
+      if (sort_column_id != GTK_TREE_SORTABLE_DEFAULT_SORT_COLUMN_ID)
+        {
+          GtkTreeDataSortHeader *header = NULL;
+
+          header = _gtk_tree_data_list_get_header (priv->sort_list,
+                                                   sort_column_id);
+
+          /* We want to make sure that we have a function */
+          g_return_if_fail (header != NULL);
+          g_return_if_fail (header->func != NULL);
+        }
+      else
+        {
+          g_return_if_fail (priv->default_sort_func != NULL);
+        }
+    }
+
+  priv->sort_column_id = sort_column_id;
+  priv->order = order;
+
+  gtk_tree_sortable_sort_column_changed (sortable);
+
+  gtk_column_store_sort (column_store);
+}
+
+static void
+gtk_column_store_set_sort_func (GtkTreeSortable        *sortable,
+                                gint                    sort_column_id,
+                                GtkTreeIterCompareFunc  func,
+                                gpointer                data,
+                                GDestroyNotify          destroy)
+{
+  GtkColumnStore *column_store = GTK_COLUMN_STORE (sortable);
+  GtkColumnStorePrivate *priv = column_store->priv;
+
+  priv->sort_list = _gtk_tree_data_list_set_header (priv->sort_list,
+                                                    sort_column_id,
+                                                    func, data, destroy);
+
+  if (priv->sort_column_id == sort_column_id)
+    gtk_column_store_sort (column_store);
+}
+
+static void
+gtk_column_store_set_default_sort_func (GtkTreeSortable        *sortable,
+                                        GtkTreeIterCompareFunc  func,
+                                        gpointer                data,
+                                        GDestroyNotify          destroy)
+{
+  GtkColumnStore *column_store = GTK_COLUMN_STORE (sortable);
+  GtkColumnStorePrivate *priv = column_store->priv;
+
+  if (priv->default_sort_destroy)
+    {
+      GDestroyNotify d = priv->default_sort_destroy;
+
+      priv->default_sort_destroy = NULL;
+      d (priv->default_sort_data);
+    }
+
+  priv->default_sort_func = func;
+  priv->default_sort_data = data;
+  priv->default_sort_destroy = destroy;
+
+  if (priv->sort_column_id == GTK_TREE_SORTABLE_DEFAULT_SORT_COLUMN_ID)
+    gtk_column_store_sort (column_store);
+}
+
+static gboolean
+gtk_column_store_has_default_sort_func (GtkTreeSortable *sortable)
+{
+  return GTK_COLUMN_STORE (sortable)->priv->default_sort_func != NULL;
+}
+
+static void
+gtk_column_store_sortable_init (GtkTreeSortableIface *iface)
+{
+  iface->get_sort_column_id = gtk_column_store_get_sort_column_id;
+  iface->set_sort_column_id = gtk_column_store_set_sort_column_id;
+  iface->set_sort_func = gtk_column_store_set_sort_func;
+  iface->set_default_sort_func = gtk_column_store_set_default_sort_func;
+  iface->has_default_sort_func = gtk_column_store_has_default_sort_func;
+}
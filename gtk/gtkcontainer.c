@@ -40,6 +40,7 @@
 #include "gtktypebuiltins.h"
 #include "gtkprivate.h"
 #include "gtkmain.h"
+#include "gtklayouttraceprivate.h"
 #include "gtkmarshalers.h"
 #include "gtksizerequest.h"
 #include "gtksizerequestcacheprivate.h"
@@ -266,6 +267,8 @@ struct _GtkContainerPrivate
   guint reallocate_redraws : 1;
   guint resize_pending     : 1;
   guint restyle_pending    : 1;
+  guint relayout_boundary  : 1;
+  guint relayout_pending   : 1;
   guint resize_mode        : 2;
   guint request_mode       : 2;
 };
@@ -1994,10 +1997,42 @@ gtk_container_set_reallocate_redraws (GtkContainer *container,
   container->priv->reallocate_redraws = needs_redraws ? TRUE : FALSE;
 }
 
+/* Reallocates the children of a relayout boundary in its current
+ * allocation. If it turns out that the size request of the boundary
+ * did change after all, falls back to a normal resize.
+ */
+static void
+gtk_container_relayout (GtkContainer *container)
+{
+  GtkWidget *widget = GTK_WIDGET (container);
+  gint old_min_width, old_nat_width, old_min_height, old_nat_height;
+  gint min_width, nat_width, min_height, nat_height;
+
+  if (!_gtk_widget_get_visible (widget) ||
+      !_gtk_widget_get_realized (widget))
+    return;
+
+  gtk_widget_get_preferred_width (widget, &old_min_width, &old_nat_width);
+  gtk_widget_get_preferred_height (widget, &old_min_height, &old_nat_height);
+
+  _gtk_size_request_cache_clear (_gtk_widget_peek_request_cache (widget));
+
+  gtk_widget_get_preferred_width (widget, &min_width, &nat_width);
+  gtk_widget_get_preferred_height (widget, &min_height, &nat_height);
+
+  if (min_width != old_min_width || nat_width != old_nat_width ||
+      min_height != old_min_height || nat_height != old_nat_height)
+    gtk_widget_queue_resize (widget);
+  else
+    gtk_widget_reallocate (widget);
+}
+
 static void
 gtk_container_idle_sizer (GdkFrameClock *clock,
 			  GtkContainer  *container)
 {
+  gboolean traced;
+
   /* We validate the style contexts in a single loop before even trying
    * to handle resizes instead of doing validations inline.
    * This is mostly necessary for compatibility reasons with old code,
@@ -2014,6 +2049,10 @@ gtk_container_idle_sizer (GdkFrameClock *clock,
       gtk_css_node_validate (gtk_widget_get_css_node (GTK_WIDGET (container)));
     }
 
+  traced = GTK_LAYOUT_TRACE_IS_ENABLED ();
+  if (traced)
+    gtk_layout_trace_begin_layout (GTK_WIDGET (container));
+
   /* we may be invoked with a container_resize_queue of NULL, because
    * queue_resize could have been adding an extra idle function while
    * the queue still got processed. we better just ignore such case
@@ -2026,7 +2065,18 @@ gtk_container_idle_sizer (GdkFrameClock *clock,
       gtk_container_check_resize (container);
     }
 
-  if (!container->priv->restyle_pending && !container->priv->resize_pending)
+  if (container->priv->relayout_pending)
+    {
+      container->priv->relayout_pending = FALSE;
+      gtk_container_relayout (container);
+    }
+
+  if (traced)
+    gtk_layout_trace_end_layout (GTK_WIDGET (container));
+
+  if (!container->priv->restyle_pending &&
+      !container->priv->resize_pending &&
+      !container->priv->relayout_pending)
     {
       _gtk_container_stop_idle_sizer (container);
     }
@@ -2105,6 +2155,24 @@ gtk_container_queue_resize_handler (GtkContainer *container)
     }
 }
 
+/* A relayout boundary is a container whose size request does not
+ * depend on its children, so a resize queued below it does not
+ * need to go any further up. It only needs to reallocate its
+ * children, which we do from its own idle sizer.
+ */
+static gboolean
+gtk_container_absorbs_resize (GtkContainer *container)
+{
+  GtkWidget *widget = GTK_WIDGET (container);
+
+  return container->priv->relayout_boundary &&
+         _gtk_widget_get_visible (widget) &&
+         _gtk_widget_get_realized (widget) &&
+         !_gtk_widget_is_toplevel (widget) &&
+         _gtk_widget_get_sizegroups (widget) == NULL &&
+         gtk_widget_get_frame_clock (widget) != NULL;
+}
+
 static void
 _gtk_container_queue_resize_internal (GtkContainer *container,
                                       gboolean      invalidate_only)
@@ -2115,6 +2183,21 @@ _gtk_container_queue_resize_internal (GtkContainer *container,
 
   do
     {
+      if (GTK_LAYOUT_TRACE_IS_ENABLED ())
+        gtk_layout_trace_invalidated (widget);
+
+      if (gtk_container_absorbs_resize ((GtkContainer*)widget))
+        {
+          _gtk_widget_set_alloc_needed (widget, TRUE);
+
+          if (!invalidate_only)
+            {
+              ((GtkContainer*)widget)->priv->relayout_pending = TRUE;
+              gtk_container_start_idle_sizer ((GtkContainer*)widget);
+            }
+          return;
+        }
+
       _gtk_widget_set_alloc_needed (widget, TRUE);
       _gtk_size_request_cache_clear (_gtk_widget_peek_request_cache (widget));
 
@@ -2180,10 +2263,34 @@ _gtk_container_resize_invalidate (GtkContainer *container)
 void
 _gtk_container_maybe_start_idle_sizer (GtkContainer *container)
 {
-  if (container->priv->restyle_pending || container->priv->resize_pending)
+  if (container->priv->restyle_pending ||
+      container->priv->resize_pending ||
+      container->priv->relayout_pending)
     gtk_container_start_idle_sizer (container);
 }
 
+/*
+ * _gtk_container_set_relayout_boundary:
+ * @container: a #GtkContainer
+ * @relayout_boundary: whether the size request of @container
+ *     is independent of its children
+ *
+ * Containers whose size request does not depend on the size requests
+ * of their children can mark themselves as relayout boundaries.
+ * Resizes queued by their descendants then stop at the container,
+ * which reallocates its children without renegotiating the size of
+ * the whole toplevel.
+ *
+ * If the size request of the container turns out to have changed
+ * anyway, the resize is passed on to the parent as usual.
+ */
+void
+_gtk_container_set_relayout_boundary (GtkContainer *container,
+                                      gboolean      relayout_boundary)
+{
+  container->priv->relayout_boundary = relayout_boundary ? TRUE : FALSE;
+}
+
 void
 gtk_container_check_resize (GtkContainer *container)
 {
@@ -43,6 +43,8 @@ void      _gtk_container_maybe_start_idle_sizer (GtkContainer *container);
 gboolean  _gtk_container_get_border_width_set   (GtkContainer *container);
 void      _gtk_container_set_border_width_set   (GtkContainer *container,
                                                  gboolean      border_width_set);
+void      _gtk_container_set_relayout_boundary  (GtkContainer *container,
+                                                 gboolean      relayout_boundary);
 
 G_END_DECLS
 
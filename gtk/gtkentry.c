@@ -10598,10 +10598,15 @@ tick_cb (GtkWidget     *widget,
   g_assert (priv->pulse2 > priv->pulse1);
   g_assert (frame2 > priv->frame1);
 
+  /* Pulses stopped arriving; don't keep the frame clock running
+   * for frames that don't change anything. The next pulse restarts us.
+   */
   if (frame2 - priv->pulse2 > 3 * (priv->pulse2 - priv->pulse1))
     {
       priv->pulse1 = 0;
-      return G_SOURCE_CONTINUE;
+      priv->frame1 = 0;
+      priv->tick_id = 0;
+      return G_SOURCE_REMOVE;
     }
 
   /* Determine the fraction to move the block from one frame
@@ -10647,7 +10652,7 @@ gtk_entry_start_pulse_mode (GtkEntry *entry)
   if (!priv->progress_pulse_mode)
     {
       priv->progress_pulse_mode = TRUE;
-      priv->tick_id = gtk_widget_add_tick_callback (GTK_WIDGET (entry), tick_cb, NULL, NULL);
+      priv->tick_id = gtk_widget_add_mapped_tick_callback (GTK_WIDGET (entry), tick_cb, NULL, NULL);
 
       priv->progress_fraction = 0.0;
       priv->progress_pulse_way_back = FALSE;
@@ -10667,7 +10672,8 @@ gtk_entry_stop_pulse_mode (GtkEntry *entry)
   if (priv->progress_pulse_mode)
     {
       priv->progress_pulse_mode = FALSE;
-      gtk_widget_remove_tick_callback (GTK_WIDGET (entry), priv->tick_id);
+      if (priv->tick_id)
+        gtk_widget_remove_tick_callback (GTK_WIDGET (entry), priv->tick_id);
       priv->tick_id = 0;
     }
 }
@@ -10679,6 +10685,9 @@ gtk_entry_update_pulse (GtkEntry *entry)
 
   priv->pulse1 = priv->pulse2;
   priv->pulse2 = g_get_monotonic_time ();
+
+  if (priv->progress_pulse_mode && priv->tick_id == 0)
+    priv->tick_id = gtk_widget_add_mapped_tick_callback (GTK_WIDGET (entry), tick_cb, NULL, NULL);
 }
 
 /**
@@ -61,6 +61,7 @@
 #include "gtkorientableprivate.h"
 #include "gtkintl.h"
 #include "gtkcssnodeprivate.h"
+#include "gtksequenceprivate.h"
 #include "gtkwidgetprivate.h"
 
 #include "a11y/gtkflowboxaccessibleprivate.h"
@@ -76,7 +77,7 @@ static void gtk_flow_box_update_selection    (GtkFlowBox      *box,
                                               GtkFlowBoxChild *child,
                                               gboolean         modify,
                                               gboolean         extend);
-static void gtk_flow_box_apply_filter        (GtkFlowBox      *box,
+static gboolean gtk_flow_box_apply_filter    (GtkFlowBox      *box,
                                               GtkFlowBoxChild *child);
 static void gtk_flow_box_apply_sort          (GtkFlowBox      *box,
                                               GtkFlowBoxChild *child);
@@ -91,6 +92,9 @@ static void gtk_flow_box_bound_model_changed (GListModel *list,
                                               gpointer    user_data);
 
 static void gtk_flow_box_check_model_compat  (GtkFlowBox *box);
+static void gtk_flow_box_insert_css_node     (GtkFlowBox    *box,
+                                              GtkWidget     *child,
+                                              GSequenceIter *iter);
 
 static void
 get_current_selection_modifiers (GtkWidget *widget,
@@ -246,6 +250,9 @@ struct _GtkFlowBoxChildPrivate
 {
   GSequenceIter *iter;
   gboolean       selected;
+  gboolean       filtered;
+  gboolean       wrapped;
+  guint          position;
 };
 
 #define CHILD_PRIV(child) ((GtkFlowBoxChildPrivate*)gtk_flow_box_child_get_instance_private ((GtkFlowBoxChild*)(child)))
@@ -668,10 +675,13 @@ gtk_flow_box_child_get_index (GtkFlowBoxChild *child)
 
   priv = CHILD_PRIV (child);
 
-  if (priv->iter != NULL)
-    return g_sequence_iter_get_position (priv->iter);
+  if (priv->iter == NULL)
+    return -1;
 
-  return -1;
+  if (BOX_PRIV (gtk_flow_box_child_get_box (child))->bind_widget_func != NULL)
+    return priv->position;
+
+  return g_sequence_iter_get_position (priv->iter);
 }
 
 /**
@@ -729,7 +739,8 @@ gtk_flow_box_child_changed (GtkFlowBoxChild *child)
     return;
 
   gtk_flow_box_apply_sort (box, child);
-  gtk_flow_box_apply_filter (box, child);
+  if (gtk_flow_box_apply_filter (box, child))
+    gtk_widget_queue_resize (GTK_WIDGET (box));
 }
 
 /* GtkFlowBox  {{{1 */
@@ -766,6 +777,7 @@ enum {
   PROP_MAX_CHILDREN_PER_LINE,
   PROP_SELECTION_MODE,
   PROP_ACTIVATE_ON_SINGLE_CLICK,
+  PROP_FIXED_SIZE_MODE,
 
   /* orientable */
   PROP_ORIENTATION,
@@ -821,10 +833,19 @@ struct _GtkFlowBoxPrivate {
   GtkScrollType      autoscroll_mode;
   guint              autoscroll_id;
 
+  gboolean           fixed_size_mode;
+  gboolean           fixed_size_mode_forced;
+  gint               view_start;
+  gint               view_end;
+
   GListModel                 *bound_model;
   GtkFlowBoxCreateWidgetFunc  create_widget_func;
+  GtkFlowBoxBindWidgetFunc    bind_widget_func;
   gpointer                    create_widget_func_data;
   GDestroyNotify              create_widget_func_data_destroy;
+
+  /* Children that are not bound to an item, when recycling */
+  GQueue                      recycled_children;
 };
 
 #define BOX_PRIV(box) ((GtkFlowBoxPrivate*)gtk_flow_box_get_instance_private ((GtkFlowBox*)(box)))
@@ -846,13 +867,20 @@ G_DEFINE_TYPE_WITH_CODE (GtkFlowBox, gtk_flow_box, GTK_TYPE_CONTAINER,
    : gtk_widget_get_halign (GTK_WIDGET (box)))
 
 /* Children are visible if they are shown by the app (visible)
- * and not filtered out (child_visible) by the box
+ * and not filtered out by the box
  */
 static inline gboolean
 child_is_visible (GtkWidget *child)
 {
   return gtk_widget_get_visible (child) &&
-         gtk_widget_get_child_visible (child);
+         !CHILD_PRIV (child)->filtered;
+}
+
+/* Fixed size mode lays children out like homogeneous mode */
+static inline gboolean
+is_homogeneous (GtkFlowBox *box)
+{
+  return BOX_PRIV (box)->homogeneous || BOX_PRIV (box)->fixed_size_mode;
 }
 
 static gint
@@ -861,6 +889,10 @@ get_visible_children (GtkFlowBox *box)
   GSequenceIter *iter;
   gint i = 0;
 
+  /* When recycling, every item counts, whether it has a child or not */
+  if (BOX_PRIV (box)->bind_widget_func != NULL)
+    return g_list_model_get_n_items (BOX_PRIV (box)->bound_model);
+
   for (iter = g_sequence_get_begin_iter (BOX_PRIV (box)->children);
        !g_sequence_iter_is_end (iter);
        iter = g_sequence_iter_next (iter))
@@ -889,7 +921,8 @@ gtk_flow_box_find_child_at_pos (GtkFlowBox *box,
        iter = g_sequence_iter_next (iter))
     {
       child = g_sequence_get (iter);
-      if (!child_is_visible (child))
+      /* Children outside of the view are not allocated in fixed size mode */
+      if (!child_is_visible (child) || !gtk_widget_get_child_visible (child))
         continue;
       gtk_widget_get_allocation (child, &allocation);
       if (x >= allocation.x && x < (allocation.x + allocation.width) &&
@@ -929,24 +962,36 @@ gtk_flow_box_update_active (GtkFlowBox      *box,
     }
 }
 
-static void
+/* Returns whether the child got filtered in or out */
+static gboolean
 gtk_flow_box_apply_filter (GtkFlowBox      *box,
                            GtkFlowBoxChild *child)
 {
   GtkFlowBoxPrivate *priv = BOX_PRIV (box);
-  gboolean do_show;
+  gboolean do_show, changed;
 
   do_show = TRUE;
   if (priv->filter_func != NULL)
     do_show = priv->filter_func (child, priv->filter_data);
 
-  gtk_widget_set_child_visible (GTK_WIDGET (child), do_show);
+  changed = CHILD_PRIV (child)->filtered != !do_show;
+  CHILD_PRIV (child)->filtered = !do_show;
+
+  /* In fixed size mode, children are only mapped once they
+   * get allocated inside the view
+   */
+  if (!priv->fixed_size_mode || !do_show)
+    gtk_widget_set_child_visible (GTK_WIDGET (child), do_show);
+
+  return changed;
 }
 
+/* Only relayouts if any child got filtered in or out */
 static void
 gtk_flow_box_apply_filter_all (GtkFlowBox *box)
 {
   GSequenceIter *iter;
+  gboolean changed = FALSE;
 
   for (iter = g_sequence_get_begin_iter (BOX_PRIV (box)->children);
        !g_sequence_iter_is_end (iter);
@@ -955,20 +1000,32 @@ gtk_flow_box_apply_filter_all (GtkFlowBox *box)
       GtkFlowBoxChild *child;
 
       child = g_sequence_get (iter);
-      gtk_flow_box_apply_filter (box, child);
+      if (gtk_flow_box_apply_filter (box, child))
+        changed = TRUE;
     }
-  gtk_widget_queue_resize (GTK_WIDGET (box));
+
+  if (changed)
+    gtk_widget_queue_resize (GTK_WIDGET (box));
 }
 
 static void
 gtk_flow_box_apply_sort (GtkFlowBox      *box,
                          GtkFlowBoxChild *child)
 {
+  GSequenceIter *iter, *old_next;
+
   if (BOX_PRIV (box)->sort_func != NULL)
     {
-      g_sequence_sort_changed (CHILD_PRIV (child)->iter,
+      /* A binary search relocates the child, nothing else moves */
+      iter = CHILD_PRIV (child)->iter;
+      old_next = g_sequence_iter_next (iter);
+      g_sequence_sort_changed (iter,
                                (GCompareDataFunc)gtk_flow_box_sort, box);
-      gtk_widget_queue_resize (GTK_WIDGET (box));
+      if (g_sequence_iter_next (iter) != old_next)
+        {
+          gtk_flow_box_insert_css_node (box, GTK_WIDGET (child), iter);
+          gtk_widget_queue_resize (GTK_WIDGET (box));
+        }
     }
 }
 
@@ -1039,6 +1096,8 @@ gtk_flow_box_update_cursor (GtkFlowBox      *box,
                             GtkFlowBoxChild *child)
 {
   BOX_PRIV (box)->cursor_child = child;
+  if (BOX_PRIV (box)->fixed_size_mode)
+    gtk_widget_set_child_visible (GTK_WIDGET (child), TRUE);
   gtk_widget_grab_focus (GTK_WIDGET (child));
   gtk_widget_queue_draw (GTK_WIDGET (child));
   _gtk_flow_box_accessible_update_cursor (GTK_WIDGET (box), GTK_WIDGET (child));
@@ -1334,6 +1393,10 @@ get_max_item_size (GtkFlowBox     *box,
 
       max_min_size = MAX (max_min_size, child_min);
       max_nat_size = MAX (max_nat_size, child_nat);
+
+      /* In fixed size mode, the first visible child stands for all of them */
+      if (BOX_PRIV (box)->fixed_size_mode)
+        break;
     }
 
   if (min_size)
@@ -1381,6 +1444,9 @@ get_largest_size_for_opposing_orientation (GtkFlowBox     *box,
 
       max_min_size = MAX (max_min_size, child_min);
       max_nat_size = MAX (max_nat_size, child_nat);
+
+      if (BOX_PRIV (box)->fixed_size_mode)
+        break;
     }
 
   if (min_item_size)
@@ -1600,6 +1666,439 @@ get_offset_pixels (GtkAlign align,
   return offset;
 }
 
+/* In fixed size mode, all children take the same space, so the
+ * place of a child follows from its index alone
+ */
+typedef struct {
+  gint     n_children;
+  gint     n_lines;
+  gint     line_length;
+  gint     item_size;
+  gint     line_size;
+  gint     item_spacing;
+  gint     line_spacing;
+  gint     item_offset;
+  gint     line_offset;
+  gint     extra_per_item;
+  gint     extra_extra;
+  GtkAlign item_align;
+} FixedLayout;
+
+static void
+get_fixed_child_allocation (GtkFlowBox    *box,
+                            FixedLayout   *layout,
+                            GtkAllocation *allocation,
+                            gint           child_index,
+                            GtkAllocation *child_allocation)
+{
+  gint line, position, extra_items;
+  gint item_offset, line_offset, item_size;
+
+  line = child_index / layout->line_length;
+  position = child_index % layout->line_length;
+
+  /* Push the index along for the last line when spreading to the end */
+  extra_items = layout->n_children % layout->line_length;
+  if (layout->item_align == GTK_ALIGN_END &&
+      line == layout->n_lines - 1 && extra_items > 0)
+    position += layout->line_length - extra_items;
+
+  line_offset = layout->line_offset + line * (layout->line_size + layout->line_spacing);
+  item_offset = layout->item_offset + position * (layout->item_size + layout->item_spacing);
+  item_size = layout->item_size;
+
+  if (layout->item_align == GTK_ALIGN_FILL)
+    {
+      item_offset += position * layout->extra_per_item + MIN (position, layout->extra_extra);
+      item_size += layout->extra_per_item;
+
+      if (position < layout->extra_extra)
+        item_size++;
+    }
+
+  if (BOX_PRIV (box)->orientation == GTK_ORIENTATION_HORIZONTAL)
+    {
+      child_allocation->x = item_offset;
+      child_allocation->y = line_offset;
+      child_allocation->width = item_size;
+      child_allocation->height = layout->line_size;
+    }
+  else /* GTK_ORIENTATION_VERTICAL */
+    {
+      child_allocation->x = line_offset;
+      child_allocation->y = item_offset;
+      child_allocation->width = layout->line_size;
+      child_allocation->height = item_size;
+    }
+
+  if (gtk_widget_get_direction (GTK_WIDGET (box)) == GTK_TEXT_DIR_RTL)
+    child_allocation->x = allocation->width - child_allocation->x - child_allocation->width;
+}
+
+/* Gets the visible part of @box along the lines, from the
+ * adjustment that scrolls in that direction
+ */
+static gboolean
+gtk_flow_box_get_view (GtkFlowBox *box,
+                       gint       *start,
+                       gint       *end)
+{
+  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+  GtkAdjustment *adjustment;
+  GtkAllocation allocation;
+
+  gtk_widget_get_allocation (GTK_WIDGET (box), &allocation);
+
+  if (priv->orientation == GTK_ORIENTATION_HORIZONTAL)
+    {
+      adjustment = priv->vadjustment;
+      if (adjustment == NULL)
+        return FALSE;
+      *start = gtk_adjustment_get_value (adjustment) - allocation.y;
+    }
+  else
+    {
+      adjustment = priv->hadjustment;
+      if (adjustment == NULL)
+        return FALSE;
+      *start = gtk_adjustment_get_value (adjustment) - allocation.x;
+    }
+
+  *end = *start + gtk_adjustment_get_page_size (adjustment);
+
+  return TRUE;
+}
+
+static void
+gtk_flow_box_adjustment_value_changed (GtkAdjustment *adjustment,
+                                       GtkFlowBox    *box)
+{
+  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+  gint start, end;
+
+  if (!priv->fixed_size_mode)
+    return;
+
+  /* Children are allocated a page ahead, so only relayout
+   * when scrolling beyond that
+   */
+  if (gtk_flow_box_get_view (box, &start, &end) &&
+      (start < priv->view_start || end > priv->view_end))
+    gtk_widget_queue_resize (GTK_WIDGET (box));
+}
+
+/* Orders children by the position of their item. The position that
+ * is searched for is passed as @data, for a %NULL child, which sorts
+ * before the child of the item at that position.
+ */
+static gint
+gtk_flow_box_compare_recycled (gconstpointer a,
+                               gconstpointer b,
+                               gpointer      data)
+{
+  gint64 pos_a, pos_b;
+
+  if (a)
+    pos_a = 2 * (gint64) CHILD_PRIV ((GtkFlowBoxChild *) a)->position;
+  else
+    pos_a = 2 * (gint64) GPOINTER_TO_UINT (data) - 1;
+
+  if (b)
+    pos_b = 2 * (gint64) CHILD_PRIV ((GtkFlowBoxChild *) b)->position;
+  else
+    pos_b = 2 * (gint64) GPOINTER_TO_UINT (data) - 1;
+
+  return (pos_a > pos_b) - (pos_a < pos_b);
+}
+
+/* Returns the iter of the first child whose item is at @position
+ * or after it. Children are kept sorted by item position when
+ * recycling.
+ */
+static GSequenceIter *
+gtk_flow_box_get_recycled_iter (GtkFlowBox *box,
+                                guint       position)
+{
+  return g_sequence_search (BOX_PRIV (box)->children, NULL,
+                            gtk_flow_box_compare_recycled,
+                            GUINT_TO_POINTER (position));
+}
+
+static GtkWidget *
+gtk_flow_box_child_get_bound_widget (GtkFlowBoxChild *child)
+{
+  if (CHILD_PRIV (child)->wrapped)
+    return gtk_bin_get_child (GTK_BIN (child));
+
+  return GTK_WIDGET (child);
+}
+
+/* Gives the item at @position a child, taking one from the
+ * recycled children if possible, and inserts it before @sibling
+ */
+static GtkFlowBoxChild *
+gtk_flow_box_bind_item (GtkFlowBox    *box,
+                        guint          position,
+                        GSequenceIter *sibling)
+{
+  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+  GtkFlowBoxChild *child;
+  GtkWidget *widget;
+  GSequenceIter *iter;
+  gpointer item;
+
+  item = g_list_model_get_item (priv->bound_model, position);
+
+  child = g_queue_pop_head (&priv->recycled_children);
+  if (child != NULL)
+    {
+      priv->bind_widget_func (gtk_flow_box_child_get_bound_widget (child),
+                              item, priv->create_widget_func_data);
+    }
+  else
+    {
+      widget = priv->create_widget_func (item, priv->create_widget_func_data);
+
+      /* See gtk_flow_box_bound_model_changed() */
+      if (g_object_is_floating (widget))
+        g_object_ref_sink (widget);
+
+      gtk_widget_show (widget);
+
+      if (GTK_IS_FLOW_BOX_CHILD (widget))
+        child = GTK_FLOW_BOX_CHILD (widget);
+      else
+        {
+          child = GTK_FLOW_BOX_CHILD (gtk_flow_box_child_new ());
+          gtk_widget_show (GTK_WIDGET (child));
+          gtk_container_add (GTK_CONTAINER (child), widget);
+          CHILD_PRIV (child)->wrapped = TRUE;
+        }
+
+      gtk_widget_set_child_visible (GTK_WIDGET (child), FALSE);
+      gtk_widget_set_parent (GTK_WIDGET (child), GTK_WIDGET (box));
+
+      g_object_unref (widget);
+    }
+
+  iter = g_sequence_insert_before (sibling, child);
+  gtk_flow_box_insert_css_node (box, GTK_WIDGET (child), iter);
+
+  CHILD_PRIV (child)->iter = iter;
+  CHILD_PRIV (child)->position = position;
+
+  g_object_unref (item);
+
+  return child;
+}
+
+/* Unbinds @child from its item and keeps it around for another one */
+static void
+gtk_flow_box_recycle_child (GtkFlowBox      *box,
+                            GtkFlowBoxChild *child)
+{
+  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+  gboolean was_selected;
+
+  was_selected = CHILD_PRIV (child)->selected;
+  gtk_flow_box_child_set_selected (child, FALSE);
+
+  /* The child's new item is neither hovered nor pressed */
+  gtk_widget_unset_state_flags (GTK_WIDGET (child),
+                                GTK_STATE_FLAG_PRELIGHT | GTK_STATE_FLAG_ACTIVE);
+
+  if (child == priv->prelight_child)
+    priv->prelight_child = NULL;
+  if (child == priv->active_child)
+    priv->active_child = NULL;
+  if (child == priv->selected_child)
+    priv->selected_child = NULL;
+  if (child == priv->cursor_child)
+    priv->cursor_child = NULL;
+  if (child == priv->rubberband_first)
+    priv->rubberband_first = NULL;
+  if (child == priv->rubberband_last)
+    priv->rubberband_last = NULL;
+
+  g_sequence_remove (CHILD_PRIV (child)->iter);
+  CHILD_PRIV (child)->iter = NULL;
+  gtk_widget_set_child_visible (GTK_WIDGET (child), FALSE);
+
+  priv->bind_widget_func (gtk_flow_box_child_get_bound_widget (child),
+                          NULL, priv->create_widget_func_data);
+  g_queue_push_tail (&priv->recycled_children, child);
+
+  if (was_selected)
+    g_signal_emit (box, signals[SELECTED_CHILDREN_CHANGED], 0);
+}
+
+static void
+gtk_flow_box_ensure_item_bound (GtkFlowBox *box,
+                                guint       position)
+{
+  GSequenceIter *iter;
+
+  iter = gtk_flow_box_get_recycled_iter (box, position);
+  if (g_sequence_iter_is_end (iter) ||
+      CHILD_PRIV (g_sequence_get (iter))->position != position)
+    gtk_flow_box_bind_item (box, position, iter);
+}
+
+/* The cursor child keeps the children next to it in every
+ * direction, so that it can be moved with the keyboard
+ */
+static gboolean
+is_next_to_cursor (guint position,
+                   guint cursor,
+                   guint line_length)
+{
+  if (cursor == G_MAXUINT)
+    return FALSE;
+
+  return position == cursor ||
+         position + 1 == cursor || position == cursor + 1 ||
+         position + line_length == cursor || position == cursor + line_length;
+}
+
+/* When recycling, only the items from @first to @last have a
+ * child, along with the selected children and the cursor child
+ */
+static void
+gtk_flow_box_update_recycled (GtkFlowBox *box,
+                              guint       first,
+                              guint       last,
+                              guint       line_length)
+{
+  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+  GtkFlowBoxChild *child;
+  GSequenceIter *iter, *next;
+  guint n_items, cursor, position;
+
+  n_items = g_list_model_get_n_items (priv->bound_model);
+  cursor = priv->cursor_child ? CHILD_PRIV (priv->cursor_child)->position : G_MAXUINT;
+
+  if (first < last)
+    {
+      iter = g_sequence_get_begin_iter (priv->children);
+      while (!g_sequence_iter_is_end (iter))
+        {
+          child = g_sequence_get (iter);
+          next = g_sequence_iter_next (iter);
+          position = CHILD_PRIV (child)->position;
+
+          if ((position < first || position >= last) &&
+              !CHILD_PRIV (child)->selected &&
+              !is_next_to_cursor (position, cursor, line_length))
+            gtk_flow_box_recycle_child (box, child);
+
+          iter = next;
+        }
+    }
+
+  for (position = first; position < last; position++)
+    gtk_flow_box_ensure_item_bound (box, position);
+
+  if (cursor != G_MAXUINT)
+    {
+      if (cursor >= 1)
+        gtk_flow_box_ensure_item_bound (box, cursor - 1);
+      if (cursor + 1 < n_items)
+        gtk_flow_box_ensure_item_bound (box, cursor + 1);
+      if (cursor >= line_length)
+        gtk_flow_box_ensure_item_bound (box, cursor - line_length);
+      if (cursor + line_length < n_items)
+        gtk_flow_box_ensure_item_bound (box, cursor + line_length);
+    }
+}
+
+/* Children are placed by their index, and only the ones in and
+ * around the visible lines are shown and allocated. The cursor
+ * child is always kept, so that it does not lose the focus.
+ */
+static void
+gtk_flow_box_allocate_fixed (GtkFlowBox    *box,
+                             GtkAllocation *allocation,
+                             FixedLayout   *layout)
+{
+  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+  GtkAllocation child_allocation;
+  GtkFlowBoxChild *child;
+  GSequenceIter *iter;
+  gint start, end, page, stride;
+  gint first_line, last_line, line;
+  gint child_index, i;
+  gboolean in_view;
+
+  first_line = 0;
+  last_line = layout->n_lines - 1;
+
+  if (gtk_flow_box_get_view (box, &start, &end))
+    {
+      page = end - start;
+      priv->view_start = start - page;
+      priv->view_end = end + page;
+
+      /* Lines run from right to left in that case */
+      if (priv->orientation == GTK_ORIENTATION_VERTICAL &&
+          gtk_widget_get_direction (GTK_WIDGET (box)) == GTK_TEXT_DIR_RTL)
+        {
+          start = allocation->width - priv->view_end;
+          end = allocation->width - priv->view_start;
+        }
+      else
+        {
+          start = priv->view_start;
+          end = priv->view_end;
+        }
+
+      stride = layout->line_size + layout->line_spacing;
+      if (stride > 0)
+        {
+          first_line = CLAMP ((start - layout->line_offset) / stride, 0, layout->n_lines - 1);
+          last_line = CLAMP ((end - layout->line_offset) / stride, first_line, layout->n_lines - 1);
+        }
+    }
+  else
+    {
+      priv->view_start = G_MININT;
+      priv->view_end = G_MAXINT;
+    }
+
+  if (priv->bind_widget_func != NULL)
+    gtk_flow_box_update_recycled (box,
+                                  first_line * layout->line_length,
+                                  MIN ((last_line + 1) * layout->line_length, layout->n_children),
+                                  layout->line_length);
+
+  i = 0;
+  for (iter = g_sequence_get_begin_iter (priv->children);
+       !g_sequence_iter_is_end (iter);
+       iter = g_sequence_iter_next (iter))
+    {
+      child = g_sequence_get (iter);
+
+      if (priv->bind_widget_func != NULL)
+        child_index = CHILD_PRIV (child)->position;
+      else if (child_is_visible (GTK_WIDGET (child)))
+        child_index = i++;
+      else
+        continue;
+
+      line = child_index / layout->line_length;
+      in_view = (line >= first_line && line <= last_line) ||
+                child == priv->cursor_child;
+
+      if (gtk_widget_get_child_visible (GTK_WIDGET (child)) != in_view)
+        gtk_widget_set_child_visible (GTK_WIDGET (child), in_view);
+
+      if (!in_view)
+        continue;
+
+      get_fixed_child_allocation (box, layout, allocation, child_index, &child_allocation);
+      gtk_widget_size_allocate (GTK_WIDGET (child), &child_allocation);
+    }
+}
+
 static void
 gtk_flow_box_size_allocate (GtkWidget     *widget,
                             GtkAllocation *allocation)
@@ -1676,7 +2175,7 @@ gtk_flow_box_size_allocate (GtkWidget     *widget,
 
   /* Here we just use the largest height-for-width and use that for the height
    * of all lines */
-  if (priv->homogeneous)
+  if (is_homogeneous (box))
     {
       n_lines = n_children / line_length;
       if ((n_children % line_length) > 0)
@@ -1805,6 +2304,27 @@ gtk_flow_box_size_allocate (GtkWidget     *widget,
       extra_line_extra = extra_line_pixels % n_lines;
     }
 
+  if (priv->fixed_size_mode)
+    {
+      FixedLayout layout;
+
+      layout.n_children = n_children;
+      layout.n_lines = n_lines;
+      layout.line_length = line_length;
+      layout.item_size = item_size;
+      layout.line_size = line_size;
+      layout.item_spacing = item_spacing;
+      layout.line_spacing = line_spacing;
+      layout.item_offset = get_offset_pixels (item_align, extra_pixels);
+      layout.line_offset = get_offset_pixels (line_align, extra_line_pixels);
+      layout.extra_per_item = extra_per_item;
+      layout.extra_extra = extra_extra;
+      layout.item_align = item_align;
+
+      gtk_flow_box_allocate_fixed (box, allocation, &layout);
+      return;
+    }
+
   /*
    * Prepare item/line initial offsets and jump into the
    * real allocation loop.
@@ -1816,7 +2336,7 @@ gtk_flow_box_size_allocate (GtkWidget     *widget,
   line_offset += get_offset_pixels (line_align, extra_line_pixels);
 
   /* Get the allocation size for the first line */
-  if (priv->homogeneous)
+  if (is_homogeneous (box))
     this_line_size = line_size;
   else
     {
@@ -1858,7 +2378,7 @@ gtk_flow_box_size_allocate (GtkWidget     *widget,
           line_count++;
 
           /* Get the new line size */
-          if (priv->homogeneous)
+          if (is_homogeneous (box))
             this_line_size = line_size;
           else
             {
@@ -1889,7 +2409,7 @@ gtk_flow_box_size_allocate (GtkWidget     *widget,
                 {
                   gint extra_items = n_children % line_length;
 
-                  if (priv->homogeneous)
+                  if (is_homogeneous (box))
                     {
                       item_offset += item_size * (line_length - extra_items);
                       item_offset += item_spacing * (line_length - extra_items);
@@ -1916,7 +2436,7 @@ gtk_flow_box_size_allocate (GtkWidget     *widget,
           position += line_length - extra_items;
         }
 
-      if (priv->homogeneous)
+      if (is_homogeneous (box))
         this_item_size = item_size;
       else
         this_item_size = item_sizes[position].minimum_size;
@@ -2058,7 +2578,7 @@ gtk_flow_box_get_preferred_width (GtkWidget *widget,
     {
       min_width = nat_width = 0;
 
-      if (!priv->homogeneous)
+      if (!is_homogeneous (box))
         {
           /* When not homogeneous; horizontally oriented boxes
            * need enough width for the widest row */
@@ -2155,7 +2675,7 @@ gtk_flow_box_get_preferred_height (GtkWidget *widget,
     {
       min_height = nat_height = 0;
 
-      if (! priv->homogeneous)
+      if (!is_homogeneous (box))
         {
           /* When not homogeneous; vertically oriented boxes
            * need enough height for the tallest column */
@@ -2279,7 +2799,7 @@ gtk_flow_box_get_preferred_height_for_width (GtkWidget *widget,
         /* Collect the extra pixels for expand children */
         extra_pixels = (avail_size - (line_length - 1) * priv->column_spacing) % line_length;
 
-      if (priv->homogeneous)
+      if (is_homogeneous (box))
         {
           gint min_item_height, nat_item_height;
           gint lines;
@@ -2443,7 +2963,7 @@ gtk_flow_box_get_preferred_width_for_height (GtkWidget *widget,
         /* Collect the extra pixels for expand children */
         extra_pixels = (avail_size - (line_length - 1) * priv->row_spacing) % line_length;
 
-      if (priv->homogeneous)
+      if (is_homogeneous (box))
         {
           gint min_item_width, nat_item_width;
           gint lines;
@@ -3155,6 +3675,15 @@ gtk_flow_box_remove (GtkContainer *container,
         }
     }
 
+  if (CHILD_PRIV (child)->iter == NULL)
+    {
+      if (g_queue_remove (&priv->recycled_children, child))
+        gtk_widget_unparent (GTK_WIDGET (child));
+      else
+        g_warning ("Tried to remove non-child %p\n", widget);
+      return;
+    }
+
   was_visible = child_is_visible (GTK_WIDGET (child));
   was_selected = CHILD_PRIV (child)->selected;
 
@@ -3183,6 +3712,7 @@ gtk_flow_box_forall (GtkContainer *container,
 {
   GSequenceIter *iter;
   GtkWidget *child;
+  GList *l;
 
   iter = g_sequence_get_begin_iter (BOX_PRIV (container)->children);
   while (!g_sequence_iter_is_end (iter))
@@ -3191,6 +3721,14 @@ gtk_flow_box_forall (GtkContainer *container,
       iter = g_sequence_iter_next (iter);
       callback (child, callback_target);
     }
+
+  l = BOX_PRIV (container)->recycled_children.head;
+  while (l != NULL)
+    {
+      child = l->data;
+      l = l->next;
+      callback (child, callback_target);
+    }
 }
 
 static GType
@@ -3580,6 +4118,9 @@ gtk_flow_box_get_property (GObject    *object,
     case PROP_ACTIVATE_ON_SINGLE_CLICK:
       g_value_set_boolean (value, priv->activate_on_single_click);
       break;
+    case PROP_FIXED_SIZE_MODE:
+      g_value_set_boolean (value, priv->fixed_size_mode);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3628,6 +4169,9 @@ gtk_flow_box_set_property (GObject      *object,
     case PROP_ACTIVATE_ON_SINGLE_CLICK:
       gtk_flow_box_set_activate_on_single_click (box, g_value_get_boolean (value));
       break;
+    case PROP_FIXED_SIZE_MODE:
+      gtk_flow_box_set_fixed_size_mode (box, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3645,6 +4189,10 @@ gtk_flow_box_finalize (GObject *obj)
     priv->sort_destroy (priv->sort_data);
 
   g_sequence_free (priv->children);
+  if (priv->hadjustment)
+    g_signal_handlers_disconnect_by_func (priv->hadjustment, gtk_flow_box_adjustment_value_changed, obj);
+  if (priv->vadjustment)
+    g_signal_handlers_disconnect_by_func (priv->vadjustment, gtk_flow_box_adjustment_value_changed, obj);
   g_clear_object (&priv->hadjustment);
   g_clear_object (&priv->vadjustment);
 
@@ -3800,6 +4348,22 @@ gtk_flow_box_class_init (GtkFlowBoxClass *class)
                        0, G_MAXUINT, 0,
                        G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
 
+  /**
+   * GtkFlowBox:fixed-size-mode:
+   *
+   * Setting the ::fixed-size-mode property to %TRUE speeds up
+   * #GtkFlowBox by assuming that all children have the same size
+   * as the first visible one. See gtk_flow_box_set_fixed_size_mode().
+   *
+   * Since: 3.20
+   */
+  props[PROP_FIXED_SIZE_MODE] =
+    g_param_spec_boolean ("fixed-size-mode",
+                          P_("Fixed Size Mode"),
+                          P_("Speeds up GtkFlowBox by assuming that all children have the same size"),
+                          FALSE,
+                          G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
+
   g_object_class_install_properties (object_class, LAST_PROP, props);
 
   /**
@@ -4039,6 +4603,41 @@ gtk_flow_box_init (GtkFlowBox *box)
                     G_CALLBACK (gtk_flow_box_drag_gesture_end), box);
 }
 
+/* Only the children of removed items go away right away, the
+ * ones for new items are created when they get into view
+ */
+static void
+gtk_flow_box_recycled_model_changed (GtkFlowBox *box,
+                                     guint       position,
+                                     guint       removed,
+                                     guint       added)
+{
+  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+  GSequenceIter *iter, *next;
+  GtkFlowBoxChild *child;
+
+  iter = gtk_flow_box_get_recycled_iter (box, position);
+  while (!g_sequence_iter_is_end (iter))
+    {
+      child = g_sequence_get (iter);
+      next = g_sequence_iter_next (iter);
+
+      if (CHILD_PRIV (child)->position < position + removed)
+        gtk_flow_box_recycle_child (box, child);
+      else
+        CHILD_PRIV (child)->position += added - removed;
+
+      iter = next;
+    }
+
+  /* Keep a child around to measure the others with */
+  if (g_sequence_iter_is_end (g_sequence_get_begin_iter (priv->children)) &&
+      g_list_model_get_n_items (priv->bound_model) > 0)
+    gtk_flow_box_bind_item (box, 0, g_sequence_get_end_iter (priv->children));
+
+  gtk_widget_queue_resize (GTK_WIDGET (box));
+}
+
 static void
 gtk_flow_box_bound_model_changed (GListModel *list,
                                   guint       position,
@@ -4050,6 +4649,12 @@ gtk_flow_box_bound_model_changed (GListModel *list,
   GtkFlowBoxPrivate *priv = BOX_PRIV (box);
   gint i;
 
+  if (priv->bind_widget_func != NULL)
+    {
+      gtk_flow_box_recycled_model_changed (box, position, removed, added);
+      return;
+    }
+
   while (removed--)
     {
       GtkFlowBoxChild *child;
@@ -4107,10 +4712,11 @@ gtk_flow_box_insert_css_node (GtkFlowBox    *box,
                               GtkWidget     *child,
                               GSequenceIter *iter)
 {
-  GSequenceIter *prev_iter;
+  GSequenceIter *prev_iter, *next_iter;
   GtkWidget *sibling;
 
   prev_iter = g_sequence_iter_prev (iter);
+  next_iter = g_sequence_iter_next (iter);
 
   if (prev_iter != iter)
     {
@@ -4119,6 +4725,13 @@ gtk_flow_box_insert_css_node (GtkFlowBox    *box,
                                  gtk_widget_get_css_node (child),
                                  gtk_widget_get_css_node (sibling));
     }
+  else if (!g_sequence_iter_is_end (next_iter))
+    {
+      sibling = g_sequence_get (next_iter);
+      gtk_css_node_insert_before (gtk_widget_get_css_node (GTK_WIDGET (box)),
+                                  gtk_widget_get_css_node (child),
+                                  gtk_widget_get_css_node (sibling));
+    }
 }
 
 /**
@@ -4178,6 +4791,8 @@ gtk_flow_box_insert (GtkFlowBox *box,
   gtk_flow_box_insert_css_node (box, GTK_WIDGET (child), iter);
 
   CHILD_PRIV (child)->iter = iter;
+  if (priv->fixed_size_mode)
+    gtk_widget_set_child_visible (GTK_WIDGET (child), FALSE);
   gtk_widget_set_parent (GTK_WIDGET (child), GTK_WIDGET (box));
   gtk_flow_box_apply_filter (box, child);
 }
@@ -4189,6 +4804,9 @@ gtk_flow_box_insert (GtkFlowBox *box,
  *
  * Gets the nth child in the @box.
  *
+ * When @box recycles its children (see gtk_flow_box_bind_model_recycling()),
+ * %NULL is returned for items that currently have no child.
+ *
  * Returns: (transfer none): the child widget, which will
  *     always be a #GtkFlowBoxChild
  *
@@ -4202,6 +4820,19 @@ gtk_flow_box_get_child_at_index (GtkFlowBox *box,
 
   g_return_val_if_fail (GTK_IS_FLOW_BOX (box), NULL);
 
+  if (BOX_PRIV (box)->bind_widget_func != NULL)
+    {
+      if (idx < 0)
+        return NULL;
+
+      iter = gtk_flow_box_get_recycled_iter (box, idx);
+      if (!g_sequence_iter_is_end (iter) &&
+          CHILD_PRIV (g_sequence_get (iter))->position == (guint) idx)
+        return g_sequence_get (iter);
+
+      return NULL;
+    }
+
   iter = g_sequence_get_iter_at_pos (BOX_PRIV (box)->children, idx);
   if (iter)
     return g_sequence_get (iter);
@@ -4241,8 +4872,16 @@ gtk_flow_box_set_hadjustment (GtkFlowBox    *box,
 
   g_object_ref (adjustment);
   if (priv->hadjustment)
-    g_object_unref (priv->hadjustment);
+    {
+      g_signal_handlers_disconnect_by_func (priv->hadjustment,
+                                            gtk_flow_box_adjustment_value_changed, box);
+      g_object_unref (priv->hadjustment);
+    }
   priv->hadjustment = adjustment;
+  g_signal_connect (adjustment, "value-changed",
+                    G_CALLBACK (gtk_flow_box_adjustment_value_changed), box);
+  g_signal_connect (adjustment, "changed",
+                    G_CALLBACK (gtk_flow_box_adjustment_value_changed), box);
   gtk_container_set_focus_hadjustment (GTK_CONTAINER (box), adjustment);
 }
 
@@ -4278,8 +4917,16 @@ gtk_flow_box_set_vadjustment (GtkFlowBox    *box,
 
   g_object_ref (adjustment);
   if (priv->vadjustment)
-    g_object_unref (priv->vadjustment);
+    {
+      g_signal_handlers_disconnect_by_func (priv->vadjustment,
+                                            gtk_flow_box_adjustment_value_changed, box);
+      g_object_unref (priv->vadjustment);
+    }
   priv->vadjustment = adjustment;
+  g_signal_connect (adjustment, "value-changed",
+                    G_CALLBACK (gtk_flow_box_adjustment_value_changed), box);
+  g_signal_connect (adjustment, "changed",
+                    G_CALLBACK (gtk_flow_box_adjustment_value_changed), box);
   gtk_container_set_focus_vadjustment (GTK_CONTAINER (box), adjustment);
 }
 
@@ -4293,6 +4940,56 @@ gtk_flow_box_check_model_compat (GtkFlowBox *box)
     g_warning ("GtkFlowBox with a model will ignore sort and filter functions");
 }
 
+static void
+gtk_flow_box_set_bound_model (GtkFlowBox                 *box,
+                              GListModel                 *model,
+                              GtkFlowBoxCreateWidgetFunc  create_widget_func,
+                              GtkFlowBoxBindWidgetFunc    bind_widget_func,
+                              gpointer                    user_data,
+                              GDestroyNotify              user_data_free_func)
+{
+  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
+
+  if (priv->bound_model)
+    {
+      if (priv->create_widget_func_data_destroy)
+        priv->create_widget_func_data_destroy (priv->create_widget_func_data);
+
+      g_signal_handlers_disconnect_by_func (priv->bound_model, gtk_flow_box_bound_model_changed, box);
+      g_clear_object (&priv->bound_model);
+    }
+
+  priv->bind_widget_func = NULL;
+  gtk_flow_box_forall (GTK_CONTAINER (box), FALSE, (GtkCallback) gtk_widget_destroy, NULL);
+
+  /* Only undo the fixed size mode that recycling turned on */
+  if (priv->fixed_size_mode_forced)
+    gtk_flow_box_set_fixed_size_mode (box, FALSE);
+
+  if (model == NULL)
+    return;
+
+  priv->bound_model = g_object_ref (model);
+  priv->create_widget_func = create_widget_func;
+  priv->create_widget_func_data = user_data;
+  priv->create_widget_func_data_destroy = user_data_free_func;
+
+  gtk_flow_box_check_model_compat (box);
+
+  if (bind_widget_func != NULL)
+    {
+      priv->bind_widget_func = bind_widget_func;
+      if (!priv->fixed_size_mode)
+        {
+          gtk_flow_box_set_fixed_size_mode (box, TRUE);
+          priv->fixed_size_mode_forced = TRUE;
+        }
+    }
+
+  g_signal_connect (priv->bound_model, "items-changed", G_CALLBACK (gtk_flow_box_bound_model_changed), box);
+  gtk_flow_box_bound_model_changed (model, 0, 0, g_list_model_get_n_items (model), box);
+}
+
 /**
  * gtk_flow_box_bind_model:
  * @box: a #GtkFlowBox
@@ -4327,35 +5024,58 @@ gtk_flow_box_bind_model (GtkFlowBox                 *box,
                          gpointer                    user_data,
                          GDestroyNotify              user_data_free_func)
 {
-  GtkFlowBoxPrivate *priv = BOX_PRIV (box);
-
   g_return_if_fail (GTK_IS_FLOW_BOX (box));
   g_return_if_fail (model == NULL || G_IS_LIST_MODEL (model));
   g_return_if_fail (model == NULL || create_widget_func != NULL);
 
-  if (priv->bound_model)
-    {
-      if (priv->create_widget_func_data_destroy)
-        priv->create_widget_func_data_destroy (priv->create_widget_func_data);
-
-      g_signal_handlers_disconnect_by_func (priv->bound_model, gtk_flow_box_bound_model_changed, box);
-      g_clear_object (&priv->bound_model);
-    }
-
-  gtk_flow_box_forall (GTK_CONTAINER (box), FALSE, (GtkCallback) gtk_widget_destroy, NULL);
-
-  if (model == NULL)
-    return;
-
-  priv->bound_model = g_object_ref (model);
-  priv->create_widget_func = create_widget_func;
-  priv->create_widget_func_data = user_data;
-  priv->create_widget_func_data_destroy = user_data_free_func;
+  gtk_flow_box_set_bound_model (box, model, create_widget_func, NULL,
+                                user_data, user_data_free_func);
+}
 
-  gtk_flow_box_check_model_compat (box);
+/**
+ * gtk_flow_box_bind_model_recycling:
+ * @box: a #GtkFlowBox
+ * @model: (allow-none): the #GListModel to be bound to @box
+ * @create_widget_func: a function that creates widgets for items
+ * @bind_widget_func: a function that makes widgets represent other items
+ * @user_data: user data passed to @create_widget_func and @bind_widget_func
+ * @user_data_free_func: function for freeing @user_data
+ *
+ * Binds @model to @box like gtk_flow_box_bind_model(), but only creates
+ * widgets for the items on the lines that are in or near the visible
+ * part of @box. When @box is scrolled, widgets that go out of view are
+ * handed to @bind_widget_func to represent the items that come into
+ * view instead, so the number of widgets does not depend on the size
+ * of @model.
+ *
+ * All children must have the same size, and @box is switched to fixed
+ * size mode while @model is bound, see gtk_flow_box_set_fixed_size_mode().
+ * For the visible
+ * part to be known, the adjustment that scrolls across the lines must
+ * be set with gtk_flow_box_set_vadjustment() (or
+ * gtk_flow_box_set_hadjustment() for vertical flow boxes); otherwise,
+ * every item gets a widget.
+ *
+ * Only items that have a widget can be retrieved or selected. Selected
+ * children and the cursor child keep their widgets while out of view.
+ *
+ * Since: 3.20
+ */
+void
+gtk_flow_box_bind_model_recycling (GtkFlowBox                 *box,
+                                   GListModel                 *model,
+                                   GtkFlowBoxCreateWidgetFunc  create_widget_func,
+                                   GtkFlowBoxBindWidgetFunc    bind_widget_func,
+                                   gpointer                    user_data,
+                                   GDestroyNotify              user_data_free_func)
+{
+  g_return_if_fail (GTK_IS_FLOW_BOX (box));
+  g_return_if_fail (model == NULL || G_IS_LIST_MODEL (model));
+  g_return_if_fail (model == NULL || create_widget_func != NULL);
+  g_return_if_fail (model == NULL || bind_widget_func != NULL);
 
-  g_signal_connect (priv->bound_model, "items-changed", G_CALLBACK (gtk_flow_box_bound_model_changed), box);
-  gtk_flow_box_bound_model_changed (model, 0, 0, g_list_model_get_n_items (model), box);
+  gtk_flow_box_set_bound_model (box, model, create_widget_func, bind_widget_func,
+                                user_data, user_data_free_func);
 }
 
 /* Setters and getters {{{2 */
@@ -4408,6 +5128,76 @@ gtk_flow_box_set_homogeneous (GtkFlowBox *box,
     }
 }
 
+/**
+ * gtk_flow_box_set_fixed_size_mode:
+ * @box: a #GtkFlowBox
+ * @enable: %TRUE to enable fixed size mode
+ *
+ * Enables or disables the fixed size mode of @box. Fixed size mode
+ * speeds up #GtkFlowBox by assuming that all children have the same
+ * size as the first visible child. Only that child is measured, the
+ * lines are laid out as in homogeneous mode, and when @box is scrolled
+ * by the adjustments set with gtk_flow_box_set_hadjustment() and
+ * gtk_flow_box_set_vadjustment(), only the children in and around the
+ * visible lines are mapped and allocated.
+ *
+ * Since: 3.20
+ */
+void
+gtk_flow_box_set_fixed_size_mode (GtkFlowBox *box,
+                                  gboolean    enable)
+{
+  GtkFlowBoxPrivate *priv;
+  GSequenceIter *iter;
+  GtkFlowBoxChild *child;
+
+  g_return_if_fail (GTK_IS_FLOW_BOX (box));
+
+  priv = BOX_PRIV (box);
+  enable = enable != FALSE;
+
+  priv->fixed_size_mode_forced = FALSE;
+
+  if (priv->fixed_size_mode == enable)
+    return;
+
+  priv->fixed_size_mode = enable;
+
+  if (!enable)
+    {
+      /* Show the children that were left out of the view again */
+      for (iter = g_sequence_get_begin_iter (priv->children);
+           !g_sequence_iter_is_end (iter);
+           iter = g_sequence_iter_next (iter))
+        {
+          child = g_sequence_get (iter);
+          gtk_widget_set_child_visible (GTK_WIDGET (child), !CHILD_PRIV (child)->filtered);
+        }
+    }
+
+  gtk_widget_queue_resize (GTK_WIDGET (box));
+
+  g_object_notify_by_pspec (G_OBJECT (box), props[PROP_FIXED_SIZE_MODE]);
+}
+
+/**
+ * gtk_flow_box_get_fixed_size_mode:
+ * @box: a #GtkFlowBox
+ *
+ * Returns whether fixed size mode is turned on for @box.
+ *
+ * Returns: %TRUE if @box is in fixed size mode
+ *
+ * Since: 3.20
+ */
+gboolean
+gtk_flow_box_get_fixed_size_mode (GtkFlowBox *box)
+{
+  g_return_val_if_fail (GTK_IS_FLOW_BOX (box), FALSE);
+
+  return BOX_PRIV (box)->fixed_size_mode;
+}
+
 /**
  * gtk_flow_box_set_row_spacing:
  * @box: a #GtkFlowBox
@@ -5029,6 +5819,17 @@ gtk_flow_box_css_node_foreach (gpointer data,
   *previous = row;
 }
 
+static void
+gtk_flow_box_child_moved (GSequenceIter *iter,
+                          GSequenceIter *old_next,
+                          gpointer       data)
+{
+  GtkFlowBox *box = data;
+
+  gtk_flow_box_insert_css_node (box, g_sequence_get (iter), iter);
+  gtk_widget_queue_resize (GTK_WIDGET (box));
+}
+
 /**
  * gtk_flow_box_invalidate_sort:
  * @box: a #GtkFlowBox
@@ -5038,6 +5839,9 @@ gtk_flow_box_css_node_foreach (gpointer data,
  * Call this when the result of the sort function on
  * @box is changed due to an external factor.
  *
+ * Only the children that ended up out of order are moved,
+ * so this is cheap when few children changed.
+ *
  * Since: 3.12
  */
 void
@@ -5050,12 +5854,15 @@ gtk_flow_box_invalidate_sort (GtkFlowBox *box)
 
   priv = BOX_PRIV (box);
 
-  if (priv->sort_func != NULL)
-    {
-      g_sequence_sort (priv->children, (GCompareDataFunc)gtk_flow_box_sort, box);
-      g_sequence_foreach (priv->children, gtk_flow_box_css_node_foreach, &previous);
-      gtk_widget_queue_resize (GTK_WIDGET (box));
-    }
+  if (priv->sort_func == NULL)
+    return;
+
+  if (gtk_sequence_resort (priv->children, (GCompareDataFunc)gtk_flow_box_sort, box,
+                           gtk_flow_box_child_moved, box))
+    return;
+
+  g_sequence_foreach (priv->children, gtk_flow_box_css_node_foreach, &previous);
+  gtk_widget_queue_resize (GTK_WIDGET (box));
 }
 
 /* vim:set foldmethod=marker expandtab: */
@@ -114,6 +114,24 @@ struct _GtkFlowBoxChildClass
 typedef GtkWidget * (*GtkFlowBoxCreateWidgetFunc) (gpointer item,
                                                    gpointer  user_data);
 
+/**
+ * GtkFlowBoxBindWidgetFunc:
+ * @widget: a widget that was returned by the #GtkFlowBoxCreateWidgetFunc
+ * @item: (nullable): the item from the model that @widget should
+ *   represent from now on, or %NULL
+ * @user_data: user data from gtk_flow_box_bind_model_recycling()
+ *
+ * Called for flow boxes that are bound to a #GListModel with
+ * gtk_flow_box_bind_model_recycling() when a widget is reused for
+ * another item. @item is %NULL when @widget is put aside until it
+ * is needed again.
+ *
+ * Since: 3.20
+ */
+typedef void (*GtkFlowBoxBindWidgetFunc) (GtkWidget *widget,
+                                          gpointer   item,
+                                          gpointer   user_data);
+
 GDK_AVAILABLE_IN_3_12
 GType                 gtk_flow_box_child_get_type            (void) G_GNUC_CONST;
 GDK_AVAILABLE_IN_3_12
@@ -138,12 +156,24 @@ void                  gtk_flow_box_bind_model                (GtkFlowBox
                                                               GtkFlowBoxCreateWidgetFunc  create_widget_func,
                                                               gpointer                    user_data,
                                                               GDestroyNotify              user_data_free_func);
+GDK_AVAILABLE_IN_3_20
+void                  gtk_flow_box_bind_model_recycling      (GtkFlowBox                 *box,
+                                                              GListModel                 *model,
+                                                              GtkFlowBoxCreateWidgetFunc  create_widget_func,
+                                                              GtkFlowBoxBindWidgetFunc    bind_widget_func,
+                                                              gpointer                    user_data,
+                                                              GDestroyNotify              user_data_free_func);
 
 GDK_AVAILABLE_IN_3_12
 void                  gtk_flow_box_set_homogeneous           (GtkFlowBox           *box,
                                                               gboolean              homogeneous);
 GDK_AVAILABLE_IN_3_12
 gboolean              gtk_flow_box_get_homogeneous           (GtkFlowBox           *box);
+GDK_AVAILABLE_IN_3_20
+void                  gtk_flow_box_set_fixed_size_mode       (GtkFlowBox           *box,
+                                                              gboolean              enable);
+GDK_AVAILABLE_IN_3_20
+gboolean              gtk_flow_box_get_fixed_size_mode       (GtkFlowBox           *box);
 GDK_AVAILABLE_IN_3_12
 void                  gtk_flow_box_set_row_spacing           (GtkFlowBox           *box,
                                                               guint                 spacing);
@@ -58,6 +58,7 @@ typedef struct _GtkGridRowProperties GtkGridRowProperties;
 typedef struct _GtkGridLine GtkGridLine;
 typedef struct _GtkGridLines GtkGridLines;
 typedef struct _GtkGridLineData GtkGridLineData;
+typedef struct _GtkGridLineCache GtkGridLineCache;
 typedef struct _GtkGridRequest GtkGridRequest;
 
 struct _GtkGridChildAttach
@@ -97,6 +98,16 @@ struct _GtkGridLineData
   guint homogeneous : 1;
 };
 
+/* A GtkGridLineCache keeps the sizes of rows or columns as
+ * requested by their non-spanning children, so that only lines
+ * with a child that queued a resize need to be measured again.
+ */
+struct _GtkGridLineCache
+{
+  GtkGridLine *lines;
+  gint min, max;
+};
+
 struct _GtkGridPrivate
 {
   GList *children;
@@ -106,6 +117,7 @@ struct _GtkGridPrivate
   gint baseline_row;
 
   GtkGridLineData linedata[2];
+  GtkGridLineCache line_cache[2];
 };
 
 #define ROWS(priv)    (&(priv)->linedata[GTK_ORIENTATION_HORIZONTAL])
@@ -177,6 +189,7 @@ G_DEFINE_TYPE_WITH_CODE (GtkGrid, gtk_grid, GTK_TYPE_CONTAINER,
 
 
 static void gtk_grid_row_properties_free (GtkGridRowProperties *props);
+static void gtk_grid_invalidate_line_cache (GtkGrid *grid);
 
 static void
 gtk_grid_get_property (GObject    *object,
@@ -376,6 +389,8 @@ gtk_grid_set_child_property (GtkContainer *container,
       break;
     }
 
+  gtk_grid_invalidate_line_cache (grid);
+
   if (_gtk_widget_get_visible (child) &&
       _gtk_widget_get_visible (GTK_WIDGET (grid)))
     gtk_widget_queue_resize (child);
@@ -412,6 +427,7 @@ gtk_grid_finalize (GObject *object)
   GtkGridPrivate *priv = grid->priv;
 
   g_list_free_full (priv->row_properties, (GDestroyNotify)gtk_grid_row_properties_free);
+  gtk_grid_invalidate_line_cache (grid);
 
   G_OBJECT_CLASS (gtk_grid_parent_class)->finalize (object);
 }
@@ -435,6 +451,7 @@ grid_attach (GtkGrid   *grid,
   CHILD_HEIGHT (child) = height;
 
   priv->children = g_list_prepend (priv->children, child);
+  gtk_grid_invalidate_line_cache (grid);
 
   gtk_widget_set_parent (widget, GTK_WIDGET (grid));
 }
@@ -525,6 +542,7 @@ gtk_grid_remove (GtkContainer *container,
           gtk_widget_unparent (child);
 
           priv->children = g_list_remove (priv->children, grid_child);
+          gtk_grid_invalidate_line_cache (grid);
 
           g_slice_free (GtkGridChild, grid_child);
 
@@ -703,6 +721,103 @@ compute_request_for_child (GtkGridRequest *request,
     }
 }
 
+static void
+gtk_grid_invalidate_line_cache (GtkGrid *grid)
+{
+  GtkGridPrivate *priv = grid->priv;
+  gint i;
+
+  for (i = 0; i < 2; i++)
+    {
+      g_free (priv->line_cache[i].lines);
+      priv->line_cache[i].lines = NULL;
+    }
+}
+
+/* Restores the sizes of lines from the cache, unless one of their
+ * non-spanning children queued a resize since they were computed.
+ * Returns the lines that need to be measured again, or %NULL if
+ * all of them do.
+ */
+static gboolean *
+gtk_grid_request_non_spanning_cached (GtkGridRequest *request,
+                                      GtkOrientation  orientation)
+{
+  GtkGridPrivate *priv = request->grid->priv;
+  GtkGridLineCache *cache;
+  GtkGridChild *child;
+  GtkGridChildAttach *attach;
+  GtkGridLines *lines;
+  GtkGridLine *line;
+  gboolean *dirty;
+  GList *list;
+  gint i;
+
+  cache = &priv->line_cache[orientation];
+  lines = &request->lines[orientation];
+
+  if (cache->lines == NULL ||
+      cache->min != lines->min ||
+      cache->max != lines->max)
+    return NULL;
+
+  dirty = g_new0 (gboolean, lines->max - lines->min);
+
+  /* Hidden children are included too, a child that was just
+   * hidden has to be removed from the size of its line.
+   */
+  for (list = priv->children; list; list = list->next)
+    {
+      child = list->data;
+
+      attach = &child->attach[orientation];
+      if (attach->span != 1)
+        continue;
+
+      if (_gtk_widget_get_alloc_needed (child->widget))
+        dirty[attach->pos - lines->min] = TRUE;
+    }
+
+  for (i = 0; i < lines->max - lines->min; i++)
+    {
+      if (dirty[i])
+        continue;
+
+      line = &lines->lines[i];
+      line->minimum = cache->lines[i].minimum;
+      line->natural = cache->lines[i].natural;
+      line->minimum_above = cache->lines[i].minimum_above;
+      line->minimum_below = cache->lines[i].minimum_below;
+      line->natural_above = cache->lines[i].natural_above;
+      line->natural_below = cache->lines[i].natural_below;
+    }
+
+  return dirty;
+}
+
+static void
+gtk_grid_request_non_spanning_commit (GtkGridRequest *request,
+                                      GtkOrientation  orientation)
+{
+  GtkGridPrivate *priv = request->grid->priv;
+  GtkGridLineCache *cache;
+  GtkGridLines *lines;
+
+  cache = &priv->line_cache[orientation];
+  lines = &request->lines[orientation];
+
+  if (cache->lines == NULL ||
+      cache->max - cache->min != lines->max - lines->min)
+    {
+      g_free (cache->lines);
+      cache->lines = g_new (GtkGridLine, lines->max - lines->min);
+    }
+
+  cache->min = lines->min;
+  cache->max = lines->max;
+  memcpy (cache->lines, lines->lines, sizeof (GtkGridLine) * (lines->max - lines->min));
+}
+
 /* Sets requisition to max. of non-spanning children.
  * If contextual is TRUE, requires allocations of
  * lines in the opposite orientation to be set.
@@ -722,9 +837,15 @@ gtk_grid_request_non_spanning (GtkGridRequest *request,
   GtkBaselinePosition baseline_pos;
   gint minimum, minimum_baseline;
   gint natural, natural_baseline;
+  gboolean *dirty;
 
   lines = &request->lines[orientation];
 
+  /* The sizes of the children for a given size of the grid
+   * can't be cached here, they depend on the allocation.
+   */
+  dirty = contextual ? NULL : gtk_grid_request_non_spanning_cached (request, orientation);
+
   for (list = priv->children; list; list = list->next)
     {
       child = list->data;
@@ -736,6 +857,9 @@ gtk_grid_request_non_spanning (GtkGridRequest *request,
       if (attach->span != 1)
         continue;
 
+      if (dirty && !dirty[attach->pos - lines->min])
+        continue;
+
       compute_request_for_child (request, child, orientation, contextual, &minimum, &natural, &minimum_baseline, &natural_baseline);
 
       line = &lines->lines[attach->pos - lines->min];
@@ -754,6 +878,10 @@ gtk_grid_request_non_spanning (GtkGridRequest *request,
 	}
     }
 
+  g_free (dirty);
+  if (!contextual)
+    gtk_grid_request_non_spanning_commit (request, orientation);
+
   for (i = 0; i < lines->max - lines->min; i++)
     {
       line = &lines->lines[i];
@@ -1801,6 +1929,8 @@ gtk_grid_class_init (GtkGridClass *class)
                       GTK_PARAM_READWRITE);
 
   gtk_container_class_install_child_properties (container_class, N_CHILD_PROPERTIES, child_properties);
+
+  gtk_widget_class_set_plain_draw (widget_class);
 }
 
 /**
@@ -2007,6 +2137,7 @@ gtk_grid_insert_row (GtkGrid *grid,
   g_return_if_fail (GTK_IS_GRID (grid));
 
   priv = grid->priv;
+  gtk_grid_invalidate_line_cache (grid);
 
   for (list = priv->children; list; list = list->next)
     {
@@ -2116,6 +2247,7 @@ gtk_grid_insert_column (GtkGrid *grid,
   g_return_if_fail (GTK_IS_GRID (grid));
 
   priv = grid->priv;
+  gtk_grid_invalidate_line_cache (grid);
 
   for (list = priv->children; list; list = list->next)
     {
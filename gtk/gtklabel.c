@@ -261,6 +261,13 @@ struct _GtkLabelPrivate
   gint     width_chars;
   gint     max_width_chars;
   gint     lines;
+
+  /* Result of the last gtk_label_get_preferred_layout_size(),
+   * valid while the layout's serial is unchanged.
+   */
+  guint          layout_size_serial;
+  PangoRectangle layout_size_smallest;
+  PangoRectangle layout_size_widest;
 };
 
 /* Notes about the handling of links:
@@ -3044,6 +3051,7 @@ gtk_label_set_width_chars (GtkLabel *label,
   if (priv->width_chars != n_chars)
     {
       priv->width_chars = n_chars;
+      priv->layout_size_serial = 0;
       g_object_notify_by_pspec (G_OBJECT (label), label_props[PROP_WIDTH_CHARS]);
       gtk_widget_queue_resize (GTK_WIDGET (label));
     }
@@ -3090,6 +3098,7 @@ gtk_label_set_max_width_chars (GtkLabel *label,
   if (priv->max_width_chars != n_chars)
     {
       priv->max_width_chars = n_chars;
+      priv->layout_size_serial = 0;
 
       g_object_notify_by_pspec (G_OBJECT (label), label_props[PROP_MAX_WIDTH_CHARS]);
       gtk_widget_queue_resize (GTK_WIDGET (label));
@@ -3264,6 +3273,8 @@ gtk_label_clear_layout (GtkLabel *label)
       g_object_unref (priv->layout);
       priv->layout = NULL;
     }
+
+  priv->layout_size_serial = 0;
 }
 
 /**
@@ -3665,6 +3676,19 @@ gtk_label_get_preferred_layout_size (GtkLabel *label,
    *    width will default to the wrap guess that gtk_label_ensure_layout() does.
    */
 
+  /* The sizes only depend on the layout, so they can be shared between
+   * the horizontal and vertical requests, which would otherwise each
+   * shape the text again.
+   */
+  gtk_label_ensure_layout (label);
+  if (priv->layout_size_serial != 0 &&
+      priv->layout_size_serial == pango_layout_get_serial (priv->layout))
+    {
+      *smallest = priv->layout_size_smallest;
+      *widest = priv->layout_size_widest;
+      return;
+    }
+
   /* Start off with the pixel extents of an as-wide-as-possible layout */
   layout = gtk_label_get_measuring_layout (label, NULL, -1);
 
@@ -3708,6 +3732,10 @@ gtk_label_get_preferred_layout_size (GtkLabel *label,
     *smallest = *widest;
 
   g_object_unref (layout);
+
+  priv->layout_size_smallest = *smallest;
+  priv->layout_size_widest = *widest;
+  priv->layout_size_serial = pango_layout_get_serial (priv->layout);
 }
 
 static void
@@ -0,0 +1,318 @@
+/* GTK - The GIMP Toolkit
+ * Copyright (C) 2015 The GTK+ Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtklayouttraceprivate.h"
+
+#include "gtkdebug.h"
+
+#include <stdlib.h>
+#include <string.h>
+#ifdef HAVE_EXECINFO_H
+#include <execinfo.h>
+#endif
+
+/* Keeps track of what causes size negotiation, so that widgets
+ * which keep invalidating the layout can be found. Tracing is active
+ * while GTK_DEBUG=resize is set or the inspector is recording; all
+ * entry points return right away otherwise.
+ *
+ * A resize is traced from the widget it was queued on (the origin)
+ * through every ancestor it invalidated, up to the toplevel or the
+ * relayout boundary that absorbed it. The layout phase that follows
+ * is summarized with the number of measurements and allocations it
+ * took.
+ */
+
+#define MAX_BACKTRACE_FRAMES 24
+
+gboolean gtk_layout_trace_enabled = FALSE;
+
+static gboolean recording;
+static GHashTable *widget_stats;
+
+static struct {
+  guint      depth;
+  gchar     *origin_name;
+  gchar     *backtrace;
+  GtkWidget *last;
+  GString   *chain;
+} current_resize;
+
+static struct {
+  guint   depth;
+  guint   n_measured;
+  guint   n_cache_hits;
+  guint   n_allocated;
+  gint64  start_time;
+} current_layout;
+
+/* Called whenever the recording state or the debug flags change */
+void
+gtk_layout_trace_update_enabled (void)
+{
+  gtk_layout_trace_enabled = recording || GTK_DEBUG_CHECK (RESIZE);
+}
+
+gboolean
+gtk_layout_trace_get_recording (void)
+{
+  return recording;
+}
+
+void
+gtk_layout_trace_set_recording (gboolean value)
+{
+  recording = value;
+  gtk_layout_trace_update_enabled ();
+}
+
+static void
+stats_free (gpointer data)
+{
+  GtkLayoutTraceStats *stats = data;
+
+  g_free (stats->last_origin);
+  g_free (stats->last_backtrace);
+  g_slice_free (GtkLayoutTraceStats, stats);
+}
+
+static void
+widget_finalized (gpointer  data,
+                  GObject  *where_the_object_was)
+{
+  g_hash_table_remove (widget_stats, where_the_object_was);
+}
+
+static GtkLayoutTraceStats *
+get_stats (GtkWidget *widget)
+{
+  GtkLayoutTraceStats *stats;
+
+  if (widget_stats == NULL)
+    widget_stats = g_hash_table_new_full (NULL, NULL, NULL, stats_free);
+
+  stats = g_hash_table_lookup (widget_stats, widget);
+  if (stats == NULL)
+    {
+      stats = g_slice_new0 (GtkLayoutTraceStats);
+      g_hash_table_insert (widget_stats, widget, stats);
+      g_object_weak_ref (G_OBJECT (widget), widget_finalized, NULL);
+    }
+
+  return stats;
+}
+
+void
+gtk_layout_trace_reset (void)
+{
+  GHashTableIter iter;
+  gpointer widget;
+
+  if (widget_stats == NULL)
+    return;
+
+  g_hash_table_iter_init (&iter, widget_stats);
+  while (g_hash_table_iter_next (&iter, &widget, NULL))
+    g_object_weak_unref (G_OBJECT (widget), widget_finalized, NULL);
+
+  g_hash_table_remove_all (widget_stats);
+}
+
+void
+gtk_layout_trace_foreach (GtkLayoutTraceFunc func,
+                          gpointer           user_data)
+{
+  GHashTableIter iter;
+  gpointer widget, stats;
+
+  if (widget_stats == NULL)
+    return;
+
+  g_hash_table_iter_init (&iter, widget_stats);
+  while (g_hash_table_iter_next (&iter, &widget, &stats))
+    func (widget, stats, user_data);
+}
+
+static gchar *
+get_backtrace (void)
+{
+#ifdef HAVE_EXECINFO_H
+  gpointer frames[MAX_BACKTRACE_FRAMES];
+  gchar **symbols;
+  GString *string;
+  gint n_frames, i;
+
+  n_frames = backtrace (frames, G_N_ELEMENTS (frames));
+  symbols = backtrace_symbols (frames, n_frames);
+  if (symbols == NULL)
+    return NULL;
+
+  string = g_string_new (NULL);
+
+  /* Skip ourselves and gtk_layout_trace_begin_resize() */
+  for (i = 2; i < n_frames; i++)
+    g_string_append_printf (string, "  %s\n", symbols[i]);
+
+  free (symbols);
+
+  return g_string_free (string, FALSE);
+#else
+  return NULL;
+#endif
+}
+
+void
+gtk_layout_trace_begin_resize (GtkWidget *widget)
+{
+  GtkLayoutTraceStats *stats;
+
+  if (!GTK_LAYOUT_TRACE_IS_ENABLED ())
+    return;
+
+  /* Resizes queued while tracing another one, e.g. from size groups,
+   * are attributed to the outermost origin.
+   */
+  if (current_resize.depth++ > 0)
+    return;
+
+  current_resize.origin_name = g_strdup_printf ("%s %p", G_OBJECT_TYPE_NAME (widget), widget);
+  current_resize.backtrace = get_backtrace ();
+  current_resize.last = NULL;
+  current_resize.chain = g_string_new (NULL);
+
+  stats = get_stats (widget);
+  stats->n_queued++;
+  g_free (stats->last_backtrace);
+  stats->last_backtrace = g_strdup (current_resize.backtrace);
+}
+
+void
+gtk_layout_trace_end_resize (GtkWidget *widget)
+{
+  if (current_resize.depth == 0)
+    return;
+
+  if (--current_resize.depth > 0)
+    return;
+
+  GTK_NOTE (RESIZE,
+            g_print ("Resize queued on %s, invalidating %s\n%s",
+                     current_resize.origin_name,
+                     current_resize.chain->len > 0 ? current_resize.chain->str : "nothing",
+                     current_resize.backtrace ? current_resize.backtrace : ""));
+
+  g_free (current_resize.origin_name);
+  g_free (current_resize.backtrace);
+  g_string_free (current_resize.chain, TRUE);
+  memset (&current_resize, 0, sizeof (current_resize));
+}
+
+void
+gtk_layout_trace_invalidated (GtkWidget *widget)
+{
+  GtkLayoutTraceStats *stats;
+
+  if (!GTK_LAYOUT_TRACE_IS_ENABLED ())
+    return;
+
+  if (widget == current_resize.last)
+    return;
+
+  stats = get_stats (widget);
+  stats->n_invalidated++;
+
+  if (current_resize.depth > 0)
+    {
+      current_resize.last = widget;
+
+      g_free (stats->last_origin);
+      stats->last_origin = g_strdup (current_resize.origin_name);
+
+      if (current_resize.chain->len > 0)
+        g_string_append (current_resize.chain, " → ");
+      g_string_append_printf (current_resize.chain, "%s %p", G_OBJECT_TYPE_NAME (widget), widget);
+    }
+}
+
+void
+gtk_layout_trace_measured (GtkWidget *widget,
+                           gboolean   cache_hit,
+                           gint64     time)
+{
+  GtkLayoutTraceStats *stats;
+
+  stats = get_stats (widget);
+
+  if (cache_hit)
+    {
+      stats->n_cache_hits++;
+      current_layout.n_cache_hits++;
+    }
+  else
+    {
+      stats->n_measured++;
+      stats->measure_time += time;
+      current_layout.n_measured++;
+    }
+}
+
+void
+gtk_layout_trace_allocated (GtkWidget *widget,
+                            gint64     time)
+{
+  GtkLayoutTraceStats *stats;
+
+  stats = get_stats (widget);
+  stats->n_allocated++;
+  stats->allocate_time += time;
+  current_layout.n_allocated++;
+}
+
+void
+gtk_layout_trace_begin_layout (GtkWidget *toplevel)
+{
+  if (!GTK_LAYOUT_TRACE_IS_ENABLED ())
+    return;
+
+  if (current_layout.depth++ > 0)
+    return;
+
+  current_layout.n_measured = 0;
+  current_layout.n_cache_hits = 0;
+  current_layout.n_allocated = 0;
+  current_layout.start_time = g_get_monotonic_time ();
+}
+
+void
+gtk_layout_trace_end_layout (GtkWidget *toplevel)
+{
+  if (current_layout.depth == 0)
+    return;
+
+  if (--current_layout.depth > 0)
+    return;
+
+  GTK_NOTE (RESIZE,
+            g_print ("Layout of %s %p: %u measured, %u cached, %u allocated in %.3f ms\n",
+                     G_OBJECT_TYPE_NAME (toplevel), toplevel,
+                     current_layout.n_measured,
+                     current_layout.n_cache_hits,
+                     current_layout.n_allocated,
+                     (g_get_monotonic_time () - current_layout.start_time) / 1000.0));
+}
@@ -0,0 +1,71 @@
+/* GTK - The GIMP Toolkit
+ * Copyright (C) 2015 The GTK+ Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GTK_LAYOUT_TRACE_PRIVATE_H__
+#define __GTK_LAYOUT_TRACE_PRIVATE_H__
+
+#include <gtk/gtkwidget.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GtkLayoutTraceStats GtkLayoutTraceStats;
+
+struct _GtkLayoutTraceStats
+{
+  guint   n_queued;        /* resizes queued on this widget */
+  guint   n_invalidated;   /* resizes that invalidated this widget */
+  guint   n_measured;      /* size requests that missed the cache */
+  guint   n_cache_hits;    /* size requests answered from the cache */
+  guint   n_allocated;     /* size allocations that reached the class */
+  gint64  measure_time;    /* in µs, including children */
+  gint64  allocate_time;   /* in µs, including children */
+  gchar  *last_origin;     /* widget whose resize last invalidated this one */
+  gchar  *last_backtrace;  /* where the last resize on this widget was queued */
+};
+
+typedef void (* GtkLayoutTraceFunc) (GtkWidget                 *widget,
+                                     const GtkLayoutTraceStats *stats,
+                                     gpointer                   user_data);
+
+/* Tested inline on the size negotiation paths, so that the trace
+ * functions are only called while tracing is on.
+ */
+extern gboolean gtk_layout_trace_enabled;
+
+#define GTK_LAYOUT_TRACE_IS_ENABLED() G_UNLIKELY (gtk_layout_trace_enabled)
+
+void     gtk_layout_trace_update_enabled (void);
+gboolean gtk_layout_trace_get_recording (void);
+void     gtk_layout_trace_set_recording (gboolean            recording);
+void     gtk_layout_trace_reset         (void);
+void     gtk_layout_trace_foreach       (GtkLayoutTraceFunc  func,
+                                         gpointer            user_data);
+
+void     gtk_layout_trace_begin_resize  (GtkWidget          *widget);
+void     gtk_layout_trace_end_resize    (GtkWidget          *widget);
+void     gtk_layout_trace_invalidated   (GtkWidget          *widget);
+void     gtk_layout_trace_measured      (GtkWidget          *widget,
+                                         gboolean            cache_hit,
+                                         gint64              time);
+void     gtk_layout_trace_allocated     (GtkWidget          *widget,
+                                         gint64              time);
+void     gtk_layout_trace_begin_layout  (GtkWidget          *toplevel);
+void     gtk_layout_trace_end_layout    (GtkWidget          *toplevel);
+
+G_END_DECLS
+
+#endif /* __GTK_LAYOUT_TRACE_PRIVATE_H__ */
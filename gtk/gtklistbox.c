@@ -24,6 +24,7 @@
 #include "gtkmarshalers.h"
 #include "gtkprivate.h"
 #include "gtkintl.h"
+#include "gtksequenceprivate.h"
 #include "gtkwidgetprivate.h"
 
 #include <float.h>
@@ -101,10 +102,20 @@ typedef struct
   int n_visible_rows;
   gboolean in_widget;
 
+  gboolean fixed_height_mode;
+  gboolean fixed_height_mode_forced;
+  gint view_top;
+  gint view_bottom;
+  gint bound_width;
+
   GListModel *bound_model;
   GtkListBoxCreateWidgetFunc create_widget_func;
+  GtkListBoxBindWidgetFunc bind_widget_func;
   gpointer create_widget_func_data;
   GDestroyNotify create_widget_func_data_destroy;
+
+  /* Rows that are not bound to an item, when recycling */
+  GQueue recycled_rows;
 } GtkListBoxPrivate;
 
 typedef struct
@@ -113,7 +124,10 @@ typedef struct
   GtkWidget *header;
   gint y;
   gint height;
+  guint position;
   guint visible     :1;
+  guint filtered    :1;
+  guint wrapped     :1;
   guint selected    :1;
   guint activatable :1;
   guint selectable  :1;
@@ -140,6 +154,7 @@ enum {
   PROP_0,
   PROP_SELECTION_MODE,
   PROP_ACTIVATE_ON_SINGLE_CLICK,
+  PROP_FIXED_HEIGHT_MODE,
   LAST_PROPERTY
 };
 
@@ -161,12 +176,12 @@ G_DEFINE_TYPE_WITH_CODE (GtkListBox, gtk_list_box, GTK_TYPE_CONTAINER,
                                                 gtk_list_box_buildable_interface_init))
 G_DEFINE_TYPE_WITH_PRIVATE (GtkListBoxRow, gtk_list_box_row, GTK_TYPE_BIN)
 
-static void                 gtk_list_box_apply_filter_all             (GtkListBox          *box);
+static gboolean             gtk_list_box_apply_filter_all             (GtkListBox          *box);
 static void                 gtk_list_box_update_header                (GtkListBox          *box,
                                                                        GSequenceIter       *iter);
 static GSequenceIter *      gtk_list_box_get_next_visible             (GtkListBox          *box,
                                                                        GSequenceIter       *iter);
-static void                 gtk_list_box_apply_filter                 (GtkListBox          *box,
+static gboolean             gtk_list_box_apply_filter                 (GtkListBox          *box,
                                                                        GtkListBoxRow       *row);
 static void                 gtk_list_box_add_move_binding             (GtkBindingSet       *binding_set,
                                                                        guint                keyval,
@@ -273,6 +288,15 @@ static void                 gtk_list_box_bound_model_changed            (GListMo
                                                                          gpointer             user_data);
 
 static void                 gtk_list_box_check_model_compat             (GtkListBox          *box);
+static GSequenceIter *      gtk_list_box_get_recycled_iter              (GtkListBox          *box,
+                                                                         guint                position);
+static void                 gtk_list_box_bind_view                      (GtkListBox          *box,
+                                                                         gint                 width);
+static void                 gtk_list_box_insert_css_node                (GtkListBox          *box,
+                                                                         GtkWidget           *child,
+                                                                         GSequenceIter       *iter);
+static void                 gtk_list_box_adjustment_value_changed       (GtkAdjustment       *adjustment,
+                                                                         GtkListBox          *box);
 static GParamSpec *properties[LAST_PROPERTY] = { NULL, };
 static guint signals[LAST_SIGNAL] = { 0 };
 static GParamSpec *row_properties[LAST_ROW_PROPERTY] = { NULL, };
@@ -340,6 +364,9 @@ gtk_list_box_get_property (GObject    *obj,
     case PROP_ACTIVATE_ON_SINGLE_CLICK:
       g_value_set_boolean (value, priv->activate_single_click);
       break;
+    case PROP_FIXED_HEIGHT_MODE:
+      g_value_set_boolean (value, priv->fixed_height_mode);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, property_id, pspec);
       break;
@@ -362,6 +389,9 @@ gtk_list_box_set_property (GObject      *obj,
     case PROP_ACTIVATE_ON_SINGLE_CLICK:
       gtk_list_box_set_activate_on_single_click (box, g_value_get_boolean (value));
       break;
+    case PROP_FIXED_HEIGHT_MODE:
+      gtk_list_box_set_fixed_height_mode (box, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, property_id, pspec);
       break;
@@ -380,6 +410,8 @@ gtk_list_box_finalize (GObject *obj)
   if (priv->update_header_func_target_destroy_notify != NULL)
     priv->update_header_func_target_destroy_notify (priv->update_header_func_target);
 
+  if (priv->adjustment)
+    g_signal_handlers_disconnect_by_func (priv->adjustment, gtk_list_box_adjustment_value_changed, obj);
   g_clear_object (&priv->adjustment);
   g_clear_object (&priv->drag_highlighted_row);
   g_clear_object (&priv->multipress_gesture);
@@ -454,6 +486,22 @@ gtk_list_box_class_init (GtkListBoxClass *klass)
                           TRUE,
                           G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
 
+  /**
+   * GtkListBox:fixed-height-mode:
+   *
+   * Setting the ::fixed-height-mode property to %TRUE speeds up
+   * #GtkListBox by assuming that all rows have the same size as
+   * the first visible one. See gtk_list_box_set_fixed_height_mode().
+   *
+   * Since: 3.20
+   */
+  properties[PROP_FIXED_HEIGHT_MODE] =
+    g_param_spec_boolean ("fixed-height-mode",
+                          P_("Fixed Height Mode"),
+                          P_("Speeds up GtkListBox by assuming that all rows have the same size"),
+                          FALSE,
+                          G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
+
   g_object_class_install_properties (object_class, LAST_PROPERTY, properties);
 
   /**
@@ -618,6 +666,8 @@ gtk_list_box_class_init (GtkListBoxClass *klass)
                                 "select-all", 0);
   gtk_binding_entry_add_signal (binding_set, GDK_KEY_a, GDK_CONTROL_MASK | GDK_SHIFT_MASK,
                                 "unselect-all", 0);
+
+  gtk_widget_class_set_plain_draw (widget_class);
 }
 
 /**
@@ -651,6 +701,9 @@ gtk_list_box_get_selected_row (GtkListBox *box)
  * If @_index is negative or larger than the number of items in the
  * list, %NULL is returned.
  *
+ * When @box recycles its rows (see gtk_list_box_bind_model_recycling()),
+ * %NULL is also returned for items that currently have no row.
+ *
  * Returns: (transfer none): the child #GtkWidget or %NULL
  *
  * Since: 3.10
@@ -663,6 +716,19 @@ gtk_list_box_get_row_at_index (GtkListBox *box,
 
   g_return_val_if_fail (GTK_IS_LIST_BOX (box), NULL);
 
+  if (BOX_PRIV (box)->bind_widget_func != NULL)
+    {
+      if (index_ < 0)
+        return NULL;
+
+      iter = gtk_list_box_get_recycled_iter (box, index_);
+      if (!g_sequence_iter_is_end (iter) &&
+          ROW_PRIV (g_sequence_get (iter))->position == (guint) index_)
+        return g_sequence_get (iter);
+
+      return NULL;
+    }
+
   iter = g_sequence_get_iter_at_pos (BOX_PRIV (box)->children, index_);
   if (!g_sequence_iter_is_end (iter))
     return g_sequence_get (iter);
@@ -953,9 +1019,19 @@ gtk_list_box_set_adjustment (GtkListBox    *box,
   g_return_if_fail (adjustment == NULL || GTK_IS_ADJUSTMENT (adjustment));
 
   if (adjustment)
-    g_object_ref_sink (adjustment);
+    {
+      g_object_ref_sink (adjustment);
+      g_signal_connect (adjustment, "value-changed",
+                        G_CALLBACK (gtk_list_box_adjustment_value_changed), box);
+      g_signal_connect (adjustment, "changed",
+                        G_CALLBACK (gtk_list_box_adjustment_value_changed), box);
+    }
   if (priv->adjustment)
-    g_object_unref (priv->adjustment);
+    {
+      g_signal_handlers_disconnect_by_func (priv->adjustment,
+                                            gtk_list_box_adjustment_value_changed, box);
+      g_object_unref (priv->adjustment);
+    }
   priv->adjustment = adjustment;
 }
 
@@ -989,6 +1065,46 @@ adjustment_changed (GObject    *object,
   gtk_list_box_set_adjustment (GTK_LIST_BOX (data), adjustment);
 }
 
+static void
+gtk_list_box_get_view (GtkListBox *box,
+                       gint       *top,
+                       gint       *bottom)
+{
+  GtkListBoxPrivate *priv = BOX_PRIV (box);
+  GtkAllocation allocation;
+
+  gtk_widget_get_allocation (GTK_WIDGET (box), &allocation);
+
+  *top = gtk_adjustment_get_value (priv->adjustment) - allocation.y;
+  *bottom = *top + gtk_adjustment_get_page_size (priv->adjustment);
+}
+
+static void
+gtk_list_box_adjustment_value_changed (GtkAdjustment *adjustment,
+                                       GtkListBox    *box)
+{
+  GtkListBoxPrivate *priv = BOX_PRIV (box);
+  gint top, bottom;
+
+  if (!priv->fixed_height_mode && priv->bind_widget_func == NULL)
+    return;
+
+  /* Rows are allocated a page ahead, so only relayout
+   * when scrolling beyond that
+   */
+  gtk_list_box_get_view (box, &top, &bottom);
+  if (top < priv->view_top || bottom > priv->view_bottom)
+    {
+      /* Bind the rows that come into view now, rather than
+       * while allocating them
+       */
+      if (priv->bind_widget_func != NULL && priv->bound_width > 0)
+        gtk_list_box_bind_view (box, priv->bound_width);
+
+      gtk_widget_queue_resize (GTK_WIDGET (box));
+    }
+}
+
 static void
 gtk_list_box_parent_set (GtkWidget *widget,
                          GtkWidget *prev_parent)
@@ -1174,9 +1290,8 @@ gtk_list_box_invalidate_filter (GtkListBox *box)
 {
   g_return_if_fail (GTK_IS_LIST_BOX (box));
 
-  gtk_list_box_apply_filter_all (box);
-  gtk_list_box_invalidate_headers (box);
-  gtk_widget_queue_resize (GTK_WIDGET (box));
+  if (gtk_list_box_apply_filter_all (box))
+    gtk_widget_queue_resize (GTK_WIDGET (box));
 }
 
 static gint
@@ -1210,6 +1325,37 @@ gtk_list_box_css_node_foreach (gpointer data,
   *previous = row;
 }
 
+/* Skips to the first visible row from @iter on */
+static GSequenceIter *
+gtk_list_box_get_visible_from (GtkListBox    *box,
+                               GSequenceIter *iter)
+{
+  if (g_sequence_iter_is_end (iter) ||
+      ROW_PRIV (g_sequence_get (iter))->visible)
+    return iter;
+
+  return gtk_list_box_get_next_visible (box, iter);
+}
+
+/* Only the rows around a row that moved need a new header */
+static void
+gtk_list_box_row_moved (GSequenceIter *iter,
+                        GSequenceIter *old_next,
+                        gpointer       data)
+{
+  GtkListBox *box = data;
+
+  gtk_list_box_insert_css_node (box, g_sequence_get (iter), iter);
+  gtk_widget_queue_resize (GTK_WIDGET (box));
+
+  if (gtk_widget_get_visible (GTK_WIDGET (box)))
+    {
+      gtk_list_box_update_header (box, iter);
+      gtk_list_box_update_header (box, gtk_list_box_get_next_visible (box, iter));
+      gtk_list_box_update_header (box, gtk_list_box_get_visible_from (box, old_next));
+    }
+}
+
 /**
  * gtk_list_box_invalidate_sort:
  * @box: a #GtkListBox
@@ -1218,6 +1364,9 @@ gtk_list_box_css_node_foreach (gpointer data,
  * of the sort function on the @box is changed due
  * to an external factor.
  *
+ * Only the rows that ended up out of order are moved, so
+ * this is cheap when few rows changed.
+ *
  * Since: 3.10
  */
 void
@@ -1228,7 +1377,13 @@ gtk_list_box_invalidate_sort (GtkListBox *box)
 
   g_return_if_fail (GTK_IS_LIST_BOX (box));
 
-  g_sequence_sort (priv->children, (GCompareDataFunc)do_sort, box);
+  if (priv->sort_func == NULL)
+    return;
+
+  if (gtk_sequence_resort (priv->children, (GCompareDataFunc)do_sort, box,
+                           gtk_list_box_row_moved, box))
+    return;
+
   g_sequence_foreach (priv->children, gtk_list_box_css_node_foreach, &previous);
 
   gtk_list_box_invalidate_headers (box);
@@ -1317,7 +1472,7 @@ gtk_list_box_got_row_changed (GtkListBox    *box,
 {
   GtkListBoxPrivate *priv = BOX_PRIV (box);
   GtkListBoxRowPrivate *row_priv = ROW_PRIV (row);
-  GSequenceIter *prev_next, *next;
+  GSequenceIter *prev_next, *next, *old_next;
 
   g_return_if_fail (GTK_IS_LIST_BOX (box));
   g_return_if_fail (GTK_IS_LIST_BOX_ROW (row));
@@ -1325,12 +1480,19 @@ gtk_list_box_got_row_changed (GtkListBox    *box,
   prev_next = gtk_list_box_get_next_visible (box, row_priv->iter);
   if (priv->sort_func != NULL)
     {
+      /* A binary search relocates the row, nothing else moves */
+      old_next = g_sequence_iter_next (row_priv->iter);
       g_sequence_sort_changed (row_priv->iter,
                                (GCompareDataFunc)do_sort,
                                box);
-      gtk_widget_queue_resize (GTK_WIDGET (box));
+      if (g_sequence_iter_next (row_priv->iter) != old_next)
+        {
+          gtk_list_box_insert_css_node (box, GTK_WIDGET (row), row_priv->iter);
+          gtk_widget_queue_resize (GTK_WIDGET (box));
+        }
     }
-  gtk_list_box_apply_filter (box, row);
+  if (gtk_list_box_apply_filter (box, row))
+    gtk_widget_queue_resize (GTK_WIDGET (box));
   if (gtk_widget_get_visible (GTK_WIDGET (box)))
     {
       next = gtk_list_box_get_next_visible (box, row_priv->iter);
@@ -1384,6 +1546,76 @@ gtk_list_box_get_activate_on_single_click (GtkListBox *box)
   return BOX_PRIV (box)->activate_single_click;
 }
 
+/**
+ * gtk_list_box_set_fixed_height_mode:
+ * @box: a #GtkListBox
+ * @enable: %TRUE to enable fixed height mode
+ *
+ * Enables or disables the fixed height mode of @box. Fixed height
+ * mode speeds up #GtkListBox by assuming that all rows, together
+ * with their headers, have the same size as the first visible row.
+ * Only that row is measured, and when @box is scrolled by an
+ * adjustment, only the rows in and around the visible part of the
+ * list are mapped and allocated.
+ *
+ * Since: 3.20
+ */
+void
+gtk_list_box_set_fixed_height_mode (GtkListBox *box,
+                                    gboolean    enable)
+{
+  GtkListBoxPrivate *priv = BOX_PRIV (box);
+  GSequenceIter *iter;
+  GtkListBoxRow *row;
+
+  g_return_if_fail (GTK_IS_LIST_BOX (box));
+
+  enable = enable != FALSE;
+
+  priv->fixed_height_mode_forced = FALSE;
+
+  if (priv->fixed_height_mode == enable)
+    return;
+
+  priv->fixed_height_mode = enable;
+
+  if (!enable)
+    {
+      /* Show the rows that were left out of the view again */
+      for (iter = g_sequence_get_begin_iter (priv->children);
+           !g_sequence_iter_is_end (iter);
+           iter = g_sequence_iter_next (iter))
+        {
+          row = g_sequence_get (iter);
+          gtk_widget_set_child_visible (GTK_WIDGET (row), !ROW_PRIV (row)->filtered);
+          if (ROW_PRIV (row)->header != NULL)
+            gtk_widget_set_child_visible (ROW_PRIV (row)->header, TRUE);
+        }
+    }
+
+  gtk_widget_queue_resize (GTK_WIDGET (box));
+
+  g_object_notify_by_pspec (G_OBJECT (box), properties[PROP_FIXED_HEIGHT_MODE]);
+}
+
+/**
+ * gtk_list_box_get_fixed_height_mode:
+ * @box: a #GtkListBox
+ *
+ * Returns whether fixed height mode is turned on for @box.
+ *
+ * Returns: %TRUE if @box is in fixed height mode
+ *
+ * Since: 3.20
+ */
+gboolean
+gtk_list_box_get_fixed_height_mode (GtkListBox *box)
+{
+  g_return_val_if_fail (GTK_IS_LIST_BOX (box), FALSE);
+
+  return BOX_PRIV (box)->fixed_height_mode;
+}
+
 
 static void
 gtk_list_box_add_move_binding (GtkBindingSet   *binding_set,
@@ -1439,6 +1671,17 @@ ensure_row_visible (GtkListBox    *box,
   if (!priv->adjustment)
     return;
 
+  /* Rows outside of the view are not allocated in fixed height mode,
+   * but their position is known nevertheless.
+   */
+  if (priv->fixed_height_mode && !gtk_widget_get_mapped (GTK_WIDGET (row)))
+    {
+      gtk_adjustment_clamp_page (priv->adjustment,
+                                 ROW_PRIV (row)->y,
+                                 ROW_PRIV (row)->y + ROW_PRIV (row)->height);
+      return;
+    }
+
   gtk_widget_get_allocation (GTK_WIDGET (row), &allocation);
   y = allocation.y;
   height = allocation.height;
@@ -1461,6 +1704,8 @@ gtk_list_box_update_cursor (GtkListBox    *box,
                             gboolean grab_focus)
 {
   BOX_PRIV (box)->cursor_row = row;
+  if (BOX_PRIV (box)->fixed_height_mode)
+    gtk_widget_set_child_visible (GTK_WIDGET (row), TRUE);
   ensure_row_visible (box, row);
   if (grab_focus)
     gtk_widget_grab_focus (GTK_WIDGET (row));
@@ -2113,6 +2358,12 @@ list_box_add_visible_rows (GtkListBox *box,
   was_zero = priv->n_visible_rows == 0;
   priv->n_visible_rows += n;
 
+  /* When recycling, only a few items have a row, and the
+   * placeholder follows the model instead
+   */
+  if (priv->bind_widget_func != NULL)
+    return;
+
   if (priv->placeholder &&
       (was_zero || priv->n_visible_rows == 0))
     gtk_widget_set_child_visible (GTK_WIDGET (priv->placeholder),
@@ -2120,7 +2371,7 @@ list_box_add_visible_rows (GtkListBox *box,
 }
 
 /* Children are visible if they are shown by the app (visible)
- * and not filtered out (child_visible) by the listbox
+ * and not filtered out by the listbox
  */
 static void
 update_row_is_visible (GtkListBox    *box,
@@ -2133,7 +2384,7 @@ update_row_is_visible (GtkListBox    *box,
 
   row_priv->visible =
     gtk_widget_get_visible (GTK_WIDGET (row)) &&
-    gtk_widget_get_child_visible (GTK_WIDGET (row));
+    !row_priv->filtered;
 
   if (was_visible && !row_priv->visible)
     list_box_add_visible_rows (box, -1);
@@ -2141,35 +2392,61 @@ update_row_is_visible (GtkListBox    *box,
     list_box_add_visible_rows (box, 1);
 }
 
-static void
+/* Returns whether the row got filtered in or out */
+static gboolean
 gtk_list_box_apply_filter (GtkListBox    *box,
                            GtkListBoxRow *row)
 {
   GtkListBoxPrivate *priv = BOX_PRIV (box);
-  gboolean do_show;
+  gboolean do_show, changed;
 
   do_show = TRUE;
   if (priv->filter_func != NULL)
     do_show = priv->filter_func (row, priv->filter_func_target);
 
-  gtk_widget_set_child_visible (GTK_WIDGET (row), do_show);
+  changed = ROW_PRIV (row)->filtered != !do_show;
+  ROW_PRIV (row)->filtered = !do_show;
+
+  /* In fixed height mode, rows are only mapped once they
+   * get allocated inside the view
+   */
+  if (!priv->fixed_height_mode || !do_show)
+    gtk_widget_set_child_visible (GTK_WIDGET (row), do_show);
 
   update_row_is_visible (box, row);
+
+  return changed;
 }
 
-static void
+/* Only the rows that got filtered in or out, and the rows
+ * following them, need a new header. Returns whether any
+ * row got filtered in or out.
+ */
+static gboolean
 gtk_list_box_apply_filter_all (GtkListBox *box)
 {
   GtkListBoxRow *row;
   GSequenceIter *iter;
+  gboolean changed = FALSE;
 
   for (iter = g_sequence_get_begin_iter (BOX_PRIV (box)->children);
        !g_sequence_iter_is_end (iter);
        iter = g_sequence_iter_next (iter))
     {
       row = g_sequence_get (iter);
-      gtk_list_box_apply_filter (box, row);
+      if (!gtk_list_box_apply_filter (box, row))
+        continue;
+
+      changed = TRUE;
+
+      if (gtk_widget_get_visible (GTK_WIDGET (box)))
+        {
+          gtk_list_box_update_header (box, iter);
+          gtk_list_box_update_header (box, gtk_list_box_get_next_visible (box, iter));
+        }
     }
+
+  return changed;
 }
 
 static GtkListBoxRow *
@@ -2263,7 +2540,9 @@ gtk_list_box_update_header (GtkListBox    *box,
   GtkListBoxRow *before_row;
   GtkWidget *old_header;
 
-  if (iter == NULL || g_sequence_iter_is_end (iter))
+  /* Recycled rows don't get headers */
+  if (iter == NULL || g_sequence_iter_is_end (iter) ||
+      priv->bind_widget_func != NULL)
     return;
 
   row = g_sequence_get (iter);
@@ -2374,6 +2653,15 @@ gtk_list_box_remove (GtkContainer *container,
     }
 
   row = GTK_LIST_BOX_ROW (child);
+  if (ROW_PRIV (row)->iter == NULL)
+    {
+      if (g_queue_remove (&priv->recycled_rows, row))
+        gtk_widget_unparent (child);
+      else
+        g_warning ("Tried to remove non-child %p\n", child);
+      return;
+    }
+
   if (g_sequence_iter_get_sequence (ROW_PRIV (row)->iter) != priv->children)
     {
       g_warning ("Tried to remove non-child %p\n", child);
@@ -2435,6 +2723,7 @@ gtk_list_box_forall (GtkContainer *container,
   GtkListBoxPrivate *priv = BOX_PRIV (container);
   GSequenceIter *iter;
   GtkListBoxRow *row;
+  GList *l;
 
   if (priv->placeholder != NULL && include_internals)
     callback (priv->placeholder, callback_target);
@@ -2448,6 +2737,14 @@ gtk_list_box_forall (GtkContainer *container,
         callback (ROW_PRIV (row)->header, callback_target);
       callback (GTK_WIDGET (row), callback_target);
     }
+
+  l = priv->recycled_rows.head;
+  while (l != NULL)
+    {
+      row = l->data;
+      l = l->next;
+      callback (GTK_WIDGET (row), callback_target);
+    }
 }
 
 static void
@@ -2479,6 +2776,48 @@ gtk_list_box_get_request_mode (GtkWidget *widget)
   return GTK_SIZE_REQUEST_HEIGHT_FOR_WIDTH;
 }
 
+static GtkListBoxRow *
+gtk_list_box_get_first_visible_row (GtkListBox *box)
+{
+  GSequenceIter *iter;
+
+  iter = g_sequence_get_begin_iter (BOX_PRIV (box)->children);
+  if (!g_sequence_iter_is_end (iter) && !row_is_visible (g_sequence_get (iter)))
+    iter = gtk_list_box_get_next_visible (box, iter);
+
+  if (g_sequence_iter_is_end (iter))
+    return NULL;
+
+  return g_sequence_get (iter);
+}
+
+/* In fixed height mode, every visible row and its header
+ * take as much space as the first visible row and its header
+ */
+static gint
+gtk_list_box_get_fixed_row_height (GtkListBox *box,
+                                   gint        width)
+{
+  GtkListBoxRow *row;
+  gint height, row_min;
+
+  row = gtk_list_box_get_first_visible_row (box);
+  if (row == NULL)
+    return 0;
+
+  height = 0;
+
+  if (ROW_PRIV (row)->header != NULL)
+    {
+      gtk_widget_get_preferred_height_for_width (ROW_PRIV (row)->header, width, &row_min, NULL);
+      height += row_min;
+    }
+  gtk_widget_get_preferred_height_for_width (GTK_WIDGET (row), width, &row_min, NULL);
+  height += row_min;
+
+  return height;
+}
+
 static void
 gtk_list_box_get_preferred_height (GtkWidget *widget,
                                    gint      *minimum_height,
@@ -2506,24 +2845,37 @@ gtk_list_box_get_preferred_height_for_width (GtkWidget *widget,
     gtk_widget_get_preferred_height_for_width (priv->placeholder, width,
                                                &minimum_height, NULL);
 
-  for (iter = g_sequence_get_begin_iter (priv->children);
-       !g_sequence_iter_is_end (iter);
-       iter = g_sequence_iter_next (iter))
+  if (priv->bind_widget_func != NULL)
     {
-      GtkListBoxRow *row;
-      gint row_min = 0;
+      minimum_height += g_list_model_get_n_items (priv->bound_model) *
+                        gtk_list_box_get_fixed_row_height (GTK_LIST_BOX (widget), width);
+    }
+  else if (priv->fixed_height_mode)
+    {
+      minimum_height += priv->n_visible_rows *
+                        gtk_list_box_get_fixed_row_height (GTK_LIST_BOX (widget), width);
+    }
+  else
+    {
+      for (iter = g_sequence_get_begin_iter (priv->children);
+           !g_sequence_iter_is_end (iter);
+           iter = g_sequence_iter_next (iter))
+        {
+          GtkListBoxRow *row;
+          gint row_min = 0;
 
-      row = g_sequence_get (iter);
-      if (!row_is_visible (row))
-        continue;
+          row = g_sequence_get (iter);
+          if (!row_is_visible (row))
+            continue;
 
-      if (ROW_PRIV (row)->header != NULL)
-        {
-          gtk_widget_get_preferred_height_for_width (ROW_PRIV (row)->header, width, &row_min, NULL);
+          if (ROW_PRIV (row)->header != NULL)
+            {
+              gtk_widget_get_preferred_height_for_width (ROW_PRIV (row)->header, width, &row_min, NULL);
+              minimum_height += row_min;
+            }
+          gtk_widget_get_preferred_height_for_width (GTK_WIDGET (row), width, &row_min, NULL);
           minimum_height += row_min;
         }
-      gtk_widget_get_preferred_height_for_width (GTK_WIDGET (row), width, &row_min, NULL);
-      minimum_height += row_min;
     }
 
   /* We always allocate the minimum height, since handling expanding rows is way too costly,
@@ -2553,7 +2905,16 @@ gtk_list_box_get_preferred_width (GtkWidget *widget,
     gtk_widget_get_preferred_width (priv->placeholder,
                                     &minimum_width, &natural_width);
 
-  for (iter = g_sequence_get_begin_iter (priv->children);
+  /* In fixed height mode, the first visible row stands for all of them */
+  if (priv->fixed_height_mode)
+    {
+      row = gtk_list_box_get_first_visible_row (GTK_LIST_BOX (widget));
+      iter = row ? ROW_PRIV (row)->iter : g_sequence_get_end_iter (priv->children);
+    }
+  else
+    iter = g_sequence_get_begin_iter (priv->children);
+
+  for (;
        !g_sequence_iter_is_end (iter);
        iter = g_sequence_iter_next (iter))
     {
@@ -2575,6 +2936,9 @@ gtk_list_box_get_preferred_width (GtkWidget *widget,
           minimum_width = MAX (minimum_width, row_min);
           natural_width = MAX (natural_width, row_nat);
         }
+
+      if (priv->fixed_height_mode)
+        break;
     }
 
   *minimum_width_out = minimum_width;
@@ -2590,52 +2954,45 @@ gtk_list_box_get_preferred_width_for_height (GtkWidget *widget,
   gtk_list_box_get_preferred_width (widget, minimum_width, natural_width);
 }
 
+/* Rows are placed by their index, and only the ones in and around
+ * the visible part of the adjustment are shown and allocated. The
+ * cursor row is always kept, so that it does not lose the focus.
+ */
 static void
-gtk_list_box_size_allocate (GtkWidget     *widget,
-                            GtkAllocation *allocation)
+gtk_list_box_allocate_fixed (GtkListBox    *box,
+                             GtkAllocation *allocation,
+                             gint           y)
 {
-  GtkListBoxPrivate *priv = BOX_PRIV (widget);
+  GtkListBoxPrivate *priv = BOX_PRIV (box);
   GtkAllocation child_allocation;
   GtkAllocation header_allocation;
   GtkListBoxRow *row;
-  GdkWindow *window;
+  GtkWidget *header;
   GSequenceIter *iter;
-  int child_min;
+  gint row_height, header_height;
+  gint top, bottom, page;
+  gboolean in_view;
 
-  child_allocation.x = 0;
-  child_allocation.y = 0;
-  child_allocation.width = 0;
-  child_allocation.height = 0;
-
-  header_allocation.x = 0;
-  header_allocation.y = 0;
-  header_allocation.width = 0;
-  header_allocation.height = 0;
+  row_height = gtk_list_box_get_fixed_row_height (box, allocation->width);
 
-  gtk_widget_set_allocation (widget, allocation);
-  window = gtk_widget_get_window (widget);
-  if (window != NULL)
-    gdk_window_move_resize (window,
-                            allocation->x, allocation->y,
-                            allocation->width, allocation->height);
+  if (priv->adjustment)
+    {
+      gtk_list_box_get_view (box, &top, &bottom);
+      page = bottom - top;
+      priv->view_top = top - page;
+      priv->view_bottom = bottom + page;
+    }
+  else
+    {
+      priv->view_top = G_MININT;
+      priv->view_bottom = G_MAXINT;
+    }
 
   child_allocation.x = 0;
-  child_allocation.y = 0;
   child_allocation.width = allocation->width;
   header_allocation.x = 0;
   header_allocation.width = allocation->width;
 
-  if (priv->placeholder != NULL && gtk_widget_get_child_visible (priv->placeholder))
-    {
-      gtk_widget_get_preferred_height_for_width (priv->placeholder,
-                                                 allocation->width, &child_min, NULL);
-      header_allocation.height = allocation->height;
-      header_allocation.y = child_allocation.y;
-      gtk_widget_size_allocate (priv->placeholder,
-                                &header_allocation);
-      child_allocation.y += child_min;
-    }
-
   for (iter = g_sequence_get_begin_iter (priv->children);
        !g_sequence_iter_is_end (iter);
        iter = g_sequence_iter_next (iter))
@@ -2643,37 +3000,449 @@ gtk_list_box_size_allocate (GtkWidget     *widget,
       row = g_sequence_get (iter);
       if (!row_is_visible (row))
         {
-          ROW_PRIV (row)->y = child_allocation.y;
+          ROW_PRIV (row)->y = y;
           ROW_PRIV (row)->height = 0;
           continue;
         }
 
-      if (ROW_PRIV (row)->header != NULL)
+      in_view = (y + row_height > priv->view_top && y < priv->view_bottom) ||
+                row == priv->cursor_row;
+
+      header = ROW_PRIV (row)->header;
+      if (gtk_widget_get_child_visible (GTK_WIDGET (row)) != in_view)
+        gtk_widget_set_child_visible (GTK_WIDGET (row), in_view);
+      if (header != NULL && gtk_widget_get_child_visible (header) != in_view)
+        gtk_widget_set_child_visible (header, in_view);
+
+      if (!in_view)
         {
-          gtk_widget_get_preferred_height_for_width (ROW_PRIV (row)->header,
-                                                     allocation->width, &child_min, NULL);
-          header_allocation.height = child_min;
-          header_allocation.y = child_allocation.y;
-          gtk_widget_size_allocate (ROW_PRIV (row)->header, &header_allocation);
-          child_allocation.y += child_min;
+          ROW_PRIV (row)->y = y;
+          ROW_PRIV (row)->height = row_height;
+          y += row_height;
+          continue;
         }
 
-      ROW_PRIV (row)->y = child_allocation.y;
+      header_height = 0;
+      if (header != NULL)
+        {
+          gtk_widget_get_preferred_height_for_width (header, allocation->width,
+                                                     &header_height, NULL);
+          header_height = MIN (header_height, row_height);
+          header_allocation.y = y;
+          header_allocation.height = header_height;
+          gtk_widget_size_allocate (header, &header_allocation);
+        }
 
-      gtk_widget_get_preferred_height_for_width (GTK_WIDGET (row),
-                                                 child_allocation.width, &child_min, NULL);
-      child_allocation.height = child_min;
+      child_allocation.y = y + header_height;
+      child_allocation.height = row_height - header_height;
 
+      ROW_PRIV (row)->y = child_allocation.y;
       ROW_PRIV (row)->height = child_allocation.height;
       gtk_widget_size_allocate (GTK_WIDGET (row), &child_allocation);
-      child_allocation.y += child_min;
+      y += row_height;
     }
 }
 
-/**
- * gtk_list_box_prepend:
- * @box: a #GtkListBox
- * @child: the #GtkWidget to add
+/* Orders rows by the position of their item. The position that is
+ * searched for is passed as @data, for a %NULL row, which sorts
+ * before the row of the item at that position.
+ */
+static gint
+gtk_list_box_compare_recycled (gconstpointer a,
+                               gconstpointer b,
+                               gpointer      data)
+{
+  gint64 pos_a, pos_b;
+
+  if (a)
+    pos_a = 2 * (gint64) ROW_PRIV ((GtkListBoxRow *) a)->position;
+  else
+    pos_a = 2 * (gint64) GPOINTER_TO_UINT (data) - 1;
+
+  if (b)
+    pos_b = 2 * (gint64) ROW_PRIV ((GtkListBoxRow *) b)->position;
+  else
+    pos_b = 2 * (gint64) GPOINTER_TO_UINT (data) - 1;
+
+  return (pos_a > pos_b) - (pos_a < pos_b);
+}
+
+/* Returns the iter of the first row whose item is at @position or
+ * after it. Rows are kept sorted by item position when recycling.
+ */
+static GSequenceIter *
+gtk_list_box_get_recycled_iter (GtkListBox *box,
+                                guint       position)
+{
+  return g_sequence_search (BOX_PRIV (box)->children, NULL,
+                            gtk_list_box_compare_recycled,
+                            GUINT_TO_POINTER (position));
+}
+
+static GtkWidget *
+gtk_list_box_row_get_bound_widget (GtkListBoxRow *row)
+{
+  if (ROW_PRIV (row)->wrapped)
+    return gtk_bin_get_child (GTK_BIN (row));
+
+  return GTK_WIDGET (row);
+}
+
+/* Gives the item at @position a row, taking one from the recycled
+ * rows if possible, and inserts it before @sibling
+ */
+static GtkListBoxRow *
+gtk_list_box_bind_item (GtkListBox    *box,
+                        guint          position,
+                        GSequenceIter *sibling)
+{
+  GtkListBoxPrivate *priv = BOX_PRIV (box);
+  GtkListBoxRow *row;
+  GtkWidget *widget;
+  GSequenceIter *iter;
+  gpointer item;
+
+  item = g_list_model_get_item (priv->bound_model, position);
+
+  row = g_queue_pop_head (&priv->recycled_rows);
+  if (row != NULL)
+    {
+      priv->bind_widget_func (gtk_list_box_row_get_bound_widget (row),
+                              item, priv->create_widget_func_data);
+    }
+  else
+    {
+      widget = priv->create_widget_func (item, priv->create_widget_func_data);
+
+      /* See gtk_list_box_bound_model_changed() */
+      if (g_object_is_floating (widget))
+        g_object_ref_sink (widget);
+
+      gtk_widget_show (widget);
+
+      if (GTK_IS_LIST_BOX_ROW (widget))
+        row = GTK_LIST_BOX_ROW (widget);
+      else
+        {
+          row = GTK_LIST_BOX_ROW (gtk_list_box_row_new ());
+          gtk_widget_show (GTK_WIDGET (row));
+          gtk_container_add (GTK_CONTAINER (row), widget);
+          ROW_PRIV (row)->wrapped = TRUE;
+        }
+
+      gtk_widget_set_child_visible (GTK_WIDGET (row), FALSE);
+      gtk_widget_set_parent (GTK_WIDGET (row), GTK_WIDGET (box));
+
+      g_object_unref (widget);
+    }
+
+  iter = g_sequence_insert_before (sibling, row);
+  gtk_list_box_insert_css_node (box, GTK_WIDGET (row), iter);
+
+  ROW_PRIV (row)->iter = iter;
+  ROW_PRIV (row)->position = position;
+  ROW_PRIV (row)->visible = gtk_widget_get_visible (GTK_WIDGET (row));
+  if (ROW_PRIV (row)->visible)
+    list_box_add_visible_rows (box, 1);
+  gtk_list_box_update_row_style (box, row);
+
+  g_object_unref (item);
+
+  return row;
+}
+
+/* Unbinds @row from its item and keeps it around for another one */
+static void
+gtk_list_box_recycle_row (GtkListBox    *box,
+                          GtkListBoxRow *row)
+{
+  GtkListBoxPrivate *priv = BOX_PRIV (box);
+  gboolean was_selected;
+
+  was_selected = ROW_PRIV (row)->selected;
+  gtk_list_box_row_set_selected (row, FALSE);
+
+  if (ROW_PRIV (row)->visible)
+    list_box_add_visible_rows (box, -1);
+
+  if (row == priv->selected_row)
+    priv->selected_row = NULL;
+  if (row == priv->prelight_row)
+    {
+      gtk_widget_unset_state_flags (GTK_WIDGET (row), GTK_STATE_FLAG_PRELIGHT);
+      priv->prelight_row = NULL;
+    }
+  if (row == priv->cursor_row)
+    priv->cursor_row = NULL;
+  if (row == priv->active_row)
+    {
+      gtk_widget_unset_state_flags (GTK_WIDGET (row), GTK_STATE_FLAG_ACTIVE);
+      priv->active_row = NULL;
+    }
+
+  if (row == priv->drag_highlighted_row)
+    gtk_list_box_drag_unhighlight_row (box);
+
+  g_sequence_remove (ROW_PRIV (row)->iter);
+  ROW_PRIV (row)->iter = NULL;
+  gtk_widget_set_child_visible (GTK_WIDGET (row), FALSE);
+
+  priv->bind_widget_func (gtk_list_box_row_get_bound_widget (row),
+                          NULL, priv->create_widget_func_data);
+  g_queue_push_tail (&priv->recycled_rows, row);
+
+  if (was_selected)
+    {
+      g_signal_emit (box, signals[ROW_SELECTED], 0, NULL);
+      g_signal_emit (box, signals[SELECTED_ROWS_CHANGED], 0);
+    }
+}
+
+static void
+gtk_list_box_ensure_item_bound (GtkListBox *box,
+                                guint       position)
+{
+  GSequenceIter *iter;
+
+  iter = gtk_list_box_get_recycled_iter (box, position);
+  if (g_sequence_iter_is_end (iter) ||
+      ROW_PRIV (g_sequence_get (iter))->position != position)
+    gtk_list_box_bind_item (box, position, iter);
+}
+
+/* When recycling, only the items in and around the view have a row,
+ * and every row is placed by the position of its item. Rows that
+ * leave that range are unbound and bound again to the items that
+ * enter it. The selected rows and the cursor row, along with the
+ * rows next to it for keyboard navigation, are kept bound.
+ *
+ * Binding changes the contents of rows, which queues resizes, so
+ * this is done before allocating: when scrolling and when the model
+ * changes. Only a new width, which can change the height of the rows
+ * and thus what is in view, has to be handled during allocation.
+ */
+static void
+gtk_list_box_bind_view (GtkListBox *box,
+                        gint        width)
+{
+  GtkListBoxPrivate *priv = BOX_PRIV (box);
+  GtkListBoxRow *row;
+  GSequenceIter *iter, *next;
+  guint n_items, first, last, cursor, position;
+  gint row_height;
+  gint top, bottom, page;
+
+  n_items = g_list_model_get_n_items (priv->bound_model);
+  row_height = gtk_list_box_get_fixed_row_height (box, width);
+
+  if (priv->adjustment)
+    {
+      gtk_list_box_get_view (box, &top, &bottom);
+      page = bottom - top;
+      priv->view_top = top - page;
+      priv->view_bottom = bottom + page;
+    }
+  else
+    {
+      priv->view_top = G_MININT;
+      priv->view_bottom = G_MAXINT;
+    }
+
+  /* The placeholder is only shown without items, so the
+   * rows start at the top
+   */
+  if (row_height <= 0)
+    {
+      /* Nothing to measure the rows with yet */
+      first = 0;
+      last = MIN (n_items, 1);
+    }
+  else if (priv->adjustment)
+    {
+      first = CLAMP (priv->view_top / row_height, 0, (gint) n_items);
+      last = CLAMP (priv->view_bottom / row_height + 1, (gint) first, (gint) n_items);
+    }
+  else
+    {
+      first = 0;
+      last = n_items;
+    }
+
+  cursor = priv->cursor_row ? ROW_PRIV (priv->cursor_row)->position : G_MAXUINT;
+
+  if (first < last)
+    {
+      iter = g_sequence_get_begin_iter (priv->children);
+      while (!g_sequence_iter_is_end (iter))
+        {
+          row = g_sequence_get (iter);
+          next = g_sequence_iter_next (iter);
+          position = ROW_PRIV (row)->position;
+
+          if ((position < first || position >= last) &&
+              !ROW_PRIV (row)->selected &&
+              (cursor == G_MAXUINT || position + 1 < cursor || position > cursor + 1))
+            gtk_list_box_recycle_row (box, row);
+
+          iter = next;
+        }
+    }
+
+  for (position = first; position < last; position++)
+    gtk_list_box_ensure_item_bound (box, position);
+
+  if (cursor != G_MAXUINT)
+    {
+      if (cursor > 0)
+        gtk_list_box_ensure_item_bound (box, cursor - 1);
+      if (cursor + 1 < n_items)
+        gtk_list_box_ensure_item_bound (box, cursor + 1);
+    }
+
+  priv->bound_width = width;
+}
+
+static void
+gtk_list_box_allocate_recycled (GtkListBox    *box,
+                                GtkAllocation *allocation,
+                                gint           y)
+{
+  GtkListBoxPrivate *priv = BOX_PRIV (box);
+  GtkAllocation child_allocation;
+  GtkListBoxRow *row;
+  GSequenceIter *iter;
+  gint row_height, row_y;
+  gboolean in_view;
+
+  if (allocation->width != priv->bound_width)
+    gtk_list_box_bind_view (box, allocation->width);
+
+  row_height = gtk_list_box_get_fixed_row_height (box, allocation->width);
+
+  child_allocation.x = 0;
+  child_allocation.width = allocation->width;
+  child_allocation.height = row_height;
+
+  for (iter = g_sequence_get_begin_iter (priv->children);
+       !g_sequence_iter_is_end (iter);
+       iter = g_sequence_iter_next (iter))
+    {
+      row = g_sequence_get (iter);
+      row_y = y + ROW_PRIV (row)->position * row_height;
+
+      ROW_PRIV (row)->y = row_y;
+      ROW_PRIV (row)->height = row_height;
+
+      in_view = (row_y + row_height > priv->view_top && row_y < priv->view_bottom) ||
+                row == priv->cursor_row;
+
+      if (gtk_widget_get_child_visible (GTK_WIDGET (row)) != in_view)
+        gtk_widget_set_child_visible (GTK_WIDGET (row), in_view);
+
+      if (!in_view)
+        continue;
+
+      child_allocation.y = row_y;
+      gtk_widget_size_allocate (GTK_WIDGET (row), &child_allocation);
+    }
+}
+
+static void
+gtk_list_box_size_allocate (GtkWidget     *widget,
+                            GtkAllocation *allocation)
+{
+  GtkListBoxPrivate *priv = BOX_PRIV (widget);
+  GtkAllocation child_allocation;
+  GtkAllocation header_allocation;
+  GtkListBoxRow *row;
+  GdkWindow *window;
+  GSequenceIter *iter;
+  int child_min;
+
+  child_allocation.x = 0;
+  child_allocation.y = 0;
+  child_allocation.width = 0;
+  child_allocation.height = 0;
+
+  header_allocation.x = 0;
+  header_allocation.y = 0;
+  header_allocation.width = 0;
+  header_allocation.height = 0;
+
+  gtk_widget_set_allocation (widget, allocation);
+  window = gtk_widget_get_window (widget);
+  if (window != NULL)
+    gdk_window_move_resize (window,
+                            allocation->x, allocation->y,
+                            allocation->width, allocation->height);
+
+  child_allocation.x = 0;
+  child_allocation.y = 0;
+  child_allocation.width = allocation->width;
+  header_allocation.x = 0;
+  header_allocation.width = allocation->width;
+
+  if (priv->placeholder != NULL && gtk_widget_get_child_visible (priv->placeholder))
+    {
+      gtk_widget_get_preferred_height_for_width (priv->placeholder,
+                                                 allocation->width, &child_min, NULL);
+      header_allocation.height = allocation->height;
+      header_allocation.y = child_allocation.y;
+      gtk_widget_size_allocate (priv->placeholder,
+                                &header_allocation);
+      child_allocation.y += child_min;
+    }
+
+  if (priv->bind_widget_func != NULL)
+    {
+      gtk_list_box_allocate_recycled (GTK_LIST_BOX (widget), allocation, child_allocation.y);
+      return;
+    }
+
+  if (priv->fixed_height_mode)
+    {
+      gtk_list_box_allocate_fixed (GTK_LIST_BOX (widget), allocation, child_allocation.y);
+      return;
+    }
+
+  for (iter = g_sequence_get_begin_iter (priv->children);
+       !g_sequence_iter_is_end (iter);
+       iter = g_sequence_iter_next (iter))
+    {
+      row = g_sequence_get (iter);
+      if (!row_is_visible (row))
+        {
+          ROW_PRIV (row)->y = child_allocation.y;
+          ROW_PRIV (row)->height = 0;
+          continue;
+        }
+
+      if (ROW_PRIV (row)->header != NULL)
+        {
+          gtk_widget_get_preferred_height_for_width (ROW_PRIV (row)->header,
+                                                     allocation->width, &child_min, NULL);
+          header_allocation.height = child_min;
+          header_allocation.y = child_allocation.y;
+          gtk_widget_size_allocate (ROW_PRIV (row)->header, &header_allocation);
+          child_allocation.y += child_min;
+        }
+
+      ROW_PRIV (row)->y = child_allocation.y;
+
+      gtk_widget_get_preferred_height_for_width (GTK_WIDGET (row),
+                                                 child_allocation.width, &child_min, NULL);
+      child_allocation.height = child_min;
+
+      ROW_PRIV (row)->height = child_allocation.height;
+      gtk_widget_size_allocate (GTK_WIDGET (row), &child_allocation);
+      child_allocation.y += child_min;
+    }
+}
+
+/**
+ * gtk_list_box_prepend:
+ * @box: a #GtkListBox
+ * @child: the #GtkWidget to add
  *
  * Prepend a widget to the list. If a sort function is set, the widget will
  * actually be inserted at the calculated position and this function has the
@@ -2693,10 +3462,11 @@ gtk_list_box_insert_css_node (GtkListBox    *box,
                               GtkWidget     *child,
                               GSequenceIter *iter)
 {
-  GSequenceIter *prev_iter;
+  GSequenceIter *prev_iter, *next_iter;
   GtkWidget *sibling;
 
   prev_iter = g_sequence_iter_prev (iter);
+  next_iter = g_sequence_iter_next (iter);
 
   if (prev_iter != iter)
     {
@@ -2705,6 +3475,13 @@ gtk_list_box_insert_css_node (GtkListBox    *box,
                                  gtk_widget_get_css_node (child),
                                  gtk_widget_get_css_node (sibling));
     }
+  else if (!g_sequence_iter_is_end (next_iter))
+    {
+      sibling = g_sequence_get (next_iter);
+      gtk_css_node_insert_before (gtk_widget_get_css_node (GTK_WIDGET (box)),
+                                  gtk_widget_get_css_node (child),
+                                  gtk_widget_get_css_node (sibling));
+    }
 }
 
 /**
@@ -2761,8 +3538,11 @@ gtk_list_box_insert (GtkListBox *box,
   gtk_list_box_insert_css_node (box, GTK_WIDGET (row), iter);
 
   ROW_PRIV (row)->iter = iter;
+  if (priv->fixed_height_mode)
+    gtk_widget_set_child_visible (GTK_WIDGET (row), FALSE);
   gtk_widget_set_parent (GTK_WIDGET (row), GTK_WIDGET (box));
-  gtk_widget_set_child_visible (GTK_WIDGET (row), TRUE);
+  if (!priv->fixed_height_mode)
+    gtk_widget_set_child_visible (GTK_WIDGET (row), TRUE);
   ROW_PRIV (row)->visible = gtk_widget_get_visible (GTK_WIDGET (row));
   if (ROW_PRIV (row)->visible)
     list_box_add_visible_rows (box, 1);
@@ -3386,10 +4166,13 @@ gtk_list_box_row_get_index (GtkListBoxRow *row)
 
   priv = ROW_PRIV (row);
 
-  if (priv->iter != NULL)
-    return g_sequence_iter_get_position (priv->iter);
+  if (priv->iter == NULL)
+    return -1;
+
+  if (BOX_PRIV (gtk_list_box_row_get_box (row))->bind_widget_func != NULL)
+    return priv->position;
 
-  return -1;
+  return g_sequence_iter_get_position (priv->iter);
 }
 
 /**
@@ -3694,6 +4477,48 @@ gtk_list_box_buildable_interface_init (GtkBuildableIface *iface)
   iface->add_child = gtk_list_box_buildable_add_child;
 }
 
+/* Only the rows of removed items go away right away, the
+ * ones for new items are created when they get into view
+ */
+static void
+gtk_list_box_recycled_model_changed (GtkListBox *box,
+                                     guint       position,
+                                     guint       removed,
+                                     guint       added)
+{
+  GtkListBoxPrivate *priv = BOX_PRIV (box);
+  GSequenceIter *iter, *next;
+  GtkListBoxRow *row;
+
+  iter = gtk_list_box_get_recycled_iter (box, position);
+  while (!g_sequence_iter_is_end (iter))
+    {
+      row = g_sequence_get (iter);
+      next = g_sequence_iter_next (iter);
+
+      if (ROW_PRIV (row)->position < position + removed)
+        gtk_list_box_recycle_row (box, row);
+      else
+        ROW_PRIV (row)->position += added - removed;
+
+      iter = next;
+    }
+
+  /* Keep a row around to measure the others with */
+  if (g_sequence_iter_is_end (g_sequence_get_begin_iter (priv->children)) &&
+      g_list_model_get_n_items (priv->bound_model) > 0)
+    gtk_list_box_bind_item (box, 0, g_sequence_get_end_iter (priv->children));
+
+  if (priv->placeholder)
+    gtk_widget_set_child_visible (priv->placeholder,
+                                  g_list_model_get_n_items (priv->bound_model) == 0);
+
+  if (priv->bound_width > 0)
+    gtk_list_box_bind_view (box, priv->bound_width);
+
+  gtk_widget_queue_resize (GTK_WIDGET (box));
+}
+
 static void
 gtk_list_box_bound_model_changed (GListModel *list,
                                   guint       position,
@@ -3705,6 +4530,12 @@ gtk_list_box_bound_model_changed (GListModel *list,
   GtkListBoxPrivate *priv = BOX_PRIV (user_data);
   gint i;
 
+  if (priv->bind_widget_func != NULL)
+    {
+      gtk_list_box_recycled_model_changed (box, position, removed, added);
+      return;
+    }
+
   while (removed--)
     {
       GtkListBoxRow *row;
@@ -3749,6 +4580,57 @@ gtk_list_box_check_model_compat (GtkListBox *box)
     g_warning ("GtkListBox with a model will ignore sort and filter functions");
 }
 
+static void
+gtk_list_box_set_bound_model (GtkListBox                 *box,
+                              GListModel                 *model,
+                              GtkListBoxCreateWidgetFunc  create_widget_func,
+                              GtkListBoxBindWidgetFunc    bind_widget_func,
+                              gpointer                    user_data,
+                              GDestroyNotify              user_data_free_func)
+{
+  GtkListBoxPrivate *priv = BOX_PRIV (box);
+
+  if (priv->bound_model)
+    {
+      if (priv->create_widget_func_data_destroy)
+        priv->create_widget_func_data_destroy (priv->create_widget_func_data);
+
+      g_signal_handlers_disconnect_by_func (priv->bound_model, gtk_list_box_bound_model_changed, box);
+      g_clear_object (&priv->bound_model);
+    }
+
+  priv->bind_widget_func = NULL;
+  priv->bound_width = 0;
+  gtk_list_box_forall (GTK_CONTAINER (box), FALSE, (GtkCallback) gtk_widget_destroy, NULL);
+
+  /* Only undo the fixed height mode that recycling turned on */
+  if (priv->fixed_height_mode_forced)
+    gtk_list_box_set_fixed_height_mode (box, FALSE);
+
+  if (model == NULL)
+    return;
+
+  priv->bound_model = g_object_ref (model);
+  priv->create_widget_func = create_widget_func;
+  priv->create_widget_func_data = user_data;
+  priv->create_widget_func_data_destroy = user_data_free_func;
+
+  gtk_list_box_check_model_compat (box);
+
+  if (bind_widget_func != NULL)
+    {
+      priv->bind_widget_func = bind_widget_func;
+      if (!priv->fixed_height_mode)
+        {
+          gtk_list_box_set_fixed_height_mode (box, TRUE);
+          priv->fixed_height_mode_forced = TRUE;
+        }
+    }
+
+  g_signal_connect (priv->bound_model, "items-changed", G_CALLBACK (gtk_list_box_bound_model_changed), box);
+  gtk_list_box_bound_model_changed (model, 0, 0, g_list_model_get_n_items (model), box);
+}
+
 /**
  * gtk_list_box_bind_model:
  * @box: a #GtkListBox
@@ -3784,33 +4666,57 @@ gtk_list_box_bind_model (GtkListBox                 *box,
                          gpointer                    user_data,
                          GDestroyNotify              user_data_free_func)
 {
-  GtkListBoxPrivate *priv = BOX_PRIV (box);
-
   g_return_if_fail (GTK_IS_LIST_BOX (box));
   g_return_if_fail (model == NULL || G_IS_LIST_MODEL (model));
   g_return_if_fail (model == NULL || create_widget_func != NULL);
 
-  if (priv->bound_model)
-    {
-      if (priv->create_widget_func_data_destroy)
-        priv->create_widget_func_data_destroy (priv->create_widget_func_data);
-
-      g_signal_handlers_disconnect_by_func (priv->bound_model, gtk_list_box_bound_model_changed, box);
-      g_clear_object (&priv->bound_model);
-    }
-
-  gtk_list_box_forall (GTK_CONTAINER (box), FALSE, (GtkCallback) gtk_widget_destroy, NULL);
-
-  if (model == NULL)
-    return;
-
-  priv->bound_model = g_object_ref (model);
-  priv->create_widget_func = create_widget_func;
-  priv->create_widget_func_data = user_data;
-  priv->create_widget_func_data_destroy = user_data_free_func;
+  gtk_list_box_set_bound_model (box, model, create_widget_func, NULL,
+                                user_data, user_data_free_func);
+}
 
-  gtk_list_box_check_model_compat (box);
+/**
+ * gtk_list_box_bind_model_recycling:
+ * @box: a #GtkListBox
+ * @model: (nullable): the #GListModel to be bound to @box
+ * @create_widget_func: (nullable): a function that creates widgets for items
+ *   or %NULL in case you also passed %NULL as @model
+ * @bind_widget_func: (nullable): a function that makes widgets represent
+ *   other items, or %NULL in case you also passed %NULL as @model
+ * @user_data: user data passed to @create_widget_func and @bind_widget_func
+ * @user_data_free_func: function for freeing @user_data
+ *
+ * Binds @model to @box like gtk_list_box_bind_model(), but only creates
+ * widgets for the items that are in or near the visible part of @box.
+ * When the list is scrolled, widgets that go out of view are handed to
+ * @bind_widget_func to represent the items that come into view instead,
+ * so the number of widgets does not depend on the size of @model.
+ *
+ * All rows must have the same height, and @box is switched to fixed
+ * height mode while @model is bound, see
+ * gtk_list_box_set_fixed_height_mode(). For the visible
+ * part to be known, @box should be in a #GtkScrolledWindow or have an
+ * adjustment set with gtk_list_box_set_adjustment(); otherwise, every
+ * item gets a widget.
+ *
+ * Only rows that have a widget can be retrieved or selected, and header
+ * functions are not supported. Selected rows and the cursor row keep
+ * their widgets while they are out of view.
+ *
+ * Since: 3.20
+ */
+void
+gtk_list_box_bind_model_recycling (GtkListBox                 *box,
+                                   GListModel                 *model,
+                                   GtkListBoxCreateWidgetFunc  create_widget_func,
+                                   GtkListBoxBindWidgetFunc    bind_widget_func,
+                                   gpointer                    user_data,
+                                   GDestroyNotify              user_data_free_func)
+{
+  g_return_if_fail (GTK_IS_LIST_BOX (box));
+  g_return_if_fail (model == NULL || G_IS_LIST_MODEL (model));
+  g_return_if_fail (model == NULL || create_widget_func != NULL);
+  g_return_if_fail (model == NULL || bind_widget_func != NULL);
 
-  g_signal_connect (priv->bound_model, "items-changed", G_CALLBACK (gtk_list_box_bound_model_changed), box);
-  gtk_list_box_bound_model_changed (model, 0, 0, g_list_model_get_n_items (model), box);
+  gtk_list_box_set_bound_model (box, model, create_widget_func, bind_widget_func,
+                                user_data, user_data_free_func);
 }
@@ -189,6 +189,24 @@ typedef void (*GtkListBoxUpdateHeaderFunc) (GtkListBoxRow *row,
 typedef GtkWidget * (*GtkListBoxCreateWidgetFunc) (gpointer item,
                                                    gpointer user_data);
 
+/**
+ * GtkListBoxBindWidgetFunc:
+ * @widget: a widget that was returned by the #GtkListBoxCreateWidgetFunc
+ * @item: (type GObject) (nullable): the item from the model that @widget
+ *   should represent from now on, or %NULL
+ * @user_data: (closure): user data
+ *
+ * Called for list boxes that are bound to a #GListModel with
+ * gtk_list_box_bind_model_recycling() when a widget is reused for
+ * another item. @item is %NULL when @widget is put aside until it is
+ * needed again, so that it does not keep the previous item alive.
+ *
+ * Since: 3.20
+ */
+typedef void (*GtkListBoxBindWidgetFunc) (GtkWidget *widget,
+                                          gpointer   item,
+                                          gpointer   user_data);
+
 GDK_AVAILABLE_IN_3_10
 GType      gtk_list_box_row_get_type      (void) G_GNUC_CONST;
 GDK_AVAILABLE_IN_3_10
@@ -304,6 +322,11 @@ void           gtk_list_box_drag_highlight_row           (GtkListBox
                                                           GtkListBoxRow                 *row);
 GDK_AVAILABLE_IN_3_10
 GtkWidget*     gtk_list_box_new                          (void);
+GDK_AVAILABLE_IN_3_20
+void           gtk_list_box_set_fixed_height_mode        (GtkListBox                    *box,
+                                                          gboolean                       enable);
+GDK_AVAILABLE_IN_3_20
+gboolean       gtk_list_box_get_fixed_height_mode        (GtkListBox                    *box);
 
 
 GDK_AVAILABLE_IN_3_16
@@ -312,6 +335,13 @@ void           gtk_list_box_bind_model                   (GtkListBox
                                                           GtkListBoxCreateWidgetFunc    create_widget_func,
                                                           gpointer                      user_data,
                                                           GDestroyNotify                user_data_free_func);
+GDK_AVAILABLE_IN_3_20
+void           gtk_list_box_bind_model_recycling         (GtkListBox                   *box,
+                                                          GListModel                   *model,
+                                                          GtkListBoxCreateWidgetFunc    create_widget_func,
+                                                          GtkListBoxBindWidgetFunc      bind_widget_func,
+                                                          gpointer                      user_data,
+                                                          GDestroyNotify                user_data_free_func);
 
 G_END_DECLS
 
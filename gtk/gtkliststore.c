@@ -21,8 +21,10 @@
 #include <string.h>
 #include <gobject/gvaluecollector.h>
 #include "gtktreemodel.h"
+#include "gtktreemodelprivate.h"
 #include "gtkliststore.h"
 #include "gtktreedatalist.h"
+#include "gtktreesortkeysprivate.h"
 #include "gtktreednd.h"
 #include "gtkintl.h"
 #include "gtkbuildable.h"
@@ -53,6 +55,18 @@
  * #GtkTreeModel::row_changed signal.  This most commonly affects lists with
  * #GdkPixbufs stored.
  *
+ * When adding many rows at once, wrap the changes between
+ * gtk_list_store_begin_update() and gtk_list_store_end_update(), or use
+ * gtk_list_store_append_rows(). The new rows are then announced with a
+ * few #GtkTreeModel::rows-inserted signals at the end, which views and
+ * filter and sort models handle much faster than one
+ * #GtkTreeModel::row-inserted per row.
+ *
+ * Rows that take long to produce, like the lines of a large file, can
+ * be loaded with gtk_list_store_load_async(). The rows are then produced
+ * in a worker thread and added in the background, so that a view of
+ * the store shows the first rows right away.
+ *
  * An example for creating a simple list store:
  * |[<!-- language="C" -->
  * enum {
@@ -189,12 +203,31 @@ struct _GtkListStorePrivate
   GtkSortType order;
 
   guint columns_dirty : 1;
+  guint batching      : 1;
 
   gpointer default_sort_data;
   gpointer seq;         /* head of the list */
+
+  /* Rows inserted since gtk_list_store_begin_update(), if all
+   * ::row-inserted handlers support ::rows-inserted
+   */
+  gint update_depth;
+  GHashTable *pending;
+
+  /* The LoadData of running gtk_list_store_load_async() calls */
+  GSList *loads;
 };
 
 #define GTK_LIST_STORE_IS_SORTED(list) (((GtkListStore*)(list))->priv->sort_column_id != GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID)
+
+/* gtk_list_store_load_async() hands rows over to the main thread in
+ * chunks of at most this many rows, or after this long, whatever
+ * comes first. The main thread adds rows for at most this long
+ * before it lets the main loop run.
+ */
+#define GTK_LIST_STORE_LOAD_MAX_ROWS_PER_CHUNK 1024
+#define GTK_LIST_STORE_LOAD_TIME_US_PER_CHUNK 5000
+#define GTK_LIST_STORE_LOAD_TIME_US_PER_FLUSH 5000
 static void         gtk_list_store_tree_model_init (GtkTreeModelIface *iface);
 static void         gtk_list_store_drag_source_init(GtkTreeDragSourceIface *iface);
 static void         gtk_list_store_drag_dest_init  (GtkTreeDragDestIface   *iface);
@@ -241,6 +274,9 @@ static void gtk_list_store_set_column_type (GtkListStore *list_store,
 					    GType         type);
 
 static void gtk_list_store_increment_stamp (GtkListStore *list_store);
+static void gtk_list_store_flush_pending   (GtkListStore *list_store);
+static void gtk_list_store_load_forget_row (gpointer       load_data,
+                                            GSequenceIter *row);
 
 
 /* Drag and Drop */
@@ -396,6 +432,133 @@ iter_is_valid (GtkTreeIter  *iter,
          g_sequence_iter_get_sequence (iter->user_data) == list_store->priv->seq;
 }
 
+static inline gboolean
+gtk_list_store_is_pending (GtkListStore  *list_store,
+                           GSequenceIter *siter)
+{
+  GtkListStorePrivate *priv = list_store->priv;
+
+  return priv->pending != NULL && g_hash_table_contains (priv->pending, siter);
+}
+
+static gboolean
+gtk_list_store_iter_is_pending (GtkTreeModel *tree_model,
+                                GtkTreeIter  *iter)
+{
+  return gtk_list_store_is_pending (GTK_LIST_STORE (tree_model), iter->user_data);
+}
+
+static gint
+compare_siters (gconstpointer a,
+                gconstpointer b)
+{
+  return g_sequence_iter_compare (*(GSequenceIter **) a, *(GSequenceIter **) b);
+}
+
+/* Announces the rows inserted during an update, one ::rows-inserted
+ * per run of adjacent rows, from the first to the last. Must run
+ * before any other change to the store, so that listeners see the
+ * insertions in a consistent order.
+ *
+ * The rows of a run stop being pending right before it is announced,
+ * so the rows that follow are still left out while handlers run.
+ * Handlers may change the store; rows they removed are skipped, and
+ * a nested flush announces all the remaining rows.
+ */
+static void
+gtk_list_store_flush_pending (GtkListStore *list_store)
+{
+  GtkListStorePrivate *priv = list_store->priv;
+  GHashTable *pending;
+  GSequenceIter **siters;
+  GtkTreeIter iter;
+  GtkTreePath *path;
+  guint n_siters, i, j;
+
+  if (priv->pending == NULL)
+    return;
+
+  pending = g_hash_table_ref (priv->pending);
+
+  siters = (GSequenceIter **) g_hash_table_get_keys_as_array (pending, &n_siters);
+  qsort (siters, n_siters, sizeof (GSequenceIter *), compare_siters);
+
+  for (i = 0; i < n_siters; i = j)
+    {
+      j = i + 1;
+
+      if (!g_hash_table_remove (pending, siters[i]))
+        continue;
+
+      while (j < n_siters &&
+             siters[j] == g_sequence_iter_next (siters[j - 1]) &&
+             g_hash_table_remove (pending, siters[j]))
+        j++;
+
+      iter.stamp = priv->stamp;
+      iter.user_data = siters[i];
+      path = gtk_tree_path_new ();
+      gtk_tree_path_append_index (path, g_sequence_iter_get_position (siters[i]));
+      gtk_tree_model_rows_inserted (GTK_TREE_MODEL (list_store), path, &iter, j - i);
+      gtk_tree_path_free (path);
+    }
+
+  if (priv->pending == pending && g_hash_table_size (pending) == 0)
+    {
+      priv->pending = NULL;
+      g_hash_table_unref (pending);
+      _gtk_tree_model_set_pending_func (GTK_TREE_MODEL (list_store), NULL);
+    }
+
+  g_free (siters);
+  g_hash_table_unref (pending);
+}
+
+static void
+gtk_list_store_row_inserted (GtkListStore *list_store,
+                             GtkTreeIter  *iter)
+{
+  GtkListStorePrivate *priv = list_store->priv;
+  GtkTreePath *path;
+
+  if (priv->update_depth > 0 && priv->batching)
+    {
+      if (priv->pending == NULL)
+        {
+          priv->pending = g_hash_table_new (NULL, NULL);
+          _gtk_tree_model_set_pending_func (GTK_TREE_MODEL (list_store),
+                                            gtk_list_store_iter_is_pending);
+        }
+
+      g_hash_table_add (priv->pending, iter->user_data);
+      return;
+    }
+
+  /* Rows can only be left pending here if a ::rows-inserted
+   * handler inserts rows
+   */
+  gtk_list_store_flush_pending (list_store);
+
+  path = gtk_list_store_get_path (GTK_TREE_MODEL (list_store), iter);
+  gtk_tree_model_row_inserted (GTK_TREE_MODEL (list_store), path, iter);
+  gtk_tree_path_free (path);
+}
+
+/* Rows that were not announced yet do not get ::row-changed either */
+static void
+gtk_list_store_row_changed (GtkListStore *list_store,
+                            GtkTreeIter  *iter)
+{
+  GtkTreePath *path;
+
+  if (gtk_list_store_is_pending (list_store, iter->user_data))
+    return;
+
+  path = gtk_list_store_get_path (GTK_TREE_MODEL (list_store), iter);
+  gtk_tree_model_row_changed (GTK_TREE_MODEL (list_store), path, iter);
+  gtk_tree_path_free (path);
+}
+
 /**
  * gtk_list_store_new:
  * @n_columns: number of columns in the list store
@@ -567,6 +730,9 @@ gtk_list_store_finalize (GObject *object)
 
   g_sequence_free (priv->seq);
 
+  if (priv->pending)
+    g_hash_table_unref (priv->pending);
+
   _gtk_tree_data_list_header_free (priv->sort_list);
   g_free (priv->column_headers);
 
@@ -935,14 +1101,11 @@ gtk_list_store_set_value (GtkListStore *list_store,
   priv = list_store->priv;
   g_return_if_fail (column >= 0 && column < priv->n_columns);
 
-  if (gtk_list_store_real_set_value (list_store, iter, column, value, TRUE))
-    {
-      GtkTreePath *path;
+  if (!gtk_list_store_is_pending (list_store, iter->user_data))
+    gtk_list_store_flush_pending (list_store);
 
-      path = gtk_list_store_get_path (GTK_TREE_MODEL (list_store), iter);
-      gtk_tree_model_row_changed (GTK_TREE_MODEL (list_store), path, iter);
-      gtk_tree_path_free (path);
-    }
+  if (gtk_list_store_real_set_value (list_store, iter, column, value, TRUE))
+    gtk_list_store_row_changed (list_store, iter);
 }
 
 static GtkTreeIterCompareFunc
@@ -1092,6 +1255,9 @@ gtk_list_store_set_valuesv (GtkListStore *list_store,
 
   priv = list_store->priv;
 
+  if (!gtk_list_store_is_pending (list_store, iter->user_data))
+    gtk_list_store_flush_pending (list_store);
+
   gtk_list_store_set_vector_internal (list_store, iter,
 				      &emit_signal,
 				      &maybe_need_sort,
@@ -1101,13 +1267,7 @@ gtk_list_store_set_valuesv (GtkListStore *list_store,
     gtk_list_store_sort_iter_changed (list_store, iter, priv->sort_column_id);
 
   if (emit_signal)
-    {
-      GtkTreePath *path;
-
-      path = gtk_list_store_get_path (GTK_TREE_MODEL (list_store), iter);
-      gtk_tree_model_row_changed (GTK_TREE_MODEL (list_store), path, iter);
-      gtk_tree_path_free (path);
-    }
+    gtk_list_store_row_changed (list_store, iter);
 }
 
 /**
@@ -1134,6 +1294,9 @@ gtk_list_store_set_valist (GtkListStore *list_store,
 
   priv = list_store->priv;
 
+  if (!gtk_list_store_is_pending (list_store, iter->user_data))
+    gtk_list_store_flush_pending (list_store);
+
   gtk_list_store_set_valist_internal (list_store, iter, 
 				      &emit_signal, 
 				      &maybe_need_sort,
@@ -1143,13 +1306,7 @@ gtk_list_store_set_valist (GtkListStore *list_store,
     gtk_list_store_sort_iter_changed (list_store, iter, priv->sort_column_id);
 
   if (emit_signal)
-    {
-      GtkTreePath *path;
-
-      path = gtk_list_store_get_path (GTK_TREE_MODEL (list_store), iter);
-      gtk_tree_model_row_changed (GTK_TREE_MODEL (list_store), path, iter);
-      gtk_tree_path_free (path);
-    }
+    gtk_list_store_row_changed (list_store, iter);
 }
 
 /**
@@ -1198,24 +1355,41 @@ gtk_list_store_remove (GtkListStore *list_store,
   GtkListStorePrivate *priv;
   GtkTreePath *path;
   GSequenceIter *ptr, *next;
+  GSList *l;
 
   g_return_val_if_fail (GTK_IS_LIST_STORE (list_store), FALSE);
   g_return_val_if_fail (iter_is_valid (iter, list_store), FALSE);
 
   priv = list_store->priv;
 
-  path = gtk_list_store_get_path (GTK_TREE_MODEL (list_store), iter);
-
   ptr = iter->user_data;
   next = g_sequence_iter_next (ptr);
-  
+
+  /* Rows that were never announced go away silently */
+  if (gtk_list_store_is_pending (list_store, ptr))
+    {
+      g_hash_table_remove (priv->pending, ptr);
+      path = NULL;
+    }
+  else
+    {
+      gtk_list_store_flush_pending (list_store);
+      path = gtk_list_store_get_path (GTK_TREE_MODEL (list_store), iter);
+    }
+
+  for (l = priv->loads; l; l = l->next)
+    gtk_list_store_load_forget_row (l->data, ptr);
+
   _gtk_tree_data_list_free (g_sequence_get (ptr), priv->column_headers);
   g_sequence_remove (iter->user_data);
 
   priv->length--;
-  
-  gtk_tree_model_row_deleted (GTK_TREE_MODEL (list_store), path);
-  gtk_tree_path_free (path);
+
+  if (path)
+    {
+      gtk_tree_model_row_deleted (GTK_TREE_MODEL (list_store), path);
+      gtk_tree_path_free (path);
+    }
 
   if (g_sequence_iter_is_end (next))
     {
@@ -1249,7 +1423,6 @@ gtk_list_store_insert (GtkListStore *list_store,
 		       gint          position)
 {
   GtkListStorePrivate *priv;
-  GtkTreePath *path;
   GSequence *seq;
   GSequenceIter *ptr;
   gint length;
@@ -1276,11 +1449,8 @@ gtk_list_store_insert (GtkListStore *list_store,
   g_assert (iter_is_valid (iter, list_store));
 
   priv->length++;
-  
-  path = gtk_tree_path_new ();
-  gtk_tree_path_append_index (path, position);
-  gtk_tree_model_row_inserted (GTK_TREE_MODEL (list_store), path, iter);
-  gtk_tree_path_free (path);
+
+  gtk_list_store_row_inserted (list_store, iter);
 }
 
 /**
@@ -1395,6 +1565,496 @@ gtk_list_store_append (GtkListStore *list_store,
   gtk_list_store_insert (list_store, iter, -1);
 }
 
+/**
+ * gtk_list_store_append_rows:
+ * @list_store: A #GtkListStore
+ * @iter: (out) (optional): An unset #GtkTreeIter to set to the first
+ *   appended row, or %NULL
+ * @n_rows: the number of rows to append
+ *
+ * Appends @n_rows empty rows to @list_store, and announces them with a
+ * single #GtkTreeModel::rows-inserted signal if all the listeners of
+ * the store support it. This is much faster than calling
+ * gtk_list_store_append() @n_rows times when the store is displayed.
+ * If @n_rows is 0, @iter is invalidated.
+ *
+ * Since: 3.20
+ */
+void
+gtk_list_store_append_rows (GtkListStore *list_store,
+                            GtkTreeIter  *iter,
+                            gint          n_rows)
+{
+  GtkListStorePrivate *priv;
+  GSequenceIter *ptr, *first;
+  GtkTreeIter tmp_iter;
+  gint i;
+
+  g_return_if_fail (GTK_IS_LIST_STORE (list_store));
+  g_return_if_fail (n_rows >= 0);
+
+  priv = list_store->priv;
+
+  if (iter)
+    iter->stamp = 0;
+
+  if (n_rows == 0)
+    return;
+
+  priv->columns_dirty = TRUE;
+
+  gtk_list_store_begin_update (list_store);
+
+  first = NULL;
+  for (i = 0; i < n_rows; i++)
+    {
+      ptr = g_sequence_append (priv->seq, NULL);
+      if (first == NULL)
+        first = ptr;
+
+      priv->length++;
+
+      tmp_iter.stamp = priv->stamp;
+      tmp_iter.user_data = ptr;
+      gtk_list_store_row_inserted (list_store, &tmp_iter);
+    }
+
+  if (iter)
+    {
+      iter->stamp = priv->stamp;
+      iter->user_data = first;
+    }
+
+  gtk_list_store_end_update (list_store);
+}
+
+/**
+ * gtk_list_store_begin_update:
+ * @list_store: A #GtkListStore
+ *
+ * Starts a batch of changes to @list_store. Until the matching call to
+ * gtk_list_store_end_update(), rows inserted into @list_store are not
+ * announced one by one; when the batch ends, adjacent new rows are
+ * announced together with #GtkTreeModel::rows-inserted.
+ *
+ * This only happens if all the #GtkTreeModel::row-inserted handlers
+ * connected to @list_store when the batch starts also handle
+ * #GtkTreeModel::rows-inserted, like the ones of #GtkTreeView,
+ * #GtkTreeModelSort and #GtkTreeModelFilter. Otherwise the rows are
+ * announced as usual.
+ *
+ * The new rows can be filled in meanwhile without causing
+ * #GtkTreeModel::row-changed emissions. Any other change to the store,
+ * like removing or changing a row that existed before, announces the
+ * rows inserted so far first.
+ *
+ * Calls to this function can be nested.
+ *
+ * Since: 3.20
+ */
+void
+gtk_list_store_begin_update (GtkListStore *list_store)
+{
+  GtkListStorePrivate *priv;
+
+  g_return_if_fail (GTK_IS_LIST_STORE (list_store));
+
+  priv = list_store->priv;
+
+  if (priv->update_depth++ == 0)
+    priv->batching = _gtk_tree_model_can_batch (GTK_TREE_MODEL (list_store));
+}
+
+/**
+ * gtk_list_store_end_update:
+ * @list_store: A #GtkListStore
+ *
+ * Ends a batch of changes started with gtk_list_store_begin_update().
+ * When the outermost batch ends, the rows inserted during it are
+ * announced.
+ *
+ * Since: 3.20
+ */
+void
+gtk_list_store_end_update (GtkListStore *list_store)
+{
+  GtkListStorePrivate *priv;
+
+  g_return_if_fail (GTK_IS_LIST_STORE (list_store));
+
+  priv = list_store->priv;
+
+  g_return_if_fail (priv->update_depth > 0);
+
+  priv->update_depth--;
+  if (priv->update_depth == 0)
+    gtk_list_store_flush_pending (list_store);
+}
+
+typedef struct {
+  GtkListStoreLoadFunc func;
+  gpointer func_data;
+  GDestroyNotify func_data_destroy;
+  GType *types;
+  gint *columns;
+  gint n_columns;
+
+  /* The rows added so far, removed again on cancellation */
+  GHashTable *rows;
+
+  /* Shared with the worker thread */
+  GMutex lock;
+  GQueue chunks;
+  GError *error;
+  guint flush_id;
+  guint producer_done : 1;
+  guint finished : 1;
+} LoadData;
+
+typedef struct {
+  gint n_rows;
+  GValue *values;
+} LoadChunk;
+
+static LoadChunk *
+load_chunk_new (LoadData *data)
+{
+  LoadChunk *chunk;
+
+  chunk = g_slice_new (LoadChunk);
+  chunk->n_rows = 0;
+  chunk->values = g_new0 (GValue, GTK_LIST_STORE_LOAD_MAX_ROWS_PER_CHUNK * data->n_columns);
+
+  return chunk;
+}
+
+static void
+load_chunk_free (LoadData  *data,
+                 LoadChunk *chunk)
+{
+  gint i;
+
+  for (i = 0; i < chunk->n_rows * data->n_columns; i++)
+    g_value_unset (&chunk->values[i]);
+
+  g_free (chunk->values);
+  g_slice_free (LoadChunk, chunk);
+}
+
+static void
+load_data_free (gpointer user_data)
+{
+  LoadData *data = user_data;
+  LoadChunk *chunk;
+
+  while ((chunk = g_queue_pop_head (&data->chunks)))
+    load_chunk_free (data, chunk);
+
+  if (data->func_data_destroy)
+    data->func_data_destroy (data->func_data);
+
+  g_clear_error (&data->error);
+  g_hash_table_unref (data->rows);
+  g_mutex_clear (&data->lock);
+  g_free (data->types);
+  g_free (data->columns);
+  g_slice_free (LoadData, data);
+}
+
+static void
+gtk_list_store_load_forget_row (gpointer       load_data,
+                                GSequenceIter *row)
+{
+  LoadData *data = load_data;
+
+  g_hash_table_remove (data->rows, row);
+}
+
+/* Removes the rows that a cancelled load added */
+static void
+load_remove_rows (GtkListStore *list_store,
+                  LoadData     *data)
+{
+  GSequenceIter **rows;
+  GtkTreeIter iter;
+  guint i, n_rows;
+
+  rows = (GSequenceIter **) g_hash_table_get_keys_as_array (data->rows, &n_rows);
+
+  for (i = 0; i < n_rows; i++)
+    {
+      iter.stamp = list_store->priv->stamp;
+      iter.user_data = rows[i];
+      gtk_list_store_remove (list_store, &iter);
+    }
+
+  g_free (rows);
+}
+
+static void
+load_finished (GtkListStore *list_store,
+               LoadData     *data)
+{
+  GtkListStorePrivate *priv = list_store->priv;
+
+  priv->loads = g_slist_remove (priv->loads, data);
+  g_hash_table_remove_all (data->rows);
+}
+
+static gboolean
+load_flush (gpointer user_data)
+{
+  GTask *task = user_data;
+  LoadData *data = g_task_get_task_data (task);
+  GtkListStore *list_store = g_task_get_source_object (task);
+  LoadChunk *chunk;
+  GtkTreeIter iter;
+  gboolean done;
+  gint64 end_time;
+  gint i;
+
+  if (g_cancellable_is_cancelled (g_task_get_cancellable (task)))
+    {
+      g_mutex_lock (&data->lock);
+      data->flush_id = 0;
+      data->finished = TRUE;
+      g_mutex_unlock (&data->lock);
+
+      load_remove_rows (list_store, data);
+      load_finished (list_store, data);
+      g_task_return_error_if_cancelled (task);
+
+      return G_SOURCE_REMOVE;
+    }
+
+  end_time = g_get_monotonic_time () + GTK_LIST_STORE_LOAD_TIME_US_PER_FLUSH;
+
+  gtk_list_store_begin_update (list_store);
+
+  do
+    {
+      g_mutex_lock (&data->lock);
+      chunk = g_queue_pop_head (&data->chunks);
+      done = chunk == NULL && data->producer_done;
+      if (chunk == NULL)
+        {
+          data->flush_id = 0;
+          data->finished = done;
+        }
+      g_mutex_unlock (&data->lock);
+
+      if (chunk == NULL)
+        break;
+
+      for (i = 0; i < chunk->n_rows; i++)
+        {
+          gtk_list_store_insert_with_valuesv (list_store, &iter, -1,
+                                              data->columns,
+                                              &chunk->values[i * data->n_columns],
+                                              data->n_columns);
+          g_hash_table_add (data->rows, iter.user_data);
+        }
+
+      load_chunk_free (data, chunk);
+    }
+  while (g_get_monotonic_time () < end_time);
+
+  gtk_list_store_end_update (list_store);
+
+  if (done)
+    {
+      load_finished (list_store, data);
+
+      if (data->error)
+        {
+          g_task_return_error (task, data->error);
+          data->error = NULL;
+        }
+      else
+        g_task_return_boolean (task, TRUE);
+    }
+
+  return chunk == NULL ? G_SOURCE_REMOVE : G_SOURCE_CONTINUE;
+}
+
+/* Called with the lock held */
+static void
+load_queue_flush (GTask    *task,
+                  LoadData *data)
+{
+  if (data->flush_id != 0 || data->finished)
+    return;
+
+  data->flush_id = gdk_threads_add_idle_full (G_PRIORITY_DEFAULT_IDLE,
+                                              load_flush,
+                                              g_object_ref (task),
+                                              g_object_unref);
+  g_source_set_name_by_id (data->flush_id, "[gtk+] gtk_list_store_load");
+}
+
+static void
+load_thread (GTask        *worker,
+             gpointer      source_object,
+             gpointer      task_data,
+             GCancellable *cancellable)
+{
+  GTask *task = task_data;
+  LoadData *data = g_task_get_task_data (task);
+  LoadChunk *chunk = NULL;
+  GError *error = NULL;
+  gint64 chunk_start = 0;
+  GValue *values;
+  gint i;
+
+  while (!g_cancellable_set_error_if_cancelled (cancellable, &error))
+    {
+      if (chunk == NULL)
+        {
+          chunk = load_chunk_new (data);
+          chunk_start = g_get_monotonic_time ();
+        }
+
+      values = &chunk->values[chunk->n_rows * data->n_columns];
+      for (i = 0; i < data->n_columns; i++)
+        g_value_init (&values[i], data->types[i]);
+
+      if (!data->func (values, cancellable, &error, data->func_data))
+        {
+          for (i = 0; i < data->n_columns; i++)
+            g_value_unset (&values[i]);
+          break;
+        }
+
+      chunk->n_rows++;
+
+      if (chunk->n_rows == GTK_LIST_STORE_LOAD_MAX_ROWS_PER_CHUNK ||
+          g_get_monotonic_time () - chunk_start >= GTK_LIST_STORE_LOAD_TIME_US_PER_CHUNK)
+        {
+          g_mutex_lock (&data->lock);
+          g_queue_push_tail (&data->chunks, chunk);
+          load_queue_flush (task, data);
+          g_mutex_unlock (&data->lock);
+
+          chunk = NULL;
+        }
+    }
+
+  g_mutex_lock (&data->lock);
+  if (chunk != NULL && chunk->n_rows > 0)
+    g_queue_push_tail (&data->chunks, chunk);
+  else if (chunk != NULL)
+    load_chunk_free (data, chunk);
+  data->error = error;
+  data->producer_done = TRUE;
+  load_queue_flush (task, data);
+  g_mutex_unlock (&data->lock);
+
+  g_task_return_boolean (worker, TRUE);
+}
+
+/**
+ * gtk_list_store_load_async:
+ * @list_store: A #GtkListStore
+ * @func: (scope notified): the function that produces the rows
+ * @func_data: (closure func): user data for @func
+ * @func_data_destroy: (allow-none): destroy notifier for @func_data
+ * @cancellable: (allow-none): optional #GCancellable object, %NULL to ignore
+ * @callback: (scope async): a #GAsyncReadyCallback to call when all
+ *     rows have been added
+ * @user_data: (closure callback): the data to pass to callback function
+ *
+ * Appends rows to @list_store as they are produced by @func, which is
+ * called repeatedly in a worker thread until it returns %FALSE.
+ *
+ * The rows are added in chunks from the main loop, a few milliseconds
+ * at a time, and announced with #GtkTreeModel::rows-inserted. So a
+ * view of @list_store stays responsive and shows the rows loaded so
+ * far while loading goes on. If the store is sorted, each row is
+ * inserted at its sorted position.
+ *
+ * When all rows have been added, @callback is called, and
+ * gtk_list_store_load_finish() returns the result. If @func fails,
+ * the rows it produced before are still added. If @cancellable is
+ * cancelled, the rows that were already added are removed again, and
+ * the rest are dropped, so that no partial result remains.
+ *
+ * The columns of @list_store must not be changed while loading.
+ *
+ * Since: 3.20
+ */
+void
+gtk_list_store_load_async (GtkListStore         *list_store,
+                           GtkListStoreLoadFunc  func,
+                           gpointer              func_data,
+                           GDestroyNotify        func_data_destroy,
+                           GCancellable         *cancellable,
+                           GAsyncReadyCallback   callback,
+                           gpointer              user_data)
+{
+  GtkListStorePrivate *priv;
+  LoadData *data;
+  GTask *task, *worker;
+  gint i;
+
+  g_return_if_fail (GTK_IS_LIST_STORE (list_store));
+  g_return_if_fail (func != NULL);
+
+  priv = list_store->priv;
+
+  data = g_slice_new0 (LoadData);
+  data->func = func;
+  data->func_data = func_data;
+  data->func_data_destroy = func_data_destroy;
+  data->n_columns = priv->n_columns;
+  data->types = g_memdup (priv->column_headers, sizeof (GType) * priv->n_columns);
+  data->columns = g_new (gint, priv->n_columns);
+  for (i = 0; i < priv->n_columns; i++)
+    data->columns[i] = i;
+  data->rows = g_hash_table_new (NULL, NULL);
+  g_mutex_init (&data->lock);
+  g_queue_init (&data->chunks);
+
+  priv->columns_dirty = TRUE;
+  priv->loads = g_slist_prepend (priv->loads, data);
+
+  task = g_task_new (list_store, cancellable, callback, user_data);
+  g_task_set_source_tag (task, gtk_list_store_load_async);
+  g_task_set_task_data (task, data, load_data_free);
+
+  /* The worker only runs the thread, @task is returned from the
+   * main thread once all rows have been added
+   */
+  worker = g_task_new (NULL, cancellable, NULL, NULL);
+  g_task_set_task_data (worker, task, g_object_unref);
+  g_task_run_in_thread (worker, load_thread);
+  g_object_unref (worker);
+}
+
+/**
+ * gtk_list_store_load_finish:
+ * @list_store: A #GtkListStore
+ * @result: a #GAsyncResult
+ * @error: (allow-none): location to store error information on failure,
+ *     or %NULL.
+ *
+ * Finishes loading rows with gtk_list_store_load_async().
+ *
+ * Returns: %TRUE if all rows were added, %FALSE on error or
+ *     cancellation
+ *
+ * Since: 3.20
+ */
+gboolean
+gtk_list_store_load_finish (GtkListStore  *list_store,
+                            GAsyncResult  *result,
+                            GError       **error)
+{
+  g_return_val_if_fail (GTK_IS_LIST_STORE (list_store), FALSE);
+  g_return_val_if_fail (g_task_is_valid (result, list_store), FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
+
 static void
 gtk_list_store_increment_stamp (GtkListStore *list_store)
 {
@@ -1568,7 +2228,6 @@ gtk_list_store_drag_data_received (GtkTreeDragDest   *drag_dest,
           GtkTreeDataList *copy_head = NULL;
           GtkTreeDataList *copy_prev = NULL;
           GtkTreeDataList *copy_iter = NULL;
-	  GtkTreePath *path;
           gint col;
 
           col = 0;
@@ -1592,9 +2251,7 @@ gtk_list_store_drag_data_received (GtkTreeDragDest   *drag_dest,
 	  dest_iter.stamp = priv->stamp;
           g_sequence_set (dest_iter.user_data, copy_head);
 
-	  path = gtk_list_store_get_path (tree_model, &dest_iter);
-	  gtk_tree_model_row_changed (tree_model, path, &dest_iter);
-	  gtk_tree_path_free (path);
+          gtk_list_store_row_changed (list_store, &dest_iter);
 	}
     }
   else
@@ -1700,6 +2357,8 @@ gtk_list_store_reorder (GtkListStore *store,
 
   priv = store->priv;
 
+  gtk_list_store_flush_pending (store);
+
   order = g_new (gint, g_sequence_get_length (priv->seq));
   for (i = 0; i < g_sequence_get_length (priv->seq); i++)
     order[new_order[i]] = i;
@@ -1797,6 +2456,8 @@ gtk_list_store_swap (GtkListStore *store,
   if (a->user_data == b->user_data)
     return;
 
+  gtk_list_store_flush_pending (store);
+
   old_positions = save_positions (priv->seq);
   
   g_sequence_swap (a->user_data, b->user_data);
@@ -1821,6 +2482,8 @@ gtk_list_store_move_to (GtkListStore *store,
   GtkTreePath *path;
   gint *order;
 
+  gtk_list_store_flush_pending (store);
+
   old_positions = save_positions (priv->seq);
 
   g_sequence_move (iter->user_data, g_sequence_get_iter_at_pos (priv->seq, new_pos));
@@ -1954,10 +2617,46 @@ gtk_list_store_compare_func (GSequenceIter *a,
   return retval;
 }
 
+/* Sorts by the values of a column, which are only fetched once */
+static gint *
+gtk_list_store_sort_keys (GtkListStore    *list_store,
+                          GtkTreeSortKeys *keys)
+{
+  GtkListStorePrivate *priv = list_store->priv;
+  GSequenceIter **siters;
+  GSequenceIter *end_siter;
+  GtkTreeIter iter;
+  gint *new_order;
+  gint length, i;
+
+  length = g_sequence_get_length (priv->seq);
+  siters = g_new (GSequenceIter *, length);
+
+  iter.stamp = priv->stamp;
+  iter.user_data = g_sequence_get_begin_iter (priv->seq);
+  for (i = 0; i < length; i++)
+    {
+      siters[i] = iter.user_data;
+      gtk_tree_sort_keys_set (keys, i, &iter);
+      iter.user_data = g_sequence_iter_next (iter.user_data);
+    }
+
+  new_order = gtk_tree_sort_keys_sort (keys);
+
+  end_siter = g_sequence_get_end_iter (priv->seq);
+  for (i = 0; i < length; i++)
+    g_sequence_move (siters[new_order[i]], end_siter);
+
+  g_free (siters);
+
+  return new_order;
+}
+
 static void
 gtk_list_store_sort (GtkListStore *list_store)
 {
   GtkListStorePrivate *priv = list_store->priv;
+  GtkTreeSortKeys *keys = NULL;
   gint *new_order;
   GtkTreePath *path;
   GHashTable *old_positions;
@@ -1966,13 +2665,38 @@ gtk_list_store_sort (GtkListStore *list_store)
       g_sequence_get_length (priv->seq) <= 1)
     return;
 
-  old_positions = save_positions (priv->seq);
+  gtk_list_store_flush_pending (list_store);
 
-  g_sequence_sort_iter (priv->seq, gtk_list_store_compare_func, list_store);
+  if (priv->sort_column_id != GTK_TREE_SORTABLE_DEFAULT_SORT_COLUMN_ID)
+    {
+      GtkTreeDataSortHeader *header;
 
-  /* Let the world know about our new order */
-  new_order = generate_order (priv->seq, old_positions);
+      header = _gtk_tree_data_list_get_header (priv->sort_list,
+                                               priv->sort_column_id);
+      g_return_if_fail (header != NULL);
+      g_return_if_fail (header->func != NULL);
+
+      keys = gtk_tree_sort_keys_new (GTK_TREE_MODEL (list_store),
+                                     header->func, header->data,
+                                     priv->order,
+                                     g_sequence_get_length (priv->seq));
+    }
+
+  if (keys)
+    {
+      new_order = gtk_list_store_sort_keys (list_store, keys);
+      gtk_tree_sort_keys_free (keys);
+    }
+  else
+    {
+      old_positions = save_positions (priv->seq);
+
+      g_sequence_sort_iter (priv->seq, gtk_list_store_compare_func, list_store);
+
+      new_order = generate_order (priv->seq, old_positions);
+    }
 
+  /* Let the world know about our new order */
   path = gtk_tree_path_new ();
   gtk_tree_model_rows_reordered (GTK_TREE_MODEL (list_store),
 				 path, NULL, new_order);
@@ -2012,6 +2736,16 @@ gtk_list_store_sort_iter_changed (GtkListStore *list_store,
   GtkListStorePrivate *priv = list_store->priv;
   GtkTreePath *path;
 
+  /* A row that was not announced yet only needs to be put in place */
+  if (gtk_list_store_is_pending (list_store, iter->user_data))
+    {
+      if (!iter_is_sorted (list_store, iter))
+        g_sequence_sort_changed_iter (iter->user_data,
+                                      gtk_list_store_compare_func,
+                                      list_store);
+      return;
+    }
+
   path = gtk_list_store_get_path (GTK_TREE_MODEL (list_store), iter);
   gtk_tree_model_row_changed (GTK_TREE_MODEL (list_store), path, iter);
   gtk_tree_path_free (path);
@@ -2183,7 +2917,6 @@ gtk_list_store_insert_with_values (GtkListStore *list_store,
 				   ...)
 {
   GtkListStorePrivate *priv;
-  GtkTreePath *path;
   GSequence *seq;
   GSequenceIter *ptr;
   GtkTreeIter tmp_iter;
@@ -2231,9 +2964,7 @@ gtk_list_store_insert_with_values (GtkListStore *list_store,
 				  list_store);
 
   /* Just emit row_inserted */
-  path = gtk_list_store_get_path (GTK_TREE_MODEL (list_store), iter);
-  gtk_tree_model_row_inserted (GTK_TREE_MODEL (list_store), path, iter);
-  gtk_tree_path_free (path);
+  gtk_list_store_row_inserted (list_store, iter);
 }
 
 
@@ -2262,7 +2993,6 @@ gtk_list_store_insert_with_valuesv (GtkListStore *list_store,
 				    gint          n_values)
 {
   GtkListStorePrivate *priv;
-  GtkTreePath *path;
   GSequence *seq;
   GSequenceIter *ptr;
   GtkTreeIter tmp_iter;
@@ -2309,9 +3039,7 @@ gtk_list_store_insert_with_valuesv (GtkListStore *list_store,
 				  list_store);
 
   /* Just emit row_inserted */
-  path = gtk_list_store_get_path (GTK_TREE_MODEL (list_store), iter);
-  gtk_tree_model_row_inserted (GTK_TREE_MODEL (list_store), path, iter);
-  gtk_tree_path_free (path);
+  gtk_list_store_row_inserted (list_store, iter);
 }
 
 /* GtkBuildable custom tag implementation
@@ -60,6 +60,29 @@ struct _GtkListStoreClass
   void (*_gtk_reserved4) (void);
 };
 
+/**
+ * GtkListStoreLoadFunc:
+ * @values: (array): one #GValue for each column of the store, already
+ *   initialized to the column types
+ * @cancellable: (allow-none): the #GCancellable given to
+ *   gtk_list_store_load_async()
+ * @error: return location for an error
+ * @data: (closure): user data given to gtk_list_store_load_async()
+ *
+ * A function that produces the rows for gtk_list_store_load_async(),
+ * one row per call. It is called in a worker thread, so it must not
+ * use the store or any other GTK+ object.
+ *
+ * Returns: %TRUE if @values hold a new row, %FALSE if there are no
+ *   more rows or if @error was set
+ *
+ * Since: 3.20
+ */
+typedef gboolean (* GtkListStoreLoadFunc) (GValue        *values,
+                                           GCancellable  *cancellable,
+                                           GError       **error,
+                                           gpointer       data);
+
 
 GDK_AVAILABLE_IN_ALL
 GType         gtk_list_store_get_type         (void) G_GNUC_CONST;
@@ -128,6 +151,26 @@ void          gtk_list_store_prepend          (GtkListStore *list_store,
 GDK_AVAILABLE_IN_ALL
 void          gtk_list_store_append           (GtkListStore *list_store,
 					       GtkTreeIter  *iter);
+GDK_AVAILABLE_IN_3_20
+void          gtk_list_store_append_rows      (GtkListStore *list_store,
+                                               GtkTreeIter  *iter,
+                                               gint          n_rows);
+GDK_AVAILABLE_IN_3_20
+void          gtk_list_store_begin_update     (GtkListStore *list_store);
+GDK_AVAILABLE_IN_3_20
+void          gtk_list_store_end_update       (GtkListStore *list_store);
+GDK_AVAILABLE_IN_3_20
+void          gtk_list_store_load_async       (GtkListStore         *list_store,
+                                               GtkListStoreLoadFunc  func,
+                                               gpointer              func_data,
+                                               GDestroyNotify        func_data_destroy,
+                                               GCancellable         *cancellable,
+                                               GAsyncReadyCallback   callback,
+                                               gpointer              user_data);
+GDK_AVAILABLE_IN_3_20
+gboolean      gtk_list_store_load_finish      (GtkListStore         *list_store,
+                                               GAsyncResult         *result,
+                                               GError              **error);
 GDK_AVAILABLE_IN_ALL
 void          gtk_list_store_clear            (GtkListStore *list_store);
 GDK_AVAILABLE_IN_ALL
@@ -116,6 +116,7 @@
 #include "gtkclipboard.h"
 #include "gtkdebug.h"
 #include "gtkdndprivate.h"
+#include "gtklayouttraceprivate.h"
 #include "gtkmain.h"
 #include "gtkmenu.h"
 #include "gtkmodules.h"
@@ -181,6 +182,8 @@ static const GDebugKey gtk_debug_keys[] = {
   {"interactive", GTK_DEBUG_INTERACTIVE},
   {"touchscreen", GTK_DEBUG_TOUCHSCREEN},
   {"actions", GTK_DEBUG_ACTIONS},
+  {"draw-cache", GTK_DEBUG_DRAW_CACHE},
+  {"resize", GTK_DEBUG_RESIZE},
 };
 #endif /* G_ENABLE_DEBUG */
 
@@ -418,6 +421,7 @@ gtk_arg_debug_cb (const char *key, const char *value, gpointer user_data)
   debug_flags |= g_parse_debug_string (value,
                                        gtk_debug_keys,
                                        G_N_ELEMENTS (gtk_debug_keys));
+  gtk_layout_trace_update_enabled ();
 
   return TRUE;
 }
@@ -428,6 +432,7 @@ gtk_arg_no_debug_cb (const char *key, const char *value, gpointer user_data)
   debug_flags &= ~g_parse_debug_string (value,
                                         gtk_debug_keys,
                                         G_N_ELEMENTS (gtk_debug_keys));
+  gtk_layout_trace_update_enabled ();
 
   return TRUE;
 }
@@ -653,10 +658,15 @@ do_pre_parse_initialization (int    *argc,
       debug_flags = g_parse_debug_string (env_string,
                                           gtk_debug_keys,
                                           G_N_ELEMENTS (gtk_debug_keys));
+      gtk_layout_trace_update_enabled ();
       env_string = NULL;
     }
 #endif  /* G_ENABLE_DEBUG */
 
+  /* Available without G_ENABLE_DEBUG, see gtkwidget.c */
+  if (g_strcmp0 (g_getenv ("GTK_DRAW_CACHE"), "1") == 0)
+    debug_flags |= GTK_DEBUG_DRAW_CACHE;
+
   env_string = g_getenv ("GTK3_MODULES");
   if (env_string)
     gtk_modules_string = g_string_new (env_string);
@@ -820,6 +830,7 @@ void
 gtk_set_debug_flags (guint flags)
 {
   debug_flags = flags;
+  gtk_layout_trace_update_enabled ();
 }
 
 gboolean
@@ -611,10 +611,15 @@ tick_cb (GtkWidget     *widget,
   g_assert (priv->pulse2 > priv->pulse1);
   g_assert (frame2 > priv->frame1);
 
+  /* Pulses stopped arriving; don't keep the frame clock running
+   * for frames that don't change anything. The next pulse restarts us.
+   */
   if (frame2 - priv->pulse2 > 3 * (priv->pulse2 - priv->pulse1))
     {
       priv->pulse1 = 0;
-      return G_SOURCE_CONTINUE;
+      priv->frame1 = 0;
+      priv->tick_id = 0;
+      return G_SOURCE_REMOVE;
     }
 
   /* Determine the fraction to move the block from one frame
@@ -702,7 +707,7 @@ gtk_progress_bar_act_mode_enter (GtkProgressBar *pbar)
         }
     }
 
-  priv->tick_id = gtk_widget_add_tick_callback (widget, tick_cb, NULL, NULL);
+  priv->tick_id = gtk_widget_add_mapped_tick_callback (widget, tick_cb, NULL, NULL);
   priv->pulse2 = 0;
   priv->pulse1 = 0;
   priv->frame1 = 0;
@@ -1141,6 +1146,9 @@ gtk_progress_bar_update_pulse (GtkProgressBar *pbar)
 
   priv->pulse1 = priv->pulse2;
   priv->pulse2 = g_get_monotonic_time ();
+
+  if (priv->activity_mode && priv->tick_id == 0)
+    priv->tick_id = gtk_widget_add_mapped_tick_callback (GTK_WIDGET (pbar), tick_cb, NULL, NULL);
 }
 
 /**
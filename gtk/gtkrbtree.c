@@ -556,6 +556,81 @@ _gtk_rbtree_insert_before (GtkRBTree *tree,
   return node;
 }
 
+static GtkRBNode *
+_gtk_rbtree_fill_helper (GtkRBTree *tree,
+                         GtkRBNode *parent,
+                         gint       n_nodes,
+                         gint       height,
+                         gboolean   valid,
+                         gint       depth,
+                         gint       red_depth)
+{
+  GtkRBNode *node;
+  gint n_left;
+
+  node = _gtk_rbnode_new (tree, height);
+  node->parent = parent;
+  if (depth != red_depth)
+    GTK_RBNODE_SET_COLOR (node, GTK_RBNODE_BLACK);
+  if (!valid)
+    GTK_RBNODE_SET_FLAG (node, GTK_RBNODE_INVALID | GTK_RBNODE_DESCENDANTS_INVALID);
+
+  n_left = (n_nodes - 1) / 2;
+  if (n_left > 0)
+    node->left = _gtk_rbtree_fill_helper (tree, node, n_left, height, valid,
+                                          depth + 1, red_depth);
+  if (n_nodes - 1 - n_left > 0)
+    node->right = _gtk_rbtree_fill_helper (tree, node, n_nodes - 1 - n_left, height, valid,
+                                           depth + 1, red_depth);
+
+  node->count = n_nodes;
+  node->total_count = n_nodes;
+  node->offset = n_nodes * height;
+
+  return node;
+}
+
+/**
+ * _gtk_rbtree_fill:
+ * @tree: an empty tree
+ * @n_nodes: the number of nodes to add
+ * @height: the height of each node
+ * @valid: whether the nodes are valid
+ *
+ * Fills @tree with @n_nodes nodes of the same height. This gives
+ * the same result as inserting them one after the other, but builds
+ * the balanced tree directly, in linear time and without any
+ * rotations.
+ **/
+void
+_gtk_rbtree_fill (GtkRBTree *tree,
+                  gint       n_nodes,
+                  gint       height,
+                  gboolean   valid)
+{
+  g_return_if_fail (tree != NULL);
+  g_return_if_fail (_gtk_rbtree_is_nil (tree->root));
+
+  if (n_nodes <= 0)
+    return;
+
+  /* Splitting in the middle keeps all levels but the bottom one
+   * full. Making the bottom level red then gives every path the
+   * same number of black nodes.
+   */
+  tree->root = _gtk_rbtree_fill_helper (tree, (GtkRBNode *) &nil,
+                                        n_nodes, height, valid,
+                                        0, n_nodes > 1 ? g_bit_nth_msf (n_nodes, -1) : -1);
+
+  gtk_rbnode_adjust (tree->parent_tree, tree->parent_node,
+                     0, n_nodes, n_nodes * height);
+
+#ifdef G_ENABLE_DEBUG
+  if (GTK_DEBUG_CHECK (TREE))
+    _gtk_rbtree_test (G_STRLOC, tree);
+#endif
+}
+
 GtkRBNode *
 _gtk_rbtree_find_count (GtkRBTree *tree,
 			gint       count)
@@ -774,61 +849,64 @@ reorder_prepare (GtkRBTree *tree,
   GTK_RBNODE_UNSET_FLAG (node, GTK_RBNODE_DESCENDANTS_INVALID);
 }
 
-static void
-reorder_fixup (GtkRBTree *tree,
-               GtkRBNode *node,
-               gpointer   data)
+/* Links nodes[0..n_nodes) into a balanced subtree, in that order.
+ * Each node's offset must only hold its own height and that of its
+ * children when this is called.
+ */
+static GtkRBNode *
+reorder_link (GtkRBTree  *tree,
+              GtkRBNode **nodes,
+              gint        n_nodes,
+              GtkRBNode  *parent,
+              gint        depth,
+              gint        red_depth)
 {
+  GtkRBNode *node;
+  gint n_left;
+
+  if (n_nodes == 0)
+    return (GtkRBNode *) &nil;
+
+  n_left = (n_nodes - 1) / 2;
+  node = nodes[n_left];
+
+  node->flags = (node->flags & GTK_RBNODE_NON_COLORS) |
+                (depth == red_depth ? GTK_RBNODE_RED : GTK_RBNODE_BLACK);
+  node->parent = parent;
+  node->left = reorder_link (tree, nodes, n_left, node,
+                             depth + 1, red_depth);
+  node->right = reorder_link (tree, nodes + n_left + 1, n_nodes - 1 - n_left, node,
+                              depth + 1, red_depth);
+
   node->offset += node->left->offset + node->right->offset;
-  node->count = 1 + node->left->count + node->right->count;
+  node->count = n_nodes;
   _fixup_validation (tree, node);
   _fixup_total_count (tree, node);
-}
 
-static void
-reorder_copy_node (GtkRBTree *tree,
-                   GtkRBNode *to,
-                   GtkRBNode *from)
-{
-  to->flags = (to->flags & GTK_RBNODE_NON_COLORS) | GTK_RBNODE_GET_COLOR (from);
-
-  to->left = from->left;
-  if (!_gtk_rbtree_is_nil (to->left))
-    to->left->parent = to;
-
-  to->right = from->right;
-  if (!_gtk_rbtree_is_nil (to->right))
-    to->right->parent = to;
-
-  to->parent = from->parent;
-  if (_gtk_rbtree_is_nil (to->parent))
-    tree->root = to;
-  else if (to->parent->left == from)
-    to->parent->left = to;
-  else if (to->parent->right == from)
-    to->parent->right = to;
+  return node;
 }
 
-/* It basically pulls everything out of the tree, rearranges it, and puts it
- * back together.  Our strategy is to keep the old RBTree intact, and just
- * rearrange the contents.  When that is done, we go through and update the
- * heights.  There is probably a more elegant way to write this function.  If
- * anyone wants to spend the time writing it, patches will be accepted.
+/* It basically pulls everything out of the tree and puts it back
+ * together in the new order. The nodes themselves stay the same, as
+ * the tree view holds on to them, only the links between them are
+ * rebuilt. Like _gtk_rbtree_fill() this gives a balanced tree in
+ * linear time.
  */
 void
 _gtk_rbtree_reorder (GtkRBTree *tree,
 		     gint      *new_order,
 		     gint       length)
 {
-  GtkRBNode **nodes;
+  GtkRBNode **nodes, **reordered;
   GtkRBNode *node;
-  gint i, j;
+  gint i;
   
   g_return_if_fail (tree != NULL);
   g_return_if_fail (length > 0);
   g_return_if_fail (tree->root->count == length);
   
   nodes = g_new (GtkRBNode *, length);
+  reordered = g_new (GtkRBNode *, length);
 
   _gtk_rbtree_traverse (tree, tree->root, G_PRE_ORDER, reorder_prepare, NULL);
 
@@ -840,42 +918,18 @@ _gtk_rbtree_reorder (GtkRBTree *tree,
     }
 
   for (i = 0; i < length; i++)
-    {
-      GtkRBNode tmp = { 0, };
-      GSList *l, *cycle = NULL;
-
-      tmp.offset = -1;
+    reordered[i] = nodes[new_order[i]];
 
-      /* already swapped */
-      if (nodes[i] == NULL)
-        continue;
-      /* no need to swap */
-      if (new_order[i] == i)
-        continue;
-
-      /* make a list out of the pending nodes */
-      for (j = i; new_order[j] != i; j = new_order[j])
-        {
-          cycle = g_slist_prepend (cycle, nodes[j]);
-          nodes[j] = NULL;
-        }
-
-      node = nodes[j];
-      reorder_copy_node (tree, &tmp, node);
-      for (l = cycle; l; l = l->next)
-        {
-          reorder_copy_node (tree, node, l->data);
-          node = l->data;
-        }
-
-      reorder_copy_node (tree, node, &tmp);
-      nodes[j] = NULL;
-      g_slist_free (cycle);
-    }
-
-  _gtk_rbtree_traverse (tree, tree->root, G_POST_ORDER, reorder_fixup, NULL);
+  tree->root = reorder_link (tree, reordered, length, (GtkRBNode *) &nil,
+                             0, length > 1 ? g_bit_nth_msf (length, -1) : -1);
 
+  g_free (reordered);
   g_free (nodes);
+
+#ifdef G_ENABLE_DEBUG
+  if (GTK_DEBUG_CHECK (TREE))
+    _gtk_rbtree_test (G_STRLOC, tree);
+#endif
 }
 
 /**
@@ -110,6 +110,10 @@ GtkRBNode *_gtk_rbtree_insert_after     (GtkRBTree              *tree,
 					 GtkRBNode              *node,
 					 gint                    height,
 					 gboolean                valid);
+void       _gtk_rbtree_fill             (GtkRBTree              *tree,
+					 gint                    n_nodes,
+					 gint                    height,
+					 gboolean                valid);
 void       _gtk_rbtree_remove_node      (GtkRBTree              *tree,
 					 GtkRBNode              *node);
 gboolean   _gtk_rbtree_is_nil           (GtkRBNode              *node);
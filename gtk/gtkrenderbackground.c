@@ -291,6 +291,44 @@ _gtk_theming_background_init_style (GtkThemingBackground *bg,
 			   padding.bottom, padding.left);
 }
 
+/* Returns %TRUE if rendering the background of @style into a
+ * @width x @height rectangle covers every pixel of it opaquely.
+ */
+gboolean
+gtk_css_style_render_background_is_opaque (GtkCssStyle *style,
+                                           gdouble      width,
+                                           gdouble      height)
+{
+  const GdkRGBA *bg_color;
+  GtkCssValue *background_image;
+  GtkRoundedBox box;
+  GtkCssArea clip;
+  int i;
+
+  bg_color = _gtk_css_rgba_value_get_rgba (gtk_css_style_get_value (style, GTK_CSS_PROPERTY_BACKGROUND_COLOR));
+  if (bg_color->alpha < 1.0)
+    return FALSE;
+
+  background_image = gtk_css_style_get_value (style, GTK_CSS_PROPERTY_BACKGROUND_IMAGE);
+  clip = _gtk_css_area_value_get
+    (_gtk_css_array_value_get_nth
+     (gtk_css_style_get_value (style, GTK_CSS_PROPERTY_BACKGROUND_CLIP),
+      _gtk_css_array_value_get_n_values (background_image) - 1));
+  if (clip != GTK_CSS_AREA_BORDER_BOX)
+    return FALSE;
+
+  _gtk_rounded_box_init_rect (&box, 0, 0, width, height);
+  _gtk_rounded_box_apply_border_radius_for_style (&box, style, 0);
+
+  for (i = 0; i < 4; i++)
+    {
+      if (box.corner[i].horizontal > 0 || box.corner[i].vertical > 0)
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
 void
 gtk_css_style_render_background (GtkCssStyle      *style,
                                  cairo_t          *cr,
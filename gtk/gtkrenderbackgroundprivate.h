@@ -36,6 +36,10 @@ void gtk_css_style_render_background  (GtkCssStyle          *style,
                                        gdouble               height,
                                        GtkJunctionSides      junction);
 
+gboolean gtk_css_style_render_background_is_opaque (GtkCssStyle    *style,
+                                                    gdouble         width,
+                                                    gdouble         height);
+
 G_END_DECLS
 
 #endif /* __GTK_RENDER_BACKGROUND_PRIVATE_H__ */
@@ -25,6 +25,7 @@
 #include <gdk/gdk.h>
 #include "gtktypebuiltins.h"
 #include "gtkprivate.h"
+#include "gtkwidgetprivate.h"
 #include "gtkintl.h"
 
 #include "fallback-c89.c"
@@ -640,7 +641,7 @@ gtk_revealer_start_animation (GtkRevealer *revealer,
       priv->end_time = priv->start_time + (priv->transition_duration * 1000);
       if (priv->tick_id == 0)
         priv->tick_id =
-          gtk_widget_add_tick_callback (widget, gtk_revealer_animate_cb, revealer, NULL);
+          gtk_widget_add_mapped_tick_callback (widget, gtk_revealer_animate_cb, revealer, NULL);
       gtk_revealer_animate_step (revealer, priv->start_time);
     }
   else
@@ -29,6 +29,7 @@
 #include "gtkadjustment.h"
 #include "gtkadjustmentprivate.h"
 #include "gtkbindings.h"
+#include "gtkcontainerprivate.h"
 #include "gtkdnd.h"
 #include "gtkintl.h"
 #include "gtkmain.h"
@@ -1296,6 +1297,19 @@ captured_event_cb (GtkWidget *widget,
   return GDK_EVENT_PROPAGATE;
 }
 
+/* As long as we scroll in both directions, our size request does not
+ * depend on the child, so resizes inside the child can stay local.
+ */
+static void
+gtk_scrolled_window_update_relayout_boundary (GtkScrolledWindow *scrolled_window)
+{
+  GtkScrolledWindowPrivate *priv = scrolled_window->priv;
+
+  _gtk_container_set_relayout_boundary (GTK_CONTAINER (scrolled_window),
+                                        priv->hscrollbar_policy != GTK_POLICY_NEVER &&
+                                        priv->vscrollbar_policy != GTK_POLICY_NEVER);
+}
+
 static void
 gtk_scrolled_window_init (GtkScrolledWindow *scrolled_window)
 {
@@ -1321,6 +1335,7 @@ gtk_scrolled_window_init (GtkScrolledWindow *scrolled_window)
   priv->window_placement = GTK_CORNER_TOP_LEFT;
   priv->min_content_width = -1;
   priv->min_content_height = -1;
+  gtk_scrolled_window_update_relayout_boundary (scrolled_window);
 
   priv->overlay_scrolling = TRUE;
 
@@ -1644,6 +1659,7 @@ gtk_scrolled_window_set_policy (GtkScrolledWindow *scrolled_window,
     {
       priv->hscrollbar_policy = hscrollbar_policy;
       priv->vscrollbar_policy = vscrollbar_policy;
+      gtk_scrolled_window_update_relayout_boundary (scrolled_window);
 
       gtk_widget_queue_resize (GTK_WIDGET (scrolled_window));
 
@@ -0,0 +1,205 @@
+/* GTK - The GIMP Toolkit
+ * Copyright (C) 2015 The GTK+ Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtksequenceprivate.h"
+
+/* Above this fraction of moved items, sorting everything is cheaper */
+#define MAX_MOVED_FRACTION 4
+#define MIN_MAX_MOVED 8
+
+/* How many items in a row can go up before the ones after them get moved */
+#define MAX_RAISED 4
+
+typedef struct {
+  GSequenceIter *iter;
+  GSequenceIter *old_next;
+} MovedItem;
+
+static inline gint
+compare (GSequenceIter    *a,
+         GSequenceIter    *b,
+         GCompareDataFunc  compare_func,
+         gpointer          compare_data)
+{
+  return compare_func (g_sequence_get (a), g_sequence_get (b), compare_data);
+}
+
+static gint
+compare_moved (gconstpointer a,
+               gconstpointer b)
+{
+  const MovedItem *item_a = a;
+  const MovedItem *item_b = b;
+
+  return g_sequence_iter_compare (item_a->iter, item_b->iter);
+}
+
+/* Counts the items right before @iter that are larger than both
+ * @iter and @next, provided that @iter is in order once they are
+ * gone. Returns 0 if @iter is the item to move instead.
+ */
+static guint
+count_raised (GSequenceIter    *iter,
+              GSequenceIter    *next,
+              GCompareDataFunc  compare_func,
+              gpointer          compare_data)
+{
+  GSequenceIter *prev;
+  guint n_raised;
+
+  prev = g_sequence_iter_prev (iter);
+  for (n_raised = 0; n_raised < MAX_RAISED; n_raised++)
+    {
+      if (compare (prev, iter, compare_func, compare_data) <= 0)
+        break;
+
+      if (compare (prev, next, compare_func, compare_data) <= 0)
+        return 0;
+
+      if (g_sequence_iter_is_begin (prev))
+        return n_raised + 1;
+
+      prev = g_sequence_iter_prev (prev);
+    }
+
+  if (compare (prev, iter, compare_func, compare_data) > 0)
+    return 0;
+
+  return n_raised;
+}
+
+static void
+take_out (GSequence     *moved,
+          GArray        *items,
+          GSequenceIter *iter)
+{
+  MovedItem item;
+
+  item.iter = iter;
+  item.old_next = g_sequence_iter_next (iter);
+  g_array_append_val (items, item);
+
+  g_sequence_move (iter, g_sequence_get_end_iter (moved));
+}
+
+/*
+ * gtk_sequence_resort:
+ * @seq: a #GSequence that was sorted with @compare_func
+ * @compare_func: the function that sorts @seq
+ * @compare_data: user data for @compare_func
+ * @moved_func: called for every item that was relocated
+ * @moved_data: user data for @moved_func
+ *
+ * Sorts @seq again after the sort keys of some of its items changed.
+ *
+ * The items that are out of order are found in a single pass, taken
+ * out and put back in place with a binary search each. This costs
+ * O(n + k log n) comparisons for k changed items, instead of the
+ * O(n log n) of g_sequence_sort(), and leaves the items that did not
+ * change where they are. @moved_func is called for each relocated
+ * item, once all of them are back and in the order they now have in
+ * @seq, along with the item that followed it before, so that callers
+ * only need to update the neighbours of the items that moved.
+ *
+ * If too many items changed, @seq is sorted with g_sequence_sort()
+ * instead, and %FALSE is returned without calling @moved_func.
+ *
+ * Returns: %TRUE if only the reported items moved
+ */
+gboolean
+gtk_sequence_resort (GSequence            *seq,
+                     GCompareDataFunc      compare_func,
+                     gpointer              compare_data,
+                     GtkSequenceMovedFunc  moved_func,
+                     gpointer              moved_data)
+{
+  GSequence *moved;
+  GArray *items;
+  GSequenceIter *iter, *next, *pos;
+  MovedItem *item;
+  guint max_moved, n_raised, i;
+  gboolean resorted;
+
+  max_moved = MAX (g_sequence_get_length (seq) / MAX_MOVED_FRACTION, MIN_MAX_MOVED);
+
+  moved = g_sequence_new (NULL);
+  items = g_array_new (FALSE, FALSE, sizeof (MovedItem));
+
+  /* Everything before @iter stays sorted, by taking out the items
+   * that do not fit. When an item is smaller than the one before it,
+   * either of them may be the one that changed: if the item after it
+   * is smaller too, the ones before it went up.
+   */
+  for (iter = g_sequence_get_begin_iter (seq);
+       !g_sequence_iter_is_end (iter);
+       iter = next)
+    {
+      next = g_sequence_iter_next (iter);
+
+      if (g_sequence_iter_is_begin (iter) ||
+          compare (g_sequence_iter_prev (iter), iter, compare_func, compare_data) <= 0)
+        continue;
+
+      n_raised = 0;
+      if (!g_sequence_iter_is_end (next))
+        n_raised = count_raised (iter, next, compare_func, compare_data);
+
+      if (n_raised == 0)
+        take_out (moved, items, iter);
+
+      for (; n_raised > 0; n_raised--)
+        take_out (moved, items, g_sequence_iter_prev (iter));
+
+      if (items->len > max_moved)
+        break;
+    }
+
+  resorted = items->len <= max_moved;
+
+  if (!resorted)
+    {
+      g_sequence_move_range (g_sequence_get_end_iter (seq),
+                             g_sequence_get_begin_iter (moved),
+                             g_sequence_get_end_iter (moved));
+      g_sequence_sort (seq, compare_func, compare_data);
+    }
+  else
+    {
+      for (i = 0; i < items->len; i++)
+        {
+          item = &g_array_index (items, MovedItem, i);
+          pos = g_sequence_search (seq, g_sequence_get (item->iter),
+                                   compare_func, compare_data);
+          g_sequence_move (item->iter, pos);
+        }
+
+      g_array_sort (items, compare_moved);
+
+      for (i = 0; i < items->len; i++)
+        {
+          item = &g_array_index (items, MovedItem, i);
+          moved_func (item->iter, item->old_next, moved_data);
+        }
+    }
+
+  g_sequence_free (moved);
+  g_array_free (items, TRUE);
+
+  return resorted;
+}
@@ -0,0 +1,37 @@
+/* GTK - The GIMP Toolkit
+ * Copyright (C) 2015 The GTK+ Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GTK_SEQUENCE_PRIVATE_H__
+#define __GTK_SEQUENCE_PRIVATE_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef void (* GtkSequenceMovedFunc) (GSequenceIter *iter,
+                                       GSequenceIter *old_next,
+                                       gpointer       user_data);
+
+gboolean gtk_sequence_resort (GSequence            *seq,
+                              GCompareDataFunc      compare_func,
+                              gpointer              compare_data,
+                              GtkSequenceMovedFunc  moved_func,
+                              gpointer              moved_data);
+
+G_END_DECLS
+
+#endif /* __GTK_SEQUENCE_PRIVATE_H__ */
@@ -23,6 +23,7 @@
 #include "gtkbuilderprivate.h"
 #include "gtkcontainer.h"
 #include "gtkintl.h"
+#include "gtklayouttraceprivate.h"
 #include "gtktypebuiltins.h"
 #include "gtkprivate.h"
 #include "gtksizegroup-private.h"
@@ -209,6 +210,9 @@ real_queue_resize (GtkWidget          *widget,
 {
   GtkWidget *container;
 
+  if (GTK_LAYOUT_TRACE_IS_ENABLED ())
+    gtk_layout_trace_invalidated (widget);
+
   _gtk_widget_set_alloc_needed (widget, TRUE);
   _gtk_size_request_cache_clear (_gtk_widget_peek_request_cache (widget));
 
@@ -614,7 +618,13 @@ void
 _gtk_size_group_queue_resize (GtkWidget           *widget,
 			      GtkQueueResizeFlags  flags)
 {
+  gboolean traced = GTK_LAYOUT_TRACE_IS_ENABLED ();
+
+  if (traced)
+    gtk_layout_trace_begin_resize (widget);
   queue_resize_on_widget (widget, TRUE, flags);
+  if (traced)
+    gtk_layout_trace_end_resize (widget);
 }
 
 typedef struct {
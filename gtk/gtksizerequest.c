@@ -25,6 +25,7 @@
 
 #include "gtkdebug.h"
 #include "gtkintl.h"
+#include "gtklayouttraceprivate.h"
 #include "gtkprivate.h"
 #include "gtksizegroup-private.h"
 #include "gtksizerequestcacheprivate.h"
@@ -148,6 +149,7 @@ gtk_widget_query_size_for_orientation (GtkWidget        *widget,
   gint min_baseline = -1;
   gint nat_baseline = -1;
   gboolean found_in_cache;
+  gint64 start_time = 0;
 
   if (gtk_widget_get_request_mode (widget) == GTK_SIZE_REQUEST_CONSTANT_SIZE)
     for_size = -1;
@@ -167,6 +169,9 @@ gtk_widget_query_size_for_orientation (GtkWidget        *widget,
     {
       gint adjusted_min, adjusted_natural, adjusted_for_size = for_size;
 
+      if (GTK_LAYOUT_TRACE_IS_ENABLED ())
+        start_time = g_get_monotonic_time ();
+
       G_GNUC_BEGIN_IGNORE_DEPRECATIONS;
       gtk_widget_ensure_style (widget);
       G_GNUC_END_IGNORE_DEPRECATIONS;
@@ -324,6 +329,10 @@ gtk_widget_query_size_for_orientation (GtkWidget        *widget,
 				      nat_baseline);
     }
 
+  if (GTK_LAYOUT_TRACE_IS_ENABLED ())
+    gtk_layout_trace_measured (widget, found_in_cache,
+                               start_time ? g_get_monotonic_time () - start_time : 0);
+
   if (minimum_size)
     *minimum_size = min_size;
 
@@ -789,14 +798,43 @@ gtk_distribute_natural_allocation (gint              extra_space,
 				   GtkRequestedSize *sizes)
 {
   guint *spreading;
+  guint  n_spreading;
+  gint   total_gap;
   gint   i;
 
   g_return_val_if_fail (extra_space >= 0, 0);
 
+  if (extra_space == 0)
+    return 0;
+
+  /* Children that are already at their natural size never take any
+   * space, so leave them out. If there's enough space for all of the
+   * others to reach their natural size, there is nothing to decide
+   * and we don't need to sort at all.
+   */
   spreading = g_newa (guint, n_requested_sizes);
+  n_spreading = 0;
+  total_gap = 0;
 
   for (i = 0; i < n_requested_sizes; i++)
-    spreading[i] = i;
+    {
+      gint gap = sizes[i].natural_size - sizes[i].minimum_size;
+
+      if (gap <= 0)
+        continue;
+
+      spreading[n_spreading++] = i;
+      if (total_gap <= extra_space)
+        total_gap += gap;
+    }
+
+  if (total_gap <= extra_space)
+    {
+      for (i = 0; i < n_spreading; i++)
+        sizes[spreading[i]].minimum_size = sizes[spreading[i]].natural_size;
+
+      return extra_space - total_gap;
+    }
 
   /* Distribute the container's extra space c_gap. We want to assign
    * this space such that the sum of extra space assigned to children
@@ -817,13 +855,13 @@ gtk_distribute_natural_allocation (gint              extra_space,
 
   /* Sort descending by gap and position. */
   g_qsort_with_data (spreading,
-		     n_requested_sizes, sizeof (guint),
+		     n_spreading, sizeof (guint),
 		     compare_gap, sizes);
 
   /* Distribute available space.
    * This master piece of a loop was conceived by Behdad Esfahbod.
    */
-  for (i = n_requested_sizes - 1; extra_space > 0 && i >= 0; --i)
+  for (i = n_spreading - 1; extra_space > 0 && i >= 0; --i)
     {
       /* Divide remaining space by number of remaining children.
        * Sort order and reducing remaining space by assigned space
@@ -31,42 +31,119 @@ _gtk_size_request_cache_init (SizeRequestCache *cache)
   memset (cache, 0, sizeof (SizeRequestCache));
 }
 
+static guint
+get_max_cached_requests (SizeRequestCache *cache,
+                         GtkOrientation    orientation)
+{
+  if (cache->flags[orientation].max_cached_requests == 0)
+    return GTK_SIZE_REQUEST_CACHED_SIZES;
+
+  return cache->flags[orientation].max_cached_requests;
+}
+
 static void
-free_sizes_x (SizeRequestX **sizes)
+free_sizes_x (SizeRequestX **sizes,
+              guint          n_sizes)
 {
-  gint i;
+  guint i;
 
-  for (i = 0; i < GTK_SIZE_REQUEST_CACHED_SIZES && sizes[i] != NULL; i++)
+  for (i = 0; i < n_sizes && sizes[i] != NULL; i++)
     g_slice_free (SizeRequestX, sizes[i]);
 
-  g_slice_free1 (sizeof (SizeRequestY *) * GTK_SIZE_REQUEST_CACHED_SIZES, sizes);
+  g_free (sizes);
 }
 
 static void
-free_sizes_y (SizeRequestY **sizes)
+free_sizes_y (SizeRequestY **sizes,
+              guint          n_sizes)
 {
-  gint i;
+  guint i;
 
-  for (i = 0; i < GTK_SIZE_REQUEST_CACHED_SIZES && sizes[i] != NULL; i++)
+  for (i = 0; i < n_sizes && sizes[i] != NULL; i++)
     g_slice_free (SizeRequestY, sizes[i]);
 
-  g_slice_free1 (sizeof (SizeRequestY *) * GTK_SIZE_REQUEST_CACHED_SIZES, sizes);
+  g_free (sizes);
 }
 
 void
 _gtk_size_request_cache_free (SizeRequestCache *cache)
 {
   if (cache->requests_x)
-    free_sizes_x (cache->requests_x);
+    free_sizes_x (cache->requests_x,
+                  get_max_cached_requests (cache, GTK_ORIENTATION_HORIZONTAL));
   if (cache->requests_y)
-    free_sizes_y (cache->requests_y);
+    free_sizes_y (cache->requests_y,
+                  get_max_cached_requests (cache, GTK_ORIENTATION_VERTICAL));
 }
 
 void
 _gtk_size_request_cache_clear (SizeRequestCache *cache)
 {
+  guint max_x, max_y, hits, misses;
+
+  /* Keep what we learned about the widget */
+  max_x = cache->flags[GTK_ORIENTATION_HORIZONTAL].max_cached_requests;
+  max_y = cache->flags[GTK_ORIENTATION_VERTICAL].max_cached_requests;
+  hits = cache->hits;
+  misses = cache->misses;
+
   _gtk_size_request_cache_free (cache);
   _gtk_size_request_cache_init (cache);
+
+  cache->flags[GTK_ORIENTATION_HORIZONTAL].max_cached_requests = max_x;
+  cache->flags[GTK_ORIENTATION_VERTICAL].max_cached_requests = max_y;
+  cache->hits = hits;
+  cache->misses = misses;
+}
+
+guint
+_gtk_size_request_cache_get_n_cached_sizes (SizeRequestCache *cache,
+                                            GtkOrientation    orientation)
+{
+  return get_max_cached_requests (cache, orientation);
+}
+
+/* Picks the slot for a new cached request, evicting an old one if
+ * needed. When the cache is full, it first grows, so that widgets
+ * which get measured for many different sizes, like wrapping
+ * labels during a window resize, stop thrashing their cache.
+ */
+static guint
+get_free_request_slot (SizeRequestCache   *cache,
+                       GtkOrientation      orientation,
+                       gpointer          **requests)
+{
+  guint n_sizes, max_sizes;
+
+  n_sizes = cache->flags[orientation].n_cached_requests;
+  max_sizes = get_max_cached_requests (cache, orientation);
+
+  if (*requests == NULL)
+    *requests = g_new0 (gpointer, max_sizes);
+
+  if (n_sizes == max_sizes && max_sizes < GTK_SIZE_REQUEST_MAX_CACHED_SIZES)
+    {
+      guint new_max_sizes = MIN (max_sizes * 2, GTK_SIZE_REQUEST_MAX_CACHED_SIZES);
+
+      *requests = g_renew (gpointer, *requests, new_max_sizes);
+      memset (*requests + max_sizes, 0, sizeof (gpointer) * (new_max_sizes - max_sizes));
+
+      cache->flags[orientation].max_cached_requests = new_max_sizes;
+      max_sizes = new_max_sizes;
+    }
+
+  if (n_sizes < max_sizes)
+    {
+      cache->flags[orientation].n_cached_requests++;
+      cache->flags[orientation].last_cached_request = cache->flags[orientation].n_cached_requests - 1;
+    }
+  else
+    {
+      if (++cache->flags[orientation].last_cached_request == max_sizes)
+        cache->flags[orientation].last_cached_request = 0;
+    }
+
+  return cache->flags[orientation].last_cached_request;
 }
 
 void
@@ -78,7 +155,7 @@ _gtk_size_request_cache_commit (SizeRequestCache *cache,
 				gint              minimum_baseline,
 				gint              natural_baseline)
 {
-  guint         i, n_sizes;
+  guint         i, n_sizes, slot;
 
   if (orientation == GTK_ORIENTATION_HORIZONTAL)
     {
@@ -131,26 +208,13 @@ _gtk_size_request_cache_commit (SizeRequestCache *cache,
 	}
 
       /* If not found, pull a new size from the cache, the returned size cache
-       * will immediately be used to cache the new computed size so we go ahead
-       * and increment the last_cached_request right away */
-      if (n_sizes < GTK_SIZE_REQUEST_CACHED_SIZES)
-	{
-	  cache->flags[orientation].n_cached_requests++;
-	  cache->flags[orientation].last_cached_request = cache->flags[orientation].n_cached_requests - 1;
-	}
-      else
-	{
-	  if (++cache->flags[orientation].last_cached_request == GTK_SIZE_REQUEST_CACHED_SIZES)
-	    cache->flags[orientation].last_cached_request = 0;
-	}
+       * will immediately be used to cache the new computed size */
+      slot = get_free_request_slot (cache, orientation, (gpointer **) &cache->requests_x);
 
-      if (cache->requests_x == NULL)
-	cache->requests_x = g_slice_alloc0 (sizeof (SizeRequestX *) * GTK_SIZE_REQUEST_CACHED_SIZES);
+      if (cache->requests_x[slot] == NULL)
+	cache->requests_x[slot] = g_slice_new (SizeRequestX);
 
-      if (cache->requests_x[cache->flags[orientation].last_cached_request] == NULL)
-	cache->requests_x[cache->flags[orientation].last_cached_request] = g_slice_new (SizeRequestX);
-
-      cached_size = cache->requests_x[cache->flags[orientation].last_cached_request];
+      cached_size = cache->requests_x[slot];
       cached_size->lower_for_size = for_size;
       cached_size->upper_for_size = for_size;
       cached_size->cached_size.minimum_size = minimum_size;
@@ -176,26 +240,13 @@ _gtk_size_request_cache_commit (SizeRequestCache *cache,
 	}
 
       /* If not found, pull a new size from the cache, the returned size cache
-       * will immediately be used to cache the new computed size so we go ahead
-       * and increment the last_cached_request right away */
-      if (n_sizes < GTK_SIZE_REQUEST_CACHED_SIZES)
-	{
-	  cache->flags[orientation].n_cached_requests++;
-	  cache->flags[orientation].last_cached_request = cache->flags[orientation].n_cached_requests - 1;
-	}
-      else
-	{
-	  if (++cache->flags[orientation].last_cached_request == GTK_SIZE_REQUEST_CACHED_SIZES)
-	    cache->flags[orientation].last_cached_request = 0;
-	}
-
-      if (cache->requests_y == NULL)
-	cache->requests_y = g_slice_alloc0 (sizeof (SizeRequestY *) * GTK_SIZE_REQUEST_CACHED_SIZES);
+       * will immediately be used to cache the new computed size */
+      slot = get_free_request_slot (cache, orientation, (gpointer **) &cache->requests_y);
 
-      if (cache->requests_y[cache->flags[orientation].last_cached_request] == NULL)
-	cache->requests_y[cache->flags[orientation].last_cached_request] = g_slice_new (SizeRequestY);
+      if (cache->requests_y[slot] == NULL)
+	cache->requests_y[slot] = g_slice_new (SizeRequestY);
 
-      cached_size = cache->requests_y[cache->flags[orientation].last_cached_request];
+      cached_size = cache->requests_y[slot];
       cached_size->lower_for_size = for_size;
       cached_size->upper_for_size = for_size;
       cached_size->cached_size.minimum_size = minimum_size;
@@ -252,10 +303,14 @@ _gtk_size_request_cache_lookup (SizeRequestCache *cache,
 	  *natural = result->natural_size;
 	  *minimum_baseline = -1;
 	  *natural_baseline = -1;
+          cache->hits++;
 	  return TRUE;
 	}
       else
-	return FALSE;
+        {
+          cache->misses++;
+	  return FALSE;
+        }
     }
   else
     {
@@ -290,10 +345,14 @@ _gtk_size_request_cache_lookup (SizeRequestCache *cache,
 	  *natural = result->natural_size;
 	  *minimum_baseline = result->minimum_baseline;
 	  *natural_baseline = result->natural_baseline;
+          cache->hits++;
 	  return TRUE;
 	}
       else
-	return FALSE;
+        {
+          cache->misses++;
+	  return FALSE;
+        }
     }
 }
 
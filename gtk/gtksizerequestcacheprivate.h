@@ -35,8 +35,14 @@ G_BEGIN_DECLS
  * for a said widget to have, if a label can
  * only wrap to 3 lines, only 3 caches will
  * ever be allocated for it.
+ *
+ * Widgets that run out of cache entries get
+ * more of them, up to the maximum, so that
+ * wrapping text does not thrash its cache
+ * during interactive resizes.
  */
-#define GTK_SIZE_REQUEST_CACHED_SIZES   (5)
+#define GTK_SIZE_REQUEST_CACHED_SIZES      (5)
+#define GTK_SIZE_REQUEST_MAX_CACHED_SIZES  (32)
 
 typedef struct {
   gint minimum_size;
@@ -74,10 +80,15 @@ typedef struct {
   GtkSizeRequestMode request_mode   : 3;
   guint       request_mode_valid    : 1;
   struct {
-    guint       n_cached_requests   : 3;
-    guint       last_cached_request : 3;
+    guint       n_cached_requests   : 6;
+    guint       last_cached_request : 5;
+    guint       max_cached_requests : 6; /* 0 means GTK_SIZE_REQUEST_CACHED_SIZES */
     guint       cached_size_valid   : 1;
   }           flags[2];
+
+  /* Statistics for the inspector, kept across clears */
+  guint       hits;
+  guint       misses;
 } SizeRequestCache;
 
 void            _gtk_size_request_cache_init                    (SizeRequestCache       *cache);
@@ -91,6 +102,8 @@ void            _gtk_size_request_cache_commit                  (SizeRequestCach
                                                                  gint                    natural_size,
                                                                  gint                    minimum_baseline,
                                                                  gint                    natural_baseline);
+guint           _gtk_size_request_cache_get_n_cached_sizes      (SizeRequestCache       *cache,
+                                                                 GtkOrientation          orientation);
 gboolean        _gtk_size_request_cache_lookup                  (SizeRequestCache       *cache,
                                                                  GtkOrientation          orientation,
                                                                  gint                    for_size,
@@ -22,6 +22,7 @@
 #include <glib/gprintf.h>
 #include <gobject/gvaluecollector.h>
 #include "gtktreemodel.h"
+#include "gtktreemodelprivate.h"
 #include "gtktreeview.h"
 #include "gtktreeprivate.h"
 #include "gtkmarshalers.h"
@@ -247,11 +248,20 @@ enum {
   ROW_HAS_CHILD_TOGGLED,
   ROW_DELETED,
   ROWS_REORDERED,
+  ROWS_INSERTED,
   LAST_SIGNAL
 };
 
 static guint tree_model_signals[LAST_SIGNAL] = { 0 };
 
+static GQuark batch_handlers_quark;
+static GQuark pending_func_quark;
+
+/* The path of the row-inserted emission done by the default
+ * ::rows-inserted handler, if any
+ */
+static GtkTreePath *batched_row_path = NULL;
+
 struct _GtkTreePath
 {
   gint depth;    /* Number of elements */
@@ -264,6 +274,12 @@ typedef struct
   GSList *list;
 } RowRefList;
 
+typedef struct
+{
+  GCallback callback;
+  gpointer  data;
+} BatchHandler;
+
 static void      gtk_tree_model_base_init   (gpointer           g_class);
 
 /* custom closures */
@@ -286,6 +302,11 @@ static void      rows_reordered_marshal     (GClosure          *closure,
                                              gpointer           invocation_hint,
                                              gpointer           marshal_data);
 
+static void      gtk_tree_model_real_rows_inserted (GtkTreeModel *tree_model,
+                                                    GtkTreePath  *path,
+                                                    GtkTreeIter  *iter,
+                                                    gint          n_rows);
+
 static void      gtk_tree_row_ref_inserted  (RowRefList        *refs,
                                              GtkTreePath       *path,
                                              GtkTreeIter       *iter);
@@ -337,6 +358,7 @@ gtk_tree_model_base_init (gpointer g_class)
       GType row_inserted_params[2];
       GType row_deleted_params[1];
       GType rows_reordered_params[3];
+      GType rows_inserted_params[3];
 
       row_inserted_params[0] = GTK_TYPE_TREE_PATH | G_SIGNAL_TYPE_STATIC_SCOPE;
       row_inserted_params[1] = GTK_TYPE_TREE_ITER;
@@ -347,6 +369,13 @@ gtk_tree_model_base_init (gpointer g_class)
       rows_reordered_params[1] = GTK_TYPE_TREE_ITER;
       rows_reordered_params[2] = G_TYPE_POINTER;
 
+      batch_handlers_quark = g_quark_from_static_string ("gtk-tree-model-batch-handlers");
+      pending_func_quark = g_quark_from_static_string ("gtk-tree-model-pending-func");
+
+      rows_inserted_params[0] = GTK_TYPE_TREE_PATH | G_SIGNAL_TYPE_STATIC_SCOPE;
+      rows_inserted_params[1] = GTK_TYPE_TREE_ITER;
+      rows_inserted_params[2] = G_TYPE_INT;
+
       /**
        * GtkTreeModel::row-changed:
        * @tree_model: the #GtkTreeModel on which the signal is emitted
@@ -479,10 +508,228 @@ gtk_tree_model_base_init (gpointer g_class)
                        _gtk_marshal_VOID__BOXED_BOXED_POINTER,
                        G_TYPE_NONE, 3,
                        rows_reordered_params);
+
+      /**
+       * GtkTreeModel::rows-inserted:
+       * @tree_model: the #GtkTreeModel on which the signal is emitted
+       * @path: a #GtkTreePath-struct identifying the first new row
+       * @iter: a valid #GtkTreeIter-struct pointing to the first new row
+       * @n_rows: the number of new rows
+       *
+       * This signal is emitted when @n_rows rows have been inserted
+       * next to each other, at the same level of the model, so that
+       * they can be handled in one go.
+       *
+       * The default handler emits #GtkTreeModel::row-inserted for
+       * each of the rows in turn, so handlers that are only connected
+       * to that signal still see all of them. Note that all the rows
+       * are already in the model at that point, so models only batch
+       * insertions this way when no such handler is connected.
+       *
+       * Since: 3.20
+       */
+      closure = g_cclosure_new (G_CALLBACK (gtk_tree_model_real_rows_inserted),
+                                NULL, NULL);
+      tree_model_signals[ROWS_INSERTED] =
+        g_signal_newv (I_("rows-inserted"),
+                       GTK_TYPE_TREE_MODEL,
+                       G_SIGNAL_RUN_LAST,
+                       closure,
+                       NULL, NULL,
+                       _gtk_marshal_VOID__BOXED_BOXED_INT,
+                       G_TYPE_NONE, 3,
+                       rows_inserted_params);
       initialized = TRUE;
     }
 }
 
+static void
+gtk_tree_model_real_rows_inserted (GtkTreeModel *tree_model,
+                                   GtkTreePath  *path,
+                                   GtkTreeIter  *iter,
+                                   gint          n_rows)
+{
+  GtkTreePath *row_path, *outer_row_path;
+  GtkTreeIter row_iter;
+  gint i;
+
+  row_path = gtk_tree_path_copy (path);
+  row_iter = *iter;
+
+  /* Mark the rows, for handlers of ::rows-inserted to skip them */
+  outer_row_path = batched_row_path;
+  batched_row_path = row_path;
+
+  for (i = 0; i < n_rows; i++)
+    {
+      if (i > 0)
+        {
+          gtk_tree_path_next (row_path);
+          if (!gtk_tree_model_iter_next (tree_model, &row_iter))
+            break;
+        }
+
+      gtk_tree_model_row_inserted (tree_model, row_path, &row_iter);
+    }
+
+  batched_row_path = outer_row_path;
+  gtk_tree_path_free (row_path);
+}
+
+/*
+ * _gtk_tree_model_row_inserted_is_batched:
+ * @tree_model: a #GtkTreeModel
+ * @path: the path passed to a #GtkTreeModel::row-inserted handler
+ *
+ * Checks whether a #GtkTreeModel::row-inserted emission is the one of
+ * a row that was already announced by #GtkTreeModel::rows-inserted.
+ * Handlers that are connected to both signals use this to only handle
+ * the rows once.
+ *
+ * Returns: %TRUE if the row was part of ::rows-inserted
+ */
+gboolean
+_gtk_tree_model_row_inserted_is_batched (GtkTreeModel *tree_model,
+                                         GtkTreePath  *path)
+{
+  return path != NULL && path == batched_row_path;
+}
+
+/*
+ * _gtk_tree_model_add_batch_handler:
+ * @tree_model: a #GtkTreeModel
+ * @row_inserted: the #GtkTreeModel::row-inserted handler
+ * @data: the data the handler was connected with
+ *
+ * Declares that a #GtkTreeModel::row-inserted handler also handles
+ * #GtkTreeModel::rows-inserted, and skips the rows that were batched.
+ * See _gtk_tree_model_can_batch().
+ */
+void
+_gtk_tree_model_add_batch_handler (GtkTreeModel *tree_model,
+                                   GCallback     row_inserted,
+                                   gpointer      data)
+{
+  GArray *handlers;
+  BatchHandler handler;
+
+  handlers = g_object_get_qdata (G_OBJECT (tree_model), batch_handlers_quark);
+  if (handlers == NULL)
+    {
+      handlers = g_array_new (FALSE, FALSE, sizeof (BatchHandler));
+      g_object_set_qdata_full (G_OBJECT (tree_model), batch_handlers_quark,
+                               handlers, (GDestroyNotify) g_array_unref);
+    }
+
+  handler.callback = row_inserted;
+  handler.data = data;
+  g_array_append_val (handlers, handler);
+}
+
+void
+_gtk_tree_model_remove_batch_handler (GtkTreeModel *tree_model,
+                                      GCallback     row_inserted,
+                                      gpointer      data)
+{
+  GArray *handlers;
+  guint i;
+
+  handlers = g_object_get_qdata (G_OBJECT (tree_model), batch_handlers_quark);
+  if (handlers == NULL)
+    return;
+
+  for (i = 0; i < handlers->len; i++)
+    {
+      BatchHandler *handler = &g_array_index (handlers, BatchHandler, i);
+
+      if (handler->callback == row_inserted && handler->data == data)
+        {
+          g_array_remove_index_fast (handlers, i);
+          break;
+        }
+    }
+
+  if (handlers->len == 0)
+    g_object_set_qdata (G_OBJECT (tree_model), batch_handlers_quark, NULL);
+}
+
+/*
+ * _gtk_tree_model_can_batch:
+ * @tree_model: a #GtkTreeModel
+ *
+ * Checks whether @tree_model may announce insertions with
+ * #GtkTreeModel::rows-inserted. This is only the case if all the
+ * #GtkTreeModel::row-inserted handlers were declared with
+ * _gtk_tree_model_add_batch_handler(); other handlers would see the
+ * per-row emissions of the default handler while the model already
+ * contains all the new rows.
+ *
+ * Returns: %TRUE if insertions can be batched
+ */
+gboolean
+_gtk_tree_model_can_batch (GtkTreeModel *tree_model)
+{
+  GArray *handlers;
+  gboolean other_handlers;
+  guint i;
+
+  handlers = g_object_get_qdata (G_OBJECT (tree_model), batch_handlers_quark);
+  if (handlers == NULL)
+    return !g_signal_has_handler_pending (tree_model,
+                                          tree_model_signals[ROW_INSERTED],
+                                          0, FALSE);
+
+  for (i = 0; i < handlers->len; i++)
+    {
+      BatchHandler *handler = &g_array_index (handlers, BatchHandler, i);
+
+      g_signal_handlers_block_matched (tree_model,
+                                       G_SIGNAL_MATCH_ID | G_SIGNAL_MATCH_FUNC | G_SIGNAL_MATCH_DATA,
+                                       tree_model_signals[ROW_INSERTED], 0,
+                                       NULL, handler->callback, handler->data);
+    }
+
+  other_handlers = g_signal_has_handler_pending (tree_model,
+                                                 tree_model_signals[ROW_INSERTED],
+                                                 0, FALSE);
+
+  for (i = 0; i < handlers->len; i++)
+    {
+      BatchHandler *handler = &g_array_index (handlers, BatchHandler, i);
+
+      g_signal_handlers_unblock_matched (tree_model,
+                                         G_SIGNAL_MATCH_ID | G_SIGNAL_MATCH_FUNC | G_SIGNAL_MATCH_DATA,
+                                         tree_model_signals[ROW_INSERTED], 0,
+                                         NULL, handler->callback, handler->data);
+    }
+
+  return !other_handlers;
+}
+
+/*
+ * _gtk_tree_model_set_pending_func:
+ * @tree_model: a #GtkTreeModel
+ * @func: (allow-none): a function telling whether a row is pending
+ *
+ * Lets a model that defers #GtkTreeModel::rows-inserted tell which
+ * of its rows were not announced yet. Proxy models that build their
+ * levels lazily skip these rows, as they learn about them when the
+ * signal is emitted. Models unset @func when no rows are pending.
+ */
+void
+_gtk_tree_model_set_pending_func (GtkTreeModel            *tree_model,
+                                  GtkTreeModelPendingFunc  func)
+{
+  g_object_set_qdata (G_OBJECT (tree_model), pending_func_quark, func);
+}
+
+GtkTreeModelPendingFunc
+_gtk_tree_model_get_pending_func (GtkTreeModel *tree_model)
+{
+  return (GtkTreeModelPendingFunc) g_object_get_qdata (G_OBJECT (tree_model),
+                                                       pending_func_quark);
+}
+
 static void
 row_inserted_marshal (GClosure          *closure,
                       GValue /* out */  *return_value,
@@ -1852,6 +2099,38 @@ gtk_tree_model_row_inserted (GtkTreeModel *tree_model,
   g_signal_emit (tree_model, tree_model_signals[ROW_INSERTED], 0, path, iter);
 }
 
+/**
+ * gtk_tree_model_rows_inserted:
+ * @tree_model: a #GtkTreeModel
+ * @path: a #GtkTreePath-struct pointing to the first inserted row
+ * @iter: a valid #GtkTreeIter-struct pointing to the first inserted row
+ * @n_rows: the number of inserted rows
+ *
+ * Emits the #GtkTreeModel::rows-inserted signal on @tree_model.
+ *
+ * This can be called by models instead of gtk_tree_model_row_inserted(),
+ * once @n_rows rows have been inserted after each other at the same
+ * level.
+ *
+ * Since: 3.20
+ */
+void
+gtk_tree_model_rows_inserted (GtkTreeModel *tree_model,
+                              GtkTreePath  *path,
+                              GtkTreeIter  *iter,
+                              gint          n_rows)
+{
+  g_return_if_fail (GTK_IS_TREE_MODEL (tree_model));
+  g_return_if_fail (path != NULL);
+  g_return_if_fail (iter != NULL);
+  g_return_if_fail (n_rows >= 0);
+
+  if (n_rows == 0)
+    return;
+
+  g_signal_emit (tree_model, tree_model_signals[ROWS_INSERTED], 0, path, iter, n_rows);
+}
+
 /**
  * gtk_tree_model_row_has_child_toggled:
  * @tree_model: a #GtkTreeModel
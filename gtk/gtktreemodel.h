@@ -384,6 +384,11 @@ GDK_AVAILABLE_IN_ALL
 void gtk_tree_model_row_inserted          (GtkTreeModel *tree_model,
 					   GtkTreePath  *path,
 					   GtkTreeIter  *iter);
+GDK_AVAILABLE_IN_3_20
+void gtk_tree_model_rows_inserted         (GtkTreeModel *tree_model,
+					   GtkTreePath  *path,
+					   GtkTreeIter  *iter,
+					   gint          n_rows);
 GDK_AVAILABLE_IN_ALL
 void gtk_tree_model_row_has_child_toggled (GtkTreeModel *tree_model,
 					   GtkTreePath  *path,
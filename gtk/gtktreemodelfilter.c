@@ -18,6 +18,7 @@
 
 #include "config.h"
 #include "gtktreemodelfilter.h"
+#include "gtktreemodelprivate.h"
 #include "gtkintl.h"
 #include "gtktreednd.h"
 #include "gtkprivate.h"
@@ -95,6 +96,16 @@
  * because it does not implement reference counting, or for models that
  * do implement reference counting, obtain references on these child levels
  * yourself.
+ *
+ * For large models, the filter can be made #GtkTreeModelFilter:incremental.
+ * The visibility of the top-level rows is then determined a chunk at a time
+ * in idle time, both when the filter is first used and after
+ * gtk_tree_model_filter_refilter(), so that filtering never blocks the user
+ * interface for long. While the filter is first used, rows that have not
+ * been looked at yet are hidden, and are inserted as they are found to be
+ * visible, so the number of rows the filter reports grows until the pass
+ * is done. During a refilter, rows that have not been looked at yet keep
+ * the visibility they had before, until the pass reaches them.
  */
 
 /* Notes on this implementation of GtkTreeModelFilter
@@ -232,6 +243,22 @@
  * row-has-child-toggled could appear frequently; it does happen that
  * we simply forward the signal emitted by e.g. GtkTreeStore but also
  * emit our own copy).
+ *
+ * Incremental filtering
+ * ---------------------
+ *
+ * In incremental mode, building the root level stops looking at child
+ * rows once a time budget is used up. The remaining rows are left out of
+ * the level, as if they were invisible, and an idle handler walks them,
+ * together with their descendants, through the same code that handles
+ * row-changed. Rows that turn out to be visible are inserted with the
+ * regular signals. Refiltering works the same way, starting over at the
+ * first row; rows past the pass are left as they are, so until the pass
+ * reaches them they keep their old visibility, and rows that were visible
+ * are only removed once they are looked at. “refilter_offset” is the
+ * child offset of the next top-level row to look at, and is kept up to
+ * date as rows are inserted or deleted before it. Everything below the
+ * root level is still filtered as soon as it is built.
  */
 
 
@@ -287,10 +314,16 @@ struct _GtkTreeModelFilterPrivate
 
   guint in_row_deleted       : 1;
   guint virtual_root_deleted : 1;
+  guint incremental          : 1;
+
+  /* incremental filtering */
+  guint refilter_id;
+  gint refilter_offset;
 
   /* signal ids */
   gulong changed_id;
   gulong inserted_id;
+  gulong rows_inserted_id;
   gulong has_child_toggled_id;
   gulong deleted_id;
   gulong reordered_id;
@@ -301,7 +334,8 @@ enum
 {
   PROP_0,
   PROP_CHILD_MODEL,
-  PROP_VIRTUAL_ROOT
+  PROP_VIRTUAL_ROOT,
+  PROP_INCREMENTAL
 };
 
 /* Set this to 0 to disable caching of child iterators.  This
@@ -321,6 +355,9 @@ enum
  */
 #undef MODEL_FILTER_DEBUG
 
+/* How long an incremental filter may look at rows in one go */
+#define GTK_TREE_MODEL_FILTER_TIME_US_PER_CHUNK 5000
+
 #define FILTER_ELT(filter_elt) ((FilterElt *)filter_elt)
 #define FILTER_LEVEL(filter_level) ((FilterLevel *)filter_level)
 #define GET_ELT(siter) ((FilterElt*) (siter ? g_sequence_get (siter) : NULL))
@@ -347,6 +384,11 @@ static void         gtk_tree_model_filter_row_inserted                    (GtkTr
                                                                            GtkTreePath            *c_path,
                                                                            GtkTreeIter            *c_iter,
                                                                            gpointer                data);
+static void         gtk_tree_model_filter_rows_inserted                   (GtkTreeModel           *c_model,
+                                                                           GtkTreePath            *c_path,
+                                                                           GtkTreeIter            *c_iter,
+                                                                           gint                    n_rows,
+                                                                           gpointer                data);
 static void         gtk_tree_model_filter_row_has_child_toggled           (GtkTreeModel           *c_model,
                                                                            GtkTreePath            *c_path,
                                                                            GtkTreeIter            *c_iter,
@@ -421,6 +463,13 @@ static void        gtk_tree_model_filter_free_level                       (GtkTr
                                                                            gboolean                unref_parent,
                                                                            gboolean                unref_external);
 
+static void         gtk_tree_model_filter_queue_refilter                  (GtkTreeModelFilter     *filter,
+                                                                           gint                    offset);
+static void         gtk_tree_model_filter_stop_refilter                   (GtkTreeModelFilter     *filter);
+static void         gtk_tree_model_filter_shift_refilter                  (GtkTreeModelFilter     *filter,
+                                                                           GtkTreePath            *c_path,
+                                                                           gint                    n_rows);
+
 static GtkTreePath *gtk_tree_model_filter_elt_get_path                    (FilterLevel            *level,
                                                                            FilterElt              *elt,
                                                                            GtkTreePath            *root);
@@ -544,6 +593,22 @@ gtk_tree_model_filter_class_init (GtkTreeModelFilterClass *filter_class)
                                                        ("The virtual root (relative to the child model) for this filtermodel"),
                                                        GTK_TYPE_TREE_PATH,
                                                        GTK_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+
+  /**
+   * GtkTreeModelFilter:incremental:
+   *
+   * Whether the visibility of top-level rows is determined in
+   * chunks, in idle time. See gtk_tree_model_filter_set_incremental().
+   *
+   * Since: 3.20
+   */
+  g_object_class_install_property (object_class,
+                                   PROP_INCREMENTAL,
+                                   g_param_spec_boolean ("incremental",
+                                                         ("Incremental"),
+                                                         ("Whether rows are filtered in idle time"),
+                                                         FALSE,
+                                                         GTK_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY));
 }
 
 static void
@@ -623,6 +688,9 @@ gtk_tree_model_filter_set_property (GObject      *object,
       case PROP_VIRTUAL_ROOT:
         gtk_tree_model_filter_set_root (filter, g_value_get_boxed (value));
         break;
+      case PROP_INCREMENTAL:
+        gtk_tree_model_filter_set_incremental (filter, g_value_get_boolean (value));
+        break;
       default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
         break;
@@ -645,6 +713,9 @@ gtk_tree_model_filter_get_property (GObject    *object,
       case PROP_VIRTUAL_ROOT:
         g_value_set_boxed (value, filter->priv->virtual_root);
         break;
+      case PROP_INCREMENTAL:
+        g_value_set_boolean (value, filter->priv->incremental);
+        break;
       default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
         break;
@@ -726,9 +797,11 @@ gtk_tree_model_filter_build_level (GtkTreeModelFilter *filter,
                                    FilterElt          *parent_elt,
                                    gboolean            emit_inserted)
 {
+  GtkTreeModelPendingFunc pending_func;
   GtkTreeIter iter;
   GtkTreeIter first_node;
   GtkTreeIter root;
+  GtkTreeIter parent_iter;
   FilterLevel *new_level;
   FilterLevel *tmp_level;
   FilterElt *tmp_elt;
@@ -736,6 +809,8 @@ gtk_tree_model_filter_build_level (GtkTreeModelFilter *filter,
   gint length = 0;
   gint i;
   gboolean empty = TRUE;
+  gboolean lazy;
+  gint64 end_time = 0;
 
   g_assert (filter->priv->child_model != NULL);
 
@@ -768,7 +843,6 @@ gtk_tree_model_filter_build_level (GtkTreeModelFilter *filter,
     }
   else
     {
-      GtkTreeIter parent_iter;
       GtkTreeIter child_parent_iter;
 
       parent_iter.stamp = filter->priv->stamp;
@@ -786,14 +860,28 @@ gtk_tree_model_filter_build_level (GtkTreeModelFilter *filter,
                                                         &child_parent_iter,
                                                         &parent_iter);
       length = gtk_tree_model_iter_n_children (filter->priv->child_model, &child_parent_iter);
-
-      /* Take a reference on the parent */
-      gtk_tree_model_filter_real_ref_node (GTK_TREE_MODEL (filter),
-                                           &parent_iter, FALSE);
     }
 
   g_return_if_fail (length > 0);
 
+  /* Leave out the rows that the child model did not announce yet; it
+   * emits ::rows-inserted for them later
+   */
+  pending_func = _gtk_tree_model_get_pending_func (filter->priv->child_model);
+  if (pending_func != NULL)
+    {
+      while (pending_func (filter->priv->child_model, &iter))
+        {
+          if (!gtk_tree_model_iter_next (filter->priv->child_model, &iter))
+            return;
+        }
+    }
+
+  /* Take a reference on the parent */
+  if (parent_level)
+    gtk_tree_model_filter_real_ref_node (GTK_TREE_MODEL (filter),
+                                         &parent_iter, FALSE);
+
   new_level = g_new (FilterLevel, 1);
   new_level->seq = g_sequence_new (filter_elt_free);
   new_level->visible_seq = g_sequence_new (NULL);
@@ -825,8 +913,26 @@ gtk_tree_model_filter_build_level (GtkTreeModelFilter *filter,
 
   first_node = iter;
 
+  /* The idle handler walks child offsets, which only match the
+   * offsets in the level if no rows are pending
+   */
+  lazy = parent_level == NULL && filter->priv->incremental && pending_func == NULL;
+  if (lazy)
+    end_time = g_get_monotonic_time () + GTK_TREE_MODEL_FILTER_TIME_US_PER_CHUNK;
+
   do
     {
+      /* The rest of the root level is left for the idle handler */
+      if (lazy && i > 0 && i % 64 == 0 &&
+          g_get_monotonic_time () >= end_time)
+        {
+          gtk_tree_model_filter_queue_refilter (filter, i);
+          break;
+        }
+
+      if (pending_func != NULL && pending_func (filter->priv->child_model, &iter))
+        continue;
+
       if (gtk_tree_model_filter_visible (filter, &iter))
         {
           FilterElt *filter_elt;
@@ -1015,7 +1121,10 @@ gtk_tree_model_filter_free_level (GtkTreeModelFilter *filter,
       filter_level->parent_elt->children = NULL;
     }
   else
-    filter->priv->root = NULL;
+    {
+      filter->priv->root = NULL;
+      gtk_tree_model_filter_stop_refilter (filter);
+    }
 
   g_sequence_free (filter_level->seq);
   g_sequence_free (filter_level->visible_seq);
@@ -2132,12 +2241,18 @@ gtk_tree_model_filter_row_inserted (GtkTreeModel *c_model,
 
   g_return_if_fail (c_path != NULL || c_iter != NULL);
 
+  /* Already handled by gtk_tree_model_filter_rows_inserted() */
+  if (_gtk_tree_model_row_inserted_is_batched (c_model, c_path))
+    return;
+
   if (!c_path)
     {
       c_path = gtk_tree_model_get_path (c_model, c_iter);
       free_c_path = TRUE;
     }
 
+  gtk_tree_model_filter_shift_refilter (filter, c_path, 1);
+
   if (c_iter)
     real_c_iter = *c_iter;
   else
@@ -2293,6 +2408,262 @@ done:
     gtk_tree_path_free (c_path);
 }
 
+static void
+gtk_tree_model_filter_emit_rows_inserted_for_path (GtkTreeModelFilter *filter,
+                                                   GtkTreeModel       *c_model,
+                                                   GtkTreePath        *c_path,
+                                                   GArray             *c_iters)
+{
+  FilterLevel *level;
+  FilterElt *elt;
+  GSequenceIter *siter;
+  GtkTreePath *path;
+  GtkTreeIter iter;
+  guint i;
+
+  gtk_tree_model_filter_increment_stamp (filter);
+
+  path = gtk_real_tree_model_filter_convert_child_path_to_path (filter,
+                                                                c_path,
+                                                                FALSE,
+                                                                TRUE);
+  if (!path)
+    /* parent is probably being filtered out */
+    return;
+
+  gtk_tree_model_filter_get_iter_full (GTK_TREE_MODEL (filter), &iter, path);
+  gtk_tree_path_free (path);
+
+  level = FILTER_LEVEL (iter.user_data);
+  elt = FILTER_ELT (iter.user_data2);
+
+  if (!gtk_tree_model_filter_elt_is_visible_in_target (level, elt))
+    return;
+
+  path = gtk_tree_model_get_path (GTK_TREE_MODEL (filter), &iter);
+
+  if (!level->parent_level || level->ext_ref_count > 0)
+    gtk_tree_model_rows_inserted (GTK_TREE_MODEL (filter), path, &iter,
+                                  c_iters->len);
+
+  if (level->parent_level && level->parent_elt->ext_ref_count > 0 &&
+      g_sequence_get_length (level->visible_seq) == (gint) c_iters->len)
+    {
+      /* These are the first visible nodes in this level, so we need
+       * to emit row-has-child-toggled on the parent.
+       */
+      gtk_tree_path_up (path);
+      gtk_tree_model_get_iter (GTK_TREE_MODEL (filter), &iter, path);
+
+      gtk_tree_model_row_has_child_toggled (GTK_TREE_MODEL (filter),
+                                            path, &iter);
+    }
+
+  gtk_tree_path_free (path);
+
+  siter = elt->visible_siter;
+  for (i = 0; i < c_iters->len; i++)
+    {
+      if (gtk_tree_model_iter_has_child (c_model,
+                                         &g_array_index (c_iters, GtkTreeIter, i)))
+        gtk_tree_model_filter_update_children (filter, level,
+                                               g_sequence_get (siter));
+
+      siter = g_sequence_iter_next (siter);
+    }
+}
+
+/* Does the same as gtk_tree_model_filter_row_inserted() for each of
+ * the rows, but updates the offsets in the level once. If our own
+ * listeners support it, the visible new rows, which end up next to
+ * each other, are announced in one go.
+ */
+static void
+gtk_tree_model_filter_rows_inserted (GtkTreeModel *c_model,
+                                     GtkTreePath  *c_path,
+                                     GtkTreeIter  *c_iter,
+                                     gint          n_rows,
+                                     gpointer      data)
+{
+  GtkTreeModelFilter *filter = GTK_TREE_MODEL_FILTER (data);
+  GtkTreePath *real_path = NULL;
+  GtkTreePath *first_c_path = NULL;
+  GtkTreePath *row_c_path;
+  GtkTreeIter row_c_iter;
+  GArray *visible_c_iters;
+  FilterElt *elt = NULL;
+  FilterLevel *level = NULL;
+  FilterLevel *parent_level = NULL;
+  GSequenceIter *siter;
+  FilterElt dummy;
+  gboolean batch;
+  gint depth, offset, index, i;
+
+  depth = gtk_tree_path_get_depth (c_path);
+  visible_c_iters = g_array_new (FALSE, FALSE, sizeof (GtkTreeIter));
+
+  gtk_tree_model_filter_shift_refilter (filter, c_path, n_rows);
+
+  /* the rows have already been inserted, so we need to fixup the
+   * virtual root here first
+   */
+  if (filter->priv->virtual_root &&
+      gtk_tree_path_get_depth (filter->priv->virtual_root) >= depth)
+    {
+      gint *v_indices, *c_indices;
+      gboolean common_prefix = TRUE;
+
+      v_indices = gtk_tree_path_get_indices (filter->priv->virtual_root);
+      c_indices = gtk_tree_path_get_indices (c_path);
+
+      for (i = 0; i < depth - 1; i++)
+        if (v_indices[i] != c_indices[i])
+          {
+            common_prefix = FALSE;
+            break;
+          }
+
+      if (common_prefix && v_indices[depth - 1] >= c_indices[depth - 1])
+        v_indices[depth - 1] += n_rows;
+    }
+
+  /* subtract virtual root if necessary */
+  if (filter->priv->virtual_root)
+    {
+      real_path = gtk_tree_model_filter_remove_root (c_path,
+                                                     filter->priv->virtual_root);
+      /* not our child */
+      if (!real_path)
+        goto done;
+    }
+  else
+    real_path = gtk_tree_path_copy (c_path);
+
+  if (!filter->priv->root)
+    {
+      /* The root level has not been exposed to the view yet; building
+       * it picks up the new rows and emits the signals for them.
+       */
+      gtk_tree_model_filter_build_level (filter, NULL, NULL, TRUE);
+      goto done;
+    }
+
+  if (gtk_tree_path_get_depth (real_path) - 1 >= 1)
+    {
+      GtkTreePath *parent = gtk_tree_path_copy (real_path);
+      gboolean found;
+
+      gtk_tree_path_up (parent);
+      found = find_elt_with_offset (filter, parent, &parent_level, &elt);
+      gtk_tree_path_free (parent);
+
+      if (!found)
+        /* Parent is not in the cache and probably being filtered out */
+        goto done;
+
+      level = elt->children;
+    }
+  else
+    level = FILTER_LEVEL (filter->priv->root);
+
+  if (!level)
+    {
+      if (elt && elt->visible_siter)
+        {
+          /* The level in which the new nodes should be inserted does
+           * not exist, but the parent, elt, does.  If elt is visible,
+           * emit row-has-child-toggled.
+           */
+          GtkTreePath *tmppath;
+          GtkTreeIter  tmpiter;
+
+          tmpiter.stamp = filter->priv->stamp;
+          tmpiter.user_data = parent_level;
+          tmpiter.user_data2 = elt;
+
+          tmppath = gtk_tree_model_get_path (GTK_TREE_MODEL (filter),
+                                             &tmpiter);
+
+          if (tmppath)
+            {
+              gtk_tree_model_row_has_child_toggled (GTK_TREE_MODEL (filter),
+                                                    tmppath, &tmpiter);
+              gtk_tree_path_free (tmppath);
+            }
+        }
+      goto done;
+    }
+
+  offset = gtk_tree_path_get_indices (real_path)[gtk_tree_path_get_depth (real_path) - 1];
+
+  /* update the offsets in one pass */
+  dummy.offset = offset;
+  siter = g_sequence_search (level->seq, &dummy, filter_elt_cmp, NULL);
+  siter = g_sequence_iter_prev (siter);
+  for (; !g_sequence_iter_is_end (siter); siter = g_sequence_iter_next (siter))
+    {
+      elt = g_sequence_get (siter);
+      if (elt->offset >= offset)
+        elt->offset += n_rows;
+    }
+
+  /* only insert the visible ones; without batching, announce each
+   * one before inserting the next
+   */
+  batch = _gtk_tree_model_can_batch (GTK_TREE_MODEL (filter));
+  row_c_iter = *c_iter;
+  for (i = 0; i < n_rows; i++)
+    {
+      if (i > 0 && !gtk_tree_model_iter_next (c_model, &row_c_iter))
+        break;
+
+      if (!gtk_tree_model_filter_visible (filter, &row_c_iter))
+        continue;
+
+      elt = gtk_tree_model_filter_insert_elt_in_level (filter, &row_c_iter,
+                                                       level, offset + i,
+                                                       &index);
+
+      /* insert_elt_in_level defaults to FALSE */
+      elt->visible_siter = g_sequence_insert_sorted (level->visible_seq,
+                                                     elt,
+                                                     filter_elt_cmp, NULL);
+
+      if (!batch)
+        {
+          row_c_path = gtk_tree_path_copy (c_path);
+          gtk_tree_path_get_indices (row_c_path)[depth - 1] += i;
+          gtk_tree_model_filter_emit_row_inserted_for_path (filter, c_model,
+                                                            row_c_path,
+                                                            &row_c_iter);
+          gtk_tree_path_free (row_c_path);
+          continue;
+        }
+
+      if (first_c_path == NULL)
+        {
+          first_c_path = gtk_tree_path_copy (c_path);
+          gtk_tree_path_get_indices (first_c_path)[depth - 1] += i;
+        }
+      g_array_append_val (visible_c_iters, row_c_iter);
+    }
+
+done:
+  if (real_path)
+    gtk_tree_model_filter_check_ancestors (filter, real_path);
+
+  if (first_c_path)
+    gtk_tree_model_filter_emit_rows_inserted_for_path (filter, c_model,
+                                                       first_c_path,
+                                                       visible_c_iters);
+
+  if (real_path)
+    gtk_tree_path_free (real_path);
+  if (first_c_path)
+    gtk_tree_path_free (first_c_path);
+  g_array_free (visible_c_iters, TRUE);
+}
+
 static void
 gtk_tree_model_filter_row_has_child_toggled (GtkTreeModel *c_model,
                                              GtkTreePath  *c_path,
@@ -2543,6 +2914,8 @@ gtk_tree_model_filter_row_deleted (GtkTreeModel *c_model,
 
   g_return_if_fail (c_path != NULL);
 
+  gtk_tree_model_filter_shift_refilter (filter, c_path, -1);
+
   /* special case the deletion of an ancestor of the virtual root */
   if (filter->priv->virtual_root &&
       (gtk_tree_path_is_ancestor (c_path, filter->priv->virtual_root) ||
@@ -2727,6 +3100,15 @@ gtk_tree_model_filter_rows_reordered (GtkTreeModel *c_model,
 
   g_return_if_fail (new_order != NULL);
 
+  /* Rows that were not filtered yet may have moved before the
+   * incremental pass, so it starts over
+   */
+  if (filter->priv->refilter_id != 0 &&
+      (filter->priv->virtual_root
+       ? c_path && gtk_tree_path_compare (c_path, filter->priv->virtual_root) == 0
+       : c_path == NULL || gtk_tree_path_get_depth (c_path) == 0))
+    filter->priv->refilter_offset = 0;
+
   if (c_path == NULL || gtk_tree_path_get_depth (c_path) == 0)
     {
       length = gtk_tree_model_iter_n_children (c_model, NULL);
@@ -3642,6 +4024,11 @@ gtk_tree_model_filter_set_model (GtkTreeModelFilter *filter,
                                    filter->priv->changed_id);
       g_signal_handler_disconnect (filter->priv->child_model,
                                    filter->priv->inserted_id);
+      g_signal_handler_disconnect (filter->priv->child_model,
+                                   filter->priv->rows_inserted_id);
+      _gtk_tree_model_remove_batch_handler (filter->priv->child_model,
+                                            G_CALLBACK (gtk_tree_model_filter_row_inserted),
+                                            filter);
       g_signal_handler_disconnect (filter->priv->child_model,
                                    filter->priv->has_child_toggled_id);
       g_signal_handler_disconnect (filter->priv->child_model,
@@ -3674,6 +4061,13 @@ gtk_tree_model_filter_set_model (GtkTreeModelFilter *filter,
         g_signal_connect (child_model, "row-inserted",
                           G_CALLBACK (gtk_tree_model_filter_row_inserted),
                           filter);
+      filter->priv->rows_inserted_id =
+        g_signal_connect (child_model, "rows-inserted",
+                          G_CALLBACK (gtk_tree_model_filter_rows_inserted),
+                          filter);
+      _gtk_tree_model_add_batch_handler (child_model,
+                                         G_CALLBACK (gtk_tree_model_filter_row_inserted),
+                                         filter);
       filter->priv->has_child_toggled_id =
         g_signal_connect (child_model, "row-has-child-toggled",
                           G_CALLBACK (gtk_tree_model_filter_row_has_child_toggled),
@@ -4249,6 +4643,175 @@ gtk_tree_model_filter_refilter_helper (GtkTreeModel *model,
   return FALSE;
 }
 
+/* incremental filtering */
+static void
+gtk_tree_model_filter_refilter_row (GtkTreeModelFilter *filter,
+                                    GtkTreePath        *c_path,
+                                    GtkTreeIter        *c_iter)
+{
+  GtkTreeModel *c_model = filter->priv->child_model;
+  GtkTreePath *c_child_path;
+  GtkTreeIter c_child;
+
+  gtk_tree_model_filter_row_changed (c_model, c_path, c_iter, filter);
+
+  if (!gtk_tree_model_iter_children (c_model, &c_child, c_iter))
+    return;
+
+  c_child_path = gtk_tree_path_copy (c_path);
+  gtk_tree_path_down (c_child_path);
+
+  do
+    {
+      gtk_tree_model_filter_refilter_row (filter, c_child_path, &c_child);
+      gtk_tree_path_next (c_child_path);
+    }
+  while (gtk_tree_model_iter_next (c_model, &c_child));
+
+  gtk_tree_path_free (c_child_path);
+}
+
+/* Filters the top-level rows from refilter_offset on, until @end_time
+ * is reached, or until the last row if @end_time is -1. Returns %TRUE
+ * once all rows were done.
+ */
+static gboolean
+gtk_tree_model_filter_refilter_chunk (GtkTreeModelFilter *filter,
+                                      gint64              end_time)
+{
+  GtkTreeModelFilterPrivate *priv = filter->priv;
+  GtkTreeIter c_iter, c_parent;
+  GtkTreePath *c_path;
+  gboolean valid;
+
+  if (priv->root == NULL)
+    return TRUE;
+
+  /* Child offsets do not match ours while the child model holds back
+   * rows it did not announce; wait for the end of its update
+   */
+  if (_gtk_tree_model_get_pending_func (priv->child_model) != NULL)
+    return FALSE;
+
+  if (priv->virtual_root)
+    {
+      if (priv->virtual_root_deleted ||
+          !gtk_tree_model_get_iter (priv->child_model, &c_parent, priv->virtual_root))
+        return TRUE;
+
+      valid = gtk_tree_model_iter_nth_child (priv->child_model, &c_iter,
+                                             &c_parent, priv->refilter_offset);
+      c_path = gtk_tree_path_copy (priv->virtual_root);
+    }
+  else
+    {
+      valid = gtk_tree_model_iter_nth_child (priv->child_model, &c_iter,
+                                             NULL, priv->refilter_offset);
+      c_path = gtk_tree_path_new ();
+    }
+
+  gtk_tree_path_append_index (c_path, priv->refilter_offset);
+
+  while (valid && priv->root != NULL)
+    {
+      gtk_tree_model_filter_refilter_row (filter, c_path, &c_iter);
+      priv->refilter_offset++;
+
+      if (end_time >= 0 && g_get_monotonic_time () >= end_time)
+        break;
+
+      valid = gtk_tree_model_iter_next (priv->child_model, &c_iter);
+      gtk_tree_path_next (c_path);
+    }
+
+  gtk_tree_path_free (c_path);
+
+  return !valid || priv->root == NULL;
+}
+
+static gboolean
+gtk_tree_model_filter_refilter_idle (gpointer data)
+{
+  GtkTreeModelFilter *filter = data;
+  guint refilter_id = filter->priv->refilter_id;
+  gboolean done;
+
+  done = gtk_tree_model_filter_refilter_chunk (filter,
+                                               g_get_monotonic_time () +
+                                               GTK_TREE_MODEL_FILTER_TIME_US_PER_CHUNK);
+
+  /* The pass was stopped or started over meanwhile */
+  if (filter->priv->refilter_id != refilter_id)
+    return G_SOURCE_REMOVE;
+
+  if (!done)
+    return G_SOURCE_CONTINUE;
+
+  filter->priv->refilter_id = 0;
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+gtk_tree_model_filter_queue_refilter (GtkTreeModelFilter *filter,
+                                      gint                offset)
+{
+  filter->priv->refilter_offset = offset;
+
+  if (filter->priv->refilter_id == 0)
+    {
+      filter->priv->refilter_id =
+        gdk_threads_add_idle_full (G_PRIORITY_DEFAULT_IDLE,
+                                   gtk_tree_model_filter_refilter_idle,
+                                   filter, NULL);
+      g_source_set_name_by_id (filter->priv->refilter_id,
+                               "[gtk+] gtk_tree_model_filter_refilter_idle");
+    }
+}
+
+static void
+gtk_tree_model_filter_stop_refilter (GtkTreeModelFilter *filter)
+{
+  if (filter->priv->refilter_id != 0)
+    {
+      g_source_remove (filter->priv->refilter_id);
+      filter->priv->refilter_id = 0;
+    }
+}
+
+/* Keeps the incremental pass at the same top-level child row while
+ * rows are inserted before it, or deleted
+ */
+static void
+gtk_tree_model_filter_shift_refilter (GtkTreeModelFilter *filter,
+                                      GtkTreePath        *c_path,
+                                      gint                n_rows)
+{
+  GtkTreeModelFilterPrivate *priv = filter->priv;
+  gint depth, offset;
+
+  if (priv->refilter_id == 0)
+    return;
+
+  depth = 1;
+  if (priv->virtual_root)
+    {
+      if (!gtk_tree_path_is_ancestor (priv->virtual_root, c_path))
+        return;
+
+      depth += gtk_tree_path_get_depth (priv->virtual_root);
+    }
+
+  if (gtk_tree_path_get_depth (c_path) != depth)
+    return;
+
+  offset = gtk_tree_path_get_indices (c_path)[depth - 1];
+
+  if (offset < priv->refilter_offset ||
+      (n_rows > 0 && offset == priv->refilter_offset))
+    priv->refilter_offset += n_rows;
+}
+
 /**
  * gtk_tree_model_filter_refilter:
  * @filter: A #GtkTreeModelFilter.
@@ -4256,6 +4819,10 @@ gtk_tree_model_filter_refilter_helper (GtkTreeModel *model,
  * Emits ::row_changed for each row in the child model, which causes
  * the filter to re-evaluate whether a row is visible or not.
  *
+ * If @filter is #GtkTreeModelFilter:incremental, only the first rows
+ * are looked at right away, and the rest follow in idle time. Until
+ * then, they keep the visibility they had before.
+ *
  * Since: 2.4
  */
 void
@@ -4263,12 +4830,90 @@ gtk_tree_model_filter_refilter (GtkTreeModelFilter *filter)
 {
   g_return_if_fail (GTK_IS_TREE_MODEL_FILTER (filter));
 
+  if (filter->priv->incremental)
+    {
+      if (filter->priv->root == NULL)
+        return;
+
+      gtk_tree_model_filter_queue_refilter (filter, 0);
+      if (gtk_tree_model_filter_refilter_chunk (filter,
+                                                g_get_monotonic_time () +
+                                                GTK_TREE_MODEL_FILTER_TIME_US_PER_CHUNK))
+        gtk_tree_model_filter_stop_refilter (filter);
+
+      return;
+    }
+
   /* S L O W */
   gtk_tree_model_foreach (filter->priv->child_model,
                           gtk_tree_model_filter_refilter_helper,
                           filter);
 }
 
+/**
+ * gtk_tree_model_filter_set_incremental:
+ * @filter: A #GtkTreeModelFilter.
+ * @incremental: whether to filter rows in idle time
+ *
+ * Sets whether the visibility of the top-level rows of @filter is
+ * determined in chunks, in idle time, instead of all at once. This
+ * keeps the user interface responsive when large models are filtered,
+ * for example while the user types a search term.
+ *
+ * When the filter is first used, rows that have not been looked at
+ * yet are hidden until they are found to be visible and inserted, so
+ * while that first pass is running, gtk_tree_model_iter_n_children()
+ * only counts the rows found so far. A pass started by
+ * gtk_tree_model_filter_refilter() instead leaves the rows it has not
+ * reached yet with the visibility they had before: they are removed
+ * or inserted as the pass gets to them. Child levels are still
+ * filtered when they are built.
+ *
+ * Turning the mode off finishes a running pass right away.
+ *
+ * Since: 3.20
+ */
+void
+gtk_tree_model_filter_set_incremental (GtkTreeModelFilter *filter,
+                                       gboolean            incremental)
+{
+  g_return_if_fail (GTK_IS_TREE_MODEL_FILTER (filter));
+
+  incremental = incremental != FALSE;
+
+  if (filter->priv->incremental == incremental)
+    return;
+
+  filter->priv->incremental = incremental;
+
+  if (!incremental && filter->priv->refilter_id != 0)
+    {
+      gtk_tree_model_filter_refilter_chunk (filter, -1);
+      gtk_tree_model_filter_stop_refilter (filter);
+    }
+
+  g_object_notify (G_OBJECT (filter), "incremental");
+}
+
+/**
+ * gtk_tree_model_filter_get_incremental:
+ * @filter: A #GtkTreeModelFilter.
+ *
+ * Returns whether @filter determines the visibility of rows in
+ * idle time. See gtk_tree_model_filter_set_incremental().
+ *
+ * Returns: %TRUE if @filter is incremental
+ *
+ * Since: 3.20
+ */
+gboolean
+gtk_tree_model_filter_get_incremental (GtkTreeModelFilter *filter)
+{
+  g_return_val_if_fail (GTK_IS_TREE_MODEL_FILTER (filter), FALSE);
+
+  return filter->priv->incremental;
+}
+
 /**
  * gtk_tree_model_filter_clear_cache:
  * @filter: A #GtkTreeModelFilter.
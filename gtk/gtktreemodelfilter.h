@@ -150,6 +150,11 @@ GDK_AVAILABLE_IN_ALL
 void          gtk_tree_model_filter_refilter                   (GtkTreeModelFilter           *filter);
 GDK_AVAILABLE_IN_ALL
 void          gtk_tree_model_filter_clear_cache                (GtkTreeModelFilter           *filter);
+GDK_AVAILABLE_IN_3_20
+void          gtk_tree_model_filter_set_incremental            (GtkTreeModelFilter           *filter,
+                                                                gboolean                      incremental);
+GDK_AVAILABLE_IN_3_20
+gboolean      gtk_tree_model_filter_get_incremental            (GtkTreeModelFilter           *filter);
 
 G_END_DECLS
 
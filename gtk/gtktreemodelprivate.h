@@ -0,0 +1,48 @@
+/* GTK - The GIMP Toolkit
+ * Copyright (C) 2015 The GTK+ Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GTK_TREE_MODEL_PRIVATE_H__
+#define __GTK_TREE_MODEL_PRIVATE_H__
+
+
+#include <gtk/gtktreemodel.h>
+
+G_BEGIN_DECLS
+
+typedef gboolean (* GtkTreeModelPendingFunc) (GtkTreeModel *tree_model,
+                                              GtkTreeIter  *iter);
+
+gboolean _gtk_tree_model_row_inserted_is_batched (GtkTreeModel *tree_model,
+                                                  GtkTreePath  *path);
+
+void     _gtk_tree_model_add_batch_handler       (GtkTreeModel *tree_model,
+                                                  GCallback     row_inserted,
+                                                  gpointer      data);
+void     _gtk_tree_model_remove_batch_handler    (GtkTreeModel *tree_model,
+                                                  GCallback     row_inserted,
+                                                  gpointer      data);
+gboolean _gtk_tree_model_can_batch               (GtkTreeModel *tree_model);
+
+void     _gtk_tree_model_set_pending_func        (GtkTreeModel            *tree_model,
+                                                  GtkTreeModelPendingFunc  func);
+GtkTreeModelPendingFunc
+         _gtk_tree_model_get_pending_func        (GtkTreeModel            *tree_model);
+
+G_END_DECLS
+
+
+#endif /* __GTK_TREE_MODEL_PRIVATE_H__ */
@@ -23,6 +23,8 @@
 #include "gtktreesortable.h"
 #include "gtktreestore.h"
 #include "gtktreedatalist.h"
+#include "gtktreemodelprivate.h"
+#include "gtktreesortkeysprivate.h"
 #include "gtkintl.h"
 #include "gtkprivate.h"
 #include "gtktreednd.h"
@@ -273,9 +275,16 @@ struct _GtkTreeModelSortPrivate
   gpointer default_sort_data;
   GDestroyNotify default_sort_destroy;
 
+  /* Child rows left out when building the root level, see
+   * gtk_tree_model_sort_rows_inserted()
+   */
+  gint root_skip_start;
+  gint root_skip_end;
+
   /* signal ids */
   gulong changed_id;
   gulong inserted_id;
+  gulong rows_inserted_id;
   gulong has_child_toggled_id;
   gulong deleted_id;
   gulong reordered_id;
@@ -327,6 +336,11 @@ static void gtk_tree_model_sort_row_inserted          (GtkTreeModel          *mo
 						       GtkTreePath           *path,
 						       GtkTreeIter           *iter,
 						       gpointer               data);
+static void gtk_tree_model_sort_rows_inserted         (GtkTreeModel          *model,
+						       GtkTreePath           *path,
+						       GtkTreeIter           *iter,
+						       gint                   n_rows,
+						       gpointer               data);
 static void gtk_tree_model_sort_row_has_child_toggled (GtkTreeModel          *model,
 						       GtkTreePath           *path,
 						       GtkTreeIter           *iter,
@@ -903,6 +917,10 @@ gtk_tree_model_sort_row_inserted (GtkTreeModel          *s_model,
 
   g_return_if_fail (s_path != NULL || s_iter != NULL);
 
+  /* Already handled by gtk_tree_model_sort_rows_inserted() */
+  if (_gtk_tree_model_row_inserted_is_batched (s_model, s_path))
+    return;
+
   if (!s_path)
     {
       s_path = gtk_tree_model_get_path (s_model, s_iter);
@@ -995,6 +1013,216 @@ gtk_tree_model_sort_row_inserted (GtkTreeModel          *s_model,
   return;
 }
 
+typedef struct
+{
+  GCompareDataFunc compare_func;
+  SortData *sort_data;
+} InsertData;
+
+/* Orders new rows like inserting them one after the other would */
+static gint
+compare_new_elts (gconstpointer a,
+                  gconstpointer b,
+                  gpointer      user_data)
+{
+  InsertData *insert_data = user_data;
+  const SortElt *elt_a = *(SortElt **) a;
+  const SortElt *elt_b = *(SortElt **) b;
+  gint retval;
+
+  retval = insert_data->compare_func (elt_a, elt_b, insert_data->sort_data);
+  if (retval == 0)
+    retval = elt_a->offset - elt_b->offset;
+
+  return retval;
+}
+
+static void
+gtk_tree_model_sort_emit_inserted (GtkTreeModelSort *tree_model_sort,
+                                   GtkTreePath      *parent_path,
+                                   SortLevel        *level,
+                                   SortElt          *elt,
+                                   gint              n_rows)
+{
+  GtkTreePath *path;
+  GtkTreeIter iter;
+
+  gtk_tree_model_sort_increment_stamp (tree_model_sort);
+
+  path = gtk_tree_path_copy (parent_path);
+  gtk_tree_path_append_index (path, g_sequence_iter_get_position (elt->siter));
+
+  iter.stamp = tree_model_sort->priv->stamp;
+  iter.user_data = level;
+  iter.user_data2 = elt;
+
+  if (n_rows > 1)
+    gtk_tree_model_rows_inserted (GTK_TREE_MODEL (tree_model_sort), path, &iter, n_rows);
+  else
+    gtk_tree_model_row_inserted (GTK_TREE_MODEL (tree_model_sort), path, &iter);
+
+  gtk_tree_path_free (path);
+}
+
+/* Does the same as gtk_tree_model_sort_row_inserted() for each of the
+ * rows, but updates the offsets in the level once. The new rows that
+ * end up next to each other are inserted together, and announced with
+ * ::rows-inserted if our own listeners support it, before the next
+ * ones are inserted.
+ */
+static void
+gtk_tree_model_sort_rows_inserted (GtkTreeModel *s_model,
+                                   GtkTreePath  *s_path,
+                                   GtkTreeIter  *s_iter,
+                                   gint          n_rows,
+                                   gpointer      data)
+{
+  GtkTreeModelSort *tree_model_sort = GTK_TREE_MODEL_SORT (data);
+  GtkTreeModelSortPrivate *priv = tree_model_sort->priv;
+  GtkTreePath *parent_s_path, *parent_path;
+  GtkTreeIter row_s_iter;
+  GSequenceIter *siter, *end_siter;
+  GSequenceIter **befores;
+  InsertData insert_data;
+  SortData sort_data;
+  GPtrArray *elts;
+  SortLevel *level;
+  SortElt *elt;
+  gboolean batch;
+  gint depth, first, n;
+  guint i, j;
+
+  depth = gtk_tree_path_get_depth (s_path);
+  first = gtk_tree_path_get_indices (s_path)[depth - 1];
+
+  if (!priv->root)
+    {
+      /* No other level can have been built */
+      if (depth != 1)
+        return;
+
+      /* Build the level without the new rows, they are inserted below */
+      priv->root_skip_start = first;
+      priv->root_skip_end = first + n_rows;
+      gtk_tree_model_sort_build_level (tree_model_sort, NULL, NULL);
+      priv->root_skip_start = priv->root_skip_end = 0;
+
+      if (!priv->root)
+        return;
+    }
+
+  /* find the level, like gtk_tree_model_sort_row_inserted() */
+  level = priv->root;
+  for (n = 0; n < depth - 1; n++)
+    {
+      if (g_sequence_get_length (level->seq) < gtk_tree_path_get_indices (s_path)[n])
+        return;
+
+      elt = lookup_elt_with_offset (tree_model_sort, level,
+                                    gtk_tree_path_get_indices (s_path)[n],
+                                    NULL);
+      if (elt == NULL || !elt->children)
+        return;
+
+      level = elt->children;
+    }
+
+  if (level->ref_count == 0 && level != priv->root)
+    {
+      gtk_tree_model_sort_free_level (tree_model_sort, level, TRUE);
+      return;
+    }
+
+  if (depth > 1)
+    {
+      parent_s_path = gtk_tree_path_copy (s_path);
+      gtk_tree_path_up (parent_s_path);
+      parent_path = gtk_real_tree_model_sort_convert_child_path_to_path (tree_model_sort,
+                                                                         parent_s_path,
+                                                                         FALSE);
+      gtk_tree_path_free (parent_s_path);
+    }
+  else
+    parent_path = gtk_tree_path_new ();
+
+  /* update all larger offsets in one pass */
+  end_siter = g_sequence_get_end_iter (level->seq);
+  for (siter = g_sequence_get_begin_iter (level->seq);
+       siter != end_siter;
+       siter = g_sequence_iter_next (siter))
+    {
+      elt = g_sequence_get (siter);
+      if (elt->offset >= first)
+        elt->offset += n_rows;
+    }
+
+  elts = g_ptr_array_sized_new (n_rows);
+  row_s_iter = *s_iter;
+  for (n = 0; n < n_rows; n++)
+    {
+      if (n > 0 && !gtk_tree_model_iter_next (s_model, &row_s_iter))
+        break;
+
+      elt = sort_elt_new ();
+      if (GTK_TREE_MODEL_SORT_CACHE_CHILD_ITERS (tree_model_sort))
+        elt->iter = row_s_iter;
+      elt->offset = first + n;
+      elt->zero_ref_count = 0;
+      elt->ref_count = 0;
+      elt->children = NULL;
+
+      g_ptr_array_add (elts, elt);
+    }
+
+  /* Find where each new row goes before changing the level */
+  fill_sort_data (&sort_data, tree_model_sort, level);
+
+  if (priv->sort_column_id == GTK_TREE_SORTABLE_DEFAULT_SORT_COLUMN_ID &&
+      priv->default_sort_func == NO_SORT_FUNC)
+    insert_data.compare_func = gtk_tree_model_sort_offset_compare_func;
+  else
+    insert_data.compare_func = gtk_tree_model_sort_compare_func;
+  insert_data.sort_data = &sort_data;
+
+  g_ptr_array_sort_with_data (elts, compare_new_elts, &insert_data);
+
+  befores = g_new (GSequenceIter *, elts->len);
+  for (i = 0; i < elts->len; i++)
+    befores[i] = g_sequence_search (level->seq, g_ptr_array_index (elts, i),
+                                    insert_data.compare_func, &sort_data);
+
+  free_sort_data (&sort_data);
+
+  /* Insert the rows that go to the same place together, and announce
+   * them before inserting the next ones, so that the model matches
+   * each emission
+   */
+  batch = _gtk_tree_model_can_batch (GTK_TREE_MODEL (tree_model_sort));
+
+  for (i = 0; i < elts->len; i = j)
+    {
+      for (j = i; j < elts->len && befores[j] == befores[i]; j++)
+        {
+          elt = g_ptr_array_index (elts, j);
+          elt->siter = g_sequence_insert_before (befores[j], elt);
+
+          if (!batch && parent_path)
+            gtk_tree_model_sort_emit_inserted (tree_model_sort, parent_path,
+                                               level, elt, 1);
+        }
+
+      if (batch && parent_path)
+        gtk_tree_model_sort_emit_inserted (tree_model_sort, parent_path,
+                                           level, g_ptr_array_index (elts, i),
+                                           j - i);
+    }
+
+  g_free (befores);
+  g_ptr_array_unref (elts);
+  if (parent_path)
+    gtk_tree_path_free (parent_path);
+}
+
 static void
 gtk_tree_model_sort_row_has_child_toggled (GtkTreeModel *s_model,
 					   GtkTreePath  *s_path,
@@ -1487,8 +1715,19 @@ gtk_tree_model_sort_iter_n_children (GtkTreeModel *tree_model,
   if (iter) 
     g_return_val_if_fail (VALID_ITER (iter, tree_model_sort), 0);
 
+  /* A level that was built does not contain the rows that the child
+   * model did not announce yet
+   */
   if (iter == NULL)
-    return gtk_tree_model_iter_n_children (priv->child_model, NULL);
+    {
+      if (priv->root)
+        return g_sequence_get_length (SORT_LEVEL (priv->root)->seq);
+
+      return gtk_tree_model_iter_n_children (priv->child_model, NULL);
+    }
+
+  if (SORT_ELT (iter->user_data2)->children)
+    return g_sequence_get_length (SORT_ELT (iter->user_data2)->children->seq);
 
   GET_CHILD_ITER (tree_model_sort, &child_iter, iter);
 
@@ -1892,6 +2131,55 @@ gtk_tree_model_sort_offset_compare_func (gconstpointer a,
   return retval;
 }
 
+/* Sorts by the values of a column, which are only fetched
+ * once for every row instead of for every comparison
+ */
+static void
+gtk_tree_model_sort_sort_level_by_keys (GtkTreeModelSort *tree_model_sort,
+                                        SortLevel        *level,
+                                        SortData         *data,
+                                        GtkTreeSortKeys  *keys)
+{
+  GtkTreeModelSortPrivate *priv = tree_model_sort->priv;
+  GSequenceIter **siters;
+  GSequenceIter *siter, *end_siter;
+  GtkTreeIter child_iter;
+  gint *order;
+  gint length, i;
+
+  length = g_sequence_get_length (level->seq);
+  siters = g_new (GSequenceIter *, length);
+
+  i = 0;
+  end_siter = g_sequence_get_end_iter (level->seq);
+  for (siter = g_sequence_get_begin_iter (level->seq);
+       siter != end_siter;
+       siter = g_sequence_iter_next (siter))
+    {
+      SortElt *elt = g_sequence_get (siter);
+
+      if (GTK_TREE_MODEL_SORT_CACHE_CHILD_ITERS (tree_model_sort))
+        child_iter = elt->iter;
+      else
+        {
+          data->parent_path_indices[data->parent_path_depth - 1] = elt->offset;
+          gtk_tree_model_get_iter (priv->child_model, &child_iter, data->parent_path);
+        }
+
+      siters[i] = siter;
+      gtk_tree_sort_keys_set (keys, i, &child_iter);
+      i++;
+    }
+
+  order = gtk_tree_sort_keys_sort (keys);
+
+  for (i = 0; i < length; i++)
+    g_sequence_move (siters[order[i]], end_siter);
+
+  g_free (order);
+  g_free (siters);
+}
+
 static void
 gtk_tree_model_sort_sort_level (GtkTreeModelSort *tree_model_sort,
 				SortLevel        *level,
@@ -1908,6 +2196,7 @@ gtk_tree_model_sort_sort_level (GtkTreeModelSort *tree_model_sort,
   GtkTreePath *path;
 
   SortData data;
+  GtkTreeSortKeys *keys;
 
   g_return_if_fail (level != NULL);
 
@@ -1937,12 +2226,22 @@ gtk_tree_model_sort_sort_level (GtkTreeModelSort *tree_model_sort,
 
   fill_sort_data (&data, tree_model_sort, level);
 
-  if (data.sort_func == NO_SORT_FUNC)
+  keys = gtk_tree_sort_keys_new (priv->child_model,
+                                 data.sort_func, data.sort_data,
+                                 priv->order, i);
+
+  if (keys)
+    gtk_tree_model_sort_sort_level_by_keys (tree_model_sort, level,
+                                            &data, keys);
+  else if (data.sort_func == NO_SORT_FUNC)
     g_sequence_sort (level->seq, gtk_tree_model_sort_offset_compare_func,
                      &data);
   else
     g_sequence_sort (level->seq, gtk_tree_model_sort_compare_func, &data);
 
+  if (keys)
+    gtk_tree_sort_keys_free (keys);
+
   free_sort_data (&data);
 
   new_order = g_new (gint, g_sequence_get_length (level->seq));
@@ -2142,6 +2441,11 @@ gtk_tree_model_sort_set_model (GtkTreeModelSort *tree_model_sort,
                                    priv->changed_id);
       g_signal_handler_disconnect (priv->child_model,
                                    priv->inserted_id);
+      g_signal_handler_disconnect (priv->child_model,
+                                   priv->rows_inserted_id);
+      _gtk_tree_model_remove_batch_handler (priv->child_model,
+                                            G_CALLBACK (gtk_tree_model_sort_row_inserted),
+                                            tree_model_sort);
       g_signal_handler_disconnect (priv->child_model,
                                    priv->has_child_toggled_id);
       g_signal_handler_disconnect (priv->child_model,
@@ -2173,6 +2477,13 @@ gtk_tree_model_sort_set_model (GtkTreeModelSort *tree_model_sort,
         g_signal_connect (child_model, "row-inserted",
                           G_CALLBACK (gtk_tree_model_sort_row_inserted),
                           tree_model_sort);
+      priv->rows_inserted_id =
+        g_signal_connect (child_model, "rows-inserted",
+                          G_CALLBACK (gtk_tree_model_sort_rows_inserted),
+                          tree_model_sort);
+      _gtk_tree_model_add_batch_handler (child_model,
+                                         G_CALLBACK (gtk_tree_model_sort_row_inserted),
+                                         tree_model_sort);
       priv->has_child_toggled_id =
         g_signal_connect (child_model, "row-has-child-toggled",
                           G_CALLBACK (gtk_tree_model_sort_row_has_child_toggled),
@@ -2464,9 +2775,13 @@ gtk_tree_model_sort_build_level (GtkTreeModelSort *tree_model_sort,
                                  SortElt          *parent_elt)
 {
   GtkTreeModelSortPrivate *priv = tree_model_sort->priv;
+  GtkTreeModelPendingFunc pending_func;
   GtkTreeIter iter;
+  GtkTreeIter parent_iter;
   SortLevel *new_level;
+  gboolean skip_range;
   gint length = 0;
+  gint offset;
   gint i;
 
   g_assert (priv->child_model != NULL);
@@ -2479,7 +2794,6 @@ gtk_tree_model_sort_build_level (GtkTreeModelSort *tree_model_sort,
     }
   else
     {
-      GtkTreeIter parent_iter;
       GtkTreeIter child_parent_iter;
 
       parent_iter.stamp = priv->stamp;
@@ -2500,13 +2814,33 @@ gtk_tree_model_sort_build_level (GtkTreeModelSort *tree_model_sort,
 						      &parent_iter);
 
       length = gtk_tree_model_iter_n_children (priv->child_model, &child_parent_iter);
-
-      gtk_tree_model_sort_ref_node (GTK_TREE_MODEL (tree_model_sort),
-                                    &parent_iter);
     }
 
   g_return_if_fail (length > 0);
 
+  /* Leave out the rows that the child model did not announce yet; it
+   * emits ::rows-inserted for them later. The level may only end up
+   * empty if gtk_tree_model_sort_rows_inserted() is about to insert
+   * rows into it.
+   */
+  pending_func = _gtk_tree_model_get_pending_func (priv->child_model);
+  skip_range = parent_level == NULL && priv->root_skip_end > priv->root_skip_start;
+
+  if (pending_func != NULL && !skip_range)
+    {
+      GtkTreeIter tmp_iter = iter;
+
+      while (pending_func (priv->child_model, &tmp_iter))
+        {
+          if (!gtk_tree_model_iter_next (priv->child_model, &tmp_iter))
+            return;
+        }
+    }
+
+  if (parent_level)
+    gtk_tree_model_sort_ref_node (GTK_TREE_MODEL (tree_model_sort),
+                                  &parent_iter);
+
   new_level = g_new (SortLevel, 1);
   new_level->seq = g_sequence_new (sort_elt_free);
   new_level->ref_count = 0;
@@ -2530,56 +2864,61 @@ gtk_tree_model_sort_build_level (GtkTreeModelSort *tree_model_sort,
   if (new_level != priv->root)
     priv->zero_ref_count++;
 
-  for (i = 0; i < length; i++)
+  for (i = 0, offset = 0; i < length; i++)
     {
       SortElt *sort_elt;
 
-      sort_elt = sort_elt_new ();
-      sort_elt->offset = i;
-      sort_elt->zero_ref_count = 0;
-      sort_elt->ref_count = 0;
-      sort_elt->children = NULL;
+      if ((!skip_range || i < priv->root_skip_start || i >= priv->root_skip_end) &&
+          (pending_func == NULL || !pending_func (priv->child_model, &iter)))
+        {
+          sort_elt = sort_elt_new ();
+          sort_elt->offset = offset++;
+          sort_elt->zero_ref_count = 0;
+          sort_elt->ref_count = 0;
+          sort_elt->children = NULL;
+
+          if (GTK_TREE_MODEL_SORT_CACHE_CHILD_ITERS (tree_model_sort))
+            sort_elt->iter = iter;
 
-      if (GTK_TREE_MODEL_SORT_CACHE_CHILD_ITERS (tree_model_sort))
+          sort_elt->siter = g_sequence_append (new_level->seq, sort_elt);
+        }
+
+      if ((GTK_TREE_MODEL_SORT_CACHE_CHILD_ITERS (tree_model_sort) || pending_func != NULL) &&
+          gtk_tree_model_iter_next (priv->child_model, &iter) == FALSE &&
+	  i < length - 1)
 	{
-	  sort_elt->iter = iter;
-	  if (gtk_tree_model_iter_next (priv->child_model, &iter) == FALSE &&
-	      i < length - 1)
+	  if (new_level->parent_level)
 	    {
-	      if (parent_level)
-	        {
-	          GtkTreePath *level;
-		  gchar *str;
-
-		  level = gtk_tree_model_sort_elt_get_path (parent_level,
-							    parent_elt);
-		  str = gtk_tree_path_to_string (level);
-		  gtk_tree_path_free (level);
-
-		  g_warning ("%s: There is a discrepancy between the sort model "
-			     "and the child model.  The child model is "
-			     "advertising a wrong length for level %s:.",
-			     G_STRLOC, str);
-		  g_free (str);
-		}
-	      else
-	        {
-		  g_warning ("%s: There is a discrepancy between the sort model "
-			     "and the child model.  The child model is "
-			     "advertising a wrong length for the root level.",
-			     G_STRLOC);
-		}
-
-	      return;
+	      GtkTreePath *level;
+	      gchar *str;
+
+	      level = gtk_tree_model_sort_elt_get_path (new_level->parent_level,
+							new_level->parent_elt);
+	      str = gtk_tree_path_to_string (level);
+	      gtk_tree_path_free (level);
+
+	      g_warning ("%s: There is a discrepancy between the sort model "
+			 "and the child model.  The child model is "
+			 "advertising a wrong length for level %s:.",
+			 G_STRLOC, str);
+	      g_free (str);
+	    }
+	  else
+	    {
+	      g_warning ("%s: There is a discrepancy between the sort model "
+			 "and the child model.  The child model is "
+			 "advertising a wrong length for the root level.",
+			 G_STRLOC);
 	    }
-	}
 
-      sort_elt->siter = g_sequence_append (new_level->seq, sort_elt);
+	  return;
+	}
     }
 
   /* sort level */
-  gtk_tree_model_sort_sort_level (tree_model_sort, new_level,
-				  FALSE, FALSE);
+  if (offset > 0)
+    gtk_tree_model_sort_sort_level (tree_model_sort, new_level,
+                                    FALSE, FALSE);
 }
 
 static void
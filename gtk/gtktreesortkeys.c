@@ -0,0 +1,419 @@
+/* GTK - The GIMP Toolkit
+ * Copyright (C) 2015 The GTK+ Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtktreesortkeysprivate.h"
+
+#include "gtktreedatalist.h"
+
+#include <string.h>
+
+/* Below this many rows for each thread, starting the threads
+ * costs more than it saves
+ */
+#define MIN_ROWS_PER_THREAD 8192
+#define MAX_THREADS 8
+
+typedef enum {
+  KEY_INT,
+  KEY_UINT,
+  KEY_DOUBLE,
+  KEY_STRING
+} KeyType;
+
+typedef union {
+  gint64   v_int;
+  guint64  v_uint;
+  gdouble  v_double;
+  gchar   *v_string;
+} Key;
+
+struct _GtkTreeSortKeys
+{
+  GtkTreeModel *model;
+  gint column;
+  KeyType type;
+  gint sign;
+  gint n_rows;
+  Key *keys;
+};
+
+typedef struct {
+  const GtkTreeSortKeys *keys;
+  const gint *src;
+  gint *dest;
+  gint start;
+  gint middle;
+  gint end;
+} SortJob;
+
+/*
+ * gtk_tree_sort_keys_new:
+ * @model: the model that @func is used with
+ * @func: the sort function of the sort column
+ * @func_data: user data for @func
+ * @order: the sort order
+ * @n_rows: the number of rows to sort
+ *
+ * Creates a sort key for each of @n_rows rows, if @func is the
+ * function that sorts a column of @model by its values. The values
+ * are then only fetched once, with gtk_tree_sort_keys_set(), and
+ * gtk_tree_sort_keys_sort() compares them without calling back into
+ * the model, which lets it spread large sorts over several threads.
+ *
+ * Returns: the sort keys, or %NULL if rows need to be compared
+ *   with @func
+ */
+GtkTreeSortKeys *
+gtk_tree_sort_keys_new (GtkTreeModel           *model,
+                        GtkTreeIterCompareFunc  func,
+                        gpointer                func_data,
+                        GtkSortType             order,
+                        gint                    n_rows)
+{
+  GtkTreeSortKeys *keys;
+  gint column;
+  KeyType type;
+
+  if (func != _gtk_tree_data_list_compare_func)
+    return NULL;
+
+  column = GPOINTER_TO_INT (func_data);
+
+  switch (G_TYPE_FUNDAMENTAL (gtk_tree_model_get_column_type (model, column)))
+    {
+    case G_TYPE_BOOLEAN:
+    case G_TYPE_CHAR:
+    case G_TYPE_INT:
+    case G_TYPE_LONG:
+    case G_TYPE_INT64:
+    case G_TYPE_ENUM:
+      type = KEY_INT;
+      break;
+    case G_TYPE_UCHAR:
+    case G_TYPE_UINT:
+    case G_TYPE_ULONG:
+    case G_TYPE_UINT64:
+    case G_TYPE_FLAGS:
+      type = KEY_UINT;
+      break;
+    case G_TYPE_FLOAT:
+    case G_TYPE_DOUBLE:
+      type = KEY_DOUBLE;
+      break;
+    case G_TYPE_STRING:
+      type = KEY_STRING;
+      break;
+    default:
+      /* Let the compare function complain */
+      return NULL;
+    }
+
+  keys = g_slice_new (GtkTreeSortKeys);
+  keys->model = model;
+  keys->column = column;
+  keys->type = type;
+  keys->sign = order == GTK_SORT_DESCENDING ? -1 : 1;
+  keys->n_rows = n_rows;
+  keys->keys = g_new0 (Key, n_rows);
+
+  return keys;
+}
+
+void
+gtk_tree_sort_keys_free (GtkTreeSortKeys *keys)
+{
+  gint i;
+
+  if (keys->type == KEY_STRING)
+    {
+      for (i = 0; i < keys->n_rows; i++)
+        g_free (keys->keys[i].v_string);
+    }
+
+  g_free (keys->keys);
+  g_slice_free (GtkTreeSortKeys, keys);
+}
+
+/*
+ * gtk_tree_sort_keys_set:
+ * @keys: a #GtkTreeSortKeys
+ * @row: the current position of the row
+ * @iter: the row
+ *
+ * Reads the sort key of @row from the model.
+ */
+void
+gtk_tree_sort_keys_set (GtkTreeSortKeys *keys,
+                        gint             row,
+                        GtkTreeIter     *iter)
+{
+  GValue value = G_VALUE_INIT;
+  Key *key;
+  const gchar *string;
+
+  g_return_if_fail (row >= 0 && row < keys->n_rows);
+
+  key = &keys->keys[row];
+  gtk_tree_model_get_value (keys->model, iter, keys->column, &value);
+
+  switch (G_TYPE_FUNDAMENTAL (G_VALUE_TYPE (&value)))
+    {
+    case G_TYPE_BOOLEAN:
+      key->v_int = g_value_get_boolean (&value) ? 1 : 0;
+      break;
+    case G_TYPE_CHAR:
+      key->v_int = g_value_get_schar (&value);
+      break;
+    case G_TYPE_INT:
+      key->v_int = g_value_get_int (&value);
+      break;
+    case G_TYPE_LONG:
+      key->v_int = g_value_get_long (&value);
+      break;
+    case G_TYPE_INT64:
+      key->v_int = g_value_get_int64 (&value);
+      break;
+    case G_TYPE_ENUM:
+      key->v_int = g_value_get_enum (&value);
+      break;
+    case G_TYPE_UCHAR:
+      key->v_uint = g_value_get_uchar (&value);
+      break;
+    case G_TYPE_UINT:
+      key->v_uint = g_value_get_uint (&value);
+      break;
+    case G_TYPE_ULONG:
+      key->v_uint = g_value_get_ulong (&value);
+      break;
+    case G_TYPE_UINT64:
+      key->v_uint = g_value_get_uint64 (&value);
+      break;
+    case G_TYPE_FLAGS:
+      key->v_uint = g_value_get_flags (&value);
+      break;
+    case G_TYPE_FLOAT:
+      key->v_double = g_value_get_float (&value);
+      break;
+    case G_TYPE_DOUBLE:
+      key->v_double = g_value_get_double (&value);
+      break;
+    case G_TYPE_STRING:
+      /* Comparing collation keys with strcmp() gives
+       * the same order as g_utf8_collate()
+       */
+      string = g_value_get_string (&value);
+      g_free (key->v_string);
+      key->v_string = g_utf8_collate_key (string ? string : "", -1);
+      break;
+    default:
+      g_assert_not_reached ();
+    }
+
+  g_value_unset (&value);
+}
+
+/* Rows with equal keys stay in the order they had, in both
+ * directions. This is what the stable sorts of the models do with
+ * a sort function, which only flips the sign of its result for
+ * descending order, so equal rows are not reversed either way.
+ */
+static inline gint
+compare_keys (const GtkTreeSortKeys *keys,
+              gint                   a,
+              gint                   b)
+{
+  const Key *key_a = &keys->keys[a];
+  const Key *key_b = &keys->keys[b];
+  gint retval;
+
+  switch (keys->type)
+    {
+    case KEY_INT:
+      retval = (key_a->v_int > key_b->v_int) - (key_a->v_int < key_b->v_int);
+      break;
+    case KEY_UINT:
+      retval = (key_a->v_uint > key_b->v_uint) - (key_a->v_uint < key_b->v_uint);
+      break;
+    case KEY_DOUBLE:
+      retval = (key_a->v_double > key_b->v_double) - (key_a->v_double < key_b->v_double);
+      break;
+    case KEY_STRING:
+      retval = strcmp (key_a->v_string, key_b->v_string);
+      break;
+    default:
+      g_assert_not_reached ();
+      return 0;
+    }
+
+  if (retval == 0)
+    return (a > b) - (a < b);
+
+  return retval * keys->sign;
+}
+
+static gint
+compare_rows (gconstpointer a,
+              gconstpointer b,
+              gpointer      user_data)
+{
+  return compare_keys (user_data, *(const gint *) a, *(const gint *) b);
+}
+
+static gpointer
+sort_run (gpointer data)
+{
+  SortJob *job = data;
+
+  g_qsort_with_data (job->dest + job->start, job->end - job->start,
+                     sizeof (gint), compare_rows, (gpointer) job->keys);
+
+  return NULL;
+}
+
+/* Merges the sorted runs [start, middle) and [middle, end) of src
+ * into dest. An empty second run just copies the first one over.
+ */
+static gpointer
+merge_runs (gpointer data)
+{
+  SortJob *job = data;
+  const gint *src = job->src;
+  gint *dest = job->dest;
+  gint i, j, k;
+
+  i = job->start;
+  j = job->middle;
+  k = job->start;
+
+  while (i < job->middle && j < job->end)
+    {
+      if (compare_keys (job->keys, src[i], src[j]) < 0)
+        dest[k++] = src[i++];
+      else
+        dest[k++] = src[j++];
+    }
+
+  memcpy (dest + k, src + i, (job->middle - i) * sizeof (gint));
+  k += job->middle - i;
+  memcpy (dest + k, src + j, (job->end - j) * sizeof (gint));
+
+  return NULL;
+}
+
+/* Runs every job but the first one in a thread of its own, and
+ * returns once all of them are done
+ */
+static void
+run_jobs (GThreadFunc  func,
+          SortJob     *jobs,
+          gint         n_jobs)
+{
+  GThread *threads[MAX_THREADS];
+  gint i;
+
+  for (i = 1; i < n_jobs; i++)
+    {
+      threads[i] = g_thread_try_new ("gtk-tree-sort", func, &jobs[i], NULL);
+      if (threads[i] == NULL)
+        func (&jobs[i]);
+    }
+
+  func (&jobs[0]);
+
+  for (i = 1; i < n_jobs; i++)
+    {
+      if (threads[i] != NULL)
+        g_thread_join (threads[i]);
+    }
+}
+
+/*
+ * gtk_tree_sort_keys_sort:
+ * @keys: a #GtkTreeSortKeys with the keys of all rows set
+ *
+ * Sorts the rows by their keys. Large sorts are split into
+ * runs that are sorted in parallel, and then merged pairwise,
+ * also in parallel.
+ *
+ * Returns: the old position of each row in the new order, as
+ *   used by gtk_tree_model_rows_reordered(). Free with g_free().
+ */
+gint *
+gtk_tree_sort_keys_sort (GtkTreeSortKeys *keys)
+{
+  SortJob jobs[MAX_THREADS];
+  gint bounds[MAX_THREADS + 1];
+  gint *rows, *tmp, *swap;
+  gint n_runs, n_jobs, i;
+
+  rows = g_new (gint, MAX (keys->n_rows, 1));
+  for (i = 0; i < keys->n_rows; i++)
+    rows[i] = i;
+
+  n_runs = keys->n_rows / MIN_ROWS_PER_THREAD;
+  n_runs = CLAMP (n_runs, 1, MIN (g_get_num_processors (), MAX_THREADS));
+
+  for (i = 0; i <= n_runs; i++)
+    bounds[i] = (gint64) keys->n_rows * i / n_runs;
+
+  for (i = 0; i < n_runs; i++)
+    {
+      jobs[i].keys = keys;
+      jobs[i].dest = rows;
+      jobs[i].start = bounds[i];
+      jobs[i].end = bounds[i + 1];
+    }
+
+  run_jobs (sort_run, jobs, n_runs);
+
+  if (n_runs == 1)
+    return rows;
+
+  tmp = g_new (gint, keys->n_rows);
+
+  while (n_runs > 1)
+    {
+      n_jobs = (n_runs + 1) / 2;
+
+      for (i = 0; i < n_jobs; i++)
+        {
+          jobs[i].keys = keys;
+          jobs[i].src = rows;
+          jobs[i].dest = tmp;
+          jobs[i].start = bounds[2 * i];
+          jobs[i].middle = bounds[MIN (2 * i + 1, n_runs)];
+          jobs[i].end = bounds[MIN (2 * i + 2, n_runs)];
+        }
+
+      run_jobs (merge_runs, jobs, n_jobs);
+
+      for (i = 0; i < n_jobs; i++)
+        bounds[i] = jobs[i].start;
+      bounds[n_jobs] = keys->n_rows;
+      n_runs = n_jobs;
+
+      swap = rows;
+      rows = tmp;
+      tmp = swap;
+    }
+
+  g_free (tmp);
+
+  return rows;
+}
@@ -0,0 +1,42 @@
+/* GTK - The GIMP Toolkit
+ * Copyright (C) 2015 The GTK+ Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GTK_TREE_SORT_KEYS_PRIVATE_H__
+#define __GTK_TREE_SORT_KEYS_PRIVATE_H__
+
+#include <gtk/gtktreemodel.h>
+#include <gtk/gtktreesortable.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GtkTreeSortKeys GtkTreeSortKeys;
+
+GtkTreeSortKeys *gtk_tree_sort_keys_new  (GtkTreeModel           *model,
+                                          GtkTreeIterCompareFunc  func,
+                                          gpointer                func_data,
+                                          GtkSortType             order,
+                                          gint                    n_rows);
+void             gtk_tree_sort_keys_free (GtkTreeSortKeys        *keys);
+
+void             gtk_tree_sort_keys_set  (GtkTreeSortKeys        *keys,
+                                          gint                    row,
+                                          GtkTreeIter            *iter);
+gint            *gtk_tree_sort_keys_sort (GtkTreeSortKeys        *keys);
+
+G_END_DECLS
+
+#endif /* __GTK_TREE_SORT_KEYS_PRIVATE_H__ */
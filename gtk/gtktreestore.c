@@ -19,8 +19,10 @@
 #include <string.h>
 #include <gobject/gvaluecollector.h>
 #include "gtktreemodel.h"
+#include "gtktreemodelprivate.h"
 #include "gtktreestore.h"
 #include "gtktreedatalist.h"
+#include "gtktreesortkeysprivate.h"
 #include "gtktreednd.h"
 #include "gtkbuildable.h"
 #include "gtkbuilderprivate.h"
@@ -75,6 +77,15 @@ struct _GtkTreeStorePrivate
   gpointer default_sort_data;
   GDestroyNotify default_sort_destroy;
   guint columns_dirty : 1;
+  guint batching      : 1;
+
+  /* Rows inserted since gtk_tree_store_begin_update(), all of them
+   * children of pending_parent, if all ::row-inserted handlers
+   * support ::rows-inserted
+   */
+  gint update_depth;
+  GHashTable *pending;
+  GNode *pending_parent;
 };
 
 
@@ -481,6 +492,8 @@ gtk_tree_store_finalize (GObject *object)
   g_node_traverse (priv->root, G_POST_ORDER, G_TRAVERSE_ALL, -1,
 		   node_free, priv->column_headers);
   g_node_destroy (priv->root);
+  if (priv->pending)
+    g_hash_table_unref (priv->pending);
   _gtk_tree_data_list_header_free (priv->sort_list);
   g_free (priv->column_headers);
 
@@ -834,6 +847,194 @@ gtk_tree_store_iter_parent (GtkTreeModel *tree_model,
 }
 
 
+static inline gboolean
+gtk_tree_store_is_pending (GtkTreeStore *tree_store,
+                           GNode        *node)
+{
+  GtkTreeStorePrivate *priv = tree_store->priv;
+
+  return priv->pending != NULL && g_hash_table_contains (priv->pending, node);
+}
+
+static gboolean
+gtk_tree_store_iter_is_pending (GtkTreeModel *tree_model,
+                                GtkTreeIter  *iter)
+{
+  return gtk_tree_store_is_pending (GTK_TREE_STORE (tree_model), iter->user_data);
+}
+
+/* Announces the rows inserted during an update, one ::rows-inserted
+ * per run of adjacent rows, from the first to the last. Must run
+ * before any other change to the store, so that listeners see the
+ * insertions in a consistent order.
+ *
+ * The rows of a run stop being pending right before it is announced,
+ * so the rows that follow are still left out while handlers run.
+ */
+static void
+gtk_tree_store_flush_pending (GtkTreeStore *tree_store)
+{
+  GtkTreeStorePrivate *priv = tree_store->priv;
+  GHashTable *pending;
+  GNode *parent, *node, *first, *run;
+  GtkTreePath *path;
+  GtkTreeIter iter;
+  gboolean had_children;
+  gint index, first_index, n_rows, i;
+
+  if (priv->pending == NULL)
+    return;
+
+  pending = g_hash_table_ref (priv->pending);
+  parent = priv->pending_parent;
+
+  if (g_hash_table_size (pending) > 0)
+    {
+      iter.stamp = priv->stamp;
+      iter.user_data = parent;
+      if (parent != priv->root)
+        path = gtk_tree_store_get_path (GTK_TREE_MODEL (tree_store), &iter);
+      else
+        path = gtk_tree_path_new ();
+
+      had_children = FALSE;
+      for (node = parent->children; node != NULL; node = node->next)
+        {
+          if (!g_hash_table_contains (pending, node))
+            {
+              had_children = TRUE;
+              break;
+            }
+        }
+
+      first = NULL;
+      first_index = n_rows = 0;
+
+      for (node = parent->children, index = 0; ; node = node->next, index++)
+        {
+          if (node != NULL && g_hash_table_contains (pending, node))
+            {
+              if (first == NULL)
+                {
+                  first = node;
+                  first_index = index;
+                  n_rows = 0;
+                }
+              n_rows++;
+              continue;
+            }
+
+          if (first != NULL)
+            {
+              for (i = 0, run = first; i < n_rows; i++, run = run->next)
+                g_hash_table_remove (pending, run);
+
+              iter.stamp = priv->stamp;
+              iter.user_data = first;
+              gtk_tree_path_append_index (path, first_index);
+              gtk_tree_model_rows_inserted (GTK_TREE_MODEL (tree_store), path, &iter, n_rows);
+              gtk_tree_path_up (path);
+              first = NULL;
+
+              if (parent != priv->root && !had_children)
+                {
+                  iter.stamp = priv->stamp;
+                  iter.user_data = parent;
+                  gtk_tree_model_row_has_child_toggled (GTK_TREE_MODEL (tree_store), path, &iter);
+                  had_children = TRUE;
+                }
+            }
+
+          if (node == NULL)
+            break;
+        }
+
+      gtk_tree_path_free (path);
+    }
+
+  if (priv->pending == pending && g_hash_table_size (pending) == 0)
+    {
+      priv->pending = NULL;
+      priv->pending_parent = NULL;
+      g_hash_table_unref (pending);
+      _gtk_tree_model_set_pending_func (GTK_TREE_MODEL (tree_store), NULL);
+    }
+
+  g_hash_table_unref (pending);
+}
+
+/* Called before a row is inserted below @parent_node. Rows only stay
+ * pending while they are all children of the same parent.
+ */
+static void
+gtk_tree_store_prepare_insert (GtkTreeStore *tree_store,
+                               GNode        *parent_node)
+{
+  GtkTreeStorePrivate *priv = tree_store->priv;
+
+  if (priv->pending_parent != NULL && priv->pending_parent != parent_node)
+    gtk_tree_store_flush_pending (tree_store);
+}
+
+static void
+gtk_tree_store_row_inserted (GtkTreeStore *tree_store,
+                             GtkTreeIter  *iter)
+{
+  GtkTreeStorePrivate *priv = tree_store->priv;
+  GNode *node = iter->user_data;
+  GtkTreePath *path;
+  GtkTreeIter parent_iter;
+
+  if (priv->update_depth > 0 && priv->batching)
+    {
+      if (priv->pending == NULL)
+        {
+          priv->pending = g_hash_table_new (NULL, NULL);
+          _gtk_tree_model_set_pending_func (GTK_TREE_MODEL (tree_store),
+                                            gtk_tree_store_iter_is_pending);
+        }
+
+      g_hash_table_add (priv->pending, node);
+      priv->pending_parent = node->parent;
+      return;
+    }
+
+  /* Rows can only be left pending here if a ::rows-inserted
+   * handler inserts rows
+   */
+  gtk_tree_store_flush_pending (tree_store);
+
+  path = gtk_tree_store_get_path (GTK_TREE_MODEL (tree_store), iter);
+  gtk_tree_model_row_inserted (GTK_TREE_MODEL (tree_store), path, iter);
+
+  if (node->parent != priv->root &&
+      node->prev == NULL && node->next == NULL)
+    {
+      parent_iter.stamp = priv->stamp;
+      parent_iter.user_data = node->parent;
+
+      gtk_tree_path_up (path);
+      gtk_tree_model_row_has_child_toggled (GTK_TREE_MODEL (tree_store), path, &parent_iter);
+    }
+
+  gtk_tree_path_free (path);
+}
+
+/* Rows that were not announced yet do not get ::row-changed either */
+static void
+gtk_tree_store_row_changed (GtkTreeStore *tree_store,
+                            GtkTreeIter  *iter)
+{
+  GtkTreePath *path;
+
+  if (gtk_tree_store_is_pending (tree_store, iter->user_data))
+    return;
+
+  path = gtk_tree_store_get_path (GTK_TREE_MODEL (tree_store), iter);
+  gtk_tree_model_row_changed (GTK_TREE_MODEL (tree_store), path, iter);
+  gtk_tree_path_free (path);
+}
+
 /* Does not emit a signal */
 static gboolean
 gtk_tree_store_real_set_value (GtkTreeStore *tree_store,
@@ -954,14 +1155,11 @@ gtk_tree_store_set_value (GtkTreeStore *tree_store,
   g_return_if_fail (column >= 0 && column < tree_store->priv->n_columns);
   g_return_if_fail (G_IS_VALUE (value));
 
-  if (gtk_tree_store_real_set_value (tree_store, iter, column, value, TRUE))
-    {
-      GtkTreePath *path;
+  if (!gtk_tree_store_is_pending (tree_store, iter->user_data))
+    gtk_tree_store_flush_pending (tree_store);
 
-      path = gtk_tree_store_get_path (GTK_TREE_MODEL (tree_store), iter);
-      gtk_tree_model_row_changed (GTK_TREE_MODEL (tree_store), path, iter);
-      gtk_tree_path_free (path);
-    }
+  if (gtk_tree_store_real_set_value (tree_store, iter, column, value, TRUE))
+    gtk_tree_store_row_changed (tree_store, iter);
 }
 
 static GtkTreeIterCompareFunc
@@ -1105,6 +1303,9 @@ gtk_tree_store_set_valuesv (GtkTreeStore *tree_store,
   g_return_if_fail (GTK_IS_TREE_STORE (tree_store));
   g_return_if_fail (VALID_ITER (iter, tree_store));
 
+  if (!gtk_tree_store_is_pending (tree_store, iter->user_data))
+    gtk_tree_store_flush_pending (tree_store);
+
   gtk_tree_store_set_vector_internal (tree_store, iter,
 				      &emit_signal,
 				      &maybe_need_sort,
@@ -1114,13 +1315,7 @@ gtk_tree_store_set_valuesv (GtkTreeStore *tree_store,
     gtk_tree_store_sort_iter_changed (tree_store, iter, priv->sort_column_id, TRUE);
 
   if (emit_signal)
-    {
-      GtkTreePath *path;
-
-      path = gtk_tree_store_get_path (GTK_TREE_MODEL (tree_store), iter);
-      gtk_tree_model_row_changed (GTK_TREE_MODEL (tree_store), path, iter);
-      gtk_tree_path_free (path);
-    }
+    gtk_tree_store_row_changed (tree_store, iter);
 }
 
 /**
@@ -1145,6 +1340,9 @@ gtk_tree_store_set_valist (GtkTreeStore *tree_store,
   g_return_if_fail (GTK_IS_TREE_STORE (tree_store));
   g_return_if_fail (VALID_ITER (iter, tree_store));
 
+  if (!gtk_tree_store_is_pending (tree_store, iter->user_data))
+    gtk_tree_store_flush_pending (tree_store);
+
   gtk_tree_store_set_valist_internal (tree_store, iter,
 				      &emit_signal,
 				      &maybe_need_sort,
@@ -1154,13 +1352,7 @@ gtk_tree_store_set_valist (GtkTreeStore *tree_store,
     gtk_tree_store_sort_iter_changed (tree_store, iter, priv->sort_column_id, TRUE);
 
   if (emit_signal)
-    {
-      GtkTreePath *path;
-
-      path = gtk_tree_store_get_path (GTK_TREE_MODEL (tree_store), iter);
-      gtk_tree_model_row_changed (GTK_TREE_MODEL (tree_store), path, iter);
-      gtk_tree_path_free (path);
-    }
+    gtk_tree_store_row_changed (tree_store, iter);
 }
 
 /**
@@ -1220,6 +1412,17 @@ gtk_tree_store_remove (GtkTreeStore *tree_store,
   g_assert (parent != NULL);
   next_node = G_NODE (iter->user_data)->next;
 
+  /* Rows that were never announced go away silently */
+  if (gtk_tree_store_is_pending (tree_store, iter->user_data))
+    {
+      g_hash_table_remove (priv->pending, iter->user_data);
+      node_free (iter->user_data, priv->column_headers);
+      g_node_destroy (G_NODE (iter->user_data));
+      goto out;
+    }
+
+  gtk_tree_store_flush_pending (tree_store);
+
   if (G_NODE (iter->user_data)->data)
     g_node_traverse (G_NODE (iter->user_data), G_POST_ORDER, G_TRAVERSE_ALL,
 		     -1, node_free, priv->column_headers);
@@ -1243,6 +1446,7 @@ gtk_tree_store_remove (GtkTreeStore *tree_store,
     }
   gtk_tree_path_free (path);
 
+out:
   /* revalidate iter */
   if (next_node != NULL)
     {
@@ -1282,7 +1486,6 @@ gtk_tree_store_insert (GtkTreeStore *tree_store,
 		       gint          position)
 {
   GtkTreeStorePrivate *priv = tree_store->priv;
-  GtkTreePath *path;
   GNode *parent_node;
   GNode *new_node;
 
@@ -1302,21 +1505,10 @@ gtk_tree_store_insert (GtkTreeStore *tree_store,
 
   iter->stamp = priv->stamp;
   iter->user_data = new_node;
+  gtk_tree_store_prepare_insert (tree_store, parent_node);
   g_node_insert (parent_node, position, new_node);
 
-  path = gtk_tree_store_get_path (GTK_TREE_MODEL (tree_store), iter);
-  gtk_tree_model_row_inserted (GTK_TREE_MODEL (tree_store), path, iter);
-
-  if (parent_node != priv->root)
-    {
-      if (new_node->prev == NULL && new_node->next == NULL)
-        {
-          gtk_tree_path_up (path);
-          gtk_tree_model_row_has_child_toggled (GTK_TREE_MODEL (tree_store), path, parent);
-        }
-    }
-
-  gtk_tree_path_free (path);
+  gtk_tree_store_row_inserted (tree_store, iter);
 
   validate_tree ((GtkTreeStore*)tree_store);
 }
@@ -1346,7 +1538,6 @@ gtk_tree_store_insert_before (GtkTreeStore *tree_store,
 			      GtkTreeIter  *sibling)
 {
   GtkTreeStorePrivate *priv = tree_store->priv;
-  GtkTreePath *path;
   GNode *parent_node = NULL;
   GNode *new_node;
 
@@ -1373,6 +1564,7 @@ gtk_tree_store_insert_before (GtkTreeStore *tree_store,
 
   new_node = g_node_new (NULL);
 
+  gtk_tree_store_prepare_insert (tree_store, parent_node);
   g_node_insert_before (parent_node,
 			sibling ? G_NODE (sibling->user_data) : NULL,
                         new_node);
@@ -1380,24 +1572,7 @@ gtk_tree_store_insert_before (GtkTreeStore *tree_store,
   iter->stamp = priv->stamp;
   iter->user_data = new_node;
 
-  path = gtk_tree_store_get_path (GTK_TREE_MODEL (tree_store), iter);
-  gtk_tree_model_row_inserted (GTK_TREE_MODEL (tree_store), path, iter);
-
-  if (parent_node != priv->root)
-    {
-      if (new_node->prev == NULL && new_node->next == NULL)
-        {
-          GtkTreeIter parent_iter;
-
-          parent_iter.stamp = priv->stamp;
-          parent_iter.user_data = parent_node;
-
-          gtk_tree_path_up (path);
-          gtk_tree_model_row_has_child_toggled (GTK_TREE_MODEL (tree_store), path, &parent_iter);
-        }
-    }
-
-  gtk_tree_path_free (path);
+  gtk_tree_store_row_inserted (tree_store, iter);
 
   validate_tree (tree_store);
 }
@@ -1427,7 +1602,6 @@ gtk_tree_store_insert_after (GtkTreeStore *tree_store,
 			     GtkTreeIter  *sibling)
 {
   GtkTreeStorePrivate *priv = tree_store->priv;
-  GtkTreePath *path;
   GNode *parent_node;
   GNode *new_node;
 
@@ -1455,6 +1629,7 @@ gtk_tree_store_insert_after (GtkTreeStore *tree_store,
 
   new_node = g_node_new (NULL);
 
+  gtk_tree_store_prepare_insert (tree_store, parent_node);
   g_node_insert_after (parent_node,
 		       sibling ? G_NODE (sibling->user_data) : NULL,
                        new_node);
@@ -1462,24 +1637,7 @@ gtk_tree_store_insert_after (GtkTreeStore *tree_store,
   iter->stamp = priv->stamp;
   iter->user_data = new_node;
 
-  path = gtk_tree_store_get_path (GTK_TREE_MODEL (tree_store), iter);
-  gtk_tree_model_row_inserted (GTK_TREE_MODEL (tree_store), path, iter);
-
-  if (parent_node != priv->root)
-    {
-      if (new_node->prev == NULL && new_node->next == NULL)
-        {
-          GtkTreeIter parent_iter;
-
-          parent_iter.stamp = priv->stamp;
-          parent_iter.user_data = parent_node;
-
-          gtk_tree_path_up (path);
-          gtk_tree_model_row_has_child_toggled (GTK_TREE_MODEL (tree_store), path, &parent_iter);
-        }
-    }
-
-  gtk_tree_path_free (path);
+  gtk_tree_store_row_inserted (tree_store, iter);
 
   validate_tree (tree_store);
 }
@@ -1521,7 +1679,6 @@ gtk_tree_store_insert_with_values (GtkTreeStore *tree_store,
 				   ...)
 {
   GtkTreeStorePrivate *priv = tree_store->priv;
-  GtkTreePath *path;
   GNode *parent_node;
   GNode *new_node;
   GtkTreeIter tmp_iter;
@@ -1548,6 +1705,7 @@ gtk_tree_store_insert_with_values (GtkTreeStore *tree_store,
 
   iter->stamp = priv->stamp;
   iter->user_data = new_node;
+  gtk_tree_store_prepare_insert (tree_store, parent_node);
   g_node_insert (parent_node, position, new_node);
 
   va_start (var_args, position);
@@ -1559,19 +1717,7 @@ gtk_tree_store_insert_with_values (GtkTreeStore *tree_store,
   if (maybe_need_sort && GTK_TREE_STORE_IS_SORTED (tree_store))
     gtk_tree_store_sort_iter_changed (tree_store, iter, priv->sort_column_id, FALSE);
 
-  path = gtk_tree_store_get_path (GTK_TREE_MODEL (tree_store), iter);
-  gtk_tree_model_row_inserted (GTK_TREE_MODEL (tree_store), path, iter);
-
-  if (parent_node != priv->root)
-    {
-      if (new_node->prev == NULL && new_node->next == NULL)
-        {
-	  gtk_tree_path_up (path);
-	  gtk_tree_model_row_has_child_toggled (GTK_TREE_MODEL (tree_store), path, parent);
-	}
-    }
-
-  gtk_tree_path_free (path);
+  gtk_tree_store_row_inserted (tree_store, iter);
 
   validate_tree ((GtkTreeStore *)tree_store);
 }
@@ -1602,7 +1748,6 @@ gtk_tree_store_insert_with_valuesv (GtkTreeStore *tree_store,
 				    gint          n_values)
 {
   GtkTreeStorePrivate *priv = tree_store->priv;
-  GtkTreePath *path;
   GNode *parent_node;
   GNode *new_node;
   GtkTreeIter tmp_iter;
@@ -1628,6 +1773,7 @@ gtk_tree_store_insert_with_valuesv (GtkTreeStore *tree_store,
 
   iter->stamp = priv->stamp;
   iter->user_data = new_node;
+  gtk_tree_store_prepare_insert (tree_store, parent_node);
   g_node_insert (parent_node, position, new_node);
 
   gtk_tree_store_set_vector_internal (tree_store, iter,
@@ -1637,19 +1783,7 @@ gtk_tree_store_insert_with_valuesv (GtkTreeStore *tree_store,
   if (maybe_need_sort && GTK_TREE_STORE_IS_SORTED (tree_store))
     gtk_tree_store_sort_iter_changed (tree_store, iter, priv->sort_column_id, FALSE);
 
-  path = gtk_tree_store_get_path (GTK_TREE_MODEL (tree_store), iter);
-  gtk_tree_model_row_inserted (GTK_TREE_MODEL (tree_store), path, iter);
-
-  if (parent_node != priv->root)
-    {
-      if (new_node->prev == NULL && new_node->next == NULL)
-        {
-	  gtk_tree_path_up (path);
-	  gtk_tree_model_row_has_child_toggled (GTK_TREE_MODEL (tree_store), path, parent);
-	}
-    }
-
-  gtk_tree_path_free (path);
+  gtk_tree_store_row_inserted (tree_store, iter);
 
   validate_tree ((GtkTreeStore *)tree_store);
 }
@@ -1688,22 +1822,13 @@ gtk_tree_store_prepend (GtkTreeStore *tree_store,
 
   if (parent_node->children == NULL)
     {
-      GtkTreePath *path;
-      
       iter->stamp = priv->stamp;
       iter->user_data = g_node_new (NULL);
 
+      gtk_tree_store_prepare_insert (tree_store, parent_node);
       g_node_prepend (parent_node, G_NODE (iter->user_data));
 
-      path = gtk_tree_store_get_path (GTK_TREE_MODEL (tree_store), iter);
-      gtk_tree_model_row_inserted (GTK_TREE_MODEL (tree_store), path, iter);
-
-      if (parent_node != priv->root)
-	{
-	  gtk_tree_path_up (path);
-	  gtk_tree_model_row_has_child_toggled (GTK_TREE_MODEL (tree_store), path, parent);
-	}
-      gtk_tree_path_free (path);
+      gtk_tree_store_row_inserted (tree_store, iter);
     }
   else
     {
@@ -1747,22 +1872,13 @@ gtk_tree_store_append (GtkTreeStore *tree_store,
 
   if (parent_node->children == NULL)
     {
-      GtkTreePath *path;
-
       iter->stamp = priv->stamp;
       iter->user_data = g_node_new (NULL);
 
+      gtk_tree_store_prepare_insert (tree_store, parent_node);
       g_node_append (parent_node, G_NODE (iter->user_data));
 
-      path = gtk_tree_store_get_path (GTK_TREE_MODEL (tree_store), iter);
-      gtk_tree_model_row_inserted (GTK_TREE_MODEL (tree_store), path, iter);
-
-      if (parent_node != priv->root)
-	{
-	  gtk_tree_path_up (path);
-	  gtk_tree_model_row_has_child_toggled (GTK_TREE_MODEL (tree_store), path, parent);
-	}
-      gtk_tree_path_free (path);
+      gtk_tree_store_row_inserted (tree_store, iter);
     }
   else
     {
@@ -1772,6 +1888,141 @@ gtk_tree_store_append (GtkTreeStore *tree_store,
   validate_tree (tree_store);
 }
 
+/**
+ * gtk_tree_store_append_rows:
+ * @tree_store: A #GtkTreeStore
+ * @iter: (out) (optional): An unset #GtkTreeIter to set to the first
+ *   appended row, or %NULL
+ * @parent: (allow-none): A valid #GtkTreeIter, or %NULL
+ * @n_rows: the number of rows to append
+ *
+ * Appends @n_rows empty rows to the children of @parent, or to the
+ * top level if @parent is %NULL, and announces them with a single
+ * #GtkTreeModel::rows-inserted signal if all the listeners of the
+ * store support it. This is much faster than calling
+ * gtk_tree_store_append() @n_rows times when the store is displayed.
+ * If @n_rows is 0, @iter is invalidated.
+ *
+ * Since: 3.20
+ */
+void
+gtk_tree_store_append_rows (GtkTreeStore *tree_store,
+                            GtkTreeIter  *iter,
+                            GtkTreeIter  *parent,
+                            gint          n_rows)
+{
+  GtkTreeStorePrivate *priv;
+  GNode *parent_node, *node;
+  GtkTreeIter tmp_iter;
+  gint i;
+
+  g_return_if_fail (GTK_IS_TREE_STORE (tree_store));
+  g_return_if_fail (parent == NULL || VALID_ITER (parent, tree_store));
+  g_return_if_fail (n_rows >= 0);
+
+  priv = tree_store->priv;
+
+  if (iter)
+    {
+      iter->stamp = 0;
+      iter->user_data = NULL;
+    }
+
+  if (n_rows == 0)
+    return;
+
+  if (parent == NULL)
+    parent_node = priv->root;
+  else
+    parent_node = parent->user_data;
+
+  priv->columns_dirty = TRUE;
+
+  gtk_tree_store_begin_update (tree_store);
+  gtk_tree_store_prepare_insert (tree_store, parent_node);
+
+  for (i = 0; i < n_rows; i++)
+    {
+      node = g_node_append (parent_node, g_node_new (NULL));
+
+      tmp_iter.stamp = priv->stamp;
+      tmp_iter.user_data = node;
+      gtk_tree_store_row_inserted (tree_store, &tmp_iter);
+
+      if (i == 0 && iter)
+        *iter = tmp_iter;
+    }
+
+  gtk_tree_store_end_update (tree_store);
+
+  validate_tree (tree_store);
+}
+
+/**
+ * gtk_tree_store_begin_update:
+ * @tree_store: A #GtkTreeStore
+ *
+ * Starts a batch of changes to @tree_store. Until the matching call to
+ * gtk_tree_store_end_update(), rows inserted into @tree_store are not
+ * announced one by one; when the batch ends, adjacent new rows are
+ * announced together with #GtkTreeModel::rows-inserted.
+ *
+ * This only happens if all the #GtkTreeModel::row-inserted handlers
+ * connected to @tree_store when the batch starts also handle
+ * #GtkTreeModel::rows-inserted, like the ones of #GtkTreeView,
+ * #GtkTreeModelSort and #GtkTreeModelFilter. Otherwise the rows are
+ * announced as usual.
+ *
+ * The new rows can be filled in meanwhile without causing
+ * #GtkTreeModel::row-changed emissions. Any other change to the store,
+ * like removing or changing a row that existed before, announces the
+ * rows inserted so far first. So does inserting a row with a different
+ * parent than the rows inserted so far, which means that only the
+ * insertion of siblings is batched.
+ *
+ * Calls to this function can be nested.
+ *
+ * Since: 3.20
+ */
+void
+gtk_tree_store_begin_update (GtkTreeStore *tree_store)
+{
+  GtkTreeStorePrivate *priv;
+
+  g_return_if_fail (GTK_IS_TREE_STORE (tree_store));
+
+  priv = tree_store->priv;
+
+  if (priv->update_depth++ == 0)
+    priv->batching = _gtk_tree_model_can_batch (GTK_TREE_MODEL (tree_store));
+}
+
+/**
+ * gtk_tree_store_end_update:
+ * @tree_store: A #GtkTreeStore
+ *
+ * Ends a batch of changes started with gtk_tree_store_begin_update().
+ * When the outermost batch ends, the rows inserted during it are
+ * announced.
+ *
+ * Since: 3.20
+ */
+void
+gtk_tree_store_end_update (GtkTreeStore *tree_store)
+{
+  GtkTreeStorePrivate *priv;
+
+  g_return_if_fail (GTK_IS_TREE_STORE (tree_store));
+
+  priv = tree_store->priv;
+
+  g_return_if_fail (priv->update_depth > 0);
+
+  priv->update_depth--;
+  if (priv->update_depth == 0)
+    gtk_tree_store_flush_pending (tree_store);
+}
+
 /**
  * gtk_tree_store_is_ancestor:
  * @tree_store: A #GtkTreeStore
@@ -1998,7 +2249,6 @@ copy_node_data (GtkTreeStore *tree_store,
   GtkTreeDataList *copy_head = NULL;
   GtkTreeDataList *copy_prev = NULL;
   GtkTreeDataList *copy_iter = NULL;
-  GtkTreePath *path;
   gint col;
 
   col = 0;
@@ -2020,9 +2270,7 @@ copy_node_data (GtkTreeStore *tree_store,
 
   G_NODE (dest_iter->user_data)->data = copy_head;
 
-  path = gtk_tree_store_get_path (GTK_TREE_MODEL (tree_store), dest_iter);
-  gtk_tree_model_row_changed (GTK_TREE_MODEL (tree_store), path, dest_iter);
-  gtk_tree_path_free (path);
+  gtk_tree_store_row_changed (tree_store, dest_iter);
 }
 
 static void
@@ -2279,6 +2527,8 @@ gtk_tree_store_reorder (GtkTreeStore *tree_store,
   g_return_if_fail (parent == NULL || VALID_ITER (parent, tree_store));
   g_return_if_fail (new_order != NULL);
 
+  gtk_tree_store_flush_pending (tree_store);
+
   if (!parent)
     level = G_NODE (tree_store->priv->root)->children;
   else
@@ -2374,6 +2624,8 @@ gtk_tree_store_swap (GtkTreeStore *tree_store,
   if (node_a == node_b)
     return;
 
+  gtk_tree_store_flush_pending (tree_store);
+
   path_a = gtk_tree_store_get_path (GTK_TREE_MODEL (tree_store), a);
   path_b = gtk_tree_store_get_path (GTK_TREE_MODEL (tree_store), b);
 
@@ -2507,6 +2759,8 @@ gtk_tree_store_move (GtkTreeStore *tree_store,
   if (position)
     g_return_if_fail (VALID_ITER (position, tree_store));
 
+  gtk_tree_store_flush_pending (tree_store);
+
   a = b = NULL;
 
   /* sanity checks */
@@ -2910,6 +3164,7 @@ gtk_tree_store_sort_helper (GtkTreeStore *tree_store,
 {
   GtkTreeIter iter;
   GArray *sort_array;
+  GtkTreeSortKeys *keys = NULL;
   GNode *node;
   GNode *tmp_node;
   gint list_length;
@@ -2944,7 +3199,44 @@ gtk_tree_store_sort_helper (GtkTreeStore *tree_store,
     }
 
   /* Sort the array */
-  g_array_sort_with_data (sort_array, gtk_tree_store_compare_func, tree_store);
+  if (tree_store->priv->sort_column_id != GTK_TREE_SORTABLE_DEFAULT_SORT_COLUMN_ID)
+    {
+      GtkTreeDataSortHeader *header;
+
+      header = _gtk_tree_data_list_get_header (tree_store->priv->sort_list,
+                                               tree_store->priv->sort_column_id);
+      keys = gtk_tree_sort_keys_new (GTK_TREE_MODEL (tree_store),
+                                     header->func, header->data,
+                                     tree_store->priv->order, list_length);
+    }
+
+  if (keys)
+    {
+      GArray *sorted_array;
+      gint *order;
+
+      /* Sort by the values of a column, which are only fetched once */
+      iter.stamp = tree_store->priv->stamp;
+      for (i = 0; i < list_length; i++)
+        {
+          iter.user_data = g_array_index (sort_array, SortTuple, i).node;
+          gtk_tree_sort_keys_set (keys, i, &iter);
+        }
+
+      order = gtk_tree_sort_keys_sort (keys);
+
+      sorted_array = g_array_sized_new (FALSE, FALSE, sizeof (SortTuple), list_length);
+      for (i = 0; i < list_length; i++)
+        g_array_append_val (sorted_array, g_array_index (sort_array, SortTuple, order[i]));
+
+      g_array_free (sort_array, TRUE);
+      sort_array = sorted_array;
+
+      g_free (order);
+      gtk_tree_sort_keys_free (keys);
+    }
+  else
+    g_array_sort_with_data (sort_array, gtk_tree_store_compare_func, tree_store);
 
   for (i = 0; i < list_length - 1; i++)
     {
@@ -3005,6 +3297,8 @@ gtk_tree_store_sort (GtkTreeStore *tree_store)
       g_return_if_fail (priv->default_sort_func != NULL);
     }
 
+  gtk_tree_store_flush_pending (tree_store);
+
   gtk_tree_store_sort_helper (tree_store, G_NODE (priv->root), TRUE);
 }
 
@@ -3160,7 +3454,8 @@ gtk_tree_store_sort_iter_changed (GtkTreeStore *tree_store,
       G_NODE (iter->user_data)->parent->children = G_NODE (iter->user_data);
     }
 
-  if (!emit_signal)
+  /* Rows that were not announced yet are only put in place */
+  if (!emit_signal || gtk_tree_store_is_pending (tree_store, iter->user_data))
     return;
 
   /* Emit the reordered signal. */
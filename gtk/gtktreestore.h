@@ -135,6 +135,15 @@ GDK_AVAILABLE_IN_ALL
 void          gtk_tree_store_append           (GtkTreeStore *tree_store,
 					       GtkTreeIter  *iter,
 					       GtkTreeIter  *parent);
+GDK_AVAILABLE_IN_3_20
+void          gtk_tree_store_append_rows      (GtkTreeStore *tree_store,
+                                               GtkTreeIter  *iter,
+                                               GtkTreeIter  *parent,
+                                               gint          n_rows);
+GDK_AVAILABLE_IN_3_20
+void          gtk_tree_store_begin_update     (GtkTreeStore *tree_store);
+GDK_AVAILABLE_IN_3_20
+void          gtk_tree_store_end_update       (GtkTreeStore *tree_store);
 GDK_AVAILABLE_IN_ALL
 gboolean      gtk_tree_store_is_ancestor      (GtkTreeStore *tree_store,
 					       GtkTreeIter  *iter,
@@ -27,6 +27,7 @@
 #include "gtkrbtree.h"
 #include "gtktreednd.h"
 #include "gtktreeprivate.h"
+#include "gtktreemodelprivate.h"
 #include "gtkcellrenderer.h"
 #include "gtkmarshalers.h"
 #include "gtkbuildable.h"
@@ -225,6 +226,12 @@ typedef enum {
 #define GTK_TREE_VIEW_PRIORITY_SCROLL_SYNC (GTK_TREE_VIEW_PRIORITY_VALIDATE + 2)
 /* 3/5 of gdkframeclockidle.c's FRAME_INTERVAL (16667 microsecs) */
 #define GTK_TREE_VIEW_TIME_MS_PER_IDLE 10
+/* Validating rows in the background may take up this share of a
+ * frame, the rest is left for layout and painting. It always gets
+ * a minimum, so that it keeps going when frames run late.
+ */
+#define GTK_TREE_VIEW_VALIDATE_FRAME_SHARE 0.5
+#define GTK_TREE_VIEW_MIN_VALIDATE_US 1000
 #define SCROLL_EDGE_SIZE 15
 #define GTK_TREE_VIEW_SEARCH_DIALOG_TIMEOUT 5000
 #define AUTO_EXPAND_TIMEOUT 500
@@ -301,7 +308,7 @@ struct _GtkTreeViewPrivate
   /* we cache it for simplicity of the code */
   gint dy;
 
-  guint validate_rows_timer;
+  guint validate_rows_tick_cb;
   guint scroll_sync_timer;
 
   /* Indentation and expander layout */
@@ -665,6 +672,11 @@ static void gtk_tree_view_row_inserted                    (GtkTreeModel    *mode
 							   GtkTreePath     *path,
 							   GtkTreeIter     *iter,
 							   gpointer         data);
+static void gtk_tree_view_rows_inserted                   (GtkTreeModel    *model,
+							   GtkTreePath     *path,
+							   GtkTreeIter     *iter,
+							   gint             n_rows,
+							   gpointer         data);
 static void gtk_tree_view_row_has_child_toggled           (GtkTreeModel    *model,
 							   GtkTreePath     *path,
 							   GtkTreeIter     *iter,
@@ -686,8 +698,10 @@ static gboolean validate_row             (GtkTreeView *tree_view,
 					  GtkTreePath *path);
 static void     validate_visible_area    (GtkTreeView *tree_view);
 static gboolean do_validate_rows         (GtkTreeView *tree_view,
-					  gboolean     queue_resize);
-static gboolean validate_rows            (GtkTreeView *tree_view);
+					  gboolean     queue_resize,
+					  gint64       end_time);
+static gboolean validate_rows            (GtkTreeView *tree_view,
+					  gint64       end_time);
 static void     install_presize_handler  (GtkTreeView *tree_view);
 static void     install_scroll_sync_handler (GtkTreeView *tree_view);
 static void     gtk_tree_view_set_top_row   (GtkTreeView *tree_view,
@@ -2502,10 +2516,10 @@ gtk_tree_view_unrealize (GtkWidget *widget)
       priv->presize_handler_tick_cb = 0;
     }
 
-  if (priv->validate_rows_timer != 0)
+  if (priv->validate_rows_tick_cb != 0)
     {
-      g_source_remove (priv->validate_rows_timer);
-      priv->validate_rows_timer = 0;
+      gtk_widget_remove_tick_callback (widget, priv->validate_rows_tick_cb);
+      priv->validate_rows_tick_cb = 0;
     }
 
   if (priv->scroll_sync_timer != 0)
@@ -2595,7 +2609,8 @@ gtk_tree_view_get_preferred_width (GtkWidget *widget,
   /* we validate some rows initially just to make sure we have some size.
    * In practice, with a lot of static lists, this should get a good width.
    */
-  do_validate_rows (tree_view, FALSE);
+  do_validate_rows (tree_view, FALSE,
+                    g_get_monotonic_time () + GTK_TREE_VIEW_TIME_MS_PER_IDLE * 1000);
 
   /* keep this in sync with size_allocate below */
   for (list = tree_view->priv->columns; list; list = list->next)
@@ -5038,21 +5053,31 @@ gtk_tree_view_bin_draw (GtkWidget      *widget,
 
       /* we *need* to set cell data on all cells before the call
        * to _has_can_focus_cell, else _has_can_focus_cell() does not
-       * return a correct value.
+       * return a correct value. It only matters for the cursor row
+       * though, other rows only set the data of the cells they draw.
        */
-      for (list = (rtl ? g_list_last (tree_view->priv->columns) : g_list_first (tree_view->priv->columns));
-	   list;
-	   list = (rtl ? list->prev : list->next))
+      if (node == tree_view->priv->cursor_node)
         {
-	  GtkTreeViewColumn *column = list->data;
-	  gtk_tree_view_column_cell_set_cell_data (column,
-						   tree_view->priv->model,
-						   &iter,
-						   GTK_RBNODE_FLAG_SET (node, GTK_RBNODE_IS_PARENT),
-						   node->children?TRUE:FALSE);
-        }
+          for (list = (rtl ? g_list_last (tree_view->priv->columns) : g_list_first (tree_view->priv->columns));
+               list;
+               list = (rtl ? list->prev : list->next))
+            {
+              GtkTreeViewColumn *column = list->data;
 
-      has_can_focus_cell = gtk_tree_view_has_can_focus_cell (tree_view);
+              if (!gtk_tree_view_column_get_visible (column))
+                continue;
+
+              gtk_tree_view_column_cell_set_cell_data (column,
+                                                       tree_view->priv->model,
+                                                       &iter,
+                                                       GTK_RBNODE_FLAG_SET (node, GTK_RBNODE_IS_PARENT),
+                                                       node->children?TRUE:FALSE);
+            }
+
+          has_can_focus_cell = gtk_tree_view_has_can_focus_cell (tree_view);
+        }
+      else
+        has_can_focus_cell = FALSE;
 
       for (list = (rtl ? g_list_last (tree_view->priv->columns) : g_list_first (tree_view->priv->columns));
 	   list;
@@ -5136,11 +5161,12 @@ gtk_tree_view_bin_draw (GtkWidget      *widget,
 	      continue;
 	    }
 
-	  gtk_tree_view_column_cell_set_cell_data (column,
-						   tree_view->priv->model,
-						   &iter,
-						   GTK_RBNODE_FLAG_SET (node, GTK_RBNODE_IS_PARENT),
-						   node->children?TRUE:FALSE);
+	  if (node != tree_view->priv->cursor_node)
+	    gtk_tree_view_column_cell_set_cell_data (column,
+						     tree_view->priv->model,
+						     &iter,
+						     GTK_RBNODE_FLAG_SET (node, GTK_RBNODE_IS_PARENT),
+						     node->children?TRUE:FALSE);
 
           /* Select the detail for drawing the cell.  relevant
            * factors are parity, sortedness, and whether to
@@ -6756,14 +6782,97 @@ initialize_fixed_height_mode (GtkTreeView *tree_view)
                                  tree_view->priv->fixed_height, TRUE);
 }
 
-/* Our strategy for finding nodes to validate is a little convoluted.  We find
- * the left-most uninvalidated node.  We then try walking right, validating
- * nodes.  Once we find a valid node, we repeat the previous process of finding
- * the first invalid node.
+static gboolean
+validate_node (GtkTreeView *tree_view,
+               GtkRBTree   *tree,
+               GtkRBNode   *node,
+               gint        *y)
+{
+  GtkTreePath *path;
+  GtkTreeIter iter;
+  gboolean changed;
+
+  path = _gtk_tree_path_new_from_rbtree (tree, node);
+  gtk_tree_model_get_iter (tree_view->priv->model, &iter, path);
+  changed = validate_row (tree_view, tree, node, &iter, path);
+  gtk_tree_path_free (path);
+
+  if (changed)
+    {
+      gint offset = gtk_tree_view_get_row_y_offset (tree_view, tree, node);
+
+      if (*y == -1 || *y > offset)
+        *y = offset;
+    }
+
+  return changed;
+}
+
+/* Validates the rows within a page below and above the visible area,
+ * the ones that scrolling brings into view next, so that they are
+ * ready before the rest of the tree. Returns whether any of them
+ * changed size, with @y lowered to the offset of the first one.
+ */
+static gboolean
+validate_near_visible_area (GtkTreeView *tree_view,
+                            gint64       end_time,
+                            gint        *y)
+{
+  GtkRBTree *tree;
+  GtkRBNode *node;
+  gint top, page_size, area;
+  gboolean changed = FALSE;
+
+  page_size = gtk_adjustment_get_page_size (tree_view->priv->vadjustment);
+  if (page_size <= 0)
+    return FALSE;
+
+  top = gtk_adjustment_get_value (tree_view->priv->vadjustment);
+
+  _gtk_rbtree_find_offset (tree_view->priv->tree, top + page_size, &tree, &node);
+  for (area = page_size; node != NULL && area > 0; )
+    {
+      if (GTK_RBNODE_FLAG_SET (node, GTK_RBNODE_INVALID) ||
+          GTK_RBNODE_FLAG_SET (node, GTK_RBNODE_COLUMN_INVALID))
+        changed |= validate_node (tree_view, tree, node, y);
+
+      if (g_get_monotonic_time () >= end_time)
+        return changed;
+
+      area -= gtk_tree_view_get_row_height (tree_view, node);
+      _gtk_rbtree_next_full (tree, node, &tree, &node);
+    }
+
+  _gtk_rbtree_find_offset (tree_view->priv->tree, top, &tree, &node);
+  if (node != NULL)
+    _gtk_rbtree_prev_full (tree, node, &tree, &node);
+  for (area = page_size; node != NULL && area > 0; )
+    {
+      if (GTK_RBNODE_FLAG_SET (node, GTK_RBNODE_INVALID) ||
+          GTK_RBNODE_FLAG_SET (node, GTK_RBNODE_COLUMN_INVALID))
+        changed |= validate_node (tree_view, tree, node, y);
+
+      if (g_get_monotonic_time () >= end_time)
+        return changed;
+
+      area -= gtk_tree_view_get_row_height (tree_view, node);
+      _gtk_rbtree_prev_full (tree, node, &tree, &node);
+    }
+
+  return changed;
+}
+
+/* Our strategy for finding nodes to validate is a little convoluted.  We
+ * start with the rows around the visible area.  Then we find the left-most
+ * uninvalidated node.  We then try walking right, validating nodes.  Once
+ * we find a valid node, we repeat the previous process of finding the first
+ * invalid node. This goes on until @end_time, a g_get_monotonic_time() value.
  */
 
 static gboolean
-do_validate_rows (GtkTreeView *tree_view, gboolean queue_resize)
+do_validate_rows (GtkTreeView *tree_view,
+                  gboolean     queue_resize,
+                  gint64       end_time)
 {
   static gboolean prevent_recursion_hack = FALSE;
 
@@ -6773,7 +6882,6 @@ do_validate_rows (GtkTreeView *tree_view, gboolean queue_resize)
   gint retval = TRUE;
   GtkTreePath *path = NULL;
   GtkTreeIter iter;
-  GTimer *timer;
   gint i = 0;
 
   gint y = -1;
@@ -6797,8 +6905,8 @@ do_validate_rows (GtkTreeView *tree_view, gboolean queue_resize)
       return FALSE;
     }
 
-  timer = g_timer_new ();
-  g_timer_start (timer);
+  if (GTK_RBNODE_FLAG_SET (tree_view->priv->tree->root, GTK_RBNODE_DESCENDANTS_INVALID))
+    validated_area = validate_near_visible_area (tree_view, end_time, &y);
 
   do
     {
@@ -6887,7 +6995,7 @@ do_validate_rows (GtkTreeView *tree_view, gboolean queue_resize)
 
       i++;
     }
-  while (g_timer_elapsed (timer, NULL) < GTK_TREE_VIEW_TIME_MS_PER_IDLE / 1000.);
+  while (g_get_monotonic_time () < end_time);
 
   if (!tree_view->priv->fixed_height_check)
    {
@@ -6938,7 +7046,6 @@ do_validate_rows (GtkTreeView *tree_view, gboolean queue_resize)
     }
 
   if (path) gtk_tree_path_free (path);
-  g_timer_destroy (timer);
 
   return retval;
 }
@@ -6955,7 +7062,7 @@ static void
 maybe_reenable_adjustment_animation (GtkTreeView *tree_view)
 {
   if (tree_view->priv->presize_handler_tick_cb != 0 ||
-      tree_view->priv->validate_rows_timer != 0)
+      tree_view->priv->validate_rows_tick_cb != 0)
     return;
 
   gtk_adjustment_enable_animation (tree_view->priv->vadjustment,
@@ -7009,7 +7116,8 @@ presize_handler_callback (GtkWidget     *widget,
 }
 
 static gboolean
-validate_rows (GtkTreeView *tree_view)
+validate_rows (GtkTreeView *tree_view,
+               gint64       end_time)
 {
   gboolean retval;
   
@@ -7019,18 +7127,41 @@ validate_rows (GtkTreeView *tree_view)
       return G_SOURCE_CONTINUE;
     }
 
-  retval = do_validate_rows (tree_view, TRUE);
+  retval = do_validate_rows (tree_view, TRUE, end_time);
   
-  if (! retval && tree_view->priv->validate_rows_timer)
+  if (! retval && tree_view->priv->validate_rows_tick_cb)
     {
-      g_source_remove (tree_view->priv->validate_rows_timer);
-      tree_view->priv->validate_rows_timer = 0;
+      gtk_widget_remove_tick_callback (GTK_WIDGET (tree_view), tree_view->priv->validate_rows_tick_cb);
+      tree_view->priv->validate_rows_tick_cb = 0;
       maybe_reenable_adjustment_animation (tree_view);
     }
 
   return retval;
 }
 
+/* Validation runs in the update phase of each frame, before layout and
+ * painting, and stops once its share of the frame is used up.
+ */
+static gboolean
+validate_rows_tick_cb (GtkWidget     *widget,
+                       GdkFrameClock *clock,
+                       gpointer       unused)
+{
+  gint64 frame_time, refresh_interval, presentation_time;
+  gint64 end_time;
+
+  frame_time = gdk_frame_clock_get_frame_time (clock);
+  gdk_frame_clock_get_refresh_info (clock, frame_time,
+                                    &refresh_interval, &presentation_time);
+  if (refresh_interval == 0)
+    refresh_interval = G_USEC_PER_SEC / 60;
+
+  end_time = frame_time + refresh_interval * GTK_TREE_VIEW_VALIDATE_FRAME_SHARE;
+  end_time = MAX (end_time, g_get_monotonic_time () + GTK_TREE_VIEW_MIN_VALIDATE_US);
+
+  return validate_rows (GTK_TREE_VIEW (widget), end_time);
+}
+
 static void
 install_presize_handler (GtkTreeView *tree_view)
 {
@@ -7044,11 +7175,10 @@ install_presize_handler (GtkTreeView *tree_view)
       tree_view->priv->presize_handler_tick_cb =
 	gtk_widget_add_tick_callback (GTK_WIDGET (tree_view), presize_handler_callback, NULL, NULL);
     }
-  if (! tree_view->priv->validate_rows_timer)
+  if (! tree_view->priv->validate_rows_tick_cb)
     {
-      tree_view->priv->validate_rows_timer =
-	gdk_threads_add_idle_full (GTK_TREE_VIEW_PRIORITY_VALIDATE, (GSourceFunc) validate_rows, tree_view, NULL);
-      g_source_set_name_by_id (tree_view->priv->validate_rows_timer, "[gtk+] validate_rows");
+      tree_view->priv->validate_rows_tick_cb =
+	gtk_widget_add_tick_callback (GTK_WIDGET (tree_view), validate_rows_tick_cb, NULL, NULL);
     }
 }
 
@@ -7219,7 +7349,8 @@ _gtk_tree_view_column_autosize (GtkTreeView *tree_view,
   _gtk_tree_view_column_cell_set_dirty (column, FALSE);
 
   do_presize_handler (tree_view);
-  while (validate_rows (tree_view));
+  while (validate_rows (tree_view,
+                        g_get_monotonic_time () + GTK_TREE_VIEW_TIME_MS_PER_IDLE * 1000));
 
   gtk_widget_queue_resize (GTK_WIDGET (tree_view));
 }
@@ -9018,6 +9149,10 @@ gtk_tree_view_row_inserted (GtkTreeModel *model,
 
   g_return_if_fail (path != NULL || iter != NULL);
 
+  /* Already handled by gtk_tree_view_rows_inserted() */
+  if (_gtk_tree_model_row_inserted_is_batched (model, path))
+    return;
+
   if (tree_view->priv->fixed_height_mode
       && tree_view->priv->fixed_height >= 0)
     height = tree_view->priv->fixed_height;
@@ -9114,6 +9249,124 @@ gtk_tree_view_row_inserted (GtkTreeModel *model,
     gtk_tree_path_free (path);
 }
 
+/* Top level rows are added to the tree in one go; rows further down
+ * are rare enough in batches to go through gtk_tree_view_row_inserted().
+ */
+static void
+gtk_tree_view_rows_inserted (GtkTreeModel *model,
+			     GtkTreePath  *path,
+			     GtkTreeIter  *iter,
+			     gint          n_rows,
+			     gpointer      data)
+{
+  GtkTreeView *tree_view = (GtkTreeView *) data;
+  GtkTreePath *row_path;
+  GtkTreeIter row_iter;
+  GtkRBTree *tree;
+  GtkRBNode *node;
+  gint first;
+  gint height;
+  gint i;
+
+  row_path = gtk_tree_path_copy (path);
+  row_iter = *iter;
+
+  if (gtk_tree_path_get_depth (path) != 1)
+    {
+      for (i = 0; i < n_rows; i++)
+        {
+          if (i > 0)
+            {
+              gtk_tree_path_next (row_path);
+              if (!gtk_tree_model_iter_next (model, &row_iter))
+                break;
+            }
+
+          gtk_tree_view_row_inserted (model, row_path, &row_iter, data);
+        }
+
+      gtk_tree_path_free (row_path);
+      return;
+    }
+
+  if (tree_view->priv->fixed_height_mode
+      && tree_view->priv->fixed_height >= 0)
+    height = tree_view->priv->fixed_height;
+  else
+    height = 0;
+
+  if (tree_view->priv->tree == NULL)
+    tree_view->priv->tree = _gtk_rbtree_new ();
+
+  tree = tree_view->priv->tree;
+
+  /* Filling an empty view, e.g. right after the model was set */
+  if (_gtk_rbtree_is_nil (tree->root))
+    {
+      for (i = 0; i < n_rows; i++)
+        {
+          if (i > 0)
+            {
+              gtk_tree_path_next (row_path);
+              if (!gtk_tree_model_iter_next (model, &row_iter))
+                break;
+            }
+
+          gtk_tree_row_reference_inserted (G_OBJECT (data), row_path);
+          gtk_tree_model_ref_node (tree_view->priv->model, &row_iter);
+        }
+
+      _gtk_rbtree_fill (tree, i, height, height > 0);
+      _gtk_tree_view_accessible_add (tree_view, tree, NULL);
+
+      gtk_tree_path_free (row_path);
+
+      if (height > 0)
+        gtk_widget_queue_resize (GTK_WIDGET (tree_view));
+      else
+        install_presize_handler (tree_view);
+
+      return;
+    }
+
+  first = gtk_tree_path_get_indices (path)[0];
+  if (first > 0)
+    node = _gtk_rbtree_find_count (tree, first);
+  else
+    node = NULL;
+
+  for (i = 0; i < n_rows; i++)
+    {
+      if (i > 0)
+        {
+          gtk_tree_path_next (row_path);
+          if (!gtk_tree_model_iter_next (model, &row_iter))
+            break;
+        }
+
+      gtk_tree_row_reference_inserted (G_OBJECT (data), row_path);
+
+      /* ref the node */
+      gtk_tree_model_ref_node (tree_view->priv->model, &row_iter);
+      if (node == NULL)
+        node = _gtk_rbtree_insert_before (tree, _gtk_rbtree_find_count (tree, 1), height, FALSE);
+      else
+        node = _gtk_rbtree_insert_after (tree, node, height, FALSE);
+
+      if (height > 0)
+        _gtk_rbtree_node_mark_valid (tree, node);
+
+      _gtk_tree_view_accessible_add (tree_view, tree, node);
+    }
+
+  gtk_tree_path_free (row_path);
+
+  if (height > 0)
+    gtk_widget_queue_resize (GTK_WIDGET (tree_view));
+  else
+    install_presize_handler (tree_view);
+}
+
 static void
 gtk_tree_view_row_has_child_toggled (GtkTreeModel *model,
 				     GtkTreePath  *path,
@@ -9534,6 +9787,28 @@ gtk_tree_view_build_tree (GtkTreeView *tree_view,
   GtkRBNode *temp = NULL;
   GtkTreePath *path = NULL;
 
+  /* Flat lists don't need to look at each row, so the whole
+   * tree can be built in one go.
+   */
+  if (tree_view->priv->is_list && _gtk_rbtree_is_nil (tree->root))
+    {
+      gint n_rows = 0;
+
+      do
+        {
+          gtk_tree_model_ref_node (tree_view->priv->model, iter);
+          n_rows++;
+        }
+      while (gtk_tree_model_iter_next (tree_view->priv->model, iter));
+
+      if (tree_view->priv->fixed_height > 0)
+        _gtk_rbtree_fill (tree, n_rows, tree_view->priv->fixed_height, TRUE);
+      else
+        _gtk_rbtree_fill (tree, n_rows, 0, FALSE);
+
+      return;
+    }
+
   do
     {
       gtk_tree_model_ref_node (tree_view->priv->model, iter);
@@ -11424,6 +11699,12 @@ gtk_tree_view_set_model (GtkTreeView  *tree_view,
       g_signal_handlers_disconnect_by_func (tree_view->priv->model,
 					    gtk_tree_view_row_inserted,
 					    tree_view);
+      g_signal_handlers_disconnect_by_func (tree_view->priv->model,
+					    gtk_tree_view_rows_inserted,
+					    tree_view);
+      _gtk_tree_model_remove_batch_handler (tree_view->priv->model,
+                                            G_CALLBACK (gtk_tree_view_row_inserted),
+                                            tree_view);
       g_signal_handlers_disconnect_by_func (tree_view->priv->model,
 					    gtk_tree_view_row_has_child_toggled,
 					    tree_view);
@@ -11492,6 +11773,13 @@ gtk_tree_view_set_model (GtkTreeView  *tree_view,
 			"row-inserted",
 			G_CALLBACK (gtk_tree_view_row_inserted),
 			tree_view);
+      g_signal_connect (tree_view->priv->model,
+			"rows-inserted",
+			G_CALLBACK (gtk_tree_view_rows_inserted),
+			tree_view);
+      _gtk_tree_model_add_batch_handler (tree_view->priv->model,
+                                         G_CALLBACK (gtk_tree_view_row_inserted),
+                                         tree_view);
       g_signal_connect (tree_view->priv->model,
 			"row-has-child-toggled",
 			G_CALLBACK (gtk_tree_view_row_has_child_toggled),
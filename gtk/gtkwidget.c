@@ -40,7 +40,9 @@
 #include "gtkcssstylepropertyprivate.h"
 #include "gtkcssnumbervalueprivate.h"
 #include "gtkcssshadowsvalueprivate.h"
+#include "gtkrenderbackgroundprivate.h"
 #include "gtkintl.h"
+#include "gtklayouttraceprivate.h"
 #include "gtkmarshalers.h"
 #include "gtkselectionprivate.h"
 #include "gtksettingsprivate.h"
@@ -456,6 +458,11 @@
 
 #define WIDGET_CLASS(w)	 GTK_WIDGET_GET_CLASS (w)
 
+/* Unlike GTK_DEBUG_CHECK(), this works in builds without debugging,
+ * so that the draw cache can be tried out everywhere
+ */
+#define DRAW_CACHE_ENABLED() G_UNLIKELY (gtk_get_debug_flags () & GTK_DEBUG_DRAW_CACHE)
+
 typedef struct {
   gchar               *name;           /* Name of the template automatic child */
   gboolean             internal_child; /* Whether the automatic widget should be exported as an <internal-child> */
@@ -487,6 +494,8 @@ struct _GtkWidgetClassPrivate
   GtkWidgetTemplate *template;
   GType accessible_type;
   AtkRole accessible_role;
+  gboolean (* plain_draw) (GtkWidget *widget,
+                           cairo_t   *cr);
 };
 
 enum {
@@ -826,6 +835,7 @@ static void gtk_cairo_set_event (cairo_t        *cr,
 				 GdkEventExpose *event);
 
 static void gtk_widget_update_input_shape (GtkWidget *widget);
+static void gtk_widget_invalidate_draw_cache (GtkWidget *widget);
 
 /* --- variables --- */
 static gint             GtkWidget_private_offset = 0;
@@ -858,6 +868,7 @@ static GQuark           quark_widget_path = 0;
 static GQuark           quark_action_muxer = 0;
 static GQuark           quark_font_options = 0;
 static GQuark           quark_font_map = 0;
+static GQuark           quark_draw_cache = 0;
 
 GParamSpecPool         *_gtk_widget_child_property_pool = NULL;
 GObjectNotifyContext   *_gtk_widget_child_property_notify_context = NULL;
@@ -1029,6 +1040,7 @@ gtk_widget_class_init (GtkWidgetClass *klass)
   quark_action_muxer = g_quark_from_static_string ("gtk-widget-action-muxer");
   quark_font_options = g_quark_from_static_string ("gtk-widget-font-options");
   quark_font_map = g_quark_from_static_string ("gtk-widget-font-map");
+  quark_draw_cache = g_quark_from_static_string ("gtk-widget-draw-cache");
 
   style_property_spec_pool = g_param_spec_pool_new (FALSE);
   _gtk_widget_child_property_pool = g_param_spec_pool_new (TRUE);
@@ -5077,6 +5089,7 @@ struct _GtkTickCallbackInfo
   GDestroyNotify notify;
 
   guint destroyed : 1;
+  guint needs_mapped : 1;
 };
 
 static void
@@ -5085,6 +5098,59 @@ ref_tick_callback_info (GtkTickCallbackInfo *info)
   info->refcount++;
 }
 
+/* Whether any of the tick callbacks wants to run right now. Callbacks
+ * added with gtk_widget_add_mapped_tick_callback() are parked while the
+ * widget is unmapped, since whatever they animate cannot be seen.
+ */
+static gboolean
+gtk_widget_wants_clock_tick (GtkWidget *widget)
+{
+  GtkWidgetPrivate *priv = widget->priv;
+  GList *l;
+
+  for (l = priv->tick_callbacks; l; l = l->next)
+    {
+      GtkTickCallbackInfo *info = l->data;
+
+      if (info->destroyed)
+        continue;
+
+      if (!info->needs_mapped || priv->mapped)
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+static void
+gtk_widget_update_clock_tick (GtkWidget *widget)
+{
+  GtkWidgetPrivate *priv = widget->priv;
+  GdkFrameClock *frame_clock;
+
+  if (!priv->realized)
+    return;
+
+  if (gtk_widget_wants_clock_tick (widget))
+    {
+      if (priv->clock_tick_id)
+        return;
+
+      frame_clock = gtk_widget_get_frame_clock (widget);
+      priv->clock_tick_id = g_signal_connect (frame_clock, "update",
+                                              G_CALLBACK (gtk_widget_on_frame_clock_update),
+                                              widget);
+      gdk_frame_clock_begin_updating (frame_clock);
+    }
+  else if (priv->clock_tick_id)
+    {
+      frame_clock = gtk_widget_get_frame_clock (widget);
+      g_signal_handler_disconnect (frame_clock, priv->clock_tick_id);
+      priv->clock_tick_id = 0;
+      gdk_frame_clock_end_updating (frame_clock);
+    }
+}
+
 static void
 unref_tick_callback_info (GtkWidget           *widget,
                           GtkTickCallbackInfo *info,
@@ -5101,13 +5167,7 @@ unref_tick_callback_info (GtkWidget           *widget,
       g_slice_free (GtkTickCallbackInfo, info);
     }
 
-  if (priv->tick_callbacks == NULL && priv->clock_tick_id)
-    {
-      GdkFrameClock *frame_clock = gtk_widget_get_frame_clock (widget);
-      g_signal_handler_disconnect (frame_clock, priv->clock_tick_id);
-      priv->clock_tick_id = 0;
-      gdk_frame_clock_end_updating (frame_clock);
-    }
+  gtk_widget_update_clock_tick (widget);
 }
 
 static void
@@ -5151,7 +5211,8 @@ gtk_widget_on_frame_clock_update (GdkFrameClock *frame_clock,
       GList *next;
 
       ref_tick_callback_info (info);
-      if (!info->destroyed)
+      if (!info->destroyed &&
+          (!info->needs_mapped || priv->mapped))
         {
           if (info->callback (widget,
                               frame_clock,
@@ -5204,28 +5265,16 @@ static guint tick_callback_id;
  *
  * Since: 3.8
  */
-guint
-gtk_widget_add_tick_callback (GtkWidget       *widget,
-                              GtkTickCallback  callback,
-                              gpointer         user_data,
-                              GDestroyNotify   notify)
+static guint
+gtk_widget_add_tick_callback_internal (GtkWidget       *widget,
+                                       GtkTickCallback  callback,
+                                       gpointer         user_data,
+                                       GDestroyNotify   notify,
+                                       gboolean         needs_mapped)
 {
-  GtkWidgetPrivate *priv;
+  GtkWidgetPrivate *priv = widget->priv;
   GtkTickCallbackInfo *info;
 
-  g_return_val_if_fail (GTK_IS_WIDGET (widget), 0);
-
-  priv = widget->priv;
-
-  if (priv->realized && !priv->clock_tick_id)
-    {
-      GdkFrameClock *frame_clock = gtk_widget_get_frame_clock (widget);
-      priv->clock_tick_id = g_signal_connect (frame_clock, "update",
-                                              G_CALLBACK (gtk_widget_on_frame_clock_update),
-                                              widget);
-      gdk_frame_clock_begin_updating (frame_clock);
-    }
-
   info = g_slice_new0 (GtkTickCallbackInfo);
 
   info->refcount = 1;
@@ -5233,13 +5282,55 @@ gtk_widget_add_tick_callback (GtkWidget       *widget,
   info->callback = callback;
   info->user_data = user_data;
   info->notify = notify;
+  info->needs_mapped = needs_mapped;
 
   priv->tick_callbacks = g_list_prepend (priv->tick_callbacks,
                                          info);
 
+  gtk_widget_update_clock_tick (widget);
+
   return info->id;
 }
 
+guint
+gtk_widget_add_tick_callback (GtkWidget       *widget,
+                              GtkTickCallback  callback,
+                              gpointer         user_data,
+                              GDestroyNotify   notify)
+{
+  g_return_val_if_fail (GTK_IS_WIDGET (widget), 0);
+
+  return gtk_widget_add_tick_callback_internal (widget, callback, user_data, notify, FALSE);
+}
+
+/*
+ * gtk_widget_add_mapped_tick_callback:
+ * @widget: a #GtkWidget
+ * @callback: function to call for updating animations
+ * @user_data: data to pass to @callback
+ * @notify: function to call to free @user_data when the callback is removed.
+ *
+ * Like gtk_widget_add_tick_callback(), but @callback is only called
+ * while @widget is mapped. While the widget is unmapped the callback
+ * stays registered but does not keep the frame clock running.
+ *
+ * This is meant for purely visual animations, like activity indicators,
+ * that have no effect while they cannot be seen.
+ *
+ * Returns: an id for the connection of this callback. Remove the callback
+ *     by passing it to gtk_widget_remove_tick_callback()
+ */
+guint
+gtk_widget_add_mapped_tick_callback (GtkWidget       *widget,
+                                     GtkTickCallback  callback,
+                                     gpointer         user_data,
+                                     GDestroyNotify   notify)
+{
+  g_return_val_if_fail (GTK_IS_WIDGET (widget), 0);
+
+  return gtk_widget_add_tick_callback_internal (widget, callback, user_data, notify, TRUE);
+}
+
 /**
  * gtk_widget_remove_tick_callback:
  * @widget: a #GtkWidget
@@ -5287,13 +5378,7 @@ gtk_widget_connect_frame_clock (GtkWidget     *widget,
   if (GTK_IS_CONTAINER (widget))
     _gtk_container_maybe_start_idle_sizer (GTK_CONTAINER (widget));
 
-  if (priv->tick_callbacks != NULL && !priv->clock_tick_id)
-    {
-      priv->clock_tick_id = g_signal_connect (frame_clock, "update",
-                                              G_CALLBACK (gtk_widget_on_frame_clock_update),
-                                              widget);
-      gdk_frame_clock_begin_updating (frame_clock);
-    }
+  gtk_widget_update_clock_tick (widget);
 
   gtk_css_node_invalidate_frame_clock (priv->cssnode, FALSE);
 
@@ -5447,6 +5532,8 @@ gtk_widget_unrealize (GtkWidget *widget)
       g_signal_emit (widget, widget_signals[UNREALIZE], 0);
       g_assert (!widget->priv->mapped);
       gtk_widget_set_realized (widget, FALSE);
+
+      g_object_set_qdata (G_OBJECT (widget), quark_draw_cache, NULL);
     }
 
   gtk_widget_pop_verify_invariants (widget);
@@ -5492,6 +5579,9 @@ gtk_widget_queue_draw_region (GtkWidget            *widget,
 
   g_return_if_fail (GTK_IS_WIDGET (widget));
 
+  if (DRAW_CACHE_ENABLED ())
+    gtk_widget_invalidate_draw_cache (widget);
+
   if (!_gtk_widget_get_realized (widget))
     return;
 
@@ -5810,6 +5900,7 @@ gtk_widget_size_allocate_with_baseline (GtkWidget     *widget,
   gint natural_width, natural_height, dummy;
   gint min_width, min_height;
   gint old_baseline;
+  gint64 start_time = 0;
 
   priv = widget->priv;
 
@@ -5950,12 +6041,21 @@ gtk_widget_size_allocate_with_baseline (GtkWidget     *widget,
   if (!alloc_needed && !size_changed && !position_changed && !baseline_changed)
     goto out;
 
+  if (DRAW_CACHE_ENABLED ())
+    gtk_widget_invalidate_draw_cache (widget);
+
   priv->allocated_baseline = baseline;
+  if (GTK_LAYOUT_TRACE_IS_ENABLED ())
+    start_time = g_get_monotonic_time ();
+
   if (g_signal_has_handler_pending (widget, widget_signals[SIZE_ALLOCATE], 0, FALSE))
     g_signal_emit (widget, widget_signals[SIZE_ALLOCATE], 0, &real_allocation);
   else
     GTK_WIDGET_GET_CLASS (widget)->size_allocate (widget, &real_allocation);
 
+  if (GTK_LAYOUT_TRACE_IS_ENABLED ())
+    gtk_layout_trace_allocated (widget, start_time ? g_get_monotonic_time () - start_time : 0);
+
   /* Size allocation is god... after consulting god, no further requests or allocations are needed */
   priv->alloc_needed = FALSE;
 
@@ -6001,6 +6101,61 @@ out:
   gtk_widget_pop_verify_invariants (widget);
 }
 
+/*
+ * gtk_widget_reallocate:
+ * @widget: a #GtkWidget
+ *
+ * Allocates @widget again with its current allocation and baseline,
+ * so that children with pending resizes get allocated. This is used
+ * by relayout boundaries, whose own size is known not to have changed.
+ */
+void
+gtk_widget_reallocate (GtkWidget *widget)
+{
+  GtkWidgetPrivate *priv = widget->priv;
+  GtkAllocation allocation;
+  GdkRectangle old_clip;
+  gint64 start_time = 0;
+
+  if (!priv->alloc_needed || !priv->visible)
+    return;
+
+  gtk_widget_push_verify_invariants (widget);
+
+  priv->alloc_needed = FALSE;
+
+  old_clip = priv->clip;
+  allocation = priv->allocation;
+
+  if (DRAW_CACHE_ENABLED ())
+    gtk_widget_invalidate_draw_cache (widget);
+
+  if (GTK_LAYOUT_TRACE_IS_ENABLED ())
+    start_time = g_get_monotonic_time ();
+
+  if (g_signal_has_handler_pending (widget, widget_signals[SIZE_ALLOCATE], 0, FALSE))
+    g_signal_emit (widget, widget_signals[SIZE_ALLOCATE], 0, &allocation);
+  else
+    GTK_WIDGET_GET_CLASS (widget)->size_allocate (widget, &allocation);
+
+  if (GTK_LAYOUT_TRACE_IS_ENABLED ())
+    gtk_layout_trace_allocated (widget, start_time ? g_get_monotonic_time () - start_time : 0);
+
+  priv->alloc_needed = FALSE;
+
+  if (_gtk_widget_get_mapped (widget) &&
+      !gdk_rectangle_equal (&old_clip, &priv->clip))
+    {
+      cairo_region_t *invalidate = cairo_region_create_rectangle (&priv->clip);
+      cairo_region_union_rectangle (invalidate, &old_clip);
+
+      gtk_widget_invalidate_widget_windows (widget, invalidate);
+      cairo_region_destroy (invalidate);
+    }
+
+  gtk_widget_pop_verify_invariants (widget);
+}
+
 
 /**
  * gtk_widget_size_allocate:
@@ -6789,6 +6944,350 @@ gtk_cairo_should_draw_window (cairo_t *cr,
     event_window == window;
 }
 
+static void
+gtk_widget_emit_draw (GtkWidget *widget,
+                      cairo_t   *cr)
+{
+  gboolean result;
+
+  if (g_signal_has_handler_pending (widget, widget_signals[DRAW], 0, FALSE))
+    {
+      g_signal_emit (widget, widget_signals[DRAW],
+                     0, cr,
+                     &result);
+    }
+  else if (GTK_WIDGET_GET_CLASS (widget)->draw)
+    {
+      cairo_save (cr);
+      GTK_WIDGET_GET_CLASS (widget)->draw (widget, cr);
+      cairo_restore (cr);
+    }
+}
+
+/* The draw cache keeps a recording of everything a widget (and its
+ * children) drew the last time, and replays it as long as nothing
+ * invalidated the widget. It is enabled with GTK_DRAW_CACHE=1, or
+ * GTK_DEBUG=draw-cache, see DRAW_CACHE_ENABLED().
+ *
+ * The recording depends on the window that is being exposed, because
+ * that decides which children get drawn, so we remember it, too.
+ */
+typedef struct {
+  cairo_surface_t *recording;
+  GdkWindow *event_window;
+  guint in_expose : 1;
+} GtkWidgetDrawCache;
+
+static void
+gtk_widget_draw_cache_free (gpointer data)
+{
+  GtkWidgetDrawCache *cache = data;
+
+  cairo_surface_destroy (cache->recording);
+  g_slice_free (GtkWidgetDrawCache, cache);
+}
+
+/* Recordings of the ancestors include the output of @widget,
+ * so they have to go, too.
+ */
+static void
+gtk_widget_invalidate_draw_cache (GtkWidget *widget)
+{
+  GtkWidget *w;
+
+  for (w = widget; w != NULL; w = w->priv->parent)
+    g_object_set_qdata (G_OBJECT (w), quark_draw_cache, NULL);
+}
+
+/* Replaying a recording only gives the same pixels as drawing
+ * directly if we don't need to resample.
+ */
+static gboolean
+gtk_widget_draw_cache_is_pixel_aligned (cairo_t *cr)
+{
+  cairo_matrix_t matrix;
+
+  cairo_get_matrix (cr, &matrix);
+
+  return matrix.xx == 1.0 && matrix.yy == 1.0 &&
+         matrix.xy == 0.0 && matrix.yx == 0.0 &&
+         matrix.x0 == floor (matrix.x0) &&
+         matrix.y0 == floor (matrix.y0);
+}
+
+/* We only record when the whole widget is going to be drawn, so we
+ * never end up with a partial recording or one that is much larger
+ * than what is being exposed.
+ */
+static gboolean
+gtk_widget_draw_cache_covers_widget (GtkWidget *widget,
+                                     cairo_t   *cr)
+{
+  GtkWidgetPrivate *priv = widget->priv;
+  cairo_rectangle_list_t *list;
+  cairo_region_t *region;
+  GdkRectangle area;
+  gboolean covered;
+  int i;
+
+  list = cairo_copy_clip_rectangle_list (cr);
+  if (list->status != CAIRO_STATUS_SUCCESS)
+    {
+      cairo_rectangle_list_destroy (list);
+      return FALSE;
+    }
+
+  region = cairo_region_create ();
+  for (i = 0; i < list->num_rectangles; i++)
+    {
+      const cairo_rectangle_t *r = &list->rectangles[i];
+      GdkRectangle rect;
+
+      rect.x = ceil (r->x);
+      rect.y = ceil (r->y);
+      rect.width = floor (r->x + r->width) - rect.x;
+      rect.height = floor (r->y + r->height) - rect.y;
+
+      if (rect.width > 0 && rect.height > 0)
+        cairo_region_union_rectangle (region, &rect);
+    }
+  cairo_rectangle_list_destroy (list);
+
+  area.x = priv->clip.x - priv->allocation.x;
+  area.y = priv->clip.y - priv->allocation.y;
+  area.width = priv->clip.width;
+  area.height = priv->clip.height;
+
+  covered = cairo_region_contains_rectangle (region, &area) == CAIRO_REGION_OVERLAP_IN;
+  cairo_region_destroy (region);
+
+  return covered;
+}
+
+static GtkWidgetDrawCache *
+gtk_widget_draw_cache_record (GtkWidget *widget,
+                              cairo_t   *cr,
+                              GdkWindow *window)
+{
+  GtkWidgetPrivate *priv = widget->priv;
+  GtkWidgetDrawCache *cache;
+  cairo_rectangle_t extents;
+  cairo_t *record_cr;
+  double x_scale, y_scale;
+
+  cairo_surface_get_device_scale (cairo_get_target (cr), &x_scale, &y_scale);
+
+  /* The extents are in device units */
+  extents.x = (priv->clip.x - priv->allocation.x) * x_scale;
+  extents.y = (priv->clip.y - priv->allocation.y) * y_scale;
+  extents.width = priv->clip.width * x_scale;
+  extents.height = priv->clip.height * y_scale;
+
+  cache = g_slice_new0 (GtkWidgetDrawCache);
+  cache->recording = cairo_recording_surface_create (CAIRO_CONTENT_COLOR_ALPHA, &extents);
+  cairo_surface_set_device_scale (cache->recording, x_scale, y_scale);
+  cache->event_window = window;
+  cache->in_expose = _gtk_cairo_get_event (cr) != NULL;
+
+  record_cr = cairo_create (cache->recording);
+  gtk_cairo_set_event_window (record_cr, window);
+  gtk_cairo_set_event (record_cr, _gtk_cairo_get_event (cr));
+
+  gtk_widget_emit_draw (widget, record_cr);
+
+  cairo_destroy (record_cr);
+
+  g_object_set_qdata_full (G_OBJECT (widget), quark_draw_cache,
+                           cache, gtk_widget_draw_cache_free);
+
+  return cache;
+}
+
+/* Draws @widget from its draw cache, recording it first if needed.
+ * Returns %FALSE if the widget has to be drawn directly.
+ */
+static gboolean
+gtk_widget_draw_cached (GtkWidget *widget,
+                        cairo_t   *cr,
+                        GdkWindow *window)
+{
+  GtkWidgetDrawCache *cache;
+
+  if (_gtk_widget_get_has_window (widget) ||
+      !gtk_widget_draw_cache_is_pixel_aligned (cr))
+    return FALSE;
+
+  cache = g_object_get_qdata (G_OBJECT (widget), quark_draw_cache);
+  if (cache == NULL ||
+      cache->event_window != window ||
+      cache->in_expose != (_gtk_cairo_get_event (cr) != NULL))
+    {
+      if (!gtk_widget_draw_cache_covers_widget (widget, cr))
+        return FALSE;
+
+      cache = gtk_widget_draw_cache_record (widget, cr, window);
+    }
+
+  /* The recording started out transparent, and widgets draw with
+   * OVER, so compositing it with OVER gives the same pixels as drawing
+   * directly onto what is below. SOURCE would wipe out whatever the
+   * parent drew where the widget is transparent. Widgets that draw
+   * with other operators, e.g. CLEAR to punch holes, are not
+   * reproduced faithfully; gtk-reftest --draw-cache catches those.
+   */
+  cairo_save (cr);
+  cairo_set_source_surface (cr, cache->recording, 0, 0);
+  cairo_set_operator (cr, CAIRO_OPERATOR_OVER);
+  cairo_paint (cr);
+  cairo_restore (cr);
+
+  return TRUE;
+}
+
+/*
+ * gtk_widget_class_set_plain_draw:
+ * @widget_class: a #GtkWidgetClass
+ *
+ * Marks the current draw implementation of @widget_class as plain:
+ * it renders the CSS background and frame of the widget over its whole
+ * allocation, then draws its children with gtk_container_propagate_draw()
+ * and draws nothing on top of them.
+ *
+ * Widgets with a plain draw implementation and an opaque background are
+ * known to be opaque, and can be skipped entirely when the area being
+ * drawn is covered by one of their opaque children.
+ *
+ * Subclasses that override the draw implementation are not affected.
+ */
+void
+gtk_widget_class_set_plain_draw (GtkWidgetClass *widget_class)
+{
+  g_return_if_fail (GTK_IS_WIDGET_CLASS (widget_class));
+
+  widget_class->priv->plain_draw = widget_class->draw;
+}
+
+static gboolean
+gtk_widget_has_plain_draw (GtkWidget *widget)
+{
+  GtkWidgetClass *klass = GTK_WIDGET_GET_CLASS (widget);
+
+  return klass->priv->plain_draw != NULL &&
+         klass->priv->plain_draw == klass->draw &&
+         !g_signal_has_handler_pending (widget, widget_signals[DRAW], 0, FALSE);
+}
+
+/*
+ * gtk_widget_is_opaque:
+ * @widget: a #GtkWidget
+ *
+ * Returns whether drawing @widget is known to cover its whole
+ * allocation with opaque pixels, so that anything below it does
+ * not need to be drawn.
+ *
+ * Returns: %TRUE if @widget is opaque
+ */
+gboolean
+gtk_widget_is_opaque (GtkWidget *widget)
+{
+  GtkWidgetPrivate *priv = widget->priv;
+  GtkStyleContext *context;
+
+  if (!_gtk_widget_is_drawable (widget) ||
+      priv->alpha != 255 ||
+      !gtk_widget_has_plain_draw (widget))
+    return FALSE;
+
+  context = gtk_widget_get_style_context (widget);
+
+  return gtk_css_style_render_background_is_opaque (gtk_style_context_lookup_style (context),
+                                                    priv->allocation.width,
+                                                    priv->allocation.height);
+}
+
+static gboolean
+rectangle_contains (const GdkRectangle *outer,
+                    const GdkRectangle *inner)
+{
+  return inner->x >= outer->x &&
+         inner->y >= outer->y &&
+         inner->x + inner->width <= outer->x + outer->width &&
+         inner->y + inner->height <= outer->y + outer->height;
+}
+
+typedef struct {
+  GtkWidget *widget;
+  GdkRectangle clip;
+  GtkWidget *cover;
+  gboolean culled;
+} OpaqueCoverData;
+
+static void
+find_opaque_cover (GtkWidget *child,
+                   gpointer   user_data)
+{
+  OpaqueCoverData *data = user_data;
+  GtkWidgetPrivate *priv = data->widget->priv;
+  GdkRectangle child_rect;
+
+  if (!data->culled || !_gtk_widget_is_drawable (child))
+    return;
+
+  child_rect = child->priv->clip;
+  child_rect.x -= priv->allocation.x;
+  child_rect.y -= priv->allocation.y;
+  if (!gdk_rectangle_intersect (&child_rect, &data->clip, NULL))
+    return;
+
+  /* Only a single child may be visible in the area, otherwise we'd
+   * have to care about stacking order.
+   */
+  if (data->cover != NULL)
+    {
+      data->cover = NULL;
+      data->culled = FALSE;
+      return;
+    }
+
+  child_rect = child->priv->allocation;
+  child_rect.x -= priv->allocation.x;
+  child_rect.y -= priv->allocation.y;
+  if (!rectangle_contains (&child_rect, &data->clip) ||
+      !gtk_widget_is_opaque (child))
+    {
+      data->culled = FALSE;
+      return;
+    }
+
+  data->cover = child;
+}
+
+/* If everything that @widget would draw in the current clip of @cr
+ * is going to be covered by a single opaque child, returns that
+ * child, so that we can draw only that.
+ */
+static GtkWidget *
+gtk_widget_get_opaque_cover (GtkWidget *widget,
+                             cairo_t   *cr)
+{
+  OpaqueCoverData data;
+
+  if (!GTK_IS_CONTAINER (widget) ||
+      _gtk_widget_get_has_window (widget) ||
+      !gtk_widget_has_plain_draw (widget))
+    return NULL;
+
+  if (!gdk_cairo_get_clip_rectangle (cr, &data.clip))
+    return NULL;
+
+  data.widget = widget;
+  data.cover = NULL;
+  data.culled = TRUE;
+  gtk_container_forall (GTK_CONTAINER (widget), find_opaque_cover, &data);
+
+  return data.culled ? data.cover : NULL;
+}
+
 static void
 _gtk_widget_draw_internal (GtkWidget *widget,
                            cairo_t   *cr,
@@ -6815,22 +7314,17 @@ _gtk_widget_draw_internal (GtkWidget *widget,
 
   if (gdk_cairo_get_clip_rectangle (cr, NULL))
     {
-      gboolean result;
+      GtkWidget *cover;
 
       gdk_window_mark_paint_from_clip (window, cr);
 
-      if (g_signal_has_handler_pending (widget, widget_signals[DRAW], 0, FALSE))
-        {
-          g_signal_emit (widget, widget_signals[DRAW],
-                         0, cr,
-                         &result);
-        }
-      else if (GTK_WIDGET_GET_CLASS (widget)->draw)
-        {
-          cairo_save (cr);
-          GTK_WIDGET_GET_CLASS (widget)->draw (widget, cr);
-          cairo_restore (cr);
-        }
+      cover = gtk_widget_get_opaque_cover (widget, cr);
+      if (cover != NULL)
+        gtk_container_propagate_draw (GTK_CONTAINER (widget), cover, cr);
+      else if (!DRAW_CACHE_ENABLED () ||
+               !clip_to_size ||
+               !gtk_widget_draw_cached (widget, cr, window))
+        gtk_widget_emit_draw (widget, cr);
 
 #ifdef G_ENABLE_DEBUG
       if (GTK_DEBUG_CHECK (BASELINES))
@@ -9128,7 +9622,17 @@ gtk_widget_set_mapped (GtkWidget *widget,
 {
   g_return_if_fail (GTK_IS_WIDGET (widget));
 
+  mapped = !!mapped;
+
+  if (widget->priv->mapped == mapped)
+    return;
+
   widget->priv->mapped = mapped;
+
+  gtk_widget_update_clock_tick (widget);
+
+  if (DRAW_CACHE_ENABLED ())
+    gtk_widget_invalidate_draw_cache (widget);
 }
 
 /**
@@ -16315,6 +16819,9 @@ gtk_widget_clear_path (GtkWidget *widget)
 void
 _gtk_widget_style_context_invalidated (GtkWidget *widget)
 {
+  if (DRAW_CACHE_ENABLED ())
+    gtk_widget_invalidate_draw_cache (widget);
+
   if (_gtk_widget_get_realized (widget))
     g_signal_emit (widget, widget_signals[STYLE_UPDATED], 0);
   else
@@ -285,6 +285,13 @@ gboolean          _gtk_widget_consumes_motion              (GtkWidget
                                                             GdkEventSequence    *sequence);
 
 gboolean          gtk_widget_has_tick_callback             (GtkWidget *widget);
+void              gtk_widget_class_set_plain_draw          (GtkWidgetClass *widget_class);
+gboolean          gtk_widget_is_opaque                     (GtkWidget *widget);
+void              gtk_widget_reallocate                    (GtkWidget *widget);
+guint             gtk_widget_add_mapped_tick_callback      (GtkWidget       *widget,
+                                                            GtkTickCallback  callback,
+                                                            gpointer         user_data,
+                                                            GDestroyNotify   notify);
 
 void              gtk_widget_set_csd_input_shape           (GtkWidget            *widget,
                                                             const cairo_region_t *region);
@@ -9768,6 +9768,31 @@ gtk_window_compute_hints (GtkWindow   *window,
  * Redrawing functions *
  ***********************/
 
+/* Returns %TRUE if the window contents below the current clip
+ * of @cr are entirely hidden by an opaque child.
+ */
+static gboolean
+gtk_window_child_covers_clip (GtkWindow *window,
+                              cairo_t   *cr)
+{
+  GtkWidget *child;
+  GtkAllocation allocation;
+  GdkRectangle clip;
+
+  child = gtk_bin_get_child (GTK_BIN (window));
+  if (child == NULL ||
+      !gdk_cairo_get_clip_rectangle (cr, &clip) ||
+      !gtk_widget_is_opaque (child))
+    return FALSE;
+
+  _gtk_widget_get_allocation (child, &allocation);
+
+  return clip.x >= allocation.x &&
+         clip.y >= allocation.y &&
+         clip.x + clip.width <= allocation.x + allocation.width &&
+         clip.y + clip.height <= allocation.y + allocation.height;
+}
+
 static gboolean
 gtk_window_draw (GtkWidget *widget,
 		 cairo_t   *cr)
@@ -9785,7 +9810,8 @@ gtk_window_draw (GtkWidget *widget,
   _gtk_widget_get_allocation (widget, &allocation);
 
   if (!gtk_widget_get_app_paintable (widget) &&
-      gtk_cairo_should_draw_window (cr, _gtk_widget_get_window (widget)))
+      gtk_cairo_should_draw_window (cr, _gtk_widget_get_window (widget)) &&
+      !gtk_window_child_covers_clip (GTK_WINDOW (widget), cr))
     {
       if (priv->client_decorated &&
           priv->decorated &&
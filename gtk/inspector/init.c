@@ -33,6 +33,7 @@
 #include "general.h"
 #include "gestures.h"
 #include "graphdata.h"
+#include "layout-trace.h"
 #include "magnifier.h"
 #include "menu.h"
 #include "misc-info.h"
@@ -66,6 +67,7 @@ gtk_inspector_init (void)
   g_type_ensure (GTK_TYPE_INSPECTOR_DATA_LIST);
   g_type_ensure (GTK_TYPE_INSPECTOR_GENERAL);
   g_type_ensure (GTK_TYPE_INSPECTOR_GESTURES);
+  g_type_ensure (GTK_TYPE_INSPECTOR_LAYOUT_TRACE);
   g_type_ensure (GTK_TYPE_MAGNIFIER);
   g_type_ensure (GTK_TYPE_INSPECTOR_MAGNIFIER);
   g_type_ensure (GTK_TYPE_INSPECTOR_MENU);
@@ -0,0 +1,299 @@
+/* GTK - The GIMP Toolkit
+ * Copyright (C) 2015 The GTK+ Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include <glib/gi18n-lib.h>
+
+#include "layout-trace.h"
+
+#include "gtklayouttraceprivate.h"
+#include "gtkliststore.h"
+#include "gtktextbuffer.h"
+#include "gtktextview.h"
+#include "gtktogglebutton.h"
+#include "gtktreeselection.h"
+#include "gtktreeview.h"
+
+enum
+{
+  PROP_0,
+  PROP_BUTTON
+};
+
+enum
+{
+  COLUMN_WIDGET,
+  COLUMN_NAME,
+  COLUMN_QUEUED,
+  COLUMN_INVALIDATED,
+  COLUMN_MEASURED,
+  COLUMN_CACHE_HITS,
+  COLUMN_MEASURE_TIME,
+  COLUMN_ALLOCATED,
+  COLUMN_ALLOCATE_TIME,
+  COLUMN_LAST_ORIGIN,
+  COLUMN_LAST_BACKTRACE
+};
+
+struct _GtkInspectorLayoutTracePrivate
+{
+  GtkListStore *model;
+  GtkTreeView *view;
+  GtkTextBuffer *details;
+  GtkWidget *button;
+  GHashTable *rows;
+  guint generation;
+  guint update_source_id;
+};
+
+typedef struct {
+  GtkTreeIter iter;
+  guint generation;
+} RowData;
+
+G_DEFINE_TYPE_WITH_PRIVATE (GtkInspectorLayoutTrace, gtk_inspector_layout_trace, GTK_TYPE_BOX)
+
+static void
+update_row (GtkWidget                 *widget,
+            const GtkLayoutTraceStats *stats,
+            gpointer                   data)
+{
+  GtkInspectorLayoutTrace *lt = data;
+  RowData *row;
+  gchar *name;
+
+  /* Don't report on ourselves */
+  if (gtk_widget_get_toplevel (widget) == gtk_widget_get_toplevel (GTK_WIDGET (lt)))
+    return;
+
+  row = g_hash_table_lookup (lt->priv->rows, widget);
+  if (row == NULL)
+    {
+      row = g_slice_new (RowData);
+      gtk_list_store_append (lt->priv->model, &row->iter);
+      g_hash_table_insert (lt->priv->rows, widget, row);
+    }
+  row->generation = lt->priv->generation;
+
+  name = g_strdup_printf ("%s %p", G_OBJECT_TYPE_NAME (widget), widget);
+  gtk_list_store_set (lt->priv->model, &row->iter,
+                      COLUMN_WIDGET, widget,
+                      COLUMN_NAME, name,
+                      COLUMN_QUEUED, stats->n_queued,
+                      COLUMN_INVALIDATED, stats->n_invalidated,
+                      COLUMN_MEASURED, stats->n_measured,
+                      COLUMN_CACHE_HITS, stats->n_cache_hits,
+                      COLUMN_MEASURE_TIME, stats->measure_time,
+                      COLUMN_ALLOCATED, stats->n_allocated,
+                      COLUMN_ALLOCATE_TIME, stats->allocate_time,
+                      COLUMN_LAST_ORIGIN, stats->last_origin,
+                      COLUMN_LAST_BACKTRACE, stats->last_backtrace,
+                      -1);
+  g_free (name);
+}
+
+static gboolean
+update_rows (gpointer data)
+{
+  GtkInspectorLayoutTrace *lt = data;
+  GHashTableIter iter;
+  RowData *row;
+
+  lt->priv->generation++;
+  gtk_layout_trace_foreach (update_row, lt);
+
+  /* Drop the rows of widgets that went away */
+  g_hash_table_iter_init (&iter, lt->priv->rows);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *)&row))
+    {
+      if (row->generation != lt->priv->generation)
+        {
+          gtk_list_store_remove (lt->priv->model, &row->iter);
+          g_hash_table_iter_remove (&iter);
+        }
+    }
+
+  return TRUE;
+}
+
+static void
+clear_rows (GtkInspectorLayoutTrace *lt)
+{
+  g_hash_table_remove_all (lt->priv->rows);
+  gtk_list_store_clear (lt->priv->model);
+  gtk_text_buffer_set_text (lt->priv->details, "", -1);
+}
+
+static void
+toggle_record (GtkToggleButton         *button,
+               GtkInspectorLayoutTrace *lt)
+{
+  if (gtk_toggle_button_get_active (button) == (lt->priv->update_source_id != 0))
+    return;
+
+  if (gtk_toggle_button_get_active (button))
+    {
+      gtk_layout_trace_reset ();
+      clear_rows (lt);
+      gtk_layout_trace_set_recording (TRUE);
+      lt->priv->update_source_id = gdk_threads_add_timeout_seconds (1,
+                                                                    update_rows,
+                                                                    lt);
+    }
+  else
+    {
+      gtk_layout_trace_set_recording (FALSE);
+      g_source_remove (lt->priv->update_source_id);
+      lt->priv->update_source_id = 0;
+      update_rows (lt);
+    }
+}
+
+static void
+selection_changed (GtkTreeSelection        *selection,
+                   GtkInspectorLayoutTrace *lt)
+{
+  GtkTreeModel *model;
+  GtkTreeIter iter;
+  gchar *origin, *backtrace, *text;
+
+  if (!gtk_tree_selection_get_selected (selection, &model, &iter))
+    {
+      gtk_text_buffer_set_text (lt->priv->details, "", -1);
+      return;
+    }
+
+  gtk_tree_model_get (model, &iter,
+                      COLUMN_LAST_ORIGIN, &origin,
+                      COLUMN_LAST_BACKTRACE, &backtrace,
+                      -1);
+
+  text = g_strdup_printf ("%s %s\n\n%s\n%s",
+                          _("Last invalidated by:"), origin ? origin : "-",
+                          _("Last resize queued at:"), backtrace ? backtrace : "-");
+  gtk_text_buffer_set_text (lt->priv->details, text, -1);
+
+  g_free (text);
+  g_free (origin);
+  g_free (backtrace);
+}
+
+static void
+row_data_free (gpointer data)
+{
+  g_slice_free (RowData, data);
+}
+
+static void
+gtk_inspector_layout_trace_init (GtkInspectorLayoutTrace *lt)
+{
+  lt->priv = gtk_inspector_layout_trace_get_instance_private (lt);
+  gtk_widget_init_template (GTK_WIDGET (lt));
+
+  lt->priv->rows = g_hash_table_new_full (NULL, NULL, NULL, row_data_free);
+
+  g_signal_connect (gtk_tree_view_get_selection (lt->priv->view), "changed",
+                    G_CALLBACK (selection_changed), lt);
+}
+
+static void
+constructed (GObject *object)
+{
+  GtkInspectorLayoutTrace *lt = GTK_INSPECTOR_LAYOUT_TRACE (object);
+
+  g_signal_connect (lt->priv->button, "toggled",
+                    G_CALLBACK (toggle_record), lt);
+}
+
+static void
+finalize (GObject *object)
+{
+  GtkInspectorLayoutTrace *lt = GTK_INSPECTOR_LAYOUT_TRACE (object);
+
+  if (lt->priv->update_source_id)
+    {
+      g_source_remove (lt->priv->update_source_id);
+      gtk_layout_trace_set_recording (FALSE);
+    }
+
+  g_hash_table_unref (lt->priv->rows);
+
+  G_OBJECT_CLASS (gtk_inspector_layout_trace_parent_class)->finalize (object);
+}
+
+static void
+get_property (GObject    *object,
+              guint       param_id,
+              GValue     *value,
+              GParamSpec *pspec)
+{
+  GtkInspectorLayoutTrace *lt = GTK_INSPECTOR_LAYOUT_TRACE (object);
+
+  switch (param_id)
+    {
+    case PROP_BUTTON:
+      g_value_set_object (value, lt->priv->button);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, param_id, pspec);
+      break;
+    }
+}
+
+static void
+set_property (GObject      *object,
+              guint         param_id,
+              const GValue *value,
+              GParamSpec   *pspec)
+{
+  GtkInspectorLayoutTrace *lt = GTK_INSPECTOR_LAYOUT_TRACE (object);
+
+  switch (param_id)
+    {
+    case PROP_BUTTON:
+      lt->priv->button = g_value_get_object (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, param_id, pspec);
+      break;
+    }
+}
+
+static void
+gtk_inspector_layout_trace_class_init (GtkInspectorLayoutTraceClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
+
+  object_class->get_property = get_property;
+  object_class->set_property = set_property;
+  object_class->constructed = constructed;
+  object_class->finalize = finalize;
+
+  g_object_class_install_property (object_class, PROP_BUTTON,
+      g_param_spec_object ("button", NULL, NULL,
+                           GTK_TYPE_WIDGET, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+
+  gtk_widget_class_set_template_from_resource (widget_class, "/org/gtk/libgtk/inspector/layout-trace.ui");
+  gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorLayoutTrace, model);
+  gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorLayoutTrace, view);
+  gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorLayoutTrace, details);
+}
+
+// vim: set et sw=2 ts=2:
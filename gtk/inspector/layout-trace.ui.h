@@ -0,0 +1,8 @@
+N_("Widget");
+N_("Queued");
+N_("Invalidated");
+N_("Measured");
+N_("Cached");
+N_("Measure (µs)");
+N_("Allocated");
+N_("Allocate (µs)");
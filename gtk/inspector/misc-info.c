@@ -55,6 +55,8 @@ struct _GtkInspectorMiscInfoPrivate {
   GtkWidget *allocated_size;
   GtkWidget *clip_area_row;
   GtkWidget *clip_area;
+  GtkWidget *size_cache_row;
+  GtkWidget *size_cache;
   GtkWidget *tick_callback_row;
   GtkWidget *tick_callback;
   GtkWidget *framerate_row;
@@ -298,6 +300,7 @@ update_info (gpointer data)
       AtkObject *accessible;
       AtkRole role;
       GList *list, *l;
+      SizeRequestCache *cache;
 
       gtk_container_forall (GTK_CONTAINER (sl->priv->mnemonic_label), (GtkCallback)gtk_widget_destroy, NULL);
       list = gtk_widget_list_mnemonic_labels (GTK_WIDGET (sl->priv->object));
@@ -317,6 +320,17 @@ update_info (gpointer data)
 
       gtk_widget_set_visible (sl->priv->tick_callback, gtk_widget_has_tick_callback (GTK_WIDGET (sl->priv->object)));
 
+      cache = _gtk_widget_peek_request_cache (GTK_WIDGET (sl->priv->object));
+      /* Translators: Statistics of the size request cache of a widget;
+       * the last two numbers are the number of cached widths and heights.
+       */
+      tmp = g_strdup_printf (_("%u hits, %u misses, %u × %u sizes"),
+                             cache->hits, cache->misses,
+                             _gtk_size_request_cache_get_n_cached_sizes (cache, GTK_ORIENTATION_HORIZONTAL),
+                             _gtk_size_request_cache_get_n_cached_sizes (cache, GTK_ORIENTATION_VERTICAL));
+      gtk_label_set_text (GTK_LABEL (sl->priv->size_cache), tmp);
+      g_free (tmp);
+
       accessible = ATK_OBJECT (gtk_widget_get_accessible (GTK_WIDGET (sl->priv->object)));
       role = atk_object_get_role (accessible);
       gtk_label_set_text (GTK_LABEL (sl->priv->accessible_role), atk_role_get_name (role));
@@ -411,6 +425,7 @@ gtk_inspector_misc_info_set_object (GtkInspectorMiscInfo *sl,
       gtk_widget_show (sl->priv->state_row);
       gtk_widget_show (sl->priv->allocated_size_row);
       gtk_widget_show (sl->priv->mnemonic_label_row);
+      gtk_widget_show (sl->priv->size_cache_row);
       gtk_widget_show (sl->priv->tick_callback_row);
       gtk_widget_show (sl->priv->accessible_role_row);
       gtk_widget_show (sl->priv->accessible_name_row);
@@ -432,6 +447,7 @@ gtk_inspector_misc_info_set_object (GtkInspectorMiscInfo *sl,
       gtk_widget_hide (sl->priv->mnemonic_label_row);
       gtk_widget_hide (sl->priv->allocated_size_row);
       gtk_widget_hide (sl->priv->clip_area_row);
+      gtk_widget_hide (sl->priv->size_cache_row);
       gtk_widget_hide (sl->priv->tick_callback_row);
       gtk_widget_hide (sl->priv->accessible_role_row);
       gtk_widget_hide (sl->priv->accessible_name_row);
@@ -583,6 +599,8 @@ gtk_inspector_misc_info_class_init (GtkInspectorMiscInfoClass *klass)
   gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorMiscInfo, allocated_size);
   gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorMiscInfo, clip_area_row);
   gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorMiscInfo, clip_area);
+  gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorMiscInfo, size_cache_row);
+  gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorMiscInfo, size_cache);
   gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorMiscInfo, tick_callback_row);
   gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorMiscInfo, tick_callback);
   gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorMiscInfo, framecount_row);
@@ -9,6 +9,7 @@ N_("Properties");
 N_("Mnemonic Label");
 N_("Allocated size");
 N_("Clip area");
+N_("Size request cache");
 N_("Tick callback");
 N_("Frame count");
 N_("Frame rate");
@@ -2,6 +2,7 @@ N_("Select an Object");
 N_("Show Details");
 N_("Show all Objects");
 N_("Collect Statistics");
+N_("Trace Layout");
 N_("Show Details");
 N_("Show all Resources");
 N_("Miscellaneous");
@@ -22,6 +23,7 @@ N_("Gestures");
 N_("Magnifier");
 N_("Objects");
 N_("Statistics");
+N_("Layout");
 N_("Resources");
 N_("CSS");
 N_("Visual");
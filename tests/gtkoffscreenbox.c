@@ -189,30 +189,6 @@ pick_offscreen_child (GdkWindow *offscreen_window,
   return NULL;
 }
 
-static void
-offscreen_window_to_parent1 (GdkWindow       *offscreen_window,
-			     double           offscreen_x,
-			     double           offscreen_y,
-			     double          *parent_x,
-			     double          *parent_y,
-			     GtkOffscreenBox *offscreen_box)
-{
-  *parent_x = offscreen_x;
-  *parent_y = offscreen_y;
-}
-
-static void
-offscreen_window_from_parent1 (GdkWindow       *window,
-			       double           parent_x,
-			       double           parent_y,
-			       double          *offscreen_x,
-			       double          *offscreen_y,
-			       GtkOffscreenBox *offscreen_box)
-{
-  *offscreen_x = parent_x;
-  *offscreen_y = parent_y;
-}
-
 static void
 offscreen_window_to_parent2 (GdkWindow       *offscreen_window,
 			     double           offscreen_x,
@@ -313,11 +289,11 @@ gtk_offscreen_box_realize (GtkWidget *widget)
 
   gdk_offscreen_window_set_embedder (offscreen_box->offscreen_window1,
 				     window);
-
-  g_signal_connect (offscreen_box->offscreen_window1, "to-embedder",
-		    G_CALLBACK (offscreen_window_to_parent1), offscreen_box);
-  g_signal_connect (offscreen_box->offscreen_window1, "from-embedder",
-		    G_CALLBACK (offscreen_window_from_parent1), offscreen_box);
+  /* Child 1 is drawn untransformed at the origin, so GDK can
+   * translate coordinates and damage for it without signals.
+   */
+  gdk_offscreen_window_set_embedder_offset (offscreen_box->offscreen_window1,
+                                            0, 0);
 
   /* Child 2 */
   attributes.y = start_y;
@@ -623,6 +599,12 @@ static gboolean
 gtk_offscreen_box_damage (GtkWidget      *widget,
                           GdkEventExpose *event)
 {
+  GtkOffscreenBox *offscreen_box = GTK_OFFSCREEN_BOX (widget);
+
+  /* Already invalidated by GDK, see gtk_offscreen_box_realize() */
+  if (event->window == offscreen_box->offscreen_window1)
+    return TRUE;
+
   gdk_window_invalidate_rect (gtk_widget_get_window (widget),
                               NULL, FALSE);
 
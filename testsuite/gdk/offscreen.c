@@ -0,0 +1,89 @@
+/* GTK - The GIMP Toolkit
+ * Copyright (C) 2015 The GTK+ Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gdk/gdk.h>
+
+static void
+count_signal (gint *count)
+{
+  (*count)++;
+}
+
+static GdkWindow *
+create_window (GdkWindowType type)
+{
+  GdkWindowAttr attributes;
+
+  attributes.window_type = type;
+  attributes.wclass = GDK_INPUT_OUTPUT;
+  attributes.x = 0;
+  attributes.y = 0;
+  attributes.width = 100;
+  attributes.height = 100;
+  attributes.event_mask = 0;
+
+  return gdk_window_new (NULL, &attributes, GDK_WA_X | GDK_WA_Y);
+}
+
+static void
+test_embedder_offset (void)
+{
+  GdkWindow *embedder, *offscreen;
+  gdouble x, y;
+  gint n_signals = 0;
+
+  embedder = create_window (GDK_WINDOW_TOPLEVEL);
+  offscreen = create_window (GDK_WINDOW_OFFSCREEN);
+  gdk_offscreen_window_set_embedder (offscreen, embedder);
+
+  g_signal_connect_swapped (offscreen, "to-embedder",
+                            G_CALLBACK (count_signal), &n_signals);
+  g_signal_connect_swapped (offscreen, "from-embedder",
+                            G_CALLBACK (count_signal), &n_signals);
+
+  gdk_offscreen_window_set_embedder_offset (offscreen, 10, 20);
+
+  gdk_window_coords_to_parent (offscreen, 1, 2, &x, &y);
+  g_assert_cmpfloat (x, ==, 11);
+  g_assert_cmpfloat (y, ==, 22);
+
+  gdk_window_coords_from_parent (offscreen, 11, 22, &x, &y);
+  g_assert_cmpfloat (x, ==, 1);
+  g_assert_cmpfloat (y, ==, 2);
+
+  /* The offset replaces the signals */
+  g_assert_cmpint (n_signals, ==, 0);
+
+  /* Setting the embedder again drops the offset */
+  gdk_offscreen_window_set_embedder (offscreen, embedder);
+  gdk_window_coords_to_parent (offscreen, 1, 2, &x, &y);
+  g_assert_cmpint (n_signals, ==, 1);
+
+  gdk_window_destroy (offscreen);
+  gdk_window_destroy (embedder);
+}
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  gdk_init (&argc, &argv);
+
+  g_test_add_func ("/offscreen/embedder-offset", test_embedder_offset);
+
+  return g_test_run ();
+}
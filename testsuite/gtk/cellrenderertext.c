@@ -0,0 +1,147 @@
+/* GTK - The GIMP Toolkit
+ * Copyright (C) 2015 The GTK+ Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtk/gtk.h>
+
+#define LONG_TEXT "A text that is long enough to be wrapped and ellipsized"
+
+static void
+measure (GtkCellRenderer *cell,
+         GtkWidget       *widget,
+         gint            *width,
+         gint            *height)
+{
+  gint min_width;
+
+  gtk_cell_renderer_get_preferred_width (cell, widget, &min_width, width);
+  gtk_cell_renderer_get_preferred_height_for_width (cell, widget, *width, NULL, height);
+}
+
+static void
+render (GtkCellRenderer *cell,
+        GtkWidget       *widget,
+        gint             width,
+        gint             height)
+{
+  cairo_surface_t *surface;
+  GdkRectangle area = { 0, 0, width, height };
+  cairo_t *cr;
+
+  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, width, height);
+  cr = cairo_create (surface);
+  gtk_cell_renderer_render (cell, cr, widget, &area, &area, 0);
+  cairo_destroy (cr);
+  cairo_surface_destroy (surface);
+}
+
+static void
+test_measure_then_render (void)
+{
+  GtkCellRenderer *cell;
+  GtkWidget *widget;
+  GdkRectangle area, aligned;
+  gint width, height, narrow_height;
+  gint new_width, new_height;
+
+  widget = g_object_ref_sink (gtk_label_new (NULL));
+  cell = g_object_ref_sink (gtk_cell_renderer_text_new ());
+  g_object_set (cell,
+                "text", LONG_TEXT,
+                "ellipsize", PANGO_ELLIPSIZE_END,
+                "wrap-width", 100,
+                NULL);
+
+  measure (cell, widget, &width, &height);
+  gtk_cell_renderer_get_preferred_height_for_width (cell, widget, width / 2, NULL, &narrow_height);
+
+  /* Rendering ellipsizes at the width of the cell */
+  render (cell, widget, width / 2, height);
+
+  area.x = 0;
+  area.y = 0;
+  area.width = width / 2;
+  area.height = height;
+  gtk_cell_renderer_get_aligned_area (cell, widget, 0, &area, &aligned);
+  g_assert_cmpint (aligned.width, <=, area.width);
+
+  /* The layouts that are reused for measuring are not affected */
+  measure (cell, widget, &new_width, &new_height);
+  g_assert_cmpint (new_width, ==, width);
+  g_assert_cmpint (new_height, ==, height);
+
+  gtk_cell_renderer_get_preferred_height_for_width (cell, widget, width / 2, NULL, &new_height);
+  g_assert_cmpint (new_height, ==, narrow_height);
+
+  render (cell, widget, width, height);
+  measure (cell, widget, &new_width, &new_height);
+  g_assert_cmpint (new_width, ==, width);
+  g_assert_cmpint (new_height, ==, height);
+
+  g_object_unref (cell);
+  g_object_unref (widget);
+}
+
+static void
+test_widget_change (void)
+{
+  GtkCellRenderer *cell;
+  GtkWidget *widget;
+  GtkCssProvider *provider;
+  gint width, height;
+  gint new_width, new_height;
+
+  cell = g_object_ref_sink (gtk_cell_renderer_text_new ());
+  g_object_set (cell, "text", LONG_TEXT, NULL);
+
+  widget = g_object_ref_sink (gtk_label_new (NULL));
+  measure (cell, widget, &width, &height);
+  render (cell, widget, width, height);
+  g_object_unref (widget);
+
+  /* Layouts are not reused once the renderer is used elsewhere */
+  widget = g_object_ref_sink (gtk_label_new (NULL));
+  measure (cell, widget, &new_width, &new_height);
+  g_assert_cmpint (new_width, ==, width);
+  g_assert_cmpint (new_height, ==, height);
+  g_object_unref (widget);
+
+  widget = g_object_ref_sink (gtk_label_new (NULL));
+  provider = gtk_css_provider_new ();
+  gtk_css_provider_load_from_data (provider, "* { font-size: 40px; }", -1, NULL);
+  gtk_style_context_add_provider (gtk_widget_get_style_context (widget),
+                                  GTK_STYLE_PROVIDER (provider),
+                                  GTK_STYLE_PROVIDER_PRIORITY_USER);
+  g_object_unref (provider);
+
+  measure (cell, widget, &new_width, &new_height);
+  g_assert_cmpint (new_width, >, width);
+  g_assert_cmpint (new_height, >, height);
+  g_object_unref (widget);
+
+  g_object_unref (cell);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  g_test_add_func ("/cellrenderertext/measure-then-render", test_measure_then_render);
+  g_test_add_func ("/cellrenderertext/widget-change", test_widget_change);
+
+  return g_test_run ();
+}
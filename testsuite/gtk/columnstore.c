@@ -0,0 +1,319 @@
+/* GTK - The GIMP Toolkit
+ * Copyright (C) 2015 The GTK+ Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtk/gtk.h>
+
+#include "treemodel.h"
+
+enum {
+  COLUMN_INT,
+  COLUMN_DOUBLE,
+  COLUMN_STRING,
+  COLUMN_OBJECT,
+  N_COLUMNS
+};
+
+static GtkColumnStore *
+create_store (void)
+{
+  return gtk_column_store_new (N_COLUMNS,
+                               G_TYPE_INT,
+                               G_TYPE_DOUBLE,
+                               G_TYPE_STRING,
+                               G_TYPE_OBJECT);
+}
+
+static gint
+get_int (GtkColumnStore *store,
+         gint            position)
+{
+  GtkTreeIter iter;
+  gint value;
+
+  g_assert (gtk_tree_model_iter_nth_child (GTK_TREE_MODEL (store), &iter, NULL, position));
+  gtk_tree_model_get (GTK_TREE_MODEL (store), &iter, COLUMN_INT, &value, -1);
+
+  return value;
+}
+
+static void
+assert_ints (GtkColumnStore *store,
+             const gint     *values,
+             gint            n_values)
+{
+  gint i;
+
+  g_assert_cmpint (gtk_tree_model_iter_n_children (GTK_TREE_MODEL (store), NULL), ==, n_values);
+
+  for (i = 0; i < n_values; i++)
+    g_assert_cmpint (get_int (store, i), ==, values[i]);
+}
+
+static void
+column_store_test_insert_remove (void)
+{
+  GtkColumnStore *store;
+  GtkTreeIter iter, iter2;
+  GtkTreePath *path;
+  gint values[] = { 1, 2, 3 };
+  gint i;
+
+  store = create_store ();
+
+  for (i = 0; i < 3; i++)
+    {
+      gtk_column_store_append (store, &iter);
+      gtk_column_store_set (store, &iter, COLUMN_INT, i + 1, -1);
+    }
+  assert_ints (store, values, 3);
+
+  gtk_column_store_insert (store, &iter, 1);
+  gtk_column_store_set (store, &iter, COLUMN_INT, 5, -1);
+  path = gtk_tree_model_get_path (GTK_TREE_MODEL (store), &iter);
+  g_assert_cmpint (gtk_tree_path_get_indices (path)[0], ==, 1);
+  gtk_tree_path_free (path);
+
+  /* Removing returns the next row */
+  iter2 = iter;
+  g_assert (gtk_column_store_remove (store, &iter2));
+  g_assert (!gtk_column_store_iter_is_valid (store, &iter));
+  g_assert_cmpint (get_int (store, 1), ==, 2);
+  assert_ints (store, values, 3);
+
+  /* A freed row is reused empty */
+  gtk_column_store_append (store, &iter);
+  g_assert_cmpint (get_int (store, 3), ==, 0);
+
+  g_assert (gtk_tree_model_iter_nth_child (GTK_TREE_MODEL (store), &iter, NULL, 3));
+  g_assert (!gtk_column_store_remove (store, &iter));
+
+  gtk_column_store_clear (store);
+  g_assert_cmpint (gtk_tree_model_iter_n_children (GTK_TREE_MODEL (store), NULL), ==, 0);
+  g_assert (!gtk_column_store_iter_is_valid (store, &iter2));
+
+  g_object_unref (store);
+}
+
+static void
+column_store_test_values (void)
+{
+  GtkColumnStore *store;
+  GtkTreeIter iter;
+  GObject *object;
+  GValue value = G_VALUE_INIT;
+  gchar *string;
+  gdouble d;
+  gint i;
+
+  store = create_store ();
+  object = g_object_new (G_TYPE_OBJECT, NULL);
+
+  gtk_column_store_append (store, &iter);
+  gtk_column_store_set (store, &iter,
+                        COLUMN_DOUBLE, 0.5,
+                        COLUMN_STRING, "foo",
+                        COLUMN_OBJECT, object,
+                        -1);
+
+  /* Transformable values are accepted */
+  g_value_init (&value, G_TYPE_UINT);
+  g_value_set_uint (&value, 42);
+  gtk_column_store_set_value (store, &iter, COLUMN_INT, &value);
+  g_value_unset (&value);
+
+  g_object_unref (object);
+
+  gtk_tree_model_get (GTK_TREE_MODEL (store), &iter,
+                      COLUMN_INT, &i,
+                      COLUMN_DOUBLE, &d,
+                      COLUMN_STRING, &string,
+                      COLUMN_OBJECT, &object,
+                      -1);
+  g_assert_cmpint (i, ==, 42);
+  g_assert_cmpfloat (d, ==, 0.5);
+  g_assert_cmpstr (string, ==, "foo");
+  g_assert (G_IS_OBJECT (object));
+  g_free (string);
+
+  g_object_add_weak_pointer (object, (gpointer *) &object);
+  g_object_unref (object);
+
+  gtk_column_store_set (store, &iter,
+                        COLUMN_STRING, NULL,
+                        COLUMN_OBJECT, NULL,
+                        -1);
+  g_assert (object == NULL);
+
+  gtk_tree_model_get (GTK_TREE_MODEL (store), &iter, COLUMN_STRING, &string, -1);
+  g_assert (string == NULL);
+
+  g_object_unref (store);
+}
+
+static void
+column_store_test_bulk (void)
+{
+  GtkColumnStore *store;
+  SignalMonitor *monitor;
+  GtkTreeIter iter;
+  gint ints[] = { 3, 1, 2 };
+  gdouble doubles[] = { 0.25, 0.5, 0.75 };
+  const gchar *strings[] = { "a", "b", "a" };
+  gchar *string;
+  gdouble d;
+  gint i;
+
+  store = create_store ();
+  monitor = signal_monitor_new (GTK_TREE_MODEL (store));
+
+  signal_monitor_append_signal (monitor, ROW_INSERTED, "0");
+  signal_monitor_append_signal (monitor, ROW_INSERTED, "1");
+  signal_monitor_append_signal (monitor, ROW_INSERTED, "2");
+  gtk_column_store_append_rows (store, 3);
+  signal_monitor_assert_is_empty (monitor);
+
+  signal_monitor_append_signal (monitor, ROW_CHANGED, "0");
+  signal_monitor_append_signal (monitor, ROW_CHANGED, "1");
+  signal_monitor_append_signal (monitor, ROW_CHANGED, "2");
+  gtk_column_store_set_column (store, COLUMN_INT, 0, 3, ints);
+  signal_monitor_assert_is_empty (monitor);
+
+  signal_monitor_append_signal (monitor, ROW_CHANGED, "1");
+  signal_monitor_append_signal (monitor, ROW_CHANGED, "2");
+  gtk_column_store_set_column (store, COLUMN_DOUBLE, 1, 2, doubles);
+  signal_monitor_assert_is_empty (monitor);
+
+  signal_monitor_append_signal (monitor, ROW_CHANGED, "0");
+  signal_monitor_append_signal (monitor, ROW_CHANGED, "1");
+  signal_monitor_append_signal (monitor, ROW_CHANGED, "2");
+  gtk_column_store_set_column (store, COLUMN_STRING, 0, 3, strings);
+  signal_monitor_assert_is_empty (monitor);
+
+  assert_ints (store, ints, 3);
+
+  for (i = 0; i < 3; i++)
+    {
+      g_assert (gtk_tree_model_iter_nth_child (GTK_TREE_MODEL (store), &iter, NULL, i));
+      gtk_tree_model_get (GTK_TREE_MODEL (store), &iter,
+                          COLUMN_DOUBLE, &d,
+                          COLUMN_STRING, &string,
+                          -1);
+      g_assert_cmpfloat (d, ==, i == 0 ? 0.0 : doubles[i - 1]);
+      g_assert_cmpstr (string, ==, strings[i]);
+      g_free (string);
+    }
+
+  signal_monitor_free (monitor);
+  g_object_unref (store);
+}
+
+static gint
+reverse_compare (GtkTreeModel *model,
+                 GtkTreeIter  *a,
+                 GtkTreeIter  *b,
+                 gpointer      data)
+{
+  gint value_a, value_b;
+
+  gtk_tree_model_get (model, a, COLUMN_INT, &value_a, -1);
+  gtk_tree_model_get (model, b, COLUMN_INT, &value_b, -1);
+
+  return value_b - value_a;
+}
+
+static void
+column_store_test_sort (void)
+{
+  GtkColumnStore *store;
+  SignalMonitor *monitor;
+  GtkTreeIter iter, first;
+  GtkTreePath *path;
+  gint ints[] = { 3, 1, 4, 1, 5 };
+  const gchar *strings[] = { "b", "d", "a", NULL, "c" };
+  gint sorted[] = { 1, 1, 3, 4, 5 };
+  gint by_string[] = { 1, 4, 3, 5, 1 };
+  gint reversed[] = { 5, 4, 3, 1, 1 };
+  gint moved[] = { 1, 3, 4, 5, 6 };
+  gint new_order[] = { 1, 3, 0, 2, 4 };
+
+  store = create_store ();
+  gtk_column_store_append_rows (store, 5);
+  gtk_column_store_set_column (store, COLUMN_INT, 0, 5, ints);
+  gtk_column_store_set_column (store, COLUMN_STRING, 0, 5, strings);
+  g_assert (gtk_tree_model_get_iter_first (GTK_TREE_MODEL (store), &first));
+
+  monitor = signal_monitor_new (GTK_TREE_MODEL (store));
+  path = gtk_tree_path_new ();
+  signal_monitor_append_signal_reordered (monitor, ROWS_REORDERED, path, new_order, 5);
+  gtk_tree_path_free (path);
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (store), COLUMN_INT, GTK_SORT_ASCENDING);
+  signal_monitor_assert_is_empty (monitor);
+  signal_monitor_free (monitor);
+  assert_ints (store, sorted, 5);
+
+  /* Iters persist */
+  g_assert (gtk_column_store_iter_is_valid (store, &first));
+  g_assert_cmpint (get_int (store, 2), ==, 3);
+
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (store), COLUMN_STRING, GTK_SORT_ASCENDING);
+  assert_ints (store, by_string, 5);
+
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (store), COLUMN_INT, GTK_SORT_DESCENDING);
+  assert_ints (store, reversed, 5);
+
+  gtk_tree_sortable_set_sort_func (GTK_TREE_SORTABLE (store), COLUMN_DOUBLE,
+                                   reverse_compare, NULL, NULL);
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (store), COLUMN_DOUBLE, GTK_SORT_DESCENDING);
+  assert_ints (store, sorted, 5);
+
+  /* Changed rows are moved into place */
+  g_assert (gtk_tree_model_iter_nth_child (GTK_TREE_MODEL (store), &iter, NULL, 0));
+  gtk_column_store_set (store, &iter, COLUMN_INT, 6, -1);
+  assert_ints (store, moved, 5);
+
+  gtk_column_store_append (store, &iter);
+  gtk_column_store_set (store, &iter, COLUMN_INT, 2, -1);
+  g_assert_cmpint (get_int (store, 1), ==, 2);
+
+  /* So are changed strings */
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (store), COLUMN_STRING, GTK_SORT_ASCENDING);
+  g_assert (gtk_tree_model_iter_nth_child (GTK_TREE_MODEL (store), &iter, NULL, 0));
+  gtk_column_store_set (store, &iter, COLUMN_STRING, "e", -1);
+  path = gtk_tree_model_get_path (GTK_TREE_MODEL (store), &iter);
+  g_assert_cmpint (gtk_tree_path_get_indices (path)[0], ==, 5);
+  gtk_tree_path_free (path);
+
+  gtk_column_store_set (store, &iter, COLUMN_STRING, "b", -1);
+  path = gtk_tree_model_get_path (GTK_TREE_MODEL (store), &iter);
+  g_assert_cmpint (gtk_tree_path_get_indices (path)[0], ==, 3);
+  gtk_tree_path_free (path);
+
+  g_object_unref (store);
+}
+
+void
+register_column_store_tests (void)
+{
+  g_test_add_func ("/ColumnStore/insert-remove",
+                   column_store_test_insert_remove);
+  g_test_add_func ("/ColumnStore/values",
+                   column_store_test_values);
+  g_test_add_func ("/ColumnStore/bulk",
+                   column_store_test_bulk);
+  g_test_add_func ("/ColumnStore/sort",
+                   column_store_test_sort);
+}
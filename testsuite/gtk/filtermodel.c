@@ -2487,6 +2487,94 @@ insert_child (void)
   gtk_widget_destroy (tree_view);
 }
 
+static void
+insert_batched_unbuilt (void)
+{
+  GtkListStore *store;
+  GtkTreeModel *filter;
+  SignalMonitor *monitor;
+  GtkTreeIter iter;
+
+  store = gtk_list_store_new (1, G_TYPE_INT);
+  gtk_list_store_insert_with_values (store, NULL, -1, 0, 50, -1);
+
+  /* The root level is built when the first run is announced, and
+   * must leave out the second one
+   */
+  filter = gtk_tree_model_filter_new (GTK_TREE_MODEL (store), NULL);
+  monitor = signal_monitor_new (filter);
+
+  signal_monitor_append_signal (monitor, ROW_INSERTED, "0");
+  signal_monitor_append_signal (monitor, ROW_INSERTED, "1");
+  signal_monitor_append_signal (monitor, ROW_INSERTED, "2");
+
+  gtk_list_store_begin_update (store);
+  gtk_list_store_insert_with_values (store, &iter, 0, 0, 10, -1);
+  gtk_list_store_insert_with_values (store, &iter, -1, 0, 90, -1);
+  gtk_list_store_end_update (store);
+
+  signal_monitor_assert_is_empty (monitor);
+  check_level_length (GTK_TREE_MODEL_FILTER (filter), NULL, 3);
+
+  signal_monitor_free (monitor);
+  g_object_unref (filter);
+  g_object_unref (store);
+}
+
+static void
+insert_batched_build_level (void)
+{
+  GtkTreeStore *store;
+  GtkTreeModel *filter;
+  GtkTreeIter parent, iter, removed;
+
+  store = gtk_tree_store_new (2, G_TYPE_STRING, G_TYPE_BOOLEAN);
+  gtk_tree_store_insert_with_values (store, &parent, NULL, -1,
+                                     0, "Parent", 1, TRUE, -1);
+  gtk_tree_store_insert_with_values (store, NULL, &parent, -1,
+                                     0, "Child", 1, TRUE, -1);
+  gtk_tree_store_insert_with_values (store, &removed, &parent, -1,
+                                     0, "Removed", 1, TRUE, -1);
+
+  filter = gtk_tree_model_filter_new (GTK_TREE_MODEL (store), NULL);
+  gtk_tree_model_filter_set_visible_column (GTK_TREE_MODEL_FILTER (filter),
+                                            1);
+
+  gtk_tree_store_begin_update (store);
+
+  /* Remove a row that was never announced */
+  gtk_tree_store_insert_with_values (store, &iter, &parent, 0,
+                                     0, "Gone", 1, TRUE, -1);
+  gtk_tree_store_remove (store, &iter);
+
+  /* Build the level of the parent while rows are pending: they must
+   * not be in it, they are added when they are announced
+   */
+  gtk_tree_store_insert_with_values (store, NULL, &parent, 0,
+                                     0, "First", 1, TRUE, -1);
+  gtk_tree_store_insert_with_values (store, NULL, &parent, -1,
+                                     0, "Hidden", 1, FALSE, -1);
+  gtk_tree_store_insert_with_values (store, NULL, &parent, -1,
+                                     0, "Last", 1, TRUE, -1);
+  check_level_length (GTK_TREE_MODEL_FILTER (filter), "0", 2);
+
+  /* Removing a row that was announced announces the pending ones */
+  gtk_tree_store_remove (store, &removed);
+  check_level_length (GTK_TREE_MODEL_FILTER (filter), "0", 3);
+
+  gtk_tree_store_insert_with_values (store, NULL, &parent, 1,
+                                     0, "Second", 1, TRUE, -1);
+  check_level_length (GTK_TREE_MODEL_FILTER (filter), "0", 3);
+
+  gtk_tree_store_end_update (store);
+
+  check_level_length (GTK_TREE_MODEL_FILTER (filter), "0", 4);
+  g_assert_cmpint (gtk_tree_model_iter_n_children (GTK_TREE_MODEL (store), &parent), ==, 5);
+
+  g_object_unref (filter);
+  g_object_unref (store);
+}
+
 
 
 static void
@@ -4580,6 +4668,114 @@ ref_count_transfer_child_level_filter (void)
 }
 
 
+/*
+ * Incremental filtering
+ */
+
+static gint incremental_modulus;
+
+static gboolean
+incremental_visible_func (GtkTreeModel *model,
+                          GtkTreeIter  *iter,
+                          gpointer      data)
+{
+  gint value;
+
+  gtk_tree_model_get (model, iter, 0, &value, -1);
+
+  return value % incremental_modulus == 0;
+}
+
+/* Checks that the filter shows exactly the visible child rows */
+static void
+check_incremental_filter (GtkTreeModel *filter)
+{
+  GtkTreeModel *child;
+  GtkTreeIter iter, c_iter, f_c_iter;
+  GtkTreePath *path, *f_path;
+  gboolean valid;
+
+  child = gtk_tree_model_filter_get_model (GTK_TREE_MODEL_FILTER (filter));
+  valid = gtk_tree_model_get_iter_first (filter, &iter);
+
+  g_assert (gtk_tree_model_get_iter_first (child, &c_iter));
+  do
+    {
+      if (!incremental_visible_func (child, &c_iter, NULL))
+        continue;
+
+      g_assert (valid);
+      gtk_tree_model_filter_convert_iter_to_child_iter (GTK_TREE_MODEL_FILTER (filter),
+                                                        &f_c_iter, &iter);
+      path = gtk_tree_model_get_path (child, &c_iter);
+      f_path = gtk_tree_model_get_path (child, &f_c_iter);
+      g_assert_cmpint (gtk_tree_path_compare (path, f_path), ==, 0);
+      gtk_tree_path_free (path);
+      gtk_tree_path_free (f_path);
+
+      valid = gtk_tree_model_iter_next (filter, &iter);
+    }
+  while (gtk_tree_model_iter_next (child, &c_iter));
+
+  g_assert (!valid);
+}
+
+static void
+incremental_filter (void)
+{
+  GtkListStore *store;
+  GtkTreeModel *filter;
+  GtkWidget *tree_view;
+  GtkTreeIter iter;
+  gint i;
+
+  store = gtk_list_store_new (1, G_TYPE_INT);
+  for (i = 0; i < 100000; i++)
+    gtk_list_store_insert_with_values (store, NULL, -1, 0, i, -1);
+
+  incremental_modulus = 3;
+  filter = gtk_tree_model_filter_new (GTK_TREE_MODEL (store), NULL);
+  gtk_tree_model_filter_set_visible_func (GTK_TREE_MODEL_FILTER (filter),
+                                          incremental_visible_func,
+                                          NULL, NULL);
+  gtk_tree_model_filter_set_incremental (GTK_TREE_MODEL_FILTER (filter), TRUE);
+  tree_view = gtk_tree_view_new_with_model (filter);
+
+  /* Rows show up as they are found */
+  g_assert_cmpint (gtk_tree_model_iter_n_children (filter, NULL), <=, 33334);
+
+  /* Changes to the child model while the pass runs */
+  gtk_list_store_insert_with_values (store, NULL, 0, 0, 0, -1);
+  g_assert (gtk_tree_model_iter_nth_child (GTK_TREE_MODEL (store), &iter, NULL, 60000));
+  gtk_list_store_remove (store, &iter);
+
+  while (gtk_events_pending ())
+    gtk_main_iteration ();
+
+  check_incremental_filter (filter);
+
+  /* Refiltering starts over */
+  incremental_modulus = 2;
+  gtk_tree_model_filter_refilter (GTK_TREE_MODEL_FILTER (filter));
+  g_assert_cmpint (gtk_tree_model_iter_n_children (filter, NULL), <=, 50001);
+
+  while (gtk_events_pending ())
+    gtk_main_iteration ();
+
+  check_incremental_filter (filter);
+
+  /* Turning the mode off finishes the pass */
+  incremental_modulus = 5;
+  gtk_tree_model_filter_refilter (GTK_TREE_MODEL_FILTER (filter));
+  gtk_tree_model_filter_set_incremental (GTK_TREE_MODEL_FILTER (filter), FALSE);
+  check_incremental_filter (filter);
+
+  gtk_widget_destroy (tree_view);
+  g_object_unref (filter);
+  g_object_unref (store);
+}
+
+
 static gboolean
 specific_path_dependent_filter_func (GtkTreeModel *model,
                                      GtkTreeIter  *iter,
@@ -7020,6 +7216,10 @@ register_filter_model_tests (void)
                    insert_before);
   g_test_add_func ("/TreeModelFilter/insert/child",
                    insert_child);
+  g_test_add_func ("/TreeModelFilter/insert/batched-unbuilt",
+                   insert_batched_unbuilt);
+  g_test_add_func ("/TreeModelFilter/insert/batched-build-level",
+                   insert_batched_build_level);
 
   /* Removals from child model after creating of filter model */
   g_test_add_func ("/TreeModelFilter/remove/node",
@@ -7082,6 +7282,9 @@ register_filter_model_tests (void)
   g_test_add_func ("/TreeModelFilter/ref-count/transfer/child-level/filter",
                    ref_count_transfer_child_level_filter);
 
+  g_test_add_func ("/TreeModelFilter/incremental",
+                   incremental_filter);
+
   g_test_add_func ("/TreeModelFilter/specific/path-dependent-filter",
                    specific_path_dependent_filter);
   g_test_add_func ("/TreeModelFilter/specific/append-after-collapse",
@@ -0,0 +1,387 @@
+/* GTK - The GIMP Toolkit
+ * Copyright (C) 2015 The GTK+ Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtk/gtk.h>
+
+static gint
+count_child_visible (GtkFlowBox *box)
+{
+  GList *children, *l;
+  gint count;
+
+  count = 0;
+  children = gtk_container_get_children (GTK_CONTAINER (box));
+  for (l = children; l; l = l->next)
+    {
+      if (gtk_widget_get_child_visible (l->data))
+        count++;
+    }
+  g_list_free (children);
+
+  return count;
+}
+
+static void
+test_fixed_size (void)
+{
+  GtkFlowBox *box;
+  GtkAdjustment *adjustment;
+  GtkAllocation allocation;
+  GtkWidget *label;
+  gint i;
+  gint min, nat, fixed_min, fixed_nat;
+
+  box = GTK_FLOW_BOX (gtk_flow_box_new ());
+  g_object_ref_sink (box);
+  gtk_widget_show (GTK_WIDGET (box));
+  gtk_flow_box_set_homogeneous (box, TRUE);
+
+  for (i = 0; i < 100; i++)
+    {
+      label = gtk_label_new ("child");
+      gtk_widget_set_size_request (label, 50, 20);
+      gtk_widget_show (label);
+      gtk_container_add (GTK_CONTAINER (box), label);
+    }
+
+  gtk_widget_get_preferred_height_for_width (GTK_WIDGET (box), 250, &min, &nat);
+
+  g_assert (!gtk_flow_box_get_fixed_size_mode (box));
+  gtk_flow_box_set_fixed_size_mode (box, TRUE);
+  g_assert (gtk_flow_box_get_fixed_size_mode (box));
+
+  /* Same children, same size */
+  gtk_widget_get_preferred_height_for_width (GTK_WIDGET (box), 250, &fixed_min, &fixed_nat);
+  g_assert_cmpint (fixed_min, ==, min);
+  g_assert_cmpint (fixed_nat, ==, nat);
+
+  adjustment = gtk_adjustment_new (0, 0, min, 10, min / 10, min / 10);
+  gtk_flow_box_set_vadjustment (box, adjustment);
+
+  allocation.x = 0;
+  allocation.y = 0;
+  allocation.width = 250;
+  allocation.height = min;
+  gtk_widget_size_allocate (GTK_WIDGET (box), &allocation);
+
+  /* Only the children on the lines in and around the first tenth are shown */
+  g_assert_cmpint (count_child_visible (box), >, 0);
+  g_assert_cmpint (count_child_visible (box), <, 100);
+
+  gtk_flow_box_set_fixed_size_mode (box, FALSE);
+  g_assert_cmpint (count_child_visible (box), ==, 100);
+
+  g_object_unref (box);
+}
+
+static void
+bind_label (GtkWidget *widget,
+            gpointer   item,
+            gpointer   data)
+{
+  gchar *text;
+
+  if (item == NULL)
+    {
+      gtk_label_set_label (GTK_LABEL (widget), "");
+      return;
+    }
+
+  text = g_strdup_printf ("%d", GPOINTER_TO_INT (g_object_get_data (item, "index")));
+  gtk_label_set_label (GTK_LABEL (widget), text);
+  g_free (text);
+}
+
+static GtkWidget *
+create_label (gpointer item,
+              gpointer data)
+{
+  GtkWidget *label;
+
+  label = gtk_label_new (NULL);
+  gtk_widget_set_size_request (label, 50, 20);
+  bind_label (label, item, data);
+
+  return label;
+}
+
+/* Checks that every child shows the item at its index, with
+ * @offset items removed from before the ones it was created for
+ */
+static void
+check_bound_children (GtkFlowBox *box,
+                      gint        offset)
+{
+  GList *children, *l;
+  GtkFlowBoxChild *child;
+  gchar *text;
+  gint idx;
+
+  children = gtk_container_get_children (GTK_CONTAINER (box));
+  for (l = children; l; l = l->next)
+    {
+      child = l->data;
+      idx = gtk_flow_box_child_get_index (child);
+      if (idx < 0)
+        continue;
+
+      g_assert (gtk_flow_box_get_child_at_index (box, idx) == child);
+
+      text = g_strdup_printf ("%d", idx + offset);
+      g_assert_cmpstr (gtk_label_get_label (GTK_LABEL (gtk_bin_get_child (GTK_BIN (child)))), ==, text);
+      g_free (text);
+    }
+  g_list_free (children);
+}
+
+static void
+test_recycling (void)
+{
+  GtkFlowBox *box;
+  GListStore *store;
+  GtkAdjustment *adjustment;
+  GtkAllocation allocation;
+  GtkFlowBoxChild *child;
+  GList *children;
+  GObject *item;
+  gint i;
+  gint min, nat;
+
+  store = g_list_store_new (G_TYPE_OBJECT);
+  for (i = 0; i < 10000; i++)
+    {
+      item = g_object_new (G_TYPE_OBJECT, NULL);
+      g_object_set_data (item, "index", GINT_TO_POINTER (i));
+      g_list_store_append (store, item);
+      g_object_unref (item);
+    }
+
+  box = GTK_FLOW_BOX (gtk_flow_box_new ());
+  g_object_ref_sink (box);
+  gtk_widget_show (GTK_WIDGET (box));
+
+  gtk_flow_box_bind_model_recycling (box, G_LIST_MODEL (store),
+                                     create_label, bind_label, NULL, NULL);
+  g_assert (gtk_flow_box_get_fixed_size_mode (box));
+
+  gtk_widget_get_preferred_height_for_width (GTK_WIDGET (box), 250, &min, &nat);
+  g_assert_cmpint (min, >, 0);
+
+  adjustment = gtk_adjustment_new (0, 0, min, 10, min / 100, min / 100);
+  gtk_flow_box_set_vadjustment (box, adjustment);
+
+  allocation.x = 0;
+  allocation.y = 0;
+  allocation.width = 250;
+  allocation.height = min;
+  gtk_widget_size_allocate (GTK_WIDGET (box), &allocation);
+
+  /* Only the items in and around the view have a child */
+  children = gtk_container_get_children (GTK_CONTAINER (box));
+  g_assert_cmpint (g_list_length (children), >, 0);
+  g_assert_cmpint (g_list_length (children), <, 1000);
+  g_list_free (children);
+
+  child = gtk_flow_box_get_child_at_index (box, 0);
+  g_assert (child != NULL);
+  g_assert (gtk_flow_box_get_child_at_index (box, 9999) == NULL);
+  check_bound_children (box, 0);
+
+  /* Children are reused for the items that scroll into view,
+   * without the hover state of the item they showed before
+   */
+  g_object_ref (child);
+  gtk_widget_set_state_flags (GTK_WIDGET (child),
+                              GTK_STATE_FLAG_PRELIGHT | GTK_STATE_FLAG_ACTIVE, FALSE);
+  gtk_adjustment_set_value (adjustment, min / 2);
+  gtk_widget_size_allocate (GTK_WIDGET (box), &allocation);
+
+  g_assert_cmpint (gtk_widget_get_state_flags (GTK_WIDGET (child)) &
+                   (GTK_STATE_FLAG_PRELIGHT | GTK_STATE_FLAG_ACTIVE), ==, 0);
+  g_object_unref (child);
+
+  children = gtk_container_get_children (GTK_CONTAINER (box));
+  g_assert_cmpint (g_list_length (children), <, 1000);
+  g_list_free (children);
+
+  g_assert (gtk_flow_box_get_child_at_index (box, 0) == NULL);
+  check_bound_children (box, 0);
+
+  /* The children after a removed item move along */
+  g_list_store_remove (store, 0);
+  gtk_widget_size_allocate (GTK_WIDGET (box), &allocation);
+
+  check_bound_children (box, 1);
+
+  /* The fixed size mode that recycling turned on goes with it */
+  gtk_flow_box_bind_model (box, G_LIST_MODEL (store), create_label, NULL, NULL);
+  g_assert (!gtk_flow_box_get_fixed_size_mode (box));
+
+  gtk_flow_box_set_fixed_size_mode (box, TRUE);
+  gtk_flow_box_bind_model_recycling (box, G_LIST_MODEL (store),
+                                     create_label, bind_label, NULL, NULL);
+  gtk_flow_box_bind_model (box, NULL, NULL, NULL, NULL);
+  g_assert (gtk_flow_box_get_fixed_size_mode (box));
+
+  g_object_unref (box);
+  g_object_unref (store);
+}
+
+static gint
+get_child_data (GtkFlowBoxChild *child)
+{
+  return GPOINTER_TO_INT (g_object_get_data (G_OBJECT (gtk_bin_get_child (GTK_BIN (child))), "data"));
+}
+
+static void
+set_child_data (GtkFlowBoxChild *child,
+                gint             data)
+{
+  g_object_set_data (G_OBJECT (gtk_bin_get_child (GTK_BIN (child))), "data", GINT_TO_POINTER (data));
+}
+
+static gint
+sort_children (GtkFlowBoxChild *child1,
+               GtkFlowBoxChild *child2,
+               gpointer         data)
+{
+  return get_child_data (child1) - get_child_data (child2);
+}
+
+static gboolean
+filter_odd (GtkFlowBoxChild *child,
+            gpointer         data)
+{
+  return get_child_data (child) % 2 == 0;
+}
+
+/* Checks that the children are sorted, and that their CSS nodes are
+ * in the same order; the style provider gives the n-th child node a
+ * left margin of n pixels.
+ */
+static void
+check_sorted (GtkFlowBox *box,
+              gboolean    check_nodes)
+{
+  GList *children, *l;
+  GtkFlowBoxChild *child;
+  GtkStyleContext *context;
+  GtkBorder margin;
+  gint n1, n2, i;
+
+  n1 = G_MININT;
+  i = 0;
+  children = gtk_container_get_children (GTK_CONTAINER (box));
+  for (l = children; l; l = l->next, i++)
+    {
+      child = l->data;
+      n2 = get_child_data (child);
+      g_assert_cmpint (n1, <=, n2);
+      n1 = n2;
+
+      if (check_nodes)
+        {
+          context = gtk_widget_get_style_context (GTK_WIDGET (child));
+          gtk_style_context_get_margin (context, gtk_style_context_get_state (context), &margin);
+          g_assert_cmpint (margin.left, ==, i + 1);
+        }
+    }
+  g_list_free (children);
+}
+
+static void
+test_sort (void)
+{
+  GtkFlowBox *box;
+  GtkFlowBoxChild *child;
+  GtkCssProvider *provider;
+  GString *css;
+  GtkWidget *label;
+  gint i;
+
+  css = g_string_new (NULL);
+  for (i = 1; i <= 20; i++)
+    g_string_append_printf (css, ".grid-child:nth-child(%d) { margin-left: %dpx; }\n", i, i);
+  provider = gtk_css_provider_new ();
+  gtk_css_provider_load_from_data (provider, css->str, -1, NULL);
+  gtk_style_context_add_provider_for_screen (gdk_screen_get_default (),
+                                             GTK_STYLE_PROVIDER (provider),
+                                             GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+  g_string_free (css, TRUE);
+
+  box = GTK_FLOW_BOX (gtk_flow_box_new ());
+  g_object_ref_sink (box);
+  gtk_widget_show (GTK_WIDGET (box));
+
+  for (i = 0; i < 20; i++)
+    {
+      label = gtk_label_new ("");
+      gtk_widget_show (label);
+      g_object_set_data (G_OBJECT (label), "data", GINT_TO_POINTER ((i * 7) % 20));
+      gtk_container_add (GTK_CONTAINER (box), label);
+    }
+
+  gtk_flow_box_set_sort_func (box, sort_children, NULL, NULL);
+  check_sorted (box, TRUE);
+
+  /* Move a few children far up and down */
+  set_child_data (gtk_flow_box_get_child_at_index (box, 1), 100);
+  set_child_data (gtk_flow_box_get_child_at_index (box, 10), -1);
+  set_child_data (gtk_flow_box_get_child_at_index (box, 18), 9);
+  gtk_flow_box_invalidate_sort (box);
+  check_sorted (box, TRUE);
+
+  /* A single child that changed moves on its own */
+  child = gtk_flow_box_get_child_at_index (box, 0);
+  set_child_data (child, 50);
+  gtk_flow_box_child_changed (child);
+  check_sorted (box, TRUE);
+  g_assert (gtk_flow_box_get_child_at_index (box, 18) == child);
+
+  child = gtk_flow_box_get_child_at_index (box, 19);
+  set_child_data (child, -5);
+  gtk_flow_box_child_changed (child);
+  check_sorted (box, TRUE);
+  g_assert (gtk_flow_box_get_child_at_index (box, 0) == child);
+
+  /* Filtering keeps the order */
+  gtk_flow_box_set_filter_func (box, filter_odd, NULL, NULL);
+  check_sorted (box, FALSE);
+  g_assert_cmpint (count_child_visible (box), <, 20);
+
+  gtk_flow_box_set_filter_func (box, NULL, NULL, NULL);
+  check_sorted (box, TRUE);
+  g_assert_cmpint (count_child_visible (box), ==, 20);
+
+  g_object_unref (box);
+
+  gtk_style_context_remove_provider_for_screen (gdk_screen_get_default (),
+                                                GTK_STYLE_PROVIDER (provider));
+  g_object_unref (provider);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  g_test_add_func ("/flowbox/fixed-size", test_fixed_size);
+  g_test_add_func ("/flowbox/recycling", test_recycling);
+  g_test_add_func ("/flowbox/sort", test_sort);
+
+  return g_test_run ();
+}
@@ -223,6 +223,47 @@ test_add (void)
   g_assert_cmpint (height, ==, 1);
 }
 
+static void
+test_remeasure (void)
+{
+  GtkGrid *g;
+  GtkWidget *a, *b;
+  gint min, nat;
+
+  g = (GtkGrid *)gtk_grid_new ();
+
+  a = gtk_label_new ("a");
+  gtk_widget_set_size_request (a, 20, 20);
+  gtk_grid_attach (g, a, 0, 0, 1, 1);
+  b = gtk_label_new ("b");
+  gtk_widget_set_size_request (b, 30, 20);
+  gtk_grid_attach (g, b, 1, 0, 1, 1);
+  gtk_widget_show_all (GTK_WIDGET (g));
+
+  gtk_widget_get_preferred_width (GTK_WIDGET (g), &min, &nat);
+  g_assert_cmpint (min, ==, 50);
+
+  /* Only the column of a changes; the column of b is reused */
+  gtk_widget_set_size_request (a, 40, 20);
+  gtk_widget_get_preferred_width (GTK_WIDGET (g), &min, &nat);
+  g_assert_cmpint (min, ==, 70);
+
+  gtk_widget_set_size_request (b, 10, 20);
+  gtk_widget_get_preferred_width (GTK_WIDGET (g), &min, &nat);
+  g_assert_cmpint (min, ==, 50);
+
+  gtk_grid_insert_column (g, 1);
+  gtk_widget_get_preferred_width (GTK_WIDGET (g), &min, &nat);
+  g_assert_cmpint (min, ==, 50);
+
+  gtk_widget_hide (a);
+  gtk_widget_get_preferred_width (GTK_WIDGET (g), &min, &nat);
+  g_assert_cmpint (min, ==, 10);
+
+  g_object_ref_sink (g);
+  g_object_unref (g);
+}
+
 int
 main (int   argc,
       char *argv[])
@@ -231,6 +272,7 @@ main (int   argc,
 
   g_test_add_func ("/grid/attach", test_attach);
   g_test_add_func ("/grid/add", test_add);
+  g_test_add_func ("/grid/remeasure", test_remeasure);
 
   return g_test_run();
 }
@@ -434,6 +434,361 @@ test_header (void)
   g_object_unref (list);
 }
 
+static gint
+get_row_data (GtkListBoxRow *row)
+{
+  return GPOINTER_TO_INT (g_object_get_data (G_OBJECT (gtk_bin_get_child (GTK_BIN (row))), "data"));
+}
+
+static void
+set_row_data (GtkListBoxRow *row,
+              gint           data)
+{
+  g_object_set_data (G_OBJECT (gtk_bin_get_child (GTK_BIN (row))), "data", GINT_TO_POINTER (data));
+}
+
+/* Rows get a header at the start of every group of ten */
+static void
+group_header_func (GtkListBoxRow *row,
+                   GtkListBoxRow *before,
+                   gpointer       data)
+{
+  gint *count = data;
+
+  (*count)++;
+
+  if (before == NULL || get_row_data (before) / 10 != get_row_data (row) / 10)
+    {
+      if (gtk_list_box_row_get_header (row) == NULL)
+        gtk_list_box_row_set_header (row, gtk_label_new ("Group"));
+    }
+  else
+    gtk_list_box_row_set_header (row, NULL);
+}
+
+static gboolean
+group_filter_func (GtkListBoxRow *row,
+                   gpointer       data)
+{
+  gint *hidden_group = data;
+
+  return get_row_data (row) / 10 != *hidden_group;
+}
+
+static void
+check_groups (GtkListBox *list)
+{
+  GList *children, *l;
+  GtkListBoxRow *row, *before;
+  gint n1, n2;
+
+  before = NULL;
+  children = gtk_container_get_children (GTK_CONTAINER (list));
+  for (l = children; l; l = l->next)
+    {
+      row = l->data;
+      if (!gtk_widget_get_child_visible (GTK_WIDGET (row)))
+        {
+          g_assert (gtk_list_box_row_get_header (row) == NULL);
+          continue;
+        }
+
+      n2 = get_row_data (row);
+      if (before == NULL)
+        g_assert (gtk_list_box_row_get_header (row) != NULL);
+      else
+        {
+          n1 = get_row_data (before);
+          g_assert_cmpint (n1, <=, n2);
+          g_assert ((gtk_list_box_row_get_header (row) != NULL) == (n1 / 10 != n2 / 10));
+        }
+
+      before = row;
+    }
+  g_list_free (children);
+}
+
+static void
+test_incremental (void)
+{
+  GtkListBox *list;
+  GtkListBoxRow *row;
+  GtkWidget *label;
+  gint sort_count, header_count, hidden_group;
+  gint i;
+
+  list = GTK_LIST_BOX (gtk_list_box_new ());
+  g_object_ref_sink (list);
+  gtk_widget_show (GTK_WIDGET (list));
+
+  for (i = 0; i < 1000; i++)
+    {
+      label = gtk_label_new ("");
+      g_object_set_data (G_OBJECT (label), "data", GINT_TO_POINTER (i));
+      gtk_container_add (GTK_CONTAINER (list), label);
+    }
+
+  sort_count = 0;
+  header_count = 0;
+  hidden_group = -1;
+  gtk_list_box_set_sort_func (list, sort_list, &sort_count, NULL);
+  gtk_list_box_set_header_func (list, group_header_func, &header_count, NULL);
+  gtk_list_box_set_filter_func (list, group_filter_func, &hidden_group, NULL);
+  check_groups (list);
+
+  /* Move a few rows far up and down; only those get relocated */
+  set_row_data (gtk_list_box_get_row_at_index (list, 10), 995);
+  set_row_data (gtk_list_box_get_row_at_index (list, 500), 3);
+  set_row_data (gtk_list_box_get_row_at_index (list, 990), 42);
+
+  sort_count = 0;
+  header_count = 0;
+  gtk_list_box_invalidate_sort (list);
+  check_sorted (list);
+  check_groups (list);
+  g_assert_cmpint (sort_count, <, 2000);
+  g_assert_cmpint (header_count, <, 20);
+
+  /* A single row that changed moves on its own */
+  row = gtk_list_box_get_row_at_index (list, 0);
+  set_row_data (row, 500);
+  sort_count = 0;
+  header_count = 0;
+  gtk_list_box_row_changed (row);
+  check_sorted (list);
+  check_groups (list);
+  g_assert_cmpint (sort_count, <, 50);
+  g_assert_cmpint (header_count, <, 5);
+
+  /* Hiding a group only touches the rows around it */
+  hidden_group = 50;
+  header_count = 0;
+  gtk_list_box_invalidate_filter (list);
+  check_groups (list);
+  g_assert_cmpint (header_count, <, 30);
+
+  hidden_group = -1;
+  header_count = 0;
+  gtk_list_box_invalidate_filter (list);
+  check_groups (list);
+  g_assert_cmpint (header_count, <, 30);
+
+  g_object_unref (list);
+}
+
+static gint
+count_child_visible (GtkListBox *list)
+{
+  GList *children, *l;
+  gint count;
+
+  count = 0;
+  children = gtk_container_get_children (GTK_CONTAINER (list));
+  for (l = children; l; l = l->next)
+    {
+      if (gtk_widget_get_child_visible (l->data))
+        count++;
+    }
+  g_list_free (children);
+
+  return count;
+}
+
+static void
+test_fixed_height (void)
+{
+  GtkListBox *list;
+  GtkAdjustment *adjustment;
+  GtkAllocation allocation;
+  GtkWidget *label;
+  gint i;
+  gint min, nat, fixed_min, fixed_nat;
+
+  list = GTK_LIST_BOX (gtk_list_box_new ());
+  g_object_ref_sink (list);
+  gtk_widget_show (GTK_WIDGET (list));
+
+  for (i = 0; i < 100; i++)
+    {
+      label = gtk_label_new ("row");
+      gtk_widget_set_size_request (label, 50, 20);
+      gtk_container_add (GTK_CONTAINER (list), label);
+    }
+
+  gtk_widget_get_preferred_height_for_width (GTK_WIDGET (list), 100, &min, &nat);
+
+  g_assert (!gtk_list_box_get_fixed_height_mode (list));
+  gtk_list_box_set_fixed_height_mode (list, TRUE);
+  g_assert (gtk_list_box_get_fixed_height_mode (list));
+
+  gtk_widget_get_preferred_height_for_width (GTK_WIDGET (list), 100, &fixed_min, &fixed_nat);
+  g_assert_cmpint (fixed_min, ==, min);
+  g_assert_cmpint (fixed_nat, ==, nat);
+
+  adjustment = gtk_adjustment_new (0, 0, min, 10, min / 10, min / 10);
+  gtk_list_box_set_adjustment (list, adjustment);
+
+  allocation.x = 0;
+  allocation.y = 0;
+  allocation.width = 100;
+  allocation.height = min;
+  gtk_widget_size_allocate (GTK_WIDGET (list), &allocation);
+
+  /* Only the rows in and around the first tenth are shown */
+  g_assert_cmpint (count_child_visible (list), >, 0);
+  g_assert_cmpint (count_child_visible (list), <, 100);
+  g_assert (gtk_list_box_get_row_at_y (list, min - 1) == gtk_list_box_get_row_at_index (list, 99));
+
+  gtk_list_box_set_fixed_height_mode (list, FALSE);
+  g_assert_cmpint (count_child_visible (list), ==, 100);
+
+  g_object_unref (list);
+}
+
+static gint n_binds;
+
+static void
+bind_label (GtkWidget *widget,
+            gpointer   item,
+            gpointer   data)
+{
+  gchar *text;
+
+  if (item == NULL)
+    {
+      gtk_label_set_label (GTK_LABEL (widget), "");
+      return;
+    }
+
+  n_binds++;
+
+  text = g_strdup_printf ("%d", GPOINTER_TO_INT (g_object_get_data (item, "index")));
+  gtk_label_set_label (GTK_LABEL (widget), text);
+  g_free (text);
+}
+
+static GtkWidget *
+create_label (gpointer item,
+              gpointer data)
+{
+  GtkWidget *label;
+
+  label = gtk_label_new (NULL);
+  gtk_widget_set_size_request (label, 50, 20);
+  bind_label (label, item, data);
+
+  return label;
+}
+
+static const gchar *
+get_row_text (GtkListBoxRow *row)
+{
+  return gtk_label_get_label (GTK_LABEL (gtk_bin_get_child (GTK_BIN (row))));
+}
+
+static void
+test_recycling (void)
+{
+  GtkListBox *list;
+  GListStore *store;
+  GtkAdjustment *adjustment;
+  GtkAllocation allocation;
+  GtkListBoxRow *row;
+  GList *children;
+  GObject *item;
+  gint i;
+  gint min, nat, row_height;
+
+  store = g_list_store_new (G_TYPE_OBJECT);
+  for (i = 0; i < 10000; i++)
+    {
+      item = g_object_new (G_TYPE_OBJECT, NULL);
+      g_object_set_data (item, "index", GINT_TO_POINTER (i));
+      g_list_store_append (store, item);
+      g_object_unref (item);
+    }
+
+  list = GTK_LIST_BOX (gtk_list_box_new ());
+  g_object_ref_sink (list);
+  gtk_widget_show (GTK_WIDGET (list));
+
+  gtk_list_box_bind_model_recycling (list, G_LIST_MODEL (store),
+                                     create_label, bind_label, NULL, NULL);
+  g_assert (gtk_list_box_get_fixed_height_mode (list));
+
+  /* Every item takes the space of the first one */
+  gtk_widget_get_preferred_height_for_width (GTK_WIDGET (list), 100, &min, &nat);
+  row_height = min / 10000;
+  g_assert_cmpint (row_height, >, 0);
+  g_assert_cmpint (min, ==, 10000 * row_height);
+
+  adjustment = gtk_adjustment_new (0, 0, min, 10, 10 * row_height, 10 * row_height);
+  gtk_list_box_set_adjustment (list, adjustment);
+
+  allocation.x = 0;
+  allocation.y = 0;
+  allocation.width = 100;
+  allocation.height = min;
+  gtk_widget_size_allocate (GTK_WIDGET (list), &allocation);
+
+  /* Only the items in and around the view have a row */
+  children = gtk_container_get_children (GTK_CONTAINER (list));
+  g_assert_cmpint (g_list_length (children), >, 0);
+  g_assert_cmpint (g_list_length (children), <, 100);
+  g_list_free (children);
+
+  row = gtk_list_box_get_row_at_y (list, 0);
+  g_assert (row != NULL);
+  g_assert_cmpint (gtk_list_box_row_get_index (row), ==, 0);
+  g_assert (gtk_list_box_get_row_at_index (list, 9999) == NULL);
+
+  /* Rows are reused for the items that scroll into view. They are
+   * bound when scrolling, so that allocating doesn't change them.
+   */
+  gtk_adjustment_set_value (adjustment, 5000 * row_height);
+  row = gtk_list_box_get_row_at_index (list, 5000);
+  g_assert (row != NULL);
+  g_assert_cmpstr (get_row_text (row), ==, "5000");
+
+  n_binds = 0;
+  gtk_widget_size_allocate (GTK_WIDGET (list), &allocation);
+  g_assert_cmpint (n_binds, ==, 0);
+
+  children = gtk_container_get_children (GTK_CONTAINER (list));
+  g_assert_cmpint (g_list_length (children), <, 100);
+  g_list_free (children);
+
+  row = gtk_list_box_get_row_at_y (list, 5000 * row_height);
+  g_assert (row != NULL);
+  g_assert (row == gtk_list_box_get_row_at_index (list, 5000));
+  g_assert_cmpint (gtk_list_box_row_get_index (row), ==, 5000);
+  g_assert_cmpstr (get_row_text (row), ==, "5000");
+  g_assert (gtk_list_box_get_row_at_y (list, 0) == NULL);
+
+  /* The rows after a removed item move up */
+  g_list_store_remove (store, 5000);
+  row = gtk_list_box_get_row_at_index (list, 5000);
+  g_assert (row != NULL);
+  g_assert_cmpstr (get_row_text (row), ==, "5001");
+
+  n_binds = 0;
+  gtk_widget_size_allocate (GTK_WIDGET (list), &allocation);
+  g_assert_cmpint (n_binds, ==, 0);
+
+  /* The fixed height mode that recycling turned on goes with it */
+  gtk_list_box_bind_model (list, G_LIST_MODEL (store), create_label, NULL, NULL);
+  g_assert (!gtk_list_box_get_fixed_height_mode (list));
+
+  gtk_list_box_set_fixed_height_mode (list, TRUE);
+  gtk_list_box_bind_model_recycling (list, G_LIST_MODEL (store),
+                                     create_label, bind_label, NULL, NULL);
+  gtk_list_box_bind_model (list, NULL, NULL, NULL, NULL);
+  g_assert (gtk_list_box_get_fixed_height_mode (list));
+
+  g_object_unref (list);
+  g_object_unref (store);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -444,6 +799,9 @@ main (int argc, char *argv[])
   g_test_add_func ("/listbox/multi-selection", test_multi_selection);
   g_test_add_func ("/listbox/filter", test_filter);
   g_test_add_func ("/listbox/header", test_header);
+  g_test_add_func ("/listbox/incremental", test_incremental);
+  g_test_add_func ("/listbox/fixed-height", test_fixed_height);
+  g_test_add_func ("/listbox/recycling", test_recycling);
 
   return g_test_run ();
 }
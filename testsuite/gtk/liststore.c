@@ -934,6 +934,322 @@ list_store_test_move_before_single (void)
 }
 
 
+/* batched insertion */
+
+static void
+list_store_test_append_rows (void)
+{
+  GtkTreeIter iter;
+  GtkListStore *store;
+  SignalMonitor *monitor;
+
+  store = gtk_list_store_new (1, G_TYPE_INT);
+  gtk_list_store_append (store, &iter);
+
+  /* A plain row-inserted handler sees the rows one at a time */
+  monitor = signal_monitor_new (GTK_TREE_MODEL (store));
+  signal_monitor_append_signal (monitor, ROW_INSERTED, "1");
+  signal_monitor_append_signal (monitor, ROW_INSERTED, "2");
+  gtk_list_store_append_rows (store, &iter, 2);
+  signal_monitor_assert_is_empty (monitor);
+  signal_monitor_free (monitor);
+
+  /* Otherwise they are announced in one go */
+  monitor = signal_monitor_new_batched (GTK_TREE_MODEL (store));
+  signal_monitor_append_signal_rows_inserted (monitor, "3", 3);
+  gtk_list_store_append_rows (store, &iter, 3);
+  signal_monitor_assert_is_empty (monitor);
+
+  g_assert (gtk_list_store_iter_is_valid (store, &iter));
+  g_assert_cmpint (gtk_tree_model_iter_n_children (GTK_TREE_MODEL (store), NULL), ==, 6);
+
+  gtk_list_store_append_rows (store, &iter, 0);
+  g_assert (!gtk_list_store_iter_is_valid (store, &iter));
+
+  signal_monitor_free (monitor);
+  g_object_unref (store);
+}
+
+static void
+list_store_test_update (void)
+{
+  GtkTreeIter iter, first, pending;
+  GtkListStore *store;
+  SignalMonitor *monitor;
+  gint i;
+
+  store = gtk_list_store_new (1, G_TYPE_INT);
+  gtk_list_store_append (store, &first);
+
+  monitor = signal_monitor_new_batched (GTK_TREE_MODEL (store));
+
+  /* Nothing is announced until the update ends, and the new rows
+   * can be filled in silently
+   */
+  gtk_list_store_begin_update (store);
+  gtk_list_store_begin_update (store);
+  for (i = 0; i < 3; i++)
+    {
+      gtk_list_store_append (store, &iter);
+      gtk_list_store_set (store, &iter, 0, i, -1);
+    }
+  gtk_list_store_prepend (store, &pending);
+  gtk_list_store_end_update (store);
+  signal_monitor_assert_is_empty (monitor);
+
+  /* Removing a new row is silent too */
+  gtk_list_store_insert (store, &iter, 2);
+  gtk_list_store_remove (store, &iter);
+
+  signal_monitor_append_signal_rows_inserted (monitor, "0", 1);
+  signal_monitor_append_signal_rows_inserted (monitor, "2", 3);
+  gtk_list_store_end_update (store);
+  signal_monitor_assert_is_empty (monitor);
+
+  /* Changing an existing row announces the new ones first */
+  gtk_list_store_begin_update (store);
+  gtk_list_store_append (store, &iter);
+
+  signal_monitor_append_signal_rows_inserted (monitor, "5", 1);
+  signal_monitor_append_signal (monitor, ROW_CHANGED, "1");
+  gtk_list_store_set (store, &first, 0, 42, -1);
+  signal_monitor_assert_is_empty (monitor);
+
+  gtk_list_store_end_update (store);
+  signal_monitor_assert_is_empty (monitor);
+
+  signal_monitor_free (monitor);
+  g_object_unref (store);
+}
+
+static void
+check_n_rows (GtkTreeModel *model,
+              GtkTreePath  *path,
+              GtkTreeIter  *iter,
+              gpointer      data)
+{
+  /* The rows are appended, and each one is announced while it
+   * is the last one
+   */
+  g_assert_cmpint (gtk_tree_path_get_indices (path)[0] + 1, ==,
+                   gtk_tree_model_iter_n_children (model, NULL));
+  (*(gint *) data)++;
+}
+
+static void
+list_store_test_update_plain_handler (void)
+{
+  GtkTreeModel *sort_model;
+  GtkListStore *store;
+  GtkTreeIter iter;
+  gint n_inserted = 0;
+  gint i;
+
+  store = gtk_list_store_new (1, G_TYPE_INT);
+  sort_model = gtk_tree_model_sort_new_with_model (GTK_TREE_MODEL (store));
+  g_signal_connect (store, "row-inserted",
+                    G_CALLBACK (check_n_rows), &n_inserted);
+
+  gtk_list_store_begin_update (store);
+  for (i = 0; i < 3; i++)
+    gtk_list_store_append (store, &iter);
+  gtk_list_store_append_rows (store, NULL, 2);
+  gtk_list_store_end_update (store);
+
+  g_assert_cmpint (n_inserted, ==, 5);
+  g_assert_cmpint (gtk_tree_model_iter_n_children (sort_model, NULL), ==, 5);
+
+  g_object_unref (sort_model);
+  g_object_unref (store);
+}
+
+#define N_LOAD_ROWS 5000
+
+typedef struct {
+  gint n_rows;
+  gint fail_at;
+  gint n_inserted;
+  gboolean done;
+  GError *error;
+
+  /* The load function waits at pause_at until resumed */
+  gint pause_at;
+  GMutex lock;
+  GCond cond;
+  gboolean resumed;
+} LoadCounter;
+
+static gboolean
+load_rows (GValue        *values,
+           GCancellable  *cancellable,
+           GError       **error,
+           gpointer       data)
+{
+  LoadCounter *counter = data;
+
+  if (counter->n_rows == counter->pause_at)
+    {
+      g_mutex_lock (&counter->lock);
+      while (!counter->resumed)
+        g_cond_wait (&counter->cond, &counter->lock);
+      g_mutex_unlock (&counter->lock);
+    }
+
+  if (counter->n_rows == counter->fail_at)
+    {
+      g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_FAILED, "failed");
+      return FALSE;
+    }
+
+  if (counter->n_rows == N_LOAD_ROWS)
+    return FALSE;
+
+  g_value_set_int (&values[0], counter->n_rows);
+  g_value_take_string (&values[1], g_strdup_printf ("%d", counter->n_rows));
+  counter->n_rows++;
+
+  return TRUE;
+}
+
+static void
+load_row_inserted (GtkTreeModel *model,
+                   GtkTreePath  *path,
+                   GtkTreeIter  *iter,
+                   gpointer      data)
+{
+  LoadCounter *counter = data;
+
+  counter->n_inserted++;
+}
+
+static void
+load_done (GObject      *source,
+           GAsyncResult *result,
+           gpointer      data)
+{
+  LoadCounter *counter = data;
+
+  if (!gtk_list_store_load_finish (GTK_LIST_STORE (source), result, &counter->error))
+    g_assert (counter->error != NULL);
+
+  counter->done = TRUE;
+}
+
+static void
+check_loaded_rows (GtkListStore *store,
+                   gint          n_rows)
+{
+  GtkTreeIter iter;
+  gchar *string, *expected;
+  gint i, value;
+
+  g_assert_cmpint (gtk_tree_model_iter_n_children (GTK_TREE_MODEL (store), NULL), ==, n_rows);
+
+  i = 0;
+  if (gtk_tree_model_get_iter_first (GTK_TREE_MODEL (store), &iter))
+    do
+      {
+        gtk_tree_model_get (GTK_TREE_MODEL (store), &iter, 0, &value, 1, &string, -1);
+        expected = g_strdup_printf ("%d", i);
+        g_assert_cmpint (value, ==, i);
+        g_assert_cmpstr (string, ==, expected);
+        g_free (expected);
+        g_free (string);
+        i++;
+      }
+    while (gtk_tree_model_iter_next (GTK_TREE_MODEL (store), &iter));
+}
+
+static void
+list_store_test_load_async (void)
+{
+  GtkListStore *store;
+  LoadCounter counter = { 0, -1, 0, FALSE, NULL, -1 };
+
+  store = gtk_list_store_new (2, G_TYPE_INT, G_TYPE_STRING);
+  g_signal_connect (store, "row-inserted",
+                    G_CALLBACK (load_row_inserted), &counter);
+
+  /* Rows are only added from the main loop */
+  gtk_list_store_load_async (store, load_rows, &counter, NULL,
+                             NULL, load_done, &counter);
+  g_assert_cmpint (gtk_tree_model_iter_n_children (GTK_TREE_MODEL (store), NULL), ==, 0);
+
+  while (!counter.done)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_no_error (counter.error);
+  g_assert_cmpint (counter.n_inserted, ==, N_LOAD_ROWS);
+  check_loaded_rows (store, N_LOAD_ROWS);
+  g_object_unref (store);
+
+  /* The rows before an error are kept */
+  store = gtk_list_store_new (2, G_TYPE_INT, G_TYPE_STRING);
+  counter.n_rows = 0;
+  counter.fail_at = 100;
+  counter.done = FALSE;
+
+  gtk_list_store_load_async (store, load_rows, &counter, NULL,
+                             NULL, load_done, &counter);
+  while (!counter.done)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_error (counter.error, G_IO_ERROR, G_IO_ERROR_FAILED);
+  g_clear_error (&counter.error);
+  check_loaded_rows (store, 100);
+  g_object_unref (store);
+}
+
+static void
+list_store_test_load_async_cancel (void)
+{
+  GtkListStore *store;
+  GCancellable *cancellable;
+  GtkTreeIter iter;
+  LoadCounter counter = { 0, -1, 0, FALSE, NULL, 2048 };
+  gchar *string;
+
+  g_mutex_init (&counter.lock);
+  g_cond_init (&counter.cond);
+
+  store = gtk_list_store_new (2, G_TYPE_INT, G_TYPE_STRING);
+  gtk_list_store_insert_with_values (store, NULL, -1, 0, -1, 1, "existing", -1);
+  cancellable = g_cancellable_new ();
+
+  gtk_list_store_load_async (store, load_rows, &counter, NULL,
+                             cancellable, load_done, &counter);
+
+  /* Wait for some of the rows before the pause to be added */
+  while (gtk_tree_model_iter_n_children (GTK_TREE_MODEL (store), NULL) == 1)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_cancellable_cancel (cancellable);
+
+  g_mutex_lock (&counter.lock);
+  counter.resumed = TRUE;
+  g_cond_signal (&counter.cond);
+  g_mutex_unlock (&counter.lock);
+
+  while (!counter.done)
+    g_main_context_iteration (NULL, TRUE);
+
+  /* No partial result remains, but rows that were there before do */
+  g_assert_error (counter.error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+  g_clear_error (&counter.error);
+
+  g_assert_cmpint (gtk_tree_model_iter_n_children (GTK_TREE_MODEL (store), NULL), ==, 1);
+  g_assert (gtk_tree_model_get_iter_first (GTK_TREE_MODEL (store), &iter));
+  gtk_tree_model_get (GTK_TREE_MODEL (store), &iter, 1, &string, -1);
+  g_assert_cmpstr (string, ==, "existing");
+  g_free (string);
+
+  g_object_unref (cancellable);
+  g_object_unref (store);
+  g_mutex_clear (&counter.lock);
+  g_cond_clear (&counter.cond);
+}
+
+
 /* iter invalidation */
 
 static void
@@ -1120,6 +1436,18 @@ register_list_store_tests (void)
   g_test_add_func ("/ListStore/move-before-single",
 		   list_store_test_move_before_single);
 
+  /* batched insertion */
+  g_test_add_func ("/ListStore/append-rows",
+                   list_store_test_append_rows);
+  g_test_add_func ("/ListStore/update",
+                   list_store_test_update);
+  g_test_add_func ("/ListStore/update-plain-handler",
+                   list_store_test_update_plain_handler);
+  g_test_add_func ("/ListStore/load-async",
+                   list_store_test_load_async);
+  g_test_add_func ("/ListStore/load-async-cancel",
+                   list_store_test_load_async_cancel);
+
   /* iter invalidation */
   g_test_add ("/ListStore/iter-prev-invalid", ListStore, NULL,
               list_store_setup, list_store_test_iter_previous_invalid,
@@ -377,6 +377,94 @@ test_insert_before (void)
   _gtk_rbtree_free (tree);
 }
 
+static void
+test_insert_random (void)
+{
+  guint n = g_test_perf () ? 1000000 : 1000;
+  GtkRBTree *tree;
+  GtkRBNode *node;
+  guint i;
+  double elapsed;
+
+  tree = _gtk_rbtree_new ();
+
+  g_test_timer_start ();
+
+  for (i = 0; i < n; i++)
+    {
+      if (i > 0)
+        node = _gtk_rbtree_find_count (tree, g_test_rand_int_range (1, i + 1));
+      else
+        node = NULL;
+
+      _gtk_rbtree_insert_after (tree, node, 1, TRUE);
+    }
+
+  elapsed = g_test_timer_elapsed ();
+  if (g_test_perf ())
+    g_test_minimized_result (elapsed, "inserting %u items at random positions: %gsec", n, elapsed);
+
+  _gtk_rbtree_test (tree);
+  g_assert (tree->root->count == n);
+  g_assert (tree->root->offset == n);
+
+  _gtk_rbtree_free (tree);
+}
+
+static void
+test_find_offset (void)
+{
+  guint n = g_test_perf () ? 1000000 : 1000;
+  GtkRBTree *tree, *find_tree;
+  GtkRBNode *node, *find_node;
+  guint i;
+  gint offset;
+  double elapsed;
+
+  tree = _gtk_rbtree_new ();
+  _gtk_rbtree_fill (tree, n, 0, TRUE);
+
+  for (node = _gtk_rbtree_first (tree), i = 0;
+       node != NULL;
+       node = _gtk_rbtree_next (tree, node), i++)
+    _gtk_rbtree_node_set_height (tree, node, i % 5 + 2);
+
+  g_test_timer_start ();
+
+  for (i = 0; i < n; i++)
+    _gtk_rbtree_find_offset (tree, g_test_rand_int_range (0, tree->root->offset),
+                             &find_tree, &find_node);
+
+  elapsed = g_test_timer_elapsed ();
+  if (g_test_perf ())
+    g_test_minimized_result (elapsed, "finding %u offsets: %gsec", n, elapsed);
+
+  _gtk_rbtree_test (tree);
+
+  /* Look inside the rows, an offset right at the border between
+   * two rows may be reported as the end of the upper one.
+   */
+  for (node = _gtk_rbtree_first (tree), offset = 0;
+       node != NULL;
+       node = _gtk_rbtree_next (tree, node))
+    {
+      g_assert (_gtk_rbtree_find_offset (tree, offset + 1, &find_tree, &find_node) == 1);
+      g_assert (find_node == node);
+      g_assert (_gtk_rbtree_find_offset (tree, offset + GTK_RBNODE_GET_HEIGHT (node) - 1,
+                                         &find_tree, &find_node) == GTK_RBNODE_GET_HEIGHT (node) - 1);
+      g_assert (find_node == node);
+      g_assert (_gtk_rbtree_node_find_offset (tree, node) == offset);
+
+      offset += GTK_RBNODE_GET_HEIGHT (node);
+    }
+
+  g_assert (offset == tree->root->offset);
+  _gtk_rbtree_find_offset (tree, offset, &find_tree, &find_node);
+  g_assert (find_node == NULL);
+
+  _gtk_rbtree_free (tree);
+}
+
 static void
 test_remove_node (void)
 {
@@ -428,6 +516,67 @@ test_remove_root (void)
   _gtk_rbtree_free (tree);
 }
 
+static void
+test_fill (void)
+{
+  GtkRBTree *tree;
+  GtkRBNode *node;
+  guint sizes[] = { 1, 2, 3, 4, 7, 8, 9, 100, 1023, 1024, 1025 };
+  guint i, n;
+
+  for (i = 0; i < G_N_ELEMENTS (sizes); i++)
+    {
+      tree = _gtk_rbtree_new ();
+
+      _gtk_rbtree_fill (tree, sizes[i], 3, i % 2 == 0);
+      _gtk_rbtree_test (tree);
+      g_assert (tree->root->count == sizes[i]);
+      g_assert (tree->root->total_count == sizes[i]);
+      g_assert (tree->root->offset == sizes[i] * 3);
+      g_assert (GTK_RBNODE_FLAG_SET (tree->root, GTK_RBNODE_DESCENDANTS_INVALID) == (i % 2 != 0));
+
+      for (node = _gtk_rbtree_first (tree), n = 0;
+           node != NULL;
+           node = _gtk_rbtree_next (tree, node), n++)
+        {
+          g_assert (GTK_RBNODE_GET_HEIGHT (node) == 3);
+          g_assert (_gtk_rbtree_node_get_index (tree, node) == n);
+        }
+      g_assert (n == sizes[i]);
+
+      /* The tree keeps its balance when it changes afterwards */
+      node = _gtk_rbtree_insert_after (tree, _gtk_rbtree_find_count (tree, 1), 5, TRUE);
+      _gtk_rbtree_test (tree);
+      _gtk_rbtree_remove_node (tree, node);
+      _gtk_rbtree_test (tree);
+
+      _gtk_rbtree_free (tree);
+    }
+}
+
+static void
+test_fill_children (void)
+{
+  GtkRBTree *tree;
+  GtkRBNode *node;
+
+  tree = _gtk_rbtree_new ();
+  node = _gtk_rbtree_insert_after (tree, NULL, 1, TRUE);
+  _gtk_rbtree_insert_after (tree, node, 1, TRUE);
+
+  node->children = _gtk_rbtree_new ();
+  node->children->parent_tree = tree;
+  node->children->parent_node = node;
+  _gtk_rbtree_fill (node->children, 50, 2, FALSE);
+
+  _gtk_rbtree_test (tree);
+  g_assert (tree->root->total_count == 52);
+  g_assert (tree->root->offset == 102);
+  g_assert (GTK_RBNODE_FLAG_SET (tree->root, GTK_RBNODE_DESCENDANTS_INVALID));
+
+  _gtk_rbtree_free (tree);
+}
+
 static gint *
 fisher_yates_shuffle (guint n_items)
 {
@@ -517,8 +666,12 @@ main (int argc, char *argv[])
   g_test_add_func ("/rbtree/create", test_create);
   g_test_add_func ("/rbtree/insert_after", test_insert_after);
   g_test_add_func ("/rbtree/insert_before", test_insert_before);
+  g_test_add_func ("/rbtree/insert_random", test_insert_random);
+  g_test_add_func ("/rbtree/find_offset", test_find_offset);
   g_test_add_func ("/rbtree/remove_node", test_remove_node);
   g_test_add_func ("/rbtree/remove_root", test_remove_root);
+  g_test_add_func ("/rbtree/fill", test_fill);
+  g_test_add_func ("/rbtree/fill_children", test_fill_children);
   g_test_add_func ("/rbtree/reorder", test_reorder);
 
   return g_test_run ();
@@ -0,0 +1,100 @@
+/* GTK - The GIMP Toolkit
+ * Copyright (C) 2015 The GTK+ Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtk/gtk.h>
+
+static void
+count_signal (gint *count)
+{
+  (*count)++;
+}
+
+static void
+test_relayout_boundary (void)
+{
+  GtkWidget *window, *box, *sw, *inner, *outer;
+  gint n_window_resizes, n_inner_allocs;
+  gint width;
+
+  window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+  box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+  gtk_container_add (GTK_CONTAINER (window), box);
+
+  sw = gtk_scrolled_window_new (NULL, NULL);
+  gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (sw),
+                                  GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+  gtk_widget_set_size_request (sw, 200, 200);
+  gtk_box_pack_start (GTK_BOX (box), sw, TRUE, TRUE, 0);
+
+  inner = gtk_label_new ("Inside");
+  gtk_container_add (GTK_CONTAINER (sw), inner);
+  outer = gtk_label_new ("Outside");
+  gtk_box_pack_start (GTK_BOX (box), outer, FALSE, FALSE, 0);
+
+  gtk_widget_show_all (window);
+  gtk_widget_show_now (window);
+  gtk_test_widget_wait_for_draw (window);
+  gtk_test_widget_wait_for_draw (window);
+
+  n_window_resizes = 0;
+  n_inner_allocs = 0;
+  g_signal_connect_swapped (window, "check-resize",
+                            G_CALLBACK (count_signal), &n_window_resizes);
+  g_signal_connect_swapped (inner, "size-allocate",
+                            G_CALLBACK (count_signal), &n_inner_allocs);
+
+  /* A resize inside the scrolled window stays there, but the
+   * label still gets its new size
+   */
+  width = gtk_widget_get_allocated_width (inner);
+  gtk_label_set_text (GTK_LABEL (inner),
+                      "Inside, with a text that is much wider than the scrolled window");
+  gtk_test_widget_wait_for_draw (inner);
+
+  g_assert_cmpint (n_window_resizes, ==, 0);
+  g_assert_cmpint (n_inner_allocs, >, 0);
+  g_assert_cmpint (gtk_widget_get_allocated_width (inner), >, width);
+
+  /* A resize next to it goes all the way up */
+  gtk_label_set_text (GTK_LABEL (outer), "Outside\nwith a second line");
+  gtk_test_widget_wait_for_draw (outer);
+
+  g_assert_cmpint (n_window_resizes, >, 0);
+
+  /* Without scrolling in both directions, the resize has to go up */
+  gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (sw),
+                                  GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
+  gtk_test_widget_wait_for_draw (window);
+  n_window_resizes = 0;
+
+  gtk_label_set_text (GTK_LABEL (inner), "Inside");
+  gtk_test_widget_wait_for_draw (inner);
+
+  g_assert_cmpint (n_window_resizes, >, 0);
+
+  gtk_widget_destroy (window);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  g_test_add_func ("/scrolledwindow/relayout-boundary", test_relayout_boundary);
+
+  return g_test_run ();
+}
@@ -0,0 +1,298 @@
+/* GTK - The GIMP Toolkit
+ * Copyright (C) 2015 The GTK+ Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtk/gtk.h>
+
+/* A widget whose height depends on its width, like a wrapping
+ * label, and which counts how often it is measured
+ */
+typedef GtkWidget      WrapWidget;
+typedef GtkWidgetClass WrapWidgetClass;
+
+static GType wrap_widget_get_type (void);
+
+G_DEFINE_TYPE (WrapWidget, wrap_widget, GTK_TYPE_WIDGET)
+
+static gint n_measures;
+
+static GtkSizeRequestMode
+wrap_widget_get_request_mode (GtkWidget *widget)
+{
+  return GTK_SIZE_REQUEST_HEIGHT_FOR_WIDTH;
+}
+
+static void
+wrap_widget_get_preferred_width (GtkWidget *widget,
+                                 gint      *minimum,
+                                 gint      *natural)
+{
+  *minimum = 10;
+  *natural = 1000;
+}
+
+static void
+wrap_widget_get_preferred_height_for_width (GtkWidget *widget,
+                                            gint       width,
+                                            gint      *minimum,
+                                            gint      *natural)
+{
+  n_measures++;
+
+  *minimum = *natural = 10000 / MAX (width, 1);
+}
+
+static void
+wrap_widget_get_preferred_height (GtkWidget *widget,
+                                  gint      *minimum,
+                                  gint      *natural)
+{
+  wrap_widget_get_preferred_height_for_width (widget, 10, minimum, natural);
+}
+
+static void
+wrap_widget_class_init (WrapWidgetClass *class)
+{
+  class->get_request_mode = wrap_widget_get_request_mode;
+  class->get_preferred_width = wrap_widget_get_preferred_width;
+  class->get_preferred_height = wrap_widget_get_preferred_height;
+  class->get_preferred_height_for_width = wrap_widget_get_preferred_height_for_width;
+}
+
+static void
+wrap_widget_init (WrapWidget *widget)
+{
+  gtk_widget_set_has_window (widget, FALSE);
+}
+
+static gint
+measure_widths (GtkWidget *widget,
+                gint       first_width,
+                gint       n_widths)
+{
+  gint width, minimum, natural;
+
+  n_measures = 0;
+
+  for (width = first_width; width < first_width + n_widths; width++)
+    {
+      gtk_widget_get_preferred_height_for_width (widget, width, &minimum, &natural);
+      g_assert_cmpint (minimum, ==, 10000 / width);
+    }
+
+  return n_measures;
+}
+
+static void
+test_cache_grow (void)
+{
+  GtkWidget *widget;
+
+  widget = g_object_ref_sink (g_object_new (wrap_widget_get_type (), NULL));
+  gtk_widget_show (widget);
+
+  /* Many different sizes fit into the cache once it has grown */
+  g_assert_cmpint (measure_widths (widget, 50, 20), ==, 20);
+  g_assert_cmpint (measure_widths (widget, 50, 20), ==, 0);
+
+  /* The grown size survives a resize */
+  gtk_widget_queue_resize (widget);
+  g_assert_cmpint (measure_widths (widget, 50, 20), ==, 20);
+  g_assert_cmpint (measure_widths (widget, 50, 20), ==, 0);
+
+  /* Beyond the limit, old sizes are evicted, but results stay correct */
+  g_assert_cmpint (measure_widths (widget, 50, 40), ==, 20);
+  g_assert_cmpint (measure_widths (widget, 50, 40), >, 0);
+
+  g_object_unref (widget);
+}
+
+static void
+get_label_size (GtkWidget *label,
+                gint      *min_width,
+                gint      *nat_width,
+                gint      *min_height,
+                gint      *nat_height)
+{
+  gtk_widget_get_preferred_width (label, min_width, nat_width);
+  gtk_widget_get_preferred_height (label, min_height, nat_height);
+}
+
+static void
+test_label_measure_order (void)
+{
+  const gchar *text = "A label with a text that is long enough to wrap "
+                      "across several lines when it is measured";
+  GtkWidget *label1, *label2;
+  gint min_width1, nat_width1, min_height1, nat_height1;
+  gint min_width2, nat_width2, min_height2, nat_height2;
+
+  /* Both orientations share one measurement, so the order in which
+   * they are requested must not matter
+   */
+  label1 = g_object_ref_sink (gtk_label_new (text));
+  label2 = g_object_ref_sink (gtk_label_new (text));
+  gtk_label_set_line_wrap (GTK_LABEL (label1), TRUE);
+  gtk_label_set_line_wrap (GTK_LABEL (label2), TRUE);
+  gtk_widget_show (label1);
+  gtk_widget_show (label2);
+
+  get_label_size (label1, &min_width1, &nat_width1, &min_height1, &nat_height1);
+  gtk_widget_get_preferred_height (label2, &min_height2, &nat_height2);
+  gtk_widget_get_preferred_width (label2, &min_width2, &nat_width2);
+
+  g_assert_cmpint (min_width1, ==, min_width2);
+  g_assert_cmpint (nat_width1, ==, nat_width2);
+  g_assert_cmpint (min_height1, ==, min_height2);
+  g_assert_cmpint (nat_height1, ==, nat_height2);
+
+  g_object_unref (label1);
+  g_object_unref (label2);
+}
+
+static void
+test_label_measure_changes (void)
+{
+  GtkWidget *label;
+  PangoAttrList *attrs;
+  gint min_width, nat_width, min_height, nat_height;
+  gint old_min_width, old_nat_width, old_min_height, old_nat_height;
+
+  label = g_object_ref_sink (gtk_label_new ("Label"));
+  gtk_widget_show (label);
+  get_label_size (label, &old_min_width, &old_nat_width, &old_min_height, &old_nat_height);
+
+  /* Every change that affects the size drops the shared measurement */
+  gtk_label_set_text (GTK_LABEL (label), "A longer label");
+  get_label_size (label, &min_width, &nat_width, &min_height, &nat_height);
+  g_assert_cmpint (nat_width, >, old_nat_width);
+  old_nat_width = nat_width;
+
+  gtk_label_set_text (GTK_LABEL (label), "A longer label\nwith two lines");
+  get_label_size (label, &min_width, &nat_width, &min_height, &nat_height);
+  g_assert_cmpint (nat_height, >, old_nat_height);
+  old_nat_height = nat_height;
+
+  attrs = pango_attr_list_new ();
+  pango_attr_list_insert (attrs, pango_attr_scale_new (2.0));
+  gtk_label_set_attributes (GTK_LABEL (label), attrs);
+  pango_attr_list_unref (attrs);
+  get_label_size (label, &min_width, &nat_width, &min_height, &nat_height);
+  g_assert_cmpint (nat_width, >, old_nat_width);
+  g_assert_cmpint (nat_height, >, old_nat_height);
+  old_min_width = min_width;
+  old_nat_width = nat_width;
+
+  gtk_label_set_width_chars (GTK_LABEL (label), 100);
+  get_label_size (label, &min_width, &nat_width, &min_height, &nat_height);
+  g_assert_cmpint (min_width, >, old_min_width);
+
+  gtk_label_set_width_chars (GTK_LABEL (label), -1);
+  gtk_label_set_line_wrap (GTK_LABEL (label), TRUE);
+  gtk_label_set_text (GTK_LABEL (label),
+                      "A label with a text that is long enough to wrap "
+                      "across several lines when it is measured");
+  gtk_label_set_max_width_chars (GTK_LABEL (label), 80);
+  get_label_size (label, &min_width, &nat_width, &min_height, &nat_height);
+  old_nat_width = nat_width;
+
+  gtk_label_set_max_width_chars (GTK_LABEL (label), 10);
+  get_label_size (label, &min_width, &nat_width, &min_height, &nat_height);
+  g_assert_cmpint (nat_width, <, old_nat_width);
+
+  g_object_unref (label);
+}
+
+static void
+set_sizes (GtkRequestedSize *sizes,
+           const gint       *minimum,
+           const gint       *natural,
+           guint             n_sizes)
+{
+  guint i;
+
+  for (i = 0; i < n_sizes; i++)
+    {
+      sizes[i].data = NULL;
+      sizes[i].minimum_size = minimum[i];
+      sizes[i].natural_size = natural[i];
+    }
+}
+
+static void
+test_distribute_enough_space (void)
+{
+  const gint minimum[] = { 10, 5, 0, 20 };
+  const gint natural[] = { 20, 5, 30, 10 };
+  GtkRequestedSize sizes[G_N_ELEMENTS (minimum)];
+
+  /* Everybody gets its natural size, and the rest is returned */
+  set_sizes (sizes, minimum, natural, G_N_ELEMENTS (sizes));
+  g_assert_cmpint (gtk_distribute_natural_allocation (100, G_N_ELEMENTS (sizes), sizes), ==, 60);
+  g_assert_cmpint (sizes[0].minimum_size, ==, 20);
+  g_assert_cmpint (sizes[1].minimum_size, ==, 5);
+  g_assert_cmpint (sizes[2].minimum_size, ==, 30);
+  /* A natural size below the minimum size never shrinks a child */
+  g_assert_cmpint (sizes[3].minimum_size, ==, 20);
+
+  set_sizes (sizes, minimum, natural, G_N_ELEMENTS (sizes));
+  g_assert_cmpint (gtk_distribute_natural_allocation (40, G_N_ELEMENTS (sizes), sizes), ==, 0);
+  g_assert_cmpint (sizes[0].minimum_size, ==, 20);
+  g_assert_cmpint (sizes[2].minimum_size, ==, 30);
+
+  set_sizes (sizes, minimum, natural, G_N_ELEMENTS (sizes));
+  g_assert_cmpint (gtk_distribute_natural_allocation (0, G_N_ELEMENTS (sizes), sizes), ==, 0);
+  g_assert_cmpint (sizes[0].minimum_size, ==, 10);
+  g_assert_cmpint (sizes[2].minimum_size, ==, 0);
+}
+
+static void
+test_distribute_ration (void)
+{
+  const gint minimum[] = { 0, 7, 0, 0, 20 };
+  const gint natural[] = { 20, 7, 10, 30, 10 };
+  GtkRequestedSize sizes[G_N_ELEMENTS (minimum)];
+
+  /* The smallest gap is filled first, the others share what is left */
+  set_sizes (sizes, minimum, natural, G_N_ELEMENTS (sizes));
+  g_assert_cmpint (gtk_distribute_natural_allocation (45, G_N_ELEMENTS (sizes), sizes), ==, 0);
+  g_assert_cmpint (sizes[0].minimum_size, ==, 18);
+  g_assert_cmpint (sizes[1].minimum_size, ==, 7);
+  g_assert_cmpint (sizes[2].minimum_size, ==, 10);
+  g_assert_cmpint (sizes[3].minimum_size, ==, 17);
+  g_assert_cmpint (sizes[4].minimum_size, ==, 20);
+
+  /* Equal shares when they fit into every gap */
+  set_sizes (sizes, minimum, natural, G_N_ELEMENTS (sizes));
+  g_assert_cmpint (gtk_distribute_natural_allocation (15, G_N_ELEMENTS (sizes), sizes), ==, 0);
+  g_assert_cmpint (sizes[0].minimum_size, ==, 5);
+  g_assert_cmpint (sizes[2].minimum_size, ==, 5);
+  g_assert_cmpint (sizes[3].minimum_size, ==, 5);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  g_test_add_func ("/sizerequest/cache-grow", test_cache_grow);
+  g_test_add_func ("/sizerequest/distribute/enough-space", test_distribute_enough_space);
+  g_test_add_func ("/sizerequest/distribute/ration", test_distribute_ration);
+  g_test_add_func ("/sizerequest/label/measure-order", test_label_measure_order);
+  g_test_add_func ("/sizerequest/label/measure-changes", test_label_measure_changes);
+
+  return g_test_run ();
+}
@@ -1029,6 +1029,362 @@ sorted_insert (void)
   g_object_unref (ref_model);
 }
 
+static void
+sorted_insert_batched (void)
+{
+  GtkListStore *store;
+  GtkTreeModel *sort_model;
+  GtkWidget *tree_view;
+  SignalMonitor *monitor;
+  GtkTreeIter iter;
+  int i;
+
+  store = gtk_list_store_new (1, G_TYPE_INT);
+  for (i = 1; i <= 5; i += 2)
+    gtk_list_store_insert_with_values (store, NULL, -1, 0, i * 10, -1);
+
+  sort_model = gtk_tree_model_sort_new_with_model (GTK_TREE_MODEL (store));
+  tree_view = gtk_tree_view_new_with_model (sort_model);
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (sort_model),
+                                        0, GTK_SORT_ASCENDING);
+  g_assert (gtk_tree_model_get_iter_first (sort_model, &iter));
+
+  monitor = signal_monitor_new_batched (sort_model);
+
+  /* The new rows end up apart, each group of them is inserted and
+   * announced on its own
+   */
+  signal_monitor_append_signal (monitor, ROW_INSERTED, "1");
+  signal_monitor_append_signal (monitor, ROW_INSERTED, "3");
+  signal_monitor_append_signal_rows_inserted (monitor, "5", 2);
+
+  gtk_list_store_begin_update (store);
+  for (i = 2; i <= 7; i += 2)
+    gtk_list_store_insert_with_values (store, NULL, -1, 0, i * 10, -1);
+  gtk_list_store_insert_with_values (store, NULL, -1, 0, 70, -1);
+  gtk_list_store_end_update (store);
+
+  signal_monitor_assert_is_empty (monitor);
+  check_sort_order (sort_model, GTK_SORT_ASCENDING, NULL);
+  g_assert_cmpint (gtk_tree_model_iter_n_children (sort_model, NULL), ==, 7);
+
+  signal_monitor_free (monitor);
+  gtk_widget_destroy (tree_view);
+  g_object_unref (sort_model);
+  g_object_unref (store);
+}
+
+static void
+sorted_insert_batched_unbuilt (void)
+{
+  GtkListStore *store;
+  GtkTreeModel *sort_model;
+  SignalMonitor *monitor;
+  GtkTreeIter iter;
+
+  store = gtk_list_store_new (1, G_TYPE_INT);
+  gtk_list_store_insert_with_values (store, NULL, -1, 0, 50, -1);
+
+  /* The root level is built when the first run is announced, and
+   * must leave out the second one
+   */
+  sort_model = gtk_tree_model_sort_new_with_model (GTK_TREE_MODEL (store));
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (sort_model),
+                                        0, GTK_SORT_ASCENDING);
+  monitor = signal_monitor_new (sort_model);
+
+  signal_monitor_append_signal (monitor, ROW_INSERTED, "0");
+  signal_monitor_append_signal (monitor, ROW_INSERTED, "2");
+
+  gtk_list_store_begin_update (store);
+  gtk_list_store_insert_with_values (store, &iter, 0, 0, 10, -1);
+  gtk_list_store_insert_with_values (store, &iter, -1, 0, 90, -1);
+  gtk_list_store_end_update (store);
+
+  signal_monitor_assert_is_empty (monitor);
+  check_sort_order (sort_model, GTK_SORT_ASCENDING, NULL);
+  g_assert_cmpint (gtk_tree_model_iter_n_children (sort_model, NULL), ==, 3);
+
+  signal_monitor_free (monitor);
+  g_object_unref (sort_model);
+  g_object_unref (store);
+}
+
+/* Counts the children of the first row, building their level */
+static gint
+count_first_children (GtkTreeModel *sort_model)
+{
+  GtkTreeIter parent, iter;
+  gint n_children = 0;
+
+  g_assert (gtk_tree_model_get_iter_first (sort_model, &parent));
+  if (gtk_tree_model_iter_children (sort_model, &iter, &parent))
+    {
+      do
+        n_children++;
+      while (gtk_tree_model_iter_next (sort_model, &iter));
+    }
+
+  g_assert_cmpint (gtk_tree_model_iter_n_children (sort_model, &parent), ==, n_children);
+
+  return n_children;
+}
+
+static void
+sorted_insert_batched_build_level (void)
+{
+  GtkTreeStore *store;
+  GtkTreeModel *sort_model;
+  GtkTreeIter parent, sort_parent, sort_child, iter, removed;
+
+  store = gtk_tree_store_new (1, G_TYPE_INT);
+  gtk_tree_store_insert_with_values (store, &parent, NULL, -1, 0, 1, -1);
+  gtk_tree_store_insert_with_values (store, NULL, &parent, -1, 0, 30, -1);
+  gtk_tree_store_insert_with_values (store, &removed, &parent, -1, 0, 20, -1);
+  gtk_tree_store_insert_with_values (store, NULL, NULL, -1, 0, 2, -1);
+
+  sort_model = gtk_tree_model_sort_new_with_model (GTK_TREE_MODEL (store));
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (sort_model),
+                                        0, GTK_SORT_ASCENDING);
+
+  gtk_tree_store_begin_update (store);
+
+  /* Remove a row that was never announced */
+  gtk_tree_store_insert_with_values (store, &iter, &parent, 0, 0, 5, -1);
+  gtk_tree_store_remove (store, &iter);
+
+  /* Build the level of the parent while rows are pending: they must
+   * not be in it, they are added when they are announced
+   */
+  gtk_tree_store_insert_with_values (store, NULL, &parent, 0, 0, 10, -1);
+  gtk_tree_store_insert_with_values (store, NULL, &parent, -1, 0, 40, -1);
+  g_assert_cmpint (count_first_children (sort_model), ==, 2);
+
+  /* Keep the level around, by referencing the row of 30 */
+  g_assert (gtk_tree_model_get_iter_first (sort_model, &sort_parent));
+  g_assert (gtk_tree_model_iter_nth_child (sort_model, &sort_child, &sort_parent, 1));
+  gtk_tree_model_ref_node (sort_model, &sort_child);
+
+  /* Removing a row that was announced announces the pending ones */
+  gtk_tree_store_remove (store, &removed);
+  g_assert_cmpint (count_first_children (sort_model), ==, 3);
+
+  gtk_tree_store_insert_with_values (store, NULL, &parent, 1, 0, 25, -1);
+  g_assert_cmpint (count_first_children (sort_model), ==, 3);
+
+  gtk_tree_store_end_update (store);
+
+  g_assert_cmpint (count_first_children (sort_model), ==, 4);
+  g_assert_cmpint (gtk_tree_model_iter_n_children (GTK_TREE_MODEL (store), &parent), ==, 4);
+  check_sort_order (sort_model, GTK_SORT_ASCENDING, "0");
+
+  g_assert (gtk_tree_model_get_iter_first (sort_model, &sort_parent));
+  g_assert (gtk_tree_model_iter_nth_child (sort_model, &sort_child, &sort_parent, 2));
+  gtk_tree_model_unref_node (sort_model, &sort_child);
+
+  g_object_unref (sort_model);
+  g_object_unref (store);
+}
+
+/* Checks that rows with equal values kept their order */
+static void
+check_sort_stable (GtkTreeModel *model)
+{
+  GtkTreeIter iter;
+  int prev_value = -1, prev_index = -1;
+
+  g_assert (gtk_tree_model_get_iter_first (model, &iter));
+
+  do
+    {
+      int value, index;
+
+      gtk_tree_model_get (model, &iter, 0, &value, 1, &index, -1);
+      if (value == prev_value)
+        g_assert_cmpint (prev_index, <, index);
+
+      prev_value = value;
+      prev_index = index;
+    }
+  while (gtk_tree_model_iter_next (model, &iter));
+}
+
+static void
+check_row_reference (GtkTreeRowReference *ref,
+                     int                  index)
+{
+  GtkTreeModel *model;
+  GtkTreePath *path;
+  GtkTreeIter iter;
+  int value;
+
+  model = gtk_tree_row_reference_get_model (ref);
+  path = gtk_tree_row_reference_get_path (ref);
+  g_assert (gtk_tree_model_get_iter (model, &iter, path));
+  gtk_tree_path_free (path);
+
+  gtk_tree_model_get (model, &iter, 1, &value, -1);
+  g_assert_cmpint (value, ==, index);
+}
+
+static void
+sort_large (void)
+{
+  GtkListStore *store;
+  GtkTreeModel *sort_model;
+  GtkTreeRowReference *ref, *sort_ref;
+  GtkTreePath *path;
+  int i;
+
+  /* Enough rows to sort in several threads, with many equal values */
+  store = gtk_list_store_new (2, G_TYPE_INT, G_TYPE_INT);
+  for (i = 0; i < 50000; i++)
+    gtk_list_store_insert_with_values (store, NULL, -1,
+                                       0, g_test_rand_int_range (0, 1000),
+                                       1, i,
+                                       -1);
+
+  sort_model = gtk_tree_model_sort_new_with_model (GTK_TREE_MODEL (store));
+
+  path = gtk_tree_path_new_from_indices (0, -1);
+  ref = gtk_tree_row_reference_new (GTK_TREE_MODEL (store), path);
+  sort_ref = gtk_tree_row_reference_new (sort_model, path);
+  gtk_tree_path_free (path);
+
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (sort_model),
+                                        0, GTK_SORT_ASCENDING);
+  check_sort_order (sort_model, GTK_SORT_ASCENDING, NULL);
+  check_sort_stable (sort_model);
+  check_row_reference (sort_ref, 0);
+
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (sort_model),
+                                        0, GTK_SORT_DESCENDING);
+  check_sort_order (sort_model, GTK_SORT_DESCENDING, NULL);
+  check_sort_stable (sort_model);
+  check_row_reference (sort_ref, 0);
+
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (store),
+                                        0, GTK_SORT_DESCENDING);
+  check_sort_order (GTK_TREE_MODEL (store), GTK_SORT_DESCENDING, NULL);
+  check_sort_stable (GTK_TREE_MODEL (store));
+  check_row_reference (ref, 0);
+
+  /* Sorting the child model again keeps the sort model in order */
+  check_sort_order (sort_model, GTK_SORT_DESCENDING, NULL);
+  check_row_reference (sort_ref, 0);
+
+  gtk_tree_row_reference_free (sort_ref);
+  gtk_tree_row_reference_free (ref);
+  g_object_unref (sort_model);
+  g_object_unref (store);
+}
+
+
+static gint
+compare_int_column (GtkTreeModel *model,
+                    GtkTreeIter  *a,
+                    GtkTreeIter  *b,
+                    gpointer      data)
+{
+  int value_a, value_b;
+
+  gtk_tree_model_get (model, a, 0, &value_a, -1);
+  gtk_tree_model_get (model, b, 0, &value_b, -1);
+
+  return (value_a > value_b) - (value_a < value_b);
+}
+
+/* Checks the order of the indices in column 1 */
+static void
+check_indices (GtkTreeModel *model,
+               const char   *expected)
+{
+  GString *indices;
+  GtkTreeIter iter;
+  int index;
+
+  indices = g_string_new (NULL);
+
+  g_assert (gtk_tree_model_get_iter_first (model, &iter));
+  do
+    {
+      gtk_tree_model_get (model, &iter, 1, &index, -1);
+      g_string_append_printf (indices, "%d", index);
+    }
+  while (gtk_tree_model_iter_next (model, &iter));
+
+  g_assert_cmpstr (indices->str, ==, expected);
+  g_string_free (indices, TRUE);
+}
+
+static void
+sort_descending_equal_keys (void)
+{
+  const int values[] = { 1, 2, 1, 2, 1 };
+  GtkListStore *store, *func_store;
+  GtkTreeStore *tree_store;
+  GtkTreeModel *sort_model, *func_sort_model;
+  guint i;
+
+  store = gtk_list_store_new (2, G_TYPE_INT, G_TYPE_INT);
+  func_store = gtk_list_store_new (2, G_TYPE_INT, G_TYPE_INT);
+  tree_store = gtk_tree_store_new (2, G_TYPE_INT, G_TYPE_INT);
+  for (i = 0; i < G_N_ELEMENTS (values); i++)
+    {
+      gtk_list_store_insert_with_values (store, NULL, -1,
+                                         0, values[i], 1, i, -1);
+      gtk_list_store_insert_with_values (func_store, NULL, -1,
+                                         0, values[i], 1, i, -1);
+      gtk_tree_store_insert_with_values (tree_store, NULL, NULL, -1,
+                                         0, values[i], 1, i, -1);
+    }
+
+  /* A sort function is compared like before sorting by keys; equal
+   * rows keep their order in descending order as well
+   */
+  gtk_tree_sortable_set_sort_func (GTK_TREE_SORTABLE (func_store), 0,
+                                   compare_int_column, NULL, NULL);
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (func_store),
+                                        0, GTK_SORT_DESCENDING);
+  check_indices (GTK_TREE_MODEL (func_store), "13024");
+
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (store),
+                                        0, GTK_SORT_DESCENDING);
+  check_indices (GTK_TREE_MODEL (store), "13024");
+
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (tree_store),
+                                        0, GTK_SORT_DESCENDING);
+  check_indices (GTK_TREE_MODEL (tree_store), "13024");
+
+  /* Sort models sort from their current order */
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (store),
+                                        1, GTK_SORT_ASCENDING);
+  sort_model = gtk_tree_model_sort_new_with_model (GTK_TREE_MODEL (store));
+  func_sort_model = gtk_tree_model_sort_new_with_model (GTK_TREE_MODEL (store));
+  gtk_tree_sortable_set_sort_func (GTK_TREE_SORTABLE (func_sort_model), 0,
+                                   compare_int_column, NULL, NULL);
+
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (sort_model),
+                                        0, GTK_SORT_ASCENDING);
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (func_sort_model),
+                                        0, GTK_SORT_ASCENDING);
+  check_indices (sort_model, "02413");
+  check_indices (func_sort_model, "02413");
+
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (sort_model),
+                                        0, GTK_SORT_DESCENDING);
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (func_sort_model),
+                                        0, GTK_SORT_DESCENDING);
+  check_indices (sort_model, "13024");
+  check_indices (func_sort_model, "13024");
+
+  g_object_unref (func_sort_model);
+  g_object_unref (sort_model);
+  g_object_unref (tree_store);
+  g_object_unref (func_store);
+  g_object_unref (store);
+}
+
 
 static void
 specific_bug_300089 (void)
@@ -1230,6 +1586,16 @@ register_sort_model_tests (void)
                    rows_reordered_two_levels);
   g_test_add_func ("/TreeModelSort/sorted-insert",
                    sorted_insert);
+  g_test_add_func ("/TreeModelSort/sorted-insert-batched",
+                   sorted_insert_batched);
+  g_test_add_func ("/TreeModelSort/sorted-insert-batched-unbuilt",
+                   sorted_insert_batched_unbuilt);
+  g_test_add_func ("/TreeModelSort/sorted-insert-batched-build-level",
+                   sorted_insert_batched_build_level);
+  g_test_add_func ("/TreeModelSort/sort-large",
+                   sort_large);
+  g_test_add_func ("/TreeModelSort/sort-descending-equal-keys",
+                   sort_descending_equal_keys);
 
   g_test_add_func ("/TreeModelSort/specific/bug-300089",
                    specific_bug_300089);
@@ -28,6 +28,7 @@ main (int    argc,
   g_test_bug_base ("http://bugzilla.gnome.org/");
 
   register_list_store_tests ();
+  register_column_store_tests ();
   register_tree_store_tests ();
   register_model_ref_count_tests ();
   register_sort_model_tests ();
@@ -60,6 +61,9 @@ signal_name_to_string (SignalName signal)
       case ROWS_REORDERED:
           return "rows-reordered";
 
+      case ROWS_INSERTED:
+          return "rows-inserted";
+
       default:
           /* Fall through */
           break;
@@ -73,7 +77,7 @@ typedef struct
   SignalName signal;
   GtkTreePath *path;
 
-  /* For rows-reordered */
+  /* For rows-reordered, and the number of rows for rows-inserted */
   int *new_order;
   int len;
 }
@@ -129,7 +133,8 @@ signal_monitor_generic_handler (SignalMonitor *m,
                                 GtkTreeModel  *model,
                                 GtkTreeIter   *iter,
                                 GtkTreePath   *path,
-                                int           *new_order)
+                                int           *new_order,
+                                int            n_rows)
 {
   Signal *s;
 
@@ -194,6 +199,9 @@ signal_monitor_generic_handler (SignalMonitor *m,
         g_assert (s->new_order[i] == new_order[i]);
     }
 
+  if (signal == ROWS_INSERTED)
+    g_assert_cmpint (s->len, ==, n_rows);
+
   s = g_queue_pop_tail (m->queue);
 
   signal_free (s);
@@ -206,7 +214,7 @@ signal_monitor_row_inserted (GtkTreeModel *model,
                              gpointer      data)
 {
   signal_monitor_generic_handler (data, ROW_INSERTED,
-                                  model, iter, path, NULL);
+                                  model, iter, path, NULL, 0);
 }
 
 static void
@@ -215,7 +223,7 @@ signal_monitor_row_deleted (GtkTreeModel *model,
                             gpointer      data)
 {
   signal_monitor_generic_handler (data, ROW_DELETED,
-                                  model, NULL, path, NULL);
+                                  model, NULL, path, NULL, 0);
 }
 
 static void
@@ -225,7 +233,7 @@ signal_monitor_row_changed (GtkTreeModel *model,
                             gpointer      data)
 {
   signal_monitor_generic_handler (data, ROW_CHANGED,
-                                  model, iter, path, NULL);
+                                  model, iter, path, NULL, 0);
 }
 
 static void
@@ -235,7 +243,7 @@ signal_monitor_row_has_child_toggled (GtkTreeModel *model,
                                       gpointer      data)
 {
   signal_monitor_generic_handler (data, ROW_HAS_CHILD_TOGGLED,
-                                  model, iter, path, NULL);
+                                  model, iter, path, NULL, 0);
 }
 
 static void
@@ -246,11 +254,23 @@ signal_monitor_rows_reordered (GtkTreeModel *model,
                                gpointer      data)
 {
   signal_monitor_generic_handler (data, ROWS_REORDERED,
-                                  model, iter, path, new_order);
+                                  model, iter, path, new_order, 0);
 }
 
-SignalMonitor *
-signal_monitor_new (GtkTreeModel *client)
+static void
+signal_monitor_rows_inserted (GtkTreeModel *model,
+                              GtkTreePath  *path,
+                              GtkTreeIter  *iter,
+                              gint          n_rows,
+                              gpointer      data)
+{
+  signal_monitor_generic_handler (data, ROWS_INSERTED,
+                                  model, iter, path, NULL, n_rows);
+}
+
+static SignalMonitor *
+signal_monitor_new_full (GtkTreeModel *client,
+                         gboolean      row_inserted)
 {
   SignalMonitor *m;
 
@@ -258,10 +278,11 @@ signal_monitor_new (GtkTreeModel *client)
   m->client = g_object_ref (client);
   m->queue = g_queue_new ();
 
-  m->signal_ids[ROW_INSERTED] = g_signal_connect (client,
-                                                  "row-inserted",
-                                                  G_CALLBACK (signal_monitor_row_inserted),
-                                                  m);
+  if (row_inserted)
+    m->signal_ids[ROW_INSERTED] = g_signal_connect (client,
+                                                    "row-inserted",
+                                                    G_CALLBACK (signal_monitor_row_inserted),
+                                                    m);
   m->signal_ids[ROW_DELETED] = g_signal_connect (client,
                                                  "row-deleted",
                                                  G_CALLBACK (signal_monitor_row_deleted),
@@ -278,17 +299,37 @@ signal_monitor_new (GtkTreeModel *client)
                                                     "rows-reordered",
                                                     G_CALLBACK (signal_monitor_rows_reordered),
                                                     m);
+  m->signal_ids[ROWS_INSERTED] = g_signal_connect (client,
+                                                   "rows-inserted",
+                                                   G_CALLBACK (signal_monitor_rows_inserted),
+                                                   m);
 
   return m;
 }
 
+SignalMonitor *
+signal_monitor_new (GtkTreeModel *client)
+{
+  return signal_monitor_new_full (client, TRUE);
+}
+
+/* Models only batch insertions if all row-inserted handlers know
+ * about rows-inserted, so this one does not listen to row-inserted
+ */
+SignalMonitor *
+signal_monitor_new_batched (GtkTreeModel *client)
+{
+  return signal_monitor_new_full (client, FALSE);
+}
+
 void
 signal_monitor_free (SignalMonitor *m)
 {
   int i;
 
   for (i = 0; i < LAST_SIGNAL; i++)
-    g_signal_handler_disconnect (m->client, m->signal_ids[i]);
+    if (m->signal_ids[i])
+      g_signal_handler_disconnect (m->client, m->signal_ids[i]);
 
   g_object_unref (m->client);
 
@@ -343,3 +384,20 @@ signal_monitor_append_signal (SignalMonitor *m,
 
   gtk_tree_path_free (path);
 }
+
+void
+signal_monitor_append_signal_rows_inserted (SignalMonitor *m,
+                                            const gchar   *path_string,
+                                            int            n_rows)
+{
+  Signal *s;
+  GtkTreePath *path;
+
+  path = gtk_tree_path_new_from_string (path_string);
+
+  s = signal_new (ROWS_INSERTED, path);
+  s->len = n_rows;
+  g_queue_push_head (m->queue, s);
+
+  gtk_tree_path_free (path);
+}
@@ -18,6 +18,7 @@
 #include <gtk/gtk.h>
 
 void register_list_store_tests ();
+void register_column_store_tests ();
 void register_tree_store_tests ();
 void register_sort_model_tests ();
 void register_filter_model_tests ();
@@ -36,11 +37,13 @@ enum _SignalName
   ROW_CHANGED,
   ROW_HAS_CHILD_TOGGLED,
   ROWS_REORDERED,
+  ROWS_INSERTED,
   LAST_SIGNAL
 };
 
 
 SignalMonitor *signal_monitor_new                     (GtkTreeModel  *client);
+SignalMonitor *signal_monitor_new_batched             (GtkTreeModel  *client);
 void           signal_monitor_free                    (SignalMonitor *m);
 
 void           signal_monitor_assert_is_empty         (SignalMonitor *m);
@@ -56,3 +59,6 @@ void           signal_monitor_append_signal_path      (SignalMonitor *m,
 void           signal_monitor_append_signal           (SignalMonitor *m,
                                                        SignalName     signal,
                                                        const gchar   *path_string);
+void           signal_monitor_append_signal_rows_inserted (SignalMonitor *m,
+                                                           const gchar   *path_string,
+                                                           int            n_rows);
@@ -937,6 +937,42 @@ tree_store_test_move_before_single (void)
 }
 
 
+/* batched insertion */
+
+static void
+tree_store_test_update (void)
+{
+  GtkTreeIter parent, iter;
+  GtkTreeStore *store;
+  SignalMonitor *monitor;
+
+  store = gtk_tree_store_new (1, G_TYPE_INT);
+  gtk_tree_store_append (store, &parent, NULL);
+
+  monitor = signal_monitor_new_batched (GTK_TREE_MODEL (store));
+
+  gtk_tree_store_begin_update (store);
+  gtk_tree_store_append_rows (store, &iter, &parent, 2);
+  gtk_tree_store_set (store, &iter, 0, 1, -1);
+  signal_monitor_assert_is_empty (monitor);
+
+  /* Rows are only batched for one parent at a time */
+  signal_monitor_append_signal_rows_inserted (monitor, "0:0", 2);
+  signal_monitor_append_signal (monitor, ROW_HAS_CHILD_TOGGLED, "0");
+  gtk_tree_store_append (store, &iter, NULL);
+  signal_monitor_assert_is_empty (monitor);
+
+  signal_monitor_append_signal_rows_inserted (monitor, "1", 1);
+  gtk_tree_store_end_update (store);
+  signal_monitor_assert_is_empty (monitor);
+
+  g_assert_cmpint (gtk_tree_model_iter_n_children (GTK_TREE_MODEL (store), &parent), ==, 2);
+
+  signal_monitor_free (monitor);
+  g_object_unref (store);
+}
+
+
 /* iter invalidation */
 
 static void
@@ -1173,6 +1209,10 @@ register_tree_store_tests (void)
   g_test_add_func ("/TreeStore/move-before-single",
 		   tree_store_test_move_before_single);
 
+  /* batched insertion */
+  g_test_add_func ("/TreeStore/update",
+                   tree_store_test_update);
+
   /* iter invalidation */
   g_test_add ("/TreeStore/iter-prev-invalid", TreeStore, NULL,
               tree_store_setup, tree_store_test_iter_previous_invalid,
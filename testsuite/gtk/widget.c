@@ -0,0 +1,172 @@
+/* GTK - The GIMP Toolkit
+ * Copyright (C) 2015 The GTK+ Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtk/gtk.h>
+
+typedef struct {
+  GtkWidget *widget;
+  gint n_draws;
+} DrawCounter;
+
+/* An emission hook sees ::draw without connecting a handler, which
+ * would make the widget draw differently
+ */
+static gboolean
+count_draws (GSignalInvocationHint *hint,
+             guint                  n_param_values,
+             const GValue          *param_values,
+             gpointer               data)
+{
+  DrawCounter *counter = data;
+
+  if (g_value_get_object (&param_values[0]) == counter->widget)
+    counter->n_draws++;
+
+  return TRUE;
+}
+
+static void
+set_css (GtkWidget   *widget,
+         const gchar *css)
+{
+  GtkCssProvider *provider;
+
+  provider = gtk_css_provider_new ();
+  gtk_css_provider_load_from_data (provider, css, -1, NULL);
+  gtk_style_context_add_provider (gtk_widget_get_style_context (widget),
+                                  GTK_STYLE_PROVIDER (provider),
+                                  GTK_STYLE_PROVIDER_PRIORITY_USER);
+  g_object_unref (provider);
+}
+
+/* Draws a small area in the middle of a box that @child fills, and
+ * returns how often the box itself was drawn
+ */
+static gint
+count_parent_draws (GtkWidget   *child,
+                    const gchar *css)
+{
+  GtkWidget *window, *parent;
+  cairo_surface_t *surface;
+  DrawCounter counter;
+  cairo_t *cr;
+  gulong hook_id;
+  guint signal_id;
+
+  window = gtk_window_new (GTK_WINDOW_POPUP);
+  parent = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+  gtk_widget_set_size_request (parent, 100, 100);
+  gtk_container_add (GTK_CONTAINER (window), parent);
+  gtk_box_pack_start (GTK_BOX (parent), child, TRUE, TRUE, 0);
+  set_css (child, css);
+
+  gtk_widget_show_all (window);
+  gtk_test_widget_wait_for_draw (window);
+
+  counter.widget = parent;
+  counter.n_draws = 0;
+  signal_id = g_signal_lookup ("draw", GTK_TYPE_WIDGET);
+  hook_id = g_signal_add_emission_hook (signal_id, 0, count_draws, &counter, NULL);
+
+  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 100, 100);
+  cr = cairo_create (surface);
+  cairo_rectangle (cr, 40, 40, 20, 20);
+  cairo_clip (cr);
+  gtk_widget_draw (parent, cr);
+  cairo_destroy (cr);
+  cairo_surface_destroy (surface);
+
+  g_signal_remove_emission_hook (signal_id, hook_id);
+  gtk_widget_destroy (window);
+
+  return counter.n_draws;
+}
+
+static void
+test_opaque_cover (void)
+{
+  GtkWidget *child;
+
+  /* The child covers the area, so the box is not drawn */
+  child = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+  g_assert_cmpint (count_parent_draws (child, "* { background-color: #00ff00; }"), ==, 0);
+
+  child = gtk_grid_new ();
+  g_assert_cmpint (count_parent_draws (child, "* { background-color: #00ff00; }"), ==, 0);
+}
+
+static void
+test_opaque_cover_alpha (void)
+{
+  GtkWidget *child;
+
+  child = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+  g_assert_cmpint (count_parent_draws (child, "* { background-color: rgba(0,255,0,0.5); }"), ==, 1);
+
+  child = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+  gtk_widget_set_opacity (child, 0.5);
+  g_assert_cmpint (count_parent_draws (child, "* { background-color: #00ff00; }"), ==, 1);
+}
+
+static void
+test_opaque_cover_rounded (void)
+{
+  GtkWidget *child;
+
+  /* The corners are not covered, even though the drawn area is */
+  child = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+  g_assert_cmpint (count_parent_draws (child,
+                                       "* { background-color: #00ff00;"
+                                       "    border-radius: 5px; }"), ==, 1);
+}
+
+static gboolean
+draw_nothing (GtkWidget *widget,
+              cairo_t   *cr)
+{
+  return FALSE;
+}
+
+static void
+test_opaque_cover_plain_draw (void)
+{
+  GtkWidget *child;
+
+  /* Only widgets whose draw just renders the background and the
+   * children count as opaque
+   */
+  child = gtk_frame_new (NULL);
+  g_assert_cmpint (count_parent_draws (child, "* { background-color: #00ff00; }"), ==, 1);
+
+  /* Draw handlers may draw anything */
+  child = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+  g_signal_connect (child, "draw", G_CALLBACK (draw_nothing), NULL);
+  g_assert_cmpint (count_parent_draws (child, "* { background-color: #00ff00; }"), ==, 1);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  g_test_add_func ("/widget/opaque-cover/opaque", test_opaque_cover);
+  g_test_add_func ("/widget/opaque-cover/alpha", test_opaque_cover_alpha);
+  g_test_add_func ("/widget/opaque-cover/rounded", test_opaque_cover_rounded);
+  g_test_add_func ("/widget/opaque-cover/plain-draw", test_opaque_cover_plain_draw);
+
+  return g_test_run ();
+}
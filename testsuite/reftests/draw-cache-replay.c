@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2015 The GTK+ Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include <gtk/gtk.h>
+
+#include "gtk-reftest.h"
+
+static guint saved_debug_flags;
+static guint n_draws;
+static guint n_ticks;
+
+/* Paints green the first time, and red whenever the widget gets
+ * drawn again instead of being replayed from the draw cache
+ */
+G_MODULE_EXPORT gboolean
+draw_cache_replay_draw (GtkWidget *widget,
+                        cairo_t   *cr)
+{
+  if (n_draws++ == 0)
+    cairo_set_source_rgb (cr, 0.0, 1.0, 0.0);
+  else
+    cairo_set_source_rgb (cr, 1.0, 0.0, 0.0);
+  cairo_paint (cr);
+
+  return FALSE;
+}
+
+G_MODULE_EXPORT gboolean
+draw_cache_replay_draw_green (GtkWidget *widget,
+                              cairo_t   *cr)
+{
+  cairo_set_source_rgb (cr, 0.0, 1.0, 0.0);
+  cairo_paint (cr);
+
+  return FALSE;
+}
+
+static gboolean
+draw_cache_replay_tick (GtkWidget     *widget,
+                        GdkFrameClock *frame_clock,
+                        gpointer       unused)
+{
+  switch (++n_ticks)
+    {
+    case 1:
+      /* The first frame draws and records the widget */
+      return G_SOURCE_CONTINUE;
+
+    case 2:
+      /* Expose it again without invalidating the widget, so the
+       * second frame replays the recording
+       */
+      gdk_window_invalidate_rect (gtk_widget_get_window (widget), NULL, TRUE);
+      return G_SOURCE_CONTINUE;
+
+    default:
+      reftest_uninhibit_snapshot ();
+      return G_SOURCE_REMOVE;
+    }
+}
+
+static void
+draw_cache_replay_restore (GtkWidget *window)
+{
+  gtk_set_debug_flags (saved_debug_flags);
+}
+
+/* Turns the draw cache on until the window goes away, so that
+ * the test fails if it does not replay what was drawn before
+ */
+G_MODULE_EXPORT gboolean
+draw_cache_replay_enable (GtkWidget *window)
+{
+  saved_debug_flags = gtk_get_debug_flags ();
+  gtk_set_debug_flags (saved_debug_flags | GTK_DEBUG_DRAW_CACHE);
+  g_signal_connect (window, "destroy",
+                    G_CALLBACK (draw_cache_replay_restore), NULL);
+
+  n_draws = 0;
+  n_ticks = 0;
+
+  reftest_inhibit_snapshot ();
+  gtk_widget_add_tick_callback (window,
+                                draw_cache_replay_tick,
+                                NULL, NULL);
+
+  return FALSE;
+}
@@ -40,6 +40,7 @@ static char *arg_output_dir = NULL;
 static char *arg_base_dir = NULL;
 static char *arg_direction = NULL;
 static char *arg_compare_dir = NULL;
+static gboolean arg_draw_cache = FALSE;
 
 static const GOptionEntry test_args[] = {
   { "output",         'o', 0, G_OPTION_ARG_FILENAME, &arg_output_dir,
@@ -50,6 +51,8 @@ static const GOptionEntry test_args[] = {
     "Set text direction", "ltr|rtl" },
   { "compare-with",    0, 0, G_OPTION_ARG_FILENAME, &arg_compare_dir,
     "Directory to compare with", "DIR" },
+  { "draw-cache",      0, 0, G_OPTION_ARG_NONE, &arg_draw_cache,
+    "Also check that rendering with the draw cache gives identical results", NULL },
   { NULL }
 };
 
@@ -282,6 +285,26 @@ test_ui_file (GFile *file)
       g_test_fail ();
     }
 
+  if (arg_draw_cache)
+    {
+      cairo_surface_t *cached_image, *cache_diff_image;
+
+      gtk_set_debug_flags (gtk_get_debug_flags () | GTK_DEBUG_DRAW_CACHE);
+      cached_image = reftest_snapshot_ui_file (ui_file);
+      gtk_set_debug_flags (gtk_get_debug_flags () & ~GTK_DEBUG_DRAW_CACHE);
+
+      cache_diff_image = reftest_compare_surfaces (cached_image, ui_image);
+      if (cache_diff_image)
+        {
+          save_image (cached_image, ui_file, ".cache.png");
+          save_image (cache_diff_image, ui_file, ".cache-diff.png");
+          g_test_fail ();
+          cairo_surface_destroy (cache_diff_image);
+        }
+
+      cairo_surface_destroy (cached_image);
+    }
+
   remove_extra_css (provider);
 }
 